@@ -3,19 +3,19 @@ precision highp float;
 uniform sampler2D texSampler;
 
 in vec2 fragTexCoord;
-in vec3 fragNormal;
-in vec3 fragColor;
+in vec4 fragColor;
 
 out vec4 outColor;
 
 void main()
 {
-	vec4 pixel = texture(texSampler, fragTexCoord);
+	// Texture coordinates are in atlas pixels, so that they stay valid when the atlas grows
+	vec2 atlasSize = vec2(textureSize(texSampler, 0));
+	vec4 pixel = texture(texSampler, fragTexCoord / atlasSize);
 	// OpenGL ES puts the alpha in the a channel, but OpenGL 3.3 puts it in the red channel
 #ifdef OPENGL_ES
-	outColor = vec4(fragColor, pixel.w);
+	outColor = vec4(fragColor.rgb, fragColor.a * pixel.w);
 #else
-	outColor = vec4(fragColor, pixel.x);
-	//outColor = vec4(fragNormal, pixel.x);
+	outColor = vec4(fragColor.rgb, fragColor.a * pixel.x);
 #endif
 }
@@ -1,21 +1,17 @@
 precision highp float;
 
 uniform mat4 viewProj;
-uniform mat4 model;
 
-in vec3 inPosition;
-in vec2 inTexCoord;
-in vec3 inNormal;
-in vec3 inColor;
+in vec3 inPosition; // world space, glyph batches have no instance transform
+in vec2 inTexCoord; // atlas pixels
+in vec4 inColor;
 
 out vec2 fragTexCoord;
-out vec3 fragNormal;
-out vec3 fragColor;
+out vec4 fragColor;
 
 void main()
 {
-    gl_Position = viewProj * model * vec4(inPosition, 1.0);
+    gl_Position = viewProj * vec4(inPosition, 1.0);
     fragTexCoord = inTexCoord;
-    fragNormal = (model * vec4(inNormal, 0.0)).xyz;
     fragColor = inColor;
 }
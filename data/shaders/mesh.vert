@@ -1,7 +1,7 @@
 precision highp float;
 
 uniform mat4 viewProj;
-uniform mat4 model;
+in mat4 inModel; // per instance
 
 /*
 attribute vec3 inPosition;
@@ -34,8 +34,8 @@ out vec3 fragColor;
 
 void main()
 {
-	gl_Position = viewProj * model * vec4(inPosition, 1.0);
+	gl_Position = viewProj * inModel * vec4(inPosition, 1.0);
 	fragTexCoord = inTexCoord;
-	fragNormal = (model * vec4(inNormal, 0.0)).xyz;
+	fragNormal = (inModel * vec4(inNormal, 0.0)).xyz;
 	fragColor = inColor;
 }
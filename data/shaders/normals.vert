@@ -1,7 +1,7 @@
 precision highp float;
 
 uniform mat4 viewProj;
-uniform mat4 model;
+in mat4 inModel; // per instance
 
 in vec3 inPosition;
 in vec2 inTexCoord;
@@ -15,9 +15,9 @@ out vec4 geomWorldPos;
 
 void main()
 {
-	geomWorldPos = model * vec4(inPosition, 1.0);
+	geomWorldPos = inModel * vec4(inPosition, 1.0);
   gl_Position = viewProj * geomWorldPos;
   geomTexCoord = inTexCoord;
-  geomNormal = inNormal;
+  geomNormal = (inModel * vec4(inNormal, 0.0)).xyz;
   geomColor = inColor;
 }
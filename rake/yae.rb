@@ -49,6 +49,9 @@ def settings()
 	end
 
 	# renderer
+	_settings[:source_files] |= FileList["src/yae/rendering/renderers/null/**/*.cpp"]
+	_settings[:defines] += ["YAE_IMPLEMENTS_RENDERER_NULL=1"]
+
 	if renderer == :opengl
 		_settings[:source_files] |= FileList["src/yae/rendering/renderers/opengl/**/*.cpp"]
 		_settings[:defines] += ["YAE_IMPLEMENTS_RENDERER_OPENGL=1"]
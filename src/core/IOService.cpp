@@ -0,0 +1,398 @@
+#include "IOService.h"
+
+#include <core/memory.h>
+#include <core/platform.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace yae {
+
+IOBatch::IOBatch(Allocator* _allocator, u64 _arenaSize)
+	: m_allocator(_allocator)
+	, m_requests(_allocator)
+	, m_arenaSize(_arenaSize)
+	, m_arenaCursor(0)
+	, m_remainingCount(0)
+{
+	if (m_arenaSize > 0)
+	{
+		m_arena = (u8*)m_allocator->allocate(m_arenaSize);
+	}
+}
+
+
+IOBatch::~IOBatch()
+{
+	if (m_service != nullptr)
+	{
+		m_service->wait(*this);
+	}
+
+	for (const IOReadRequest& request : m_requests)
+	{
+		if (request.isDataOwned)
+		{
+			std::free(const_cast<void*>(request.data));
+		}
+	}
+	m_requests.clear();
+
+	if (m_arena != nullptr)
+	{
+		m_allocator->deallocate(m_arena);
+		m_arena = nullptr;
+	}
+}
+
+
+IOReadRequest& IOBatch::addRead(const char* _path, void* _buffer, u64 _bufferSize, void* _userData)
+{
+	YAE_ASSERT_MSG(m_service == nullptr, "Can't add requests to a submitted batch");
+	YAE_ASSERT(_path != nullptr);
+
+	IOReadRequest request;
+	request.path = _path;
+	request.buffer = _buffer;
+	request.bufferSize = _bufferSize;
+	request.userData = _userData;
+	m_requests.push_back(request);
+	return m_requests.back();
+}
+
+
+void IOBatch::setCallback(IOCallback _callback)
+{
+	YAE_ASSERT_MSG(m_service == nullptr, "Can't change the callback of a submitted batch");
+	m_callback = _callback;
+}
+
+
+bool IOBatch::isComplete() const
+{
+	return m_remainingCount.load(std::memory_order_acquire) == 0;
+}
+
+
+u32 IOBatch::getRequestCount() const
+{
+	return m_requests.size();
+}
+
+
+const IOReadRequest& IOBatch::getRequest(u32 _index) const
+{
+	return m_requests[_index];
+}
+
+
+void* IOBatch::_allocate(u64 _size, bool* _outIsOwned)
+{
+	const u64 ALIGN = 16;
+	u64 alignedSize = (_size + ALIGN - 1) & ~(ALIGN - 1);
+	if (m_arena != nullptr && alignedSize <= m_arenaSize)
+	{
+		u64 offset = m_arenaCursor.fetch_add(alignedSize);
+		if (offset + alignedSize <= m_arenaSize)
+		{
+			*_outIsOwned = false;
+			return m_arena + offset;
+		}
+	}
+
+	// @NOTE(remi): the batch allocator can't be used from the I/O threads
+	*_outIsOwned = true;
+	return std::malloc(_size > 0 ? _size : 1);
+}
+
+
+
+IOService::IOService(Allocator* _allocator)
+	: m_allocator(_allocator)
+	, m_threads(_allocator)
+	, m_submittedBatches(_allocator)
+	, m_queuedBatches(_allocator)
+{
+
+}
+
+
+IOService::~IOService()
+{
+	YAE_ASSERT(m_threads.size() == 0);
+	YAE_ASSERT_MSG(m_submittedBatches.size() == 0, "Batches must be complete before the service gets destroyed");
+}
+
+
+void IOService::init(u32 _threadCount)
+{
+	YAE_ASSERT(m_threads.size() == 0);
+
+#if YAE_IO_THREADS_ENABLED
+	m_stopRequested = false;
+	for (u32 i = 0; i < _threadCount; ++i)
+	{
+		std::thread* thread = m_allocator->create<std::thread>(&IOService::_threadMain, this);
+		m_threads.push_back(thread);
+	}
+#endif
+}
+
+
+void IOService::shutdown()
+{
+	// Pending batches are finished on the calling thread
+	while (m_submittedBatches.size() > 0)
+	{
+		wait(*m_submittedBatches.back());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopRequested = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread* thread : m_threads)
+	{
+		thread->join();
+		m_allocator->destroy(thread);
+	}
+	m_threads.clear();
+}
+
+
+void IOService::submit(IOBatch& _batch)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT_MSG(_batch.m_service == nullptr, "Batch already submitted");
+
+	_batch.m_service = this;
+	_batch.m_nextRequest = 0;
+	_batch.m_remainingCount.store(_batch.m_requests.size());
+	m_submittedBatches.push_back(&_batch);
+
+	if (_batch.m_requests.size() == 0)
+		return;
+
+	if (m_threads.size() == 0)
+	{
+		for (u32 i = 0; i < _batch.m_requests.size(); ++i)
+		{
+			_processRequest(_batch, i);
+		}
+		_batch.m_nextRequest = _batch.m_requests.size();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queuedBatches.push_back(&_batch);
+	}
+	m_wakeCondition.notify_all();
+}
+
+
+void IOService::wait(IOBatch& _batch)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_batch.m_service == this);
+
+	// Help with the requests nobody started yet
+	while (true)
+	{
+		u32 index = 0;
+		IOBatch* batch = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			batch = _claimRequest(&_batch, &index);
+		}
+		if (batch == nullptr)
+			break;
+
+		_processRequest(_batch, index);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCondition.wait(lock, [&_batch]() { return _batch.isComplete(); });
+	}
+
+	_dispatchCallbacks(_batch);
+	_removeSubmittedBatch(_batch);
+}
+
+
+void IOService::update()
+{
+	YAE_CAPTURE_FUNCTION();
+
+	for (u32 i = 0; i < m_submittedBatches.size();)
+	{
+		IOBatch* batch = m_submittedBatches[i];
+		if (batch->isComplete())
+		{
+			_dispatchCallbacks(*batch);
+			batch->m_service = nullptr;
+			m_submittedBatches.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+
+u32 IOService::getThreadCount() const
+{
+	return m_threads.size();
+}
+
+
+u32 IOService::GetDefaultThreadCount()
+{
+#if YAE_IO_THREADS_ENABLED
+	// Threads mostly wait for the disk, a few of them are enough to keep it busy
+	return 4;
+#else
+	return 0;
+#endif
+}
+
+
+void IOService::_threadMain()
+{
+	while (true)
+	{
+		u32 index = 0;
+		IOBatch* batch = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeCondition.wait(lock, [this]() { return m_stopRequested || m_queuedBatches.size() > 0; });
+			if (m_stopRequested)
+				return;
+
+			batch = _claimRequest(nullptr, &index);
+		}
+
+		if (batch != nullptr)
+		{
+			_processRequest(*batch, index);
+		}
+	}
+}
+
+
+IOBatch* IOService::_claimRequest(IOBatch* _batch, u32* _outIndex)
+{
+	IOBatch** batchPtr = nullptr;
+	if (_batch != nullptr)
+	{
+		batchPtr = m_queuedBatches.find(_batch);
+	}
+	else if (m_queuedBatches.size() > 0)
+	{
+		batchPtr = &m_queuedBatches[0];
+	}
+
+	if (batchPtr == nullptr)
+		return nullptr;
+
+	IOBatch* batch = *batchPtr;
+	*_outIndex = batch->m_nextRequest++;
+	if (batch->m_nextRequest == batch->m_requests.size())
+	{
+		m_queuedBatches.erase(batchPtr);
+	}
+	return batch;
+}
+
+
+void IOService::_processRequest(IOBatch& _batch, u32 _index)
+{
+	IOReadRequest& request = _batch.m_requests[_index];
+	request.status = IOStatus::READ_FAILED;
+
+	FILE* file = std::fopen(request.path, "rb");
+	if (file == nullptr)
+	{
+		request.status = IOStatus::OPEN_FAILED;
+	}
+	else
+	{
+		i64 size = -1;
+		if (YAE_FSEEK64(file, 0, SEEK_END) == 0)
+		{
+			size = YAE_FTELL64(file);
+			YAE_FSEEK64(file, 0, SEEK_SET);
+		}
+
+		if (size >= 0)
+		{
+			void* buffer = request.buffer;
+			if (buffer == nullptr)
+			{
+				buffer = _batch._allocate(u64(size), &request.isDataOwned);
+			}
+
+			if (request.buffer != nullptr && u64(size) > request.bufferSize)
+			{
+				request.status = IOStatus::BUFFER_TOO_SMALL;
+			}
+			else if (std::fread(buffer, 1, size_t(size), file) == size_t(size))
+			{
+				request.status = IOStatus::DONE;
+				request.data = buffer;
+				request.size = u64(size);
+			}
+			else if (request.isDataOwned)
+			{
+				std::free(buffer);
+				request.isDataOwned = false;
+			}
+		}
+		std::fclose(file);
+	}
+
+	// @NOTE(remi): the batch may be destroyed as soon as its last request is done, it must not be touched afterwards.
+	if (_batch.m_remainingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_doneCondition.notify_all();
+	}
+}
+
+
+void IOService::_dispatchCallbacks(IOBatch& _batch)
+{
+	YAE_ASSERT(_batch.isComplete());
+
+	if (_batch.m_areCallbacksDispatched)
+		return;
+
+	_batch.m_areCallbacksDispatched = true;
+	if (_batch.m_callback == nullptr)
+		return;
+
+	for (const IOReadRequest& request : _batch.m_requests)
+	{
+		_batch.m_callback(request);
+	}
+}
+
+
+void IOService::_removeSubmittedBatch(IOBatch& _batch)
+{
+	_batch.m_service = nullptr;
+
+	IOBatch** batchPtr = m_submittedBatches.find(&_batch);
+	if (batchPtr != nullptr)
+	{
+		m_submittedBatches.erase(batchPtr);
+	}
+}
+
+} // namespace yae
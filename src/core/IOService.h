@@ -0,0 +1,122 @@
+#pragma once
+
+#include <core/types.h>
+#include <core/containers/Array.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define YAE_IO_THREADS_ENABLED (YAE_PLATFORM_WEB == 0)
+
+namespace yae {
+
+class IOService;
+
+enum class IOStatus : u8
+{
+	PENDING,
+	DONE,
+	OPEN_FAILED,
+	READ_FAILED,
+	BUFFER_TOO_SMALL,
+};
+
+struct IOReadRequest
+{
+	const char* path = nullptr; // must stay valid until the batch is complete
+	void* buffer = nullptr; // nullptr to read in the batch memory
+	u64 bufferSize = 0;
+	void* userData = nullptr;
+
+	// Filled when the request is complete
+	IOStatus status = IOStatus::PENDING;
+	const void* data = nullptr;
+	u64 size = 0;
+	bool isDataOwned = false; // allocated by the batch outside of its arena
+};
+
+typedef void(*IOCallback)(const IOReadRequest& _request);
+
+// Read requests submitted together to the IOService.
+// Requests without buffer are read in the batch arena, or in memory owned by the batch once the arena is full. The
+// data stays valid as long as the batch does.
+// @NOTE(remi): the batch must not be destroyed before it is complete, the destructor waits for it to be safe.
+class CORE_API IOBatch
+{
+public:
+	IOBatch(Allocator* _allocator, u64 _arenaSize = 0);
+	~IOBatch();
+
+	// The returned reference is only valid until the next request is added
+	IOReadRequest& addRead(const char* _path, void* _buffer = nullptr, u64 _bufferSize = 0, void* _userData = nullptr);
+	// Called once per request, on the thread that completes the batch (IOService::update or IOService::wait)
+	void setCallback(IOCallback _callback);
+
+	bool isComplete() const; // completion token, the requests can be read once it is set
+	u32 getRequestCount() const;
+	const IOReadRequest& getRequest(u32 _index) const;
+
+//private:
+	friend class IOService;
+
+	void* _allocate(u64 _size, bool* _outIsOwned); // called from the I/O threads
+
+	Allocator* m_allocator = nullptr;
+	DataArray<IOReadRequest> m_requests;
+	IOCallback m_callback = nullptr;
+	IOService* m_service = nullptr;
+
+	u8* m_arena = nullptr;
+	u64 m_arenaSize = 0;
+	std::atomic<u64> m_arenaCursor;
+
+	u32 m_nextRequest = 0; // guarded by the service mutex
+	std::atomic<u32> m_remainingCount;
+	bool m_areCallbacksDispatched = false;
+};
+
+// Reads batches of files on a pool of I/O threads.
+// Batches are submitted from the main thread, the thread waiting for a batch reads its remaining requests too, so
+// with no thread (e.g. on web) requests are just read when submitted.
+// @NOTE(remi): I/O threads use the C file API directly, FileHandle allocates from the engine allocators which are not thread safe.
+class CORE_API IOService
+{
+public:
+	IOService(Allocator* _allocator);
+	~IOService();
+
+	void init(u32 _threadCount);
+	void shutdown();
+
+	// The batch can't be modified once submitted
+	void submit(IOBatch& _batch);
+	// Returns when every request of the batch is read, after its callbacks are called
+	void wait(IOBatch& _batch);
+	// Calls the callbacks of the batches completed since the last update
+	void update();
+
+	u32 getThreadCount() const;
+
+	static u32 GetDefaultThreadCount();
+
+//private:
+	void _threadMain();
+	IOBatch* _claimRequest(IOBatch* _batch, u32* _outIndex); // any batch when _batch is nullptr, m_mutex must be locked
+	void _processRequest(IOBatch& _batch, u32 _index);
+	void _dispatchCallbacks(IOBatch& _batch);
+	void _removeSubmittedBatch(IOBatch& _batch);
+
+	Allocator* m_allocator = nullptr;
+	DataArray<std::thread*> m_threads;
+	DataArray<IOBatch*> m_submittedBatches; // waiting for their callbacks, main thread only
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+	DataArray<IOBatch*> m_queuedBatches; // with requests left to claim
+	bool m_stopRequested = false;
+};
+
+} // namespace yae
@@ -0,0 +1,193 @@
+#include "JobSystem.h"
+
+#include <core/memory.h>
+
+namespace yae {
+
+JobSystem::JobSystem(Allocator* _allocator)
+	: m_allocator(_allocator)
+	, m_workers(_allocator)
+	, m_mainThreadId(std::this_thread::get_id())
+	, m_batchCursor(0)
+	, m_remainingBatches(0)
+{
+
+}
+
+
+JobSystem::~JobSystem()
+{
+	YAE_ASSERT(m_workers.size() == 0);
+}
+
+
+void JobSystem::init(u32 _workerCount)
+{
+	YAE_ASSERT(isMainThread());
+	YAE_ASSERT(m_workers.size() == 0);
+
+#if YAE_JOBS_ENABLED
+	m_stopRequested = false;
+	for (u32 i = 0; i < _workerCount; ++i)
+	{
+		std::thread* worker = m_allocator->create<std::thread>(&JobSystem::_workerMain, this);
+		m_workers.push_back(worker);
+	}
+#endif
+}
+
+
+void JobSystem::shutdown()
+{
+	YAE_ASSERT(isMainThread());
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopRequested = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread* worker : m_workers)
+	{
+		worker->join();
+		m_allocator->destroy(worker);
+	}
+	m_workers.clear();
+}
+
+
+void JobSystem::parallelFor(u32 _count, u32 _batchSize, JobFunction _function, void* _userData)
+{
+	YAE_ASSERT(_function != nullptr);
+	if (_count == 0)
+		return;
+
+	_batchSize = _batchSize > 0 ? _batchSize : 1;
+	u32 batchCount = (_count + _batchSize - 1) / _batchSize;
+
+	// Nested or trivial jobs run inline
+	if (m_workers.size() == 0 || batchCount == 1 || !isMainThread())
+	{
+		_function(0, _count, _userData);
+		return;
+	}
+
+	Job job;
+	job.function = _function;
+	job.userData = _userData;
+	job.count = _count;
+	job.batchSize = _batchSize;
+	job.batchCount = batchCount;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_jobGeneration;
+		job.generation = m_jobGeneration;
+		m_job = job;
+		m_remainingBatches.store(batchCount);
+		m_batchCursor.store(u64(job.generation) << 32);
+	}
+	m_wakeCondition.notify_all();
+
+	_runBatches(job);
+
+	// @NOTE(remi): workers that are late on this job are not waited for, they will fail to claim a batch since the cursor generation will not match theirs.
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this]() { return m_remainingBatches.load() == 0; });
+}
+
+
+u32 JobSystem::getWorkerCount() const
+{
+	return m_workers.size();
+}
+
+
+u32 JobSystem::getThreadCount() const
+{
+	return m_workers.size() + 1;
+}
+
+
+bool JobSystem::isMainThread() const
+{
+	return std::this_thread::get_id() == m_mainThreadId;
+}
+
+
+u32 JobSystem::GetDefaultWorkerCount()
+{
+#if YAE_JOBS_ENABLED
+	u32 hardwareThreads = std::thread::hardware_concurrency();
+	return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+#else
+	return 0;
+#endif
+}
+
+
+void JobSystem::_workerMain()
+{
+	u32 lastGeneration = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		lastGeneration = m_jobGeneration;
+	}
+
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeCondition.wait(lock, [this, lastGeneration]() { return m_stopRequested || m_jobGeneration != lastGeneration; });
+			if (m_stopRequested)
+				return;
+
+			lastGeneration = m_jobGeneration;
+			job = m_job;
+		}
+
+		_runBatches(job);
+	}
+}
+
+
+void JobSystem::_runBatches(const Job& _job)
+{
+	u32 batch = 0;
+	while (_claimBatch(_job, batch))
+	{
+		u32 begin = batch * _job.batchSize;
+		u32 end = begin + _job.batchSize < _job.count ? begin + _job.batchSize : _job.count;
+		_job.function(begin, end, _job.userData);
+
+		if (m_remainingBatches.fetch_sub(1) == 1)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_doneCondition.notify_all();
+		}
+	}
+}
+
+
+bool JobSystem::_claimBatch(const Job& _job, u32& _outBatch)
+{
+	u64 cursor = m_batchCursor.load();
+	while (true)
+	{
+		if (u32(cursor >> 32) != _job.generation)
+			return false;
+
+		u32 batch = u32(cursor);
+		if (batch >= _job.batchCount)
+			return false;
+
+		if (m_batchCursor.compare_exchange_weak(cursor, cursor + 1))
+		{
+			_outBatch = batch;
+			return true;
+		}
+	}
+}
+
+} // namespace yae
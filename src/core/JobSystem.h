@@ -0,0 +1,76 @@
+#pragma once
+
+#include <core/types.h>
+#include <core/containers/Array.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define YAE_JOBS_ENABLED (YAE_PLATFORM_WEB == 0)
+
+namespace yae {
+
+typedef void(*JobFunction)(u32 _begin, u32 _end, void* _userData);
+
+// Small fork/join worker pool.
+// Work is always submitted from the main thread and the main thread takes part in it, so with no
+// workers (e.g. on web) everything just runs inline.
+// @NOTE(remi): jobs must not touch the scratch allocator nor the profiler, neither of them are thread safe.
+class CORE_API JobSystem
+{
+public:
+	JobSystem(Allocator* _allocator);
+	~JobSystem();
+
+	void init(u32 _workerCount);
+	void shutdown();
+
+	// Splits [0, _count[ into batches of _batchSize elements and runs them on all threads. Returns when every batch is done.
+	void parallelFor(u32 _count, u32 _batchSize, JobFunction _function, void* _userData);
+	// _function(u32 _begin, u32 _end)
+	template <typename Function>
+	void parallelFor(u32 _count, u32 _batchSize, Function&& _function);
+
+	u32 getWorkerCount() const;
+	u32 getThreadCount() const; // workers + main thread
+	bool isMainThread() const;
+
+	static u32 GetDefaultWorkerCount();
+
+//private:
+	struct Job
+	{
+		JobFunction function = nullptr;
+		void* userData = nullptr;
+		u32 count = 0;
+		u32 batchSize = 0;
+		u32 batchCount = 0;
+		u32 generation = 0;
+	};
+
+	void _workerMain();
+	void _runBatches(const Job& _job);
+	bool _claimBatch(const Job& _job, u32& _outBatch);
+
+	Allocator* m_allocator = nullptr;
+	DataArray<std::thread*> m_workers;
+	std::thread::id m_mainThreadId;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+	Job m_job;
+	u32 m_jobGeneration = 0;
+	bool m_stopRequested = false;
+
+	// Generation of the current job in the high 32 bits, next batch to run in the low 32 bits.
+	// Batches are claimed with a compare and swap, so a worker still holding an older job can never take a batch of the current one.
+	std::atomic<u64> m_batchCursor;
+	std::atomic<u32> m_remainingBatches;
+};
+
+} // namespace yae
+
+#include "JobSystem.inl"
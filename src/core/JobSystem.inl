@@ -0,0 +1,15 @@
+#include <type_traits>
+
+namespace yae {
+
+template <typename Function>
+void JobSystem::parallelFor(u32 _count, u32 _batchSize, Function&& _function)
+{
+	auto trampoline = [](u32 _begin, u32 _end, void* _userData)
+	{
+		(*(typename std::remove_reference<Function>::type*)_userData)(_begin, _end);
+	};
+	parallelFor(_count, _batchSize, trampoline, (void*)&_function);
+}
+
+} // namespace yae
@@ -0,0 +1,357 @@
+#include "StringBuilder.h"
+
+#include <core/memory.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace yae {
+
+static const char DIGIT_PAIRS[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const u32 MAX_FLOAT_DECIMALS = 9;
+static const u64 POWERS_OF_10[MAX_FLOAT_DECIMALS + 1] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull };
+
+StringBuilder::StringBuilder(Allocator* _allocator)
+	: m_buffer(m_emptyBuffer)
+	, m_allocator(_allocator)
+{
+	if (m_allocator == nullptr)
+	{
+		m_allocator = &defaultAllocator();
+	}
+}
+
+
+StringBuilder::StringBuilder(char* _buffer, size_t _bufferSize, Allocator* _allocator)
+	: StringBuilder(_allocator)
+{
+	YAE_ASSERT(_buffer != nullptr && _bufferSize > 0);
+	m_buffer = _buffer;
+	m_buffer[0] = 0;
+	m_capacity = _bufferSize - 1;
+}
+
+
+StringBuilder::~StringBuilder()
+{
+	if (m_isBufferOwned)
+	{
+		m_allocator->deallocate(m_buffer);
+	}
+	m_buffer = nullptr;
+}
+
+
+StringBuilder& StringBuilder::append(const char* _str)
+{
+	YAE_ASSERT(_str != nullptr);
+	return append(_str, strlen(_str));
+}
+
+
+StringBuilder& StringBuilder::append(const char* _str, size_t _length)
+{
+	if (m_length + _length > m_capacity)
+	{
+		_grow(m_length + _length);
+	}
+	memcpy(m_buffer + m_length, _str, _length);
+	m_length += _length;
+	m_buffer[m_length] = 0;
+	return *this;
+}
+
+
+StringBuilder& StringBuilder::append(const String& _str)
+{
+	return append(_str.c_str(), _str.size());
+}
+
+
+StringBuilder& StringBuilder::append(char _char)
+{
+	if (m_length + 1 > m_capacity)
+	{
+		_grow(m_length + 1);
+	}
+	m_buffer[m_length] = _char;
+	++m_length;
+	m_buffer[m_length] = 0;
+	return *this;
+}
+
+
+StringBuilder& StringBuilder::appendRepeated(char _char, size_t _count)
+{
+	if (m_length + _count > m_capacity)
+	{
+		_grow(m_length + _count);
+	}
+	memset(m_buffer + m_length, _char, _count);
+	m_length += _count;
+	m_buffer[m_length] = 0;
+	return *this;
+}
+
+
+StringBuilder& StringBuilder::appendInteger(i64 _value)
+{
+	if (_value < 0)
+	{
+		append('-');
+		return appendUnsigned(0 - u64(_value));
+	}
+	return appendUnsigned(u64(_value));
+}
+
+
+StringBuilder& StringBuilder::appendUnsigned(u64 _value)
+{
+	// Written backwards from the end, two digits at a time
+	char digits[20];
+	char* cursor = digits + sizeof(digits);
+	while (_value >= 100)
+	{
+		u32 index = u32(_value % 100) * 2;
+		_value /= 100;
+		*--cursor = DIGIT_PAIRS[index + 1];
+		*--cursor = DIGIT_PAIRS[index];
+	}
+	if (_value >= 10)
+	{
+		u32 index = u32(_value) * 2;
+		*--cursor = DIGIT_PAIRS[index + 1];
+		*--cursor = DIGIT_PAIRS[index];
+	}
+	else
+	{
+		*--cursor = char('0' + _value);
+	}
+	return append(cursor, size_t(digits + sizeof(digits) - cursor));
+}
+
+
+StringBuilder& StringBuilder::appendFloat(double _value, i32 _decimals)
+{
+	if (std::isnan(_value))
+		return append("nan", 3);
+
+	if (std::signbit(_value))
+	{
+		append('-');
+		_value = -_value;
+	}
+
+	if (_value > DBL_MAX)
+		return append("inf", 3);
+
+	bool trimZeros = _decimals < 0;
+	u32 decimals = trimZeros ? 6 : (u32(_decimals) > MAX_FLOAT_DECIMALS ? MAX_FLOAT_DECIMALS : u32(_decimals));
+	u64 scale = POWERS_OF_10[decimals];
+
+	// Too large for the integer part to fit in 64 bits, written as d.ddde+XX
+	i32 exponent = 0;
+	bool isScientific = _value >= 1e15;
+	if (isScientific)
+	{
+		exponent = i32(std::floor(std::log10(_value)));
+		_value /= std::pow(10.0, double(exponent));
+		while (_value >= 10.0)
+		{
+			_value /= 10.0;
+			++exponent;
+		}
+		while (_value < 1.0)
+		{
+			_value *= 10.0;
+			--exponent;
+		}
+	}
+
+	u64 integerPart = u64(_value);
+	u64 fractionalPart = u64((_value - double(integerPart)) * double(scale) + 0.5);
+	if (fractionalPart >= scale)
+	{
+		++integerPart;
+		fractionalPart -= scale;
+	}
+	if (isScientific && integerPart >= 10)
+	{
+		integerPart /= 10;
+		++exponent;
+	}
+
+	appendUnsigned(integerPart);
+	if (decimals > 0)
+	{
+		char digits[MAX_FLOAT_DECIMALS];
+		for (u32 i = decimals; i > 0; --i)
+		{
+			digits[i - 1] = char('0' + fractionalPart % 10);
+			fractionalPart /= 10;
+		}
+
+		u32 digitCount = decimals;
+		while (trimZeros && digitCount > 0 && digits[digitCount - 1] == '0')
+		{
+			--digitCount;
+		}
+
+		if (digitCount > 0)
+		{
+			append('.');
+			append(digits, digitCount);
+		}
+	}
+
+	if (isScientific)
+	{
+		append(exponent < 0 ? "e-" : "e+", 2);
+		u32 absoluteExponent = u32(exponent < 0 ? -exponent : exponent);
+		if (absoluteExponent < 10)
+		{
+			append('0');
+		}
+		appendUnsigned(absoluteExponent);
+	}
+	return *this;
+}
+
+
+StringBuilder& StringBuilder::formatArguments(const char* _fmt, const FormatArgument* _arguments, u32 _argumentCount)
+{
+	YAE_ASSERT(_fmt != nullptr);
+
+	u32 argumentIndex = 0;
+	const char* literalStart = _fmt;
+	const char* cursor = _fmt;
+	while (*cursor != 0)
+	{
+		if ((cursor[0] == '{' && cursor[1] == '{') || (cursor[0] == '}' && cursor[1] == '}'))
+		{
+			append(literalStart, size_t(cursor - literalStart) + 1);
+			cursor += 2;
+			literalStart = cursor;
+			continue;
+		}
+
+		if (cursor[0] != '{')
+		{
+			++cursor;
+			continue;
+		}
+
+		append(literalStart, size_t(cursor - literalStart));
+
+		const char* placeholderEnd = strchr(cursor, '}');
+		YAE_ASSERT_MSGF(placeholderEnd != nullptr, "Unclosed placeholder in format string \"%s\"", _fmt);
+		if (placeholderEnd == nullptr)
+		{
+			literalStart = cursor;
+			break;
+		}
+
+		i32 decimals = -1;
+		if (cursor[1] == '.')
+		{
+			decimals = 0;
+			for (const char* digit = cursor + 2; digit < placeholderEnd && *digit >= '0' && *digit <= '9'; ++digit)
+			{
+				decimals = decimals * 10 + (*digit - '0');
+			}
+		}
+
+		YAE_ASSERT_MSGF(argumentIndex < _argumentCount, "Not enough arguments for format string \"%s\"", _fmt);
+		if (argumentIndex < _argumentCount)
+		{
+			const FormatArgument& argument = _arguments[argumentIndex];
+			switch (argument.type)
+			{
+				case FormatArgument::TYPE_SIGNED: appendInteger(argument.signedInteger); break;
+				case FormatArgument::TYPE_UNSIGNED: appendUnsigned(argument.unsignedInteger); break;
+				case FormatArgument::TYPE_FLOAT: appendFloat(argument.floating, decimals); break;
+				case FormatArgument::TYPE_BOOL: append(argument.boolean ? "true" : "false"); break;
+				case FormatArgument::TYPE_CHAR: append(argument.character); break;
+				case FormatArgument::TYPE_STRING: append(argument.string); break;
+			}
+		}
+		++argumentIndex;
+
+		cursor = placeholderEnd + 1;
+		literalStart = cursor;
+	}
+	append(literalStart, strlen(literalStart));
+
+	YAE_ASSERT_MSGF(argumentIndex >= _argumentCount, "Too many arguments for format string \"%s\"", _fmt);
+	return *this;
+}
+
+
+void StringBuilder::reserve(size_t _capacity)
+{
+	if (_capacity > m_capacity)
+	{
+		_grow(_capacity);
+	}
+}
+
+
+void StringBuilder::clear()
+{
+	m_length = 0;
+	m_buffer[0] = 0;
+}
+
+
+void StringBuilder::resize(size_t _size)
+{
+	YAE_ASSERT(_size <= m_length);
+	m_length = _size;
+	m_buffer[m_length] = 0;
+}
+
+
+String StringBuilder::toString(Allocator* _allocator) const
+{
+	return String(m_buffer, _allocator != nullptr ? _allocator : m_allocator);
+}
+
+
+void StringBuilder::_grow(size_t _minCapacity)
+{
+	size_t capacity = m_capacity * 2;
+	if (capacity < 64)
+	{
+		capacity = 64;
+	}
+	if (capacity < _minCapacity)
+	{
+		capacity = _minCapacity;
+	}
+
+	char* buffer = (char*)m_allocator->allocate(capacity + 1);
+	YAE_ASSERT_MSG(buffer != nullptr, "Allocation failed");
+	memcpy(buffer, m_buffer, m_length + 1);
+
+	if (m_isBufferOwned)
+	{
+		m_allocator->deallocate(m_buffer);
+	}
+	m_buffer = buffer;
+	m_capacity = capacity;
+	m_isBufferOwned = true;
+}
+
+} // namespace yae
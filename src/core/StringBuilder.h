@@ -0,0 +1,104 @@
+#pragma once
+
+#include <core/types.h>
+
+#include <type_traits>
+
+namespace yae {
+
+// Value passed to StringBuilder::format, the type is checked at compile time
+struct FormatArgument
+{
+	enum Type : u8
+	{
+		TYPE_SIGNED,
+		TYPE_UNSIGNED,
+		TYPE_FLOAT,
+		TYPE_BOOL,
+		TYPE_CHAR,
+		TYPE_STRING,
+	};
+
+	FormatArgument(const char* _value) : type(TYPE_STRING) { string = _value != nullptr ? _value : "(null)"; }
+	FormatArgument(char* _value) : FormatArgument((const char*)_value) {}
+	FormatArgument(const String& _value) : type(TYPE_STRING) { string = _value.c_str(); }
+	FormatArgument(char _value) : type(TYPE_CHAR) { character = _value; }
+	FormatArgument(bool _value) : type(TYPE_BOOL) { boolean = _value; }
+	FormatArgument(float _value) : type(TYPE_FLOAT) { floating = _value; }
+	FormatArgument(double _value) : type(TYPE_FLOAT) { floating = _value; }
+
+	template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+	FormatArgument(T _value) : type(TYPE_SIGNED) { signedInteger = i64(_value); }
+
+	template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, int>::type = 0>
+	FormatArgument(T _value) : type(TYPE_UNSIGNED) { unsignedInteger = u64(_value); }
+
+	template <typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+	FormatArgument(T _value) : FormatArgument(typename std::underlying_type<T>::type(_value)) {}
+
+	Type type;
+	union
+	{
+		i64 signedInteger;
+		u64 unsignedInteger;
+		double floating;
+		bool boolean;
+		char character;
+		const char* string;
+	};
+};
+
+// Appends to a buffer that grows geometrically, so that building a string is linear in its final size.
+// Numbers are written directly, without going through snprintf. The builder can start in a caller provided buffer
+// (usually on the stack) and only allocates once it outgrows it.
+class CORE_API StringBuilder
+{
+public:
+	StringBuilder(Allocator* _allocator = nullptr);
+	StringBuilder(char* _buffer, size_t _bufferSize, Allocator* _allocator = nullptr);
+	~StringBuilder();
+
+	StringBuilder(const StringBuilder&) = delete;
+	StringBuilder& operator=(const StringBuilder&) = delete;
+
+	StringBuilder& append(const char* _str);
+	StringBuilder& append(const char* _str, size_t _length);
+	StringBuilder& append(const String& _str);
+	StringBuilder& append(char _char);
+	StringBuilder& appendRepeated(char _char, size_t _count);
+	StringBuilder& appendInteger(i64 _value);
+	StringBuilder& appendUnsigned(u64 _value);
+	// _decimals < 0 writes up to 6 decimals without the trailing zeros
+	StringBuilder& appendFloat(double _value, i32 _decimals = -1);
+
+	// "{}" is replaced by the next argument, "{.N}" writes a float with N decimals, "{{" and "}}" write braces.
+	// e.g. format("{}: {.2}ms", name, time)
+	template <typename... Args>
+	StringBuilder& format(const char* _fmt, const Args&... _args);
+	StringBuilder& formatArguments(const char* _fmt, const FormatArgument* _arguments, u32 _argumentCount);
+
+	void reserve(size_t _capacity);
+	void clear(); // keeps the buffer
+	void resize(size_t _size); // shrinks only
+
+	size_t size() const { return m_length; }
+	size_t capacity() const { return m_capacity; }
+	const char* c_str() const { return m_buffer; }
+	char* data() { return m_buffer; }
+
+	String toString(Allocator* _allocator = nullptr) const;
+
+//private:
+	void _grow(size_t _minCapacity);
+
+	char* m_buffer = nullptr;
+	size_t m_length = 0;
+	size_t m_capacity = 0; // without the null terminator
+	Allocator* m_allocator = nullptr;
+	bool m_isBufferOwned = false;
+	char m_emptyBuffer[1] = {};
+};
+
+} // namespace yae
+
+#include "StringBuilder.inl"
@@ -0,0 +1,17 @@
+namespace yae {
+
+template <typename... Args>
+StringBuilder& StringBuilder::format(const char* _fmt, const Args&... _args)
+{
+	if constexpr (sizeof...(Args) == 0)
+	{
+		return formatArguments(_fmt, nullptr, 0);
+	}
+	else
+	{
+		const FormatArgument arguments[] = { FormatArgument(_args)... };
+		return formatArguments(_fmt, arguments, u32(sizeof...(Args)));
+	}
+}
+
+} // namespace yae
@@ -82,7 +82,82 @@ u32 StringHash::operator%(u32 _rhs) const
 	return m_hash % _rhs;
 }
 
-StringHash::operator u32() const
+
+
+
+StringHash64::StringHash64()
+	: m_hash(0u)
+#if DEBUG_STRINGHASH
+	, m_string(nullptr)
+#endif
+{
+
+}
+
+StringHash64::StringHash64(const char* _str)
+{
+	m_hash = hash::hashString64(_str);
+
+#if DEBUG_STRINGHASH
+	m_string = g_stringHashRepository.registerStringHash64(m_hash, _str);
+#endif
+}
+
+StringHash64::StringHash64(const String& _str)
+	: StringHash64(_str.c_str())
+{
+}
+
+StringHash64::StringHash64(u64 _hash)
+{
+	m_hash = _hash;
+
+#if DEBUG_STRINGHASH
+	m_string = g_stringHashRepository.getString64(m_hash);
+#endif
+}
+
+bool StringHash64::operator==(const StringHash64& _rhs) const
+{
+	return m_hash == _rhs.m_hash;
+}
+
+bool StringHash64::operator==(u64 _rhs) const
+{
+	return m_hash == _rhs;
+}
+
+bool StringHash64::operator!=(const StringHash64& _rhs) const
+{
+	return m_hash != _rhs.m_hash;
+}
+
+bool StringHash64::operator<(const StringHash64& _rhs) const
+{
+	return m_hash < _rhs.m_hash;
+}
+
+bool StringHash64::operator>(const StringHash64& _rhs) const
+{
+	return m_hash > _rhs.m_hash;
+}
+
+bool StringHash64::operator<=(const StringHash64& _rhs) const
+{
+	return m_hash <= _rhs.m_hash;
+}
+
+bool StringHash64::operator>=(const StringHash64& _rhs) const
+{
+	return m_hash >= _rhs.m_hash;
+}
+
+u64 StringHash64::operator%(u64 _rhs) const
+{
+	return m_hash % _rhs;
+}
+
+StringHash64::operator u64() const
 {
 	return getHash();
 }
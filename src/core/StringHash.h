@@ -2,6 +2,8 @@
 
 #include <core/types.h>
 
+#include <initializer_list>
+
 #ifndef DEBUG_STRINGHASH
 	#ifdef YAE_DEBUG
 		#define DEBUG_STRINGHASH 1
@@ -22,7 +24,10 @@ public:
 	StringHash(const String& _str);
 	StringHash(u32 _hash);
 
-	u32 getHash() const { return m_hash; }
+	// Hashed at compile time when _str is a constant, see the _sh literal
+	static constexpr StringHash FromLiteral(const char* _str, size_t _size);
+
+	constexpr u32 getHash() const { return m_hash; }
 
 	bool operator==(const StringHash& _rhs) const;
 	bool operator==(u32 _rhs) const;
@@ -32,13 +37,82 @@ public:
 	bool operator<=(const StringHash& _rhs) const;
 	bool operator>=(const StringHash& _rhs) const;
 	u32 operator%(u32 _rhs) const;
-	operator u32() const;
+	constexpr operator u32() const { return m_hash; }
 
 private:
+	// @NOTE(remi): no repository registration, the debug string points to the literal
+	constexpr StringHash(u32 _hash, const char* _str)
+		: m_hash(_hash)
+#if DEBUG_STRINGHASH
+		, m_string(_str)
+#endif
+	{
+	}
+
 	u32 m_hash;
 #if DEBUG_STRINGHASH
 	const char*	m_string;
 #endif
 };
 
+constexpr StringHash StringHash::FromLiteral(const char* _str, size_t _size)
+{
+	return StringHash(hash::hash32Constexpr(_str, _size), _str);
+}
+
+// "name"_sh, same hash as StringHash("name") computed by the compiler
+constexpr StringHash operator""_sh(const char* _str, size_t _size)
+{
+	return StringHash::FromLiteral(_str, _size);
+}
+
+namespace string_hash {
+
+// false if two of the hashes are equal
+constexpr bool areUnique(std::initializer_list<u32> _hashes)
+{
+	for (const u32* a = _hashes.begin(); a != _hashes.end(); ++a)
+	{
+		for (const u32* b = a + 1; b != _hashes.end(); ++b)
+		{
+			if (*a == *b)
+				return false;
+		}
+	}
+	return true;
+}
+
+} // namespace string_hash
+
+// Compile time collision check of a set of well known hashes: YAE_CHECK_STRING_HASHES("foo"_sh, "bar"_sh)
+#define YAE_CHECK_STRING_HASHES(...) static_assert(::yae::string_hash::areUnique({ __VA_ARGS__ }), "StringHash collision in " #__VA_ARGS__)
+
+// Same as StringHash with 64 bits, for large sets of strings where 32 bits hashes start to collide
+class CORE_API StringHash64
+{
+public:
+	StringHash64();
+	StringHash64(const char* _str);
+	StringHash64(const String& _str);
+	StringHash64(u64 _hash);
+
+	u64 getHash() const { return m_hash; }
+
+	bool operator==(const StringHash64& _rhs) const;
+	bool operator==(u64 _rhs) const;
+	bool operator!=(const StringHash64& _rhs) const;
+	bool operator< (const StringHash64& _rhs) const;
+	bool operator> (const StringHash64& _rhs) const;
+	bool operator<=(const StringHash64& _rhs) const;
+	bool operator>=(const StringHash64& _rhs) const;
+	u64 operator%(u64 _rhs) const;
+	operator u64() const;
+
+private:
+	u64 m_hash;
+#if DEBUG_STRINGHASH
+	const char*	m_string;
+#endif
+};
+
 } // namespace yae
@@ -7,19 +7,21 @@ namespace yae {
 #if DEBUG_STRINGHASH
 StringHashRepository::StringHashRepository()
 	: m_stringMap(&mallocAllocator())
+	, m_string64Map(&mallocAllocator())
 {
 
 }
 
-const char* StringHashRepository::registerStringHash(u32 _hash, const char* _string)
+template <typename Hash>
+static const char* registerString(HashMap<Hash, char*>& _stringMap, Hash _hash, const char* _string)
 {
-	char** stringPtr = m_stringMap.get(_hash);
+	char** stringPtr = _stringMap.get(_hash);
 	if (stringPtr == nullptr)
 	{
 		size_t stringLength = strlen(_string);
 		char* buffer = (char*)malloc(stringLength + 1);
 		strcpy(buffer, _string);
-		m_stringMap.set(_hash, buffer);
+		_stringMap.set(_hash, buffer);
 		return buffer;
 	}
 	else
@@ -29,9 +31,10 @@ const char* StringHashRepository::registerStringHash(u32 _hash, const char* _str
 	}
 }
 
-const char* StringHashRepository::getString(u32 _hash) const
+template <typename Hash>
+static const char* findString(const HashMap<Hash, char*>& _stringMap, Hash _hash)
 {
-	char* const* stringPtr = m_stringMap.get(_hash);
+	char* const* stringPtr = _stringMap.get(_hash);
 	if (stringPtr != nullptr)
 	{
 		return *stringPtr;
@@ -39,6 +42,26 @@ const char* StringHashRepository::getString(u32 _hash) const
 	return nullptr;
 }
 
+const char* StringHashRepository::registerStringHash(u32 _hash, const char* _string)
+{
+	return registerString(m_stringMap, _hash, _string);
+}
+
+const char* StringHashRepository::getString(u32 _hash) const
+{
+	return findString(m_stringMap, _hash);
+}
+
+const char* StringHashRepository::registerStringHash64(u64 _hash, const char* _string)
+{
+	return registerString(m_string64Map, _hash, _string);
+}
+
+const char* StringHashRepository::getString64(u64 _hash) const
+{
+	return findString(m_string64Map, _hash);
+}
+
 void StringHashRepository::clear()
 {
 	for (auto pair : m_stringMap)
@@ -47,6 +70,13 @@ void StringHashRepository::clear()
 	}
 	m_stringMap.clear();
 	m_stringMap.shrink();
+
+	for (auto pair : m_string64Map)
+	{
+		free(pair.value);
+	}
+	m_string64Map.clear();
+	m_string64Map.shrink();
 }
 
 
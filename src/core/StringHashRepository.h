@@ -17,11 +17,14 @@ public:
 	StringHashRepository();
 	const char* registerStringHash(u32 _hash, const char* _string);
 	const char* getString(u32 _hash) const;
+	const char* registerStringHash64(u64 _hash, const char* _string);
+	const char* getString64(u64 _hash) const;
 
 	void clear();
 
 private:
 	HashMap<u32, char*> m_stringMap;
+	HashMap<u64, char*> m_string64Map;
 };
 
 extern StringHashRepository g_stringHashRepository;
@@ -0,0 +1,244 @@
+#include "StringPool.h"
+
+#include <core/hash.h>
+#include <core/memory.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace yae {
+
+StringPool::StringPool()
+	: m_slots(&mallocAllocator())
+{
+	memset(m_pages, 0, sizeof(m_pages));
+}
+
+
+StringPool::~StringPool()
+{
+	for (u32 i = 0; i < m_pageCount; ++i)
+	{
+		std::free(m_pages[i]);
+		m_pages[i] = nullptr;
+	}
+	m_pageCount = 0;
+}
+
+
+u32 StringPool::intern(const char* _str, u32 _length)
+{
+	if (_length == 0)
+		return 0;
+
+	u32 hash = hash::hash32(_str, _length);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_slots.size() == 0)
+	{
+		m_slots.resize(256, 0);
+	}
+
+	u32 slot = _findSlot(_str, _length, hash);
+	if (m_slots[slot] != 0)
+		return m_slots[slot];
+
+	// Kept at most half full, so probe sequences stay short
+	if ((m_stringCount + 1) * 2 > m_slots.size())
+	{
+		_growSlots();
+		slot = _findSlot(_str, _length, hash);
+	}
+
+	u32 id = _allocateEntry(_str, _length, hash);
+	if (id == 0)
+		return 0;
+
+	m_slots[slot] = id;
+	++m_stringCount;
+	return id;
+}
+
+
+u32 StringPool::find(const char* _str, u32 _length) const
+{
+	if (_length == 0)
+		return 0;
+
+	u32 hash = hash::hash32(_str, _length);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_slots.size() == 0)
+		return 0;
+
+	return m_slots[_findSlot(_str, _length, hash)];
+}
+
+
+const char* StringPool::getString(u32 _id) const
+{
+	if (_id == 0)
+		return "";
+
+	return (const char*)(_getEntry(_id) + 1);
+}
+
+
+u32 StringPool::getLength(u32 _id) const
+{
+	if (_id == 0)
+		return 0;
+
+	return _getEntry(_id)->length;
+}
+
+
+u32 StringPool::getStringCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stringCount;
+}
+
+
+u64 StringPool::getAllocatedSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_allocatedSize;
+}
+
+
+const StringPool::Entry* StringPool::_getEntry(u32 _id) const
+{
+	u32 location = _id - 1;
+	u32 pageIndex = location >> OFFSET_BITS;
+	u32 offset = (location & ((1u << OFFSET_BITS) - 1)) * ENTRY_ALIGNMENT;
+	YAE_ASSERT(pageIndex < MAX_PAGE_COUNT && m_pages[pageIndex] != nullptr);
+	return (const Entry*)(m_pages[pageIndex] + offset);
+}
+
+
+u32 StringPool::_findSlot(const char* _str, u32 _length, u32 _hash) const
+{
+	u32 mask = m_slots.size() - 1;
+	u32 slot = _hash & mask;
+	while (m_slots[slot] != 0)
+	{
+		const Entry* entry = _getEntry(m_slots[slot]);
+		if (entry->hash == _hash && entry->length == _length && memcmp(entry + 1, _str, _length) == 0)
+			return slot;
+
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+
+u32 StringPool::_allocateEntry(const char* _str, u32 _length, u32 _hash)
+{
+	u32 entrySize = (sizeof(Entry) + _length + 1 + ENTRY_ALIGNMENT - 1) & ~(ENTRY_ALIGNMENT - 1);
+
+	u32 pageIndex = m_currentPage;
+	u32 offset = m_currentPageCursor;
+	if (offset + entrySize > PAGE_SIZE)
+	{
+		if (m_pageCount == MAX_PAGE_COUNT)
+		{
+			YAE_ASSERT_MSG(false, "String pool is full");
+			return 0;
+		}
+
+		// @NOTE(remi): a long string does not end the current page, short strings can still be appended to it
+		u32 pageSize = entrySize > PAGE_SIZE ? entrySize : PAGE_SIZE;
+		pageIndex = m_pageCount;
+		offset = 0;
+		m_pages[pageIndex] = (u8*)std::malloc(pageSize);
+		m_allocatedSize += pageSize;
+		++m_pageCount;
+
+		if (pageSize == PAGE_SIZE)
+		{
+			m_currentPage = pageIndex;
+			m_currentPageCursor = 0;
+		}
+	}
+
+	Entry* entry = (Entry*)(m_pages[pageIndex] + offset);
+	entry->hash = _hash;
+	entry->length = _length;
+	char* string = (char*)(entry + 1);
+	memcpy(string, _str, _length);
+	string[_length] = 0;
+
+	if (pageIndex == m_currentPage)
+	{
+		m_currentPageCursor = offset + entrySize;
+	}
+
+	return ((pageIndex << OFFSET_BITS) | (offset / ENTRY_ALIGNMENT)) + 1;
+}
+
+
+void StringPool::_growSlots()
+{
+	DataArray<u32> previousSlots(m_slots, &mallocAllocator());
+	m_slots.clear();
+	m_slots.resize(previousSlots.size() * 2, 0);
+
+	u32 mask = m_slots.size() - 1;
+	for (u32 id : previousSlots)
+	{
+		if (id == 0)
+			continue;
+
+		u32 slot = _getEntry(id)->hash & mask;
+		while (m_slots[slot] != 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_slots[slot] = id;
+	}
+}
+
+
+StringPool& stringPool()
+{
+	// Names may be interned during static initialization
+	static StringPool s_stringPool;
+	return s_stringPool;
+}
+
+
+
+InternedString::InternedString(const char* _str)
+	: m_id(stringPool().intern(_str, u32(strlen(_str))))
+{
+}
+
+
+InternedString::InternedString(const String& _str)
+	: m_id(stringPool().intern(_str.c_str(), u32(_str.size())))
+{
+}
+
+
+InternedString InternedString::Find(const char* _str)
+{
+	InternedString result;
+	result.m_id = stringPool().find(_str, u32(strlen(_str)));
+	return result;
+}
+
+
+const char* InternedString::c_str() const
+{
+	return stringPool().getString(m_id);
+}
+
+
+u32 InternedString::size() const
+{
+	return stringPool().getLength(m_id);
+}
+
+} // namespace yae
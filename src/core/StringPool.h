@@ -0,0 +1,84 @@
+#pragma once
+
+#include <core/types.h>
+#include <core/containers/Array.h>
+
+#include <mutex>
+
+namespace yae {
+
+// Global table storing each interned string once, in pages that are never moved or freed while the program runs.
+// Strings are identified by a 32 bits id, 0 being the empty string. Interning is thread safe, resolving an id is a
+// lock free lookup in the page table.
+class CORE_API StringPool
+{
+public:
+	static const u32 PAGE_SIZE = 64 * 1024; // longer strings get a page of their own
+	static const u32 MAX_PAGE_COUNT = 4096;
+
+	StringPool();
+	~StringPool();
+
+	u32 intern(const char* _str, u32 _length);
+	u32 find(const char* _str, u32 _length) const; // 0 if the string was never interned
+
+	const char* getString(u32 _id) const;
+	u32 getLength(u32 _id) const;
+
+	u32 getStringCount() const;
+	u64 getAllocatedSize() const;
+
+//private:
+	// Stored before the characters of each string, which are null terminated
+	struct Entry
+	{
+		u32 hash;
+		u32 length;
+	};
+
+	static const u32 ENTRY_ALIGNMENT = 4;
+	static const u32 OFFSET_BITS = 14; // PAGE_SIZE / ENTRY_ALIGNMENT
+
+	const Entry* _getEntry(u32 _id) const;
+	u32 _findSlot(const char* _str, u32 _length, u32 _hash) const;
+	u32 _allocateEntry(const char* _str, u32 _length, u32 _hash);
+	void _growSlots();
+
+	u8* m_pages[MAX_PAGE_COUNT];
+	u32 m_pageCount = 0;
+	u32 m_currentPage = 0; // last regular page, strings are appended to it
+	u32 m_currentPageCursor = PAGE_SIZE;
+
+	DataArray<u32> m_slots; // open addressing on the string hashes, 0 for empty slots
+	u32 m_stringCount = 0;
+	u64 m_allocatedSize = 0;
+	mutable std::mutex m_mutex;
+};
+
+CORE_API StringPool& stringPool();
+
+// Name stored in the string pool. Copying and comparing is the same as for an integer.
+class CORE_API InternedString
+{
+public:
+	InternedString() : m_id(0) {}
+	InternedString(const char* _str);
+	InternedString(const String& _str);
+
+	// Does not add the string to the pool, empty if it is not interned yet
+	static InternedString Find(const char* _str);
+
+	const char* c_str() const;
+	u32 size() const;
+	bool isEmpty() const { return m_id == 0; }
+	u32 getID() const { return m_id; }
+
+	bool operator==(const InternedString& _rhs) const { return m_id == _rhs.m_id; }
+	bool operator!=(const InternedString& _rhs) const { return m_id != _rhs.m_id; }
+	explicit operator size_t() const { return m_id; } // HashMap key
+
+private:
+	u32 m_id;
+};
+
+} // namespace yae
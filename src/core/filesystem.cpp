@@ -177,6 +177,27 @@ Date getFileLastWriteTime(const char* _path)
 }
 
 
+bool getFileStatus(const char* _path, u64* _outSize, i64* _outWriteTime)
+{
+#if YAE_PLATFORM_WEB == 0
+	std::error_code errorCode;
+	std::uintmax_t size = std::filesystem::file_size(_path, errorCode);
+	if (errorCode.value() != 0)
+		return false;
+
+	auto writeTime = std::filesystem::last_write_time(_path, errorCode);
+	if (errorCode.value() != 0)
+		return false;
+
+	*_outSize = u64(size);
+	*_outWriteTime = i64(writeTime.time_since_epoch().count());
+	return true;
+#else
+	return false;
+#endif
+}
+
+
 bool copy(const char* _from, const char* _to, CopyMode _mode)
 {
 	using namespace std::filesystem;
@@ -192,7 +213,7 @@ bool copy(const char* _from, const char* _to, CopyMode _mode)
 	std::filesystem::copy(_from, _to, copyOptions, errorCode);
 	if (errorCode.value() != 0)
 	{
-		YAE_ERRORF_CAT("filesystem", "copy %s -> %s failed: %s", _from, _to, errorCode.message().c_str());
+		YAE_ERRORF_CAT(filesystem, "copy %s -> %s failed: %s", _from, _to, errorCode.message().c_str());
 	}
 	return errorCode.value() == 0;
 }
@@ -352,33 +373,33 @@ bool FileHandle::isOpen() const
 	return m_fileHandle != nullptr;
 }
 
-i32 FileHandle::getSize() const
+i64 FileHandle::getSize() const
 {
 	if (m_fileHandle)
 	{
-		i32 offset = std::ftell((std::FILE*)m_fileHandle);
-		std::fseek((std::FILE*)m_fileHandle, 0, SEEK_END);
-		i32 size = ftell((std::FILE*)m_fileHandle);
-		std::fseek((std::FILE*)m_fileHandle, offset, SEEK_SET);
+		i64 offset = getOffset();
+		YAE_FSEEK64((std::FILE*)m_fileHandle, 0, SEEK_END);
+		i64 size = YAE_FTELL64((std::FILE*)m_fileHandle);
+		YAE_FSEEK64((std::FILE*)m_fileHandle, offset, SEEK_SET);
 		return size;
 	}
 	return 0;
 }
 
-i32 FileHandle::getOffset() const
+i64 FileHandle::getOffset() const
 {
 	if (m_fileHandle)
 	{
-		return std::ftell((std::FILE*)m_fileHandle);
+		return YAE_FTELL64((std::FILE*)m_fileHandle);
 	}
 	return 0;
 }
 
-void FileHandle::setOffset(i32 offset)
+void FileHandle::setOffset(i64 offset)
 {
 	if (m_fileHandle)
 	{
-		std::fseek((std::FILE*)m_fileHandle, offset, SEEK_SET);
+		YAE_FSEEK64((std::FILE*)m_fileHandle, offset, SEEK_SET);
 	}
 }
 
@@ -395,7 +416,15 @@ FileReader::FileReader(const char* _path, Allocator* _allocator)
 
 FileReader::~FileReader()
 {
-	allocator().deallocate(m_content);
+	if (m_isMapped)
+	{
+		platform::unmapFile(m_content, m_contentSize, m_mapping);
+		m_mapping = nullptr;
+	}
+	else
+	{
+		allocator().deallocate(m_content);
+	}
 	m_content = nullptr;
 }
 
@@ -413,16 +442,64 @@ bool FileReader::load()
 		return false;
 	}
 
-	m_contentSize = file.getSize();
-	m_content = allocator().allocate(m_contentSize);
-	file.read(m_content, m_contentSize);
+	i64 size = file.getSize();
+	if (size < 0 || u64(size) > u64(SIZE_MAX))
+	{
+		return false;
+	}
+
+	m_contentSize = u64(size);
+	m_content = allocator().allocate(size_t(m_contentSize));
+	file.read(m_content, size_t(m_contentSize));
 	file.close();
 	
 	m_isLoaded = true;
 	return true;
 }
 
-u32 FileReader::getContentSize() const
+bool FileReader::map(bool _prefault)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(!m_isLoaded);
+	YAE_ASSERT(m_content == nullptr);
+
+	u64 size = 0;
+	void* mapping = nullptr;
+	const void* content = platform::mapFile(m_path.c_str(), &size, &mapping);
+	if (content == nullptr)
+	{
+		return load();
+	}
+
+	m_content = const_cast<void*>(content);
+	m_contentSize = size;
+	m_mapping = mapping;
+	m_isMapped = true;
+	m_isLoaded = true;
+
+	if (_prefault)
+	{
+		YAE_CAPTURE_SCOPE("page_faults");
+
+		const u64 PAGE_SIZE = 4096;
+		const volatile u8* bytes = (const volatile u8*)m_content;
+		u8 sum = 0;
+		for (u64 i = 0; i < m_contentSize; i += PAGE_SIZE)
+		{
+			sum += bytes[i];
+		}
+		(void)sum;
+	}
+	return true;
+}
+
+bool FileReader::isMapped() const
+{
+	return m_isMapped;
+}
+
+u64 FileReader::getContentSize() const
 {
 	YAE_ASSERT(m_isLoaded);
 	return m_contentSize;
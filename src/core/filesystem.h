@@ -30,6 +30,8 @@ CORE_API bool doesPathExists(const char* _path);
 CORE_API bool deletePath(const char* _path);
 CORE_API bool createDirectory(const char* _path);
 CORE_API Date getFileLastWriteTime(const char* _path);
+// Size and raw last write time, precise enough to tell successive writes apart. false if the file does not exist.
+CORE_API bool getFileStatus(const char* _path, u64* _outSize, i64* _outWriteTime);
 
 enum CopyMode
 {
@@ -79,9 +81,9 @@ public:
 	size_t read(void* buffer, size_t size) const;
 
 	bool isOpen() const;
-	i32 getSize() const;
-	i32 getOffset() const;
-	void setOffset(i32 offset);
+	i64 getSize() const;
+	i64 getOffset() const;
+	void setOffset(i64 offset);
 	const char* getPath() const;
 
 private:
@@ -96,8 +98,15 @@ public:
 	FileReader(const char* _path, Allocator* _allocator = nullptr);
 	~FileReader();
 
+	// Reads the whole file in memory of the allocator
 	bool load();
-	u32 getContentSize() const;
+	// Maps the file read-only instead of copying it, falls back to load() if the file can't be mapped.
+	// Pages are faulted in on first access. Prefaulting reads every page right away in a profiler scope instead, only
+	// worth it when the whole content is about to be read.
+	bool map(bool _prefault = false);
+	bool isMapped() const;
+
+	u64 getContentSize() const;
 	const void* getContent() const;
 	const char* getPath() const;
 
@@ -106,8 +115,10 @@ public:
 private:
 	String m_path;
 	void* m_content = nullptr;
-	u32 m_contentSize = 0;
+	u64 m_contentSize = 0;
+	void* m_mapping = nullptr;
 	bool m_isLoaded = false;
+	bool m_isMapped = false;
 	Allocator* m_allocator = nullptr;
 };
 
@@ -5,8 +5,95 @@
 namespace yae {
 namespace hash {
 
-#define OFFSET_BASIS	2166136261
-#define FNV_PRIME		16777619
+// wyhash (final version 4)
+// https://github.com/wangyi-fudan/wyhash
+static const u64 WYHASH_SECRET[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+static inline void multiply128(u64* _a, u64* _b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t result = __uint128_t(*_a) * *_b;
+	*_a = u64(result);
+	*_b = u64(result >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	*_a = _umul128(*_a, *_b, _b);
+#else
+	u64 aHigh = *_a >> 32, aLow = u32(*_a), bHigh = *_b >> 32, bLow = u32(*_b);
+	u64 high = aHigh * bHigh, middle0 = aHigh * bLow, middle1 = aLow * bHigh, low = aLow * bLow;
+	u64 t = low + (middle0 << 32);
+	u64 carry = t < low;
+	u64 lo = t + (middle1 << 32);
+	carry += lo < t;
+	*_a = lo;
+	*_b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+#endif
+}
+
+static inline u64 mix(u64 _a, u64 _b)
+{
+	multiply128(&_a, &_b);
+	return _a ^ _b;
+}
+
+static inline u64 read64(const u8* _p) { u64 value; memcpy(&value, _p, sizeof(value)); return value; }
+static inline u64 read32(const u8* _p) { u32 value; memcpy(&value, _p, sizeof(value)); return value; }
+static inline u64 read3(const u8* _p, size_t _size) { return (u64(_p[0]) << 16) | (u64(_p[_size >> 1]) << 8) | _p[_size - 1]; }
+
+u64 hash64(const void* _data, size_t _size, u64 _seed)
+{
+	const u8* p = static_cast<const u8*>(_data);
+	u64 seed = _seed ^ mix(_seed ^ WYHASH_SECRET[0], WYHASH_SECRET[1]);
+	u64 a, b;
+	if (_size <= 16)
+	{
+		if (_size >= 4)
+		{
+			a = (read32(p) << 32) | read32(p + ((_size >> 3) << 2));
+			b = (read32(p + _size - 4) << 32) | read32(p + _size - 4 - ((_size >> 3) << 2));
+		}
+		else if (_size > 0)
+		{
+			a = read3(p, _size);
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
+	}
+	else
+	{
+		size_t i = _size;
+		if (i > 48)
+		{
+			u64 seed1 = seed, seed2 = seed;
+			do
+			{
+				seed = mix(read64(p) ^ WYHASH_SECRET[1], read64(p + 8) ^ seed);
+				seed1 = mix(read64(p + 16) ^ WYHASH_SECRET[2], read64(p + 24) ^ seed1);
+				seed2 = mix(read64(p + 32) ^ WYHASH_SECRET[3], read64(p + 40) ^ seed2);
+				p += 48;
+				i -= 48;
+			}
+			while (i > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (i > 16)
+		{
+			seed = mix(read64(p) ^ WYHASH_SECRET[1], read64(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = read64(p + i - 16);
+		b = read64(p + i - 8);
+	}
+
+	a ^= WYHASH_SECRET[1];
+	b ^= seed;
+	multiply128(&a, &b);
+	return mix(a ^ WYHASH_SECRET[0] ^ _size, b ^ WYHASH_SECRET[1]);
+}
+
 
 u32 hash32(const void* _data, size_t _size)
 {
@@ -15,17 +102,8 @@ u32 hash32(const void* _data, size_t _size)
 		return 0;
 	}
 
-	// FNV-1a algorithm
-	// http://isthe.com/chongo/tech/comp/fnv/
-	u32 hash = OFFSET_BASIS;
-	const u8* buf = static_cast<const u8*>(_data);
-	for (u32 i = 0u; i < _size; i++)
-	{
-		hash = hash * FNV_PRIME;
-		hash = hash ^ *buf;
-		++buf;
-	}
-	return hash;
+	u64 hash = hash64(_data, _size);
+	return u32(hash ^ (hash >> 32));
 }
 
 
@@ -34,5 +112,11 @@ u32 hashString(const char* _str)
 	return hash32(_str, strlen(_str));
 }
 
+
+u64 hashString64(const char* _str)
+{
+	return hash64(_str, strlen(_str));
+}
+
 } // namespace hash
 } // namespace yae
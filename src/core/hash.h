@@ -5,12 +5,18 @@
 namespace yae {
 namespace hash {
 
+// wyhash, reading 8 bytes at a time. hash32 folds the 64 bits result, empty data hashes to 0.
 CORE_API u32 hash32(const void* _data, size_t _size);
 CORE_API u32 hashString(const char* _str);
 
+CORE_API u64 hash64(const void* _data, size_t _size, u64 _seed = 0);
+CORE_API u64 hashString64(const char* _str);
+
 template <typename T>
 u32 hash32(const T& _data);
 
+// Compile time versions: see core/hash_constexpr.h
+
 } // namespace hash
 } // namespace yae
 
@@ -0,0 +1,114 @@
+#pragma once
+
+// Same results as hash32/hash64/hashString from core/hash.h, usable in constant expressions. Slower at runtime.
+// Included by core/types.h, before StringHash and the log categories which use it.
+
+namespace yae {
+namespace hash {
+
+// @NOTE(remi): mirror of the wyhash implementation in hash.cpp, with little endian reads done byte by byte since
+// memcpy is not allowed in constant expressions. Both must be changed together.
+constexpr u64 _constexprSecret(u32 _index)
+{
+	return _index == 0 ? 0x2d358dccaa6c78a5ull : _index == 1 ? 0x8bb84b93962eacc9ull : _index == 2 ? 0x4b33a62ed433d4a3ull : 0x4d5a2da51de1aa47ull;
+}
+
+constexpr void _constexprMultiply128(u64& _a, u64& _b)
+{
+	u64 aHigh = _a >> 32, aLow = u32(_a), bHigh = _b >> 32, bLow = u32(_b);
+	u64 high = aHigh * bHigh, middle0 = aHigh * bLow, middle1 = aLow * bHigh, low = aLow * bLow;
+	u64 t = low + (middle0 << 32);
+	u64 carry = t < low;
+	u64 lo = t + (middle1 << 32);
+	carry += lo < t;
+	_a = lo;
+	_b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+}
+
+constexpr u64 _constexprMix(u64 _a, u64 _b)
+{
+	_constexprMultiply128(_a, _b);
+	return _a ^ _b;
+}
+
+constexpr u64 _constexprRead(const char* _p, u32 _byteCount)
+{
+	u64 value = 0;
+	for (u32 i = 0; i < _byteCount; ++i)
+	{
+		value |= u64(u8(_p[i])) << (i * 8);
+	}
+	return value;
+}
+
+constexpr u64 hash64Constexpr(const char* _data, size_t _size, u64 _seed = 0)
+{
+	const char* p = _data;
+	u64 seed = _seed ^ _constexprMix(_seed ^ _constexprSecret(0), _constexprSecret(1));
+	u64 a = 0, b = 0;
+	if (_size <= 16)
+	{
+		if (_size >= 4)
+		{
+			a = (_constexprRead(p, 4) << 32) | _constexprRead(p + ((_size >> 3) << 2), 4);
+			b = (_constexprRead(p + _size - 4, 4) << 32) | _constexprRead(p + _size - 4 - ((_size >> 3) << 2), 4);
+		}
+		else if (_size > 0)
+		{
+			a = (u64(u8(p[0])) << 16) | (u64(u8(p[_size >> 1])) << 8) | u64(u8(p[_size - 1]));
+		}
+	}
+	else
+	{
+		size_t i = _size;
+		if (i > 48)
+		{
+			u64 seed1 = seed, seed2 = seed;
+			do
+			{
+				seed = _constexprMix(_constexprRead(p, 8) ^ _constexprSecret(1), _constexprRead(p + 8, 8) ^ seed);
+				seed1 = _constexprMix(_constexprRead(p + 16, 8) ^ _constexprSecret(2), _constexprRead(p + 24, 8) ^ seed1);
+				seed2 = _constexprMix(_constexprRead(p + 32, 8) ^ _constexprSecret(3), _constexprRead(p + 40, 8) ^ seed2);
+				p += 48;
+				i -= 48;
+			}
+			while (i > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (i > 16)
+		{
+			seed = _constexprMix(_constexprRead(p, 8) ^ _constexprSecret(1), _constexprRead(p + 8, 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = _constexprRead(p + i - 16, 8);
+		b = _constexprRead(p + i - 8, 8);
+	}
+
+	a ^= _constexprSecret(1);
+	b ^= seed;
+	_constexprMultiply128(a, b);
+	return _constexprMix(a ^ _constexprSecret(0) ^ _size, b ^ _constexprSecret(1));
+}
+
+constexpr u32 hash32Constexpr(const char* _data, size_t _size)
+{
+	if (_size == 0)
+		return 0;
+
+	u64 hash = hash64Constexpr(_data, _size);
+	return u32(hash ^ (hash >> 32));
+}
+
+constexpr u32 hashStringConstexpr(const char* _str)
+{
+	size_t size = 0;
+	while (_str[size] != 0)
+	{
+		++size;
+	}
+	return hash32Constexpr(_str, size);
+}
+
+} // namespace hash
+} // namespace yae
@@ -1,78 +1,315 @@
 #include "logger.h"
 
 #include <core/Program.h>
-#include <core/filesystem.h>
 #include <core/serialization/serialization.h>
 
+#include <chrono>
+#include <cstdio>
+#include <new>
 
 namespace yae {
 
-const char* DEFAULT_CATEGORY_NAME = "Default";
+// Room for the messages written by the log thread until the main thread dispatches them
+const u32 LOGGED_QUEUE_SIZE = 256 * 1024;
+const u32 FORMAT_BUFFER_SIZE = 512;
+const u32 THREAD_WAKE_PERIOD_MS = 5;
+const u32 THREAD_QUEUE_SLOT_COUNT = 4;
+
+const u32 RECORD_PREFIX_SIZE = 8;
+const u32 RECORD_PADDING = ~0u;
+
+static std::atomic<u32> s_nextLoggerId(1);
+
+// Queues of the calling thread, one per logger it logs to
+struct ThreadQueues
+{
+	struct Slot
+	{
+		u32 loggerId = 0;
+		LogQueue* queue = nullptr;
+	};
+	Slot slots[THREAD_QUEUE_SLOT_COUNT];
+	u32 nextSlot = 0;
+
+	// Message between beginMessage and endMessage
+	LogQueue* pendingQueue = nullptr;
+	LogVerbosity pendingVerbosity = LogVerbosity::NONE;
+};
+static thread_local ThreadQueues s_threadQueues;
+
+static u32 alignRecordSize(u32 _size)
+{
+	return (_size + 7) & ~7u;
+}
+
+static const char* findFileName(const char* _fileInfo)
+{
+	const char* fileName = _fileInfo;
+	for (const char* c = _fileInfo; *c != 0; ++c)
+	{
+		if (*c == '/' || *c == '\\')
+		{
+			fileName = c + 1;
+		}
+	}
+	return fileName;
+}
+
+LogQueue::LogQueue(u32 _capacity)
+	: m_capacity(_capacity)
+	, m_writeCursor(0)
+	, m_readCursor(0)
+{
+	YAE_ASSERT(_capacity >= 64 && (_capacity & (_capacity - 1)) == 0);
+	m_data = (u8*)malloc(_capacity);
+}
+
+LogQueue::~LogQueue()
+{
+	free(m_data);
+}
+
+u8* LogQueue::beginWrite(u32 _size)
+{
+	YAE_ASSERT(m_pendingWriteSize == 0);
+
+	u32 recordSize = RECORD_PREFIX_SIZE + alignRecordSize(_size);
+	if (recordSize > getMaxRecordSize() + RECORD_PREFIX_SIZE)
+		return nullptr;
+
+	// Cursors are never wrapped, the capacity is a power of two so their difference stays valid when they overflow
+	u32 writeCursor = m_writeCursor.load(std::memory_order_relaxed);
+	u32 readCursor = m_readCursor.load(std::memory_order_acquire);
+	u32 freeSize = m_capacity - (writeCursor - readCursor);
+	u32 offset = writeCursor & (m_capacity - 1);
+	u32 contiguousSize = m_capacity - offset;
+
+	// Records never wrap, the end of the buffer is skipped instead
+	u32 paddingSize = recordSize > contiguousSize ? contiguousSize : 0;
+	if (paddingSize + recordSize > freeSize)
+		return nullptr;
+
+	if (paddingSize != 0)
+	{
+		memcpy(m_data + offset, &RECORD_PADDING, sizeof(RECORD_PADDING));
+		offset = 0;
+	}
+	memcpy(m_data + offset, &_size, sizeof(_size));
+	m_pendingWriteSize = paddingSize + recordSize;
+	return m_data + offset + RECORD_PREFIX_SIZE;
+}
+
+void LogQueue::endWrite()
+{
+	YAE_ASSERT(m_pendingWriteSize != 0);
+	m_writeCursor.store(m_writeCursor.load(std::memory_order_relaxed) + m_pendingWriteSize, std::memory_order_release);
+	m_pendingWriteSize = 0;
+}
+
+const u8* LogQueue::beginRead(u32* _outSize)
+{
+	u32 readCursor = m_readCursor.load(std::memory_order_relaxed);
+	u32 writeCursor = m_writeCursor.load(std::memory_order_acquire);
+	if (readCursor == writeCursor)
+		return nullptr;
+
+	u32 offset = readCursor & (m_capacity - 1);
+	u32 paddingSize = 0;
+	u32 size;
+	memcpy(&size, m_data + offset, sizeof(size));
+	if (size == RECORD_PADDING)
+	{
+		// Padding is published along with the record that follows it
+		paddingSize = m_capacity - offset;
+		offset = 0;
+		memcpy(&size, m_data, sizeof(size));
+	}
+
+	m_pendingReadSize = paddingSize + RECORD_PREFIX_SIZE + alignRecordSize(size);
+	if (_outSize != nullptr)
+	{
+		*_outSize = size;
+	}
+	return m_data + offset + RECORD_PREFIX_SIZE;
+}
+
+void LogQueue::endRead()
+{
+	YAE_ASSERT(m_pendingReadSize != 0);
+	m_readCursor.store(m_readCursor.load(std::memory_order_relaxed) + m_pendingReadSize, std::memory_order_release);
+	m_pendingReadSize = 0;
+}
+
+bool LogQueue::isEmpty() const
+{
+	return m_readCursor.load(std::memory_order_acquire) == m_writeCursor.load(std::memory_order_acquire);
+}
+
+u32 LogQueue::getMaxRecordSize() const
+{
+	return m_capacity / 4 - RECORD_PREFIX_SIZE;
+}
 
 Logger::Logger()
 	: m_categories(&toolAllocator())
+	, m_queueCount(0)
+	, m_nextSequence(0)
+	, m_processedCount(0)
+	, m_loggedQueue(LOGGED_QUEUE_SIZE)
+	, m_droppedLoggedCount(0)
 {
+	m_instanceId = s_nextLoggerId.fetch_add(1);
+	m_mainThreadId = std::this_thread::get_id();
+
+	updateCategories();
+
+#if YAE_LOG_ASYNC
+	m_thread = defaultAllocator().create<std::thread>(&Logger::_threadMain, this);
+#endif
 }
 
 
 Logger::~Logger()
 {
+	flush();
+
+#if YAE_LOG_ASYNC
+	{
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		m_stopRequested = true;
+	}
+	m_wakeCondition.notify_one();
+	m_thread->join();
+	defaultAllocator().destroy(m_thread);
+	m_thread = nullptr;
+#endif
+
+	setOutputFile(nullptr);
+
+	u32 queueCount = m_queueCount.load();
+	for (u32 i = 0; i < queueCount; ++i)
+	{
+		m_queues[i]->~LogQueue();
+		free(m_queues[i]);
+		m_queues[i] = nullptr;
+	}
 }
 
-void Logger::log(const char* _categoryName, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _msg)
+void Logger::log(const LogCategory& _category, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _msg)
 {
-	Logger::LogCategory& category = findOrAddCategory(_categoryName);
+	if (_category.verbosity < _verbosity)
+		return;
 
-	OutputColor outputColor = getDefaultOutputColor();
-	switch(_verbosity)
+	LogQueue* queue = _getThreadQueue();
+	if (queue == nullptr)
 	{
-		case LogVerbosity::ERROR: outputColor = OutputColor_Red; break;
-		case LogVerbosity::WARNING: outputColor = OutputColor_Yellow; break;
-		case LogVerbosity::VERBOSE: outputColor = OutputColor_Grey; break;
-		default: break;
+		// No queue left for this thread, written right away. It takes no sequence, so it is not ordered with the queued messages.
+		MessageHeader header = {};
+		header.fileInfo = _fileInfo;
+		header.categoryName = _category.name;
+		header.verbosity = _verbosity;
+		header.outputColor = u8(getDefaultOutputColor());
+		std::lock_guard<std::mutex> lock(m_processMutex);
+		_writeMessage(header, _msg);
+		return;
 	}
 
-	if (category.verbosity >= _verbosity)
+	// Truncated if too big for the queue
+	u32 maxMessageSize = queue->getMaxRecordSize() - u32(sizeof(MessageHeader));
+	u32 messageSize = u32(strlen(_msg)) + 1;
+	messageSize = messageSize < maxMessageSize ? messageSize : maxMessageSize;
+
+	u8* message = _beginMessage(_category, _verbosity, _fileInfo, nullptr, nullptr, messageSize);
+	YAE_ASSERT(message != nullptr);
+	memcpy(message, _msg, messageSize - 1);
+	message[messageSize - 1] = 0;
+	_endMessage();
+}
+
+void Logger::flush()
+{
+	YAE_CAPTURE_FUNCTION();
+
+	// Messages being written by other threads are waited for
+	u64 sequence = m_nextSequence.load(std::memory_order_acquire);
+	while (true)
 	{
-		String128 fileName = filesystem::getFileName(_fileInfo);
+		_processMessages();
+		if (m_processedCount.load(std::memory_order_acquire) >= sequence)
+			break;
 
-		platform::setOutputColor(outputColor);
-		printf("[%s][%s] %s\n", category.name.c_str(), fileName.c_str(), _msg);
-		platform::setOutputColor(OutputColor_Default);
+		std::this_thread::yield();
 	}
 
-	logged.dispatch(category.name.c_str(), _verbosity, _fileInfo, _msg);
+	if (std::this_thread::get_id() == m_mainThreadId)
+	{
+		dispatchLogged();
+	}
 }
 
-void Logger::setCategoryVerbosity(const char* _categoryName, LogVerbosity _verbosity)
+void Logger::dispatchLogged()
 {
-	LogCategory& category = findOrAddCategory(_categoryName);
-	category.verbosity = _verbosity;
-}
+	YAE_ASSERT_MSG(std::this_thread::get_id() == m_mainThreadId, "Logged messages must be dispatched from the main thread");
 
+	u32 droppedCount = m_droppedLoggedCount.exchange(0);
+	if (droppedCount != 0)
+	{
+		logging::log(*this, log_category::Default, LogVerbosity::WARNING, __FILE_AND_LINE__, "%u log messages were not dispatched, the logged queue was full", droppedCount);
+	}
 
-Logger::LogCategory& Logger::findOrAddCategory(const char* _categoryName)
-{
-	if (_categoryName == nullptr)
+	while (true)
 	{
-		_categoryName = DEFAULT_CATEGORY_NAME;
+		const u8* record = m_loggedQueue.beginRead();
+		if (record == nullptr)
+			break;
+
+		LogVerbosity verbosity;
+		memcpy(&verbosity, record, sizeof(verbosity));
+		const char* categoryName = (const char*)record + sizeof(verbosity);
+		const char* fileInfo = categoryName + strlen(categoryName) + 1;
+		const char* message = fileInfo + strlen(fileInfo) + 1;
+		logged.dispatch(categoryName, verbosity, fileInfo, message);
+
+		m_loggedQueue.endRead();
 	}
+}
+
+void Logger::setCategoryVerbosity(const char* _categoryName, LogVerbosity _verbosity)
+{
+	CategorySettings& settings = _findOrAddCategorySettings(_categoryName);
+	settings.verbosity = _verbosity;
 
 	StringHash hash = _categoryName;
-	LogCategory* categoryPtr = m_categories.get(hash);
-	if (categoryPtr == nullptr)
+	for (LogCategory* category = logging::getFirstCategory(); category != nullptr; category = category->next)
 	{
-		LogCategory category;
-		category.name = _categoryName;
-		category.verbosity = LogVerbosity::LOG;
-		categoryPtr = &m_categories.set(hash, category);
+		if (category->hash == hash.getHash())
+		{
+			category->verbosity = _verbosity;
+		}
 	}
-	return *categoryPtr;
 }
 
-LogVerbosity Logger::getCategoryVerbosity(const char* _categoryName)
+LogVerbosity Logger::getCategoryVerbosity(const char* _categoryName) const
 {
-	return findOrAddCategory(_categoryName).verbosity;
+	const CategorySettings* settings = m_categories.get(StringHash(_categoryName));
+	return settings != nullptr ? settings->verbosity : LogVerbosity::LOG;
+}
+
+void Logger::updateCategories()
+{
+	for (LogCategory* category = logging::getFirstCategory(); category != nullptr; category = category->next)
+	{
+		const CategorySettings* settings = m_categories.get(StringHash(category->hash));
+		if (settings != nullptr)
+		{
+			category->verbosity = settings->verbosity;
+		}
+		else
+		{
+			CategorySettings& newSettings = _findOrAddCategorySettings(category->name);
+			newSettings.verbosity = category->verbosity;
+		}
+	}
 }
 
 void Logger::setDefaultOutputColor(OutputColor _color)
@@ -85,14 +322,40 @@ OutputColor Logger::getDefaultOutputColor() const
 	return m_defaultOutputColor;
 }
 
-const HashMap<StringHash, Logger::LogCategory>& Logger::getCategories() const
+void Logger::setStandardOutputEnabled(bool _enabled)
+{
+	std::lock_guard<std::mutex> lock(m_processMutex);
+	m_isStandardOutputEnabled = _enabled;
+}
+
+bool Logger::isStandardOutputEnabled() const
+{
+	return m_isStandardOutputEnabled;
+}
+
+void Logger::setOutputFile(const char* _path)
+{
+	std::lock_guard<std::mutex> lock(m_processMutex);
+	if (m_outputFile != nullptr)
+	{
+		fclose((FILE*)m_outputFile);
+		m_outputFile = nullptr;
+	}
+
+	if (_path != nullptr)
+	{
+		m_outputFile = fopen(_path, "w");
+	}
+}
+
+const HashMap<StringHash, Logger::CategorySettings>& Logger::getCategories() const
 {
 	return m_categories;
 }
 
 bool Logger::serialize(Serializer& _serializer)
 {
-	Array<LogCategory> categories(&scratchAllocator());
+	Array<CategorySettings> categories(&scratchAllocator());
 	if (_serializer.isWriting())
 	{
 		for(auto pair : m_categories)
@@ -110,9 +373,11 @@ bool Logger::serialize(Serializer& _serializer)
 		{
 			if (_serializer.beginSerializeObject())
 			{
-				LogCategory& category = categories[i];
-				if (!_serializer.serialize(category.name, "name"))
+				CategorySettings& category = categories[i];
+				String name(category.name.c_str(), &scratchAllocator());
+				if (!_serializer.serialize(name, "name"))
 					continue;
+				category.name = name;
 
 				if (!serialization::serializeMirrorType(_serializer, category.verbosity, "verbosity"))
 					continue;
@@ -126,7 +391,7 @@ bool Logger::serialize(Serializer& _serializer)
 
 	if (_serializer.isReading())
 	{
-		for (LogCategory& logCategory : categories)
+		for (CategorySettings& logCategory : categories)
 		{
 			setCategoryVerbosity(logCategory.name.c_str(), logCategory.verbosity);
 		}
@@ -135,5 +400,276 @@ bool Logger::serialize(Serializer& _serializer)
 	return true;
 }
 
+Logger::CategorySettings& Logger::_findOrAddCategorySettings(const char* _categoryName)
+{
+	StringHash hash = _categoryName;
+	CategorySettings* settingsPtr = m_categories.get(hash);
+	if (settingsPtr == nullptr)
+	{
+		CategorySettings settings;
+		settings.name = _categoryName;
+		settings.verbosity = LogVerbosity::LOG;
+		settingsPtr = &m_categories.set(hash, settings);
+	}
+	return *settingsPtr;
+}
+
+LogQueue* Logger::_getThreadQueue()
+{
+	for (const ThreadQueues::Slot& slot : s_threadQueues.slots)
+	{
+		if (slot.loggerId == m_instanceId)
+			return slot.queue;
+	}
+
+	// Queues are registered once per thread and never released before the logger is destroyed
+	LogQueue* queue = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_queuesMutex);
+		u32 queueCount = m_queueCount.load(std::memory_order_relaxed);
+		if (queueCount == YAE_LOG_MAX_THREADS)
+			return nullptr;
+
+		// Not allocated from the engine allocators, they are not thread safe
+		queue = new (malloc(sizeof(LogQueue))) LogQueue(YAE_LOG_QUEUE_SIZE);
+		m_queues[queueCount] = queue;
+		m_queueCount.store(queueCount + 1, std::memory_order_release);
+	}
+
+	ThreadQueues::Slot& slot = s_threadQueues.slots[s_threadQueues.nextSlot];
+	s_threadQueues.nextSlot = (s_threadQueues.nextSlot + 1) % THREAD_QUEUE_SLOT_COUNT;
+	slot.loggerId = m_instanceId;
+	slot.queue = queue;
+	return queue;
+}
+
+u8* Logger::_beginMessage(const LogCategory& _category, LogVerbosity _verbosity, const char* _fileInfo, const char* _fmt, logging::FormatFunction _formatFunction, u32 _argumentsSize)
+{
+	YAE_ASSERT(s_threadQueues.pendingQueue == nullptr);
+
+	LogQueue* queue = _getThreadQueue();
+	if (queue == nullptr)
+		return nullptr;
+
+	u32 recordSize = u32(sizeof(MessageHeader)) + _argumentsSize;
+	if (recordSize > queue->getMaxRecordSize())
+		return nullptr;
+
+	u8* record = queue->beginWrite(recordSize);
+	while (record == nullptr)
+	{
+		// Full, waits for the log thread to catch up
+#if YAE_LOG_ASYNC
+		_wakeThread();
+		std::this_thread::yield();
+#else
+		_processMessages();
+#endif
+		record = queue->beginWrite(recordSize);
+	}
+
+	OutputColor outputColor = getDefaultOutputColor();
+	switch(_verbosity)
+	{
+		case LogVerbosity::ERROR: outputColor = OutputColor_Red; break;
+		case LogVerbosity::WARNING: outputColor = OutputColor_Yellow; break;
+		case LogVerbosity::VERBOSE: outputColor = OutputColor_Grey; break;
+		default: break;
+	}
+
+	MessageHeader header;
+	header.sequence = m_nextSequence.fetch_add(1, std::memory_order_acq_rel);
+	header.format = _fmt;
+	header.formatFunction = _formatFunction;
+	header.fileInfo = _fileInfo;
+	header.categoryName = _category.name;
+	header.verbosity = _verbosity;
+	header.outputColor = u8(outputColor);
+	header.argumentsSize = _argumentsSize;
+	memcpy(record, &header, sizeof(header));
+
+	s_threadQueues.pendingQueue = queue;
+	s_threadQueues.pendingVerbosity = _verbosity;
+	return record + sizeof(header);
+}
+
+void Logger::_endMessage()
+{
+	YAE_ASSERT(s_threadQueues.pendingQueue != nullptr);
+	s_threadQueues.pendingQueue->endWrite();
+	s_threadQueues.pendingQueue = nullptr;
+
+#if YAE_LOG_ASYNC
+	// Errors are written before returning, in case they are followed by a crash
+	if (s_threadQueues.pendingVerbosity == LogVerbosity::ERROR)
+	{
+		flush();
+	}
+#else
+	_processMessages();
+	if (std::this_thread::get_id() == m_mainThreadId)
+	{
+		dispatchLogged();
+	}
+#endif
+}
+
+void Logger::_wakeThread()
+{
+#if YAE_LOG_ASYNC
+	{
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		m_wakeRequested = true;
+	}
+	m_wakeCondition.notify_one();
+#endif
+}
+
+void Logger::_threadMain()
+{
+#if YAE_LOG_ASYNC
+	while (true)
+	{
+		bool stop;
+		{
+			std::unique_lock<std::mutex> lock(m_threadMutex);
+			m_wakeCondition.wait_for(lock, std::chrono::milliseconds(THREAD_WAKE_PERIOD_MS), [this]() { return m_wakeRequested || m_stopRequested; });
+			m_wakeRequested = false;
+			stop = m_stopRequested;
+		}
+
+		// A message is still being written by its thread, it is about to be published
+		while (_processMessages() && !stop)
+		{
+			std::this_thread::yield();
+		}
+
+		if (stop)
+			break;
+	}
+#endif
+}
+
+bool Logger::_processMessages()
+{
+	std::lock_guard<std::mutex> lock(m_processMutex);
+
+	char formatBuffer[FORMAT_BUFFER_SIZE];
+	u32 processedCount = 0;
+	bool isWaitingForMessage = false;
+	while (true)
+	{
+		// Oldest message first, so that the messages of different threads stay in order
+		u32 queueCount = m_queueCount.load(std::memory_order_acquire);
+		LogQueue* oldestQueue = nullptr;
+		MessageHeader oldestHeader;
+		for (u32 i = 0; i < queueCount; ++i)
+		{
+			const u8* record = m_queues[i]->beginRead();
+			if (record == nullptr)
+				continue;
+
+			MessageHeader header;
+			memcpy(&header, record, sizeof(header));
+			if (oldestQueue == nullptr || header.sequence < oldestHeader.sequence)
+			{
+				oldestQueue = m_queues[i];
+				oldestHeader = header;
+			}
+		}
+		if (oldestQueue == nullptr)
+			break;
+
+		// Each queue holds increasing sequences, so the next message to write is at the head of one of them. If it is
+		// not there yet, its thread took its sequence but has not published it: writing the oldest one would reorder them.
+		if (oldestHeader.sequence != m_nextWrittenSequence)
+		{
+			YAE_ASSERT(oldestHeader.sequence > m_nextWrittenSequence);
+			isWaitingForMessage = true;
+			break;
+		}
+
+		const u8* record = oldestQueue->beginRead();
+		const u8* arguments = record + sizeof(MessageHeader);
+
+		if (oldestHeader.format == nullptr)
+		{
+			_writeMessage(oldestHeader, (const char*)arguments);
+		}
+		else
+		{
+			int messageSize = oldestHeader.formatFunction(formatBuffer, sizeof(formatBuffer), oldestHeader.format, arguments);
+			if (messageSize < 0)
+			{
+				_writeMessage(oldestHeader, oldestHeader.format);
+			}
+			else if (u32(messageSize) < sizeof(formatBuffer))
+			{
+				_writeMessage(oldestHeader, formatBuffer);
+			}
+			else
+			{
+				char* message = (char*)malloc(messageSize + 1);
+				oldestHeader.formatFunction(message, messageSize + 1, oldestHeader.format, arguments);
+				_writeMessage(oldestHeader, message);
+				free(message);
+			}
+		}
+
+		oldestQueue->endRead();
+		++m_nextWrittenSequence;
+		m_processedCount.fetch_add(1, std::memory_order_release);
+		++processedCount;
+	}
+
+	if (processedCount != 0 && m_outputFile != nullptr)
+	{
+		fflush((FILE*)m_outputFile);
+	}
+	return isWaitingForMessage;
+}
+
+void Logger::_writeMessage(const MessageHeader& _header, const char* _message)
+{
+	const char* categoryName = _header.categoryName;
+	const char* fileName = findFileName(_header.fileInfo);
+
+	if (m_isStandardOutputEnabled)
+	{
+		platform::setOutputColor(OutputColor(_header.outputColor));
+		printf("[%s][%s] %s\n", categoryName, fileName, _message);
+		platform::setOutputColor(OutputColor_Default);
+	}
+
+	if (m_outputFile != nullptr)
+	{
+		fprintf((FILE*)m_outputFile, "[%s][%s] %s\n", categoryName, fileName, _message);
+	}
+
+	// Strings are copied, the file info may belong to a module that gets unloaded before the dispatch
+	u32 categoryNameSize = u32(strlen(categoryName)) + 1;
+	u32 fileInfoSize = u32(strlen(_header.fileInfo)) + 1;
+	u32 messageSize = u32(strlen(_message)) + 1;
+	u32 maxMessageSize = m_loggedQueue.getMaxRecordSize() - u32(sizeof(LogVerbosity)) - categoryNameSize - fileInfoSize;
+	messageSize = messageSize < maxMessageSize ? messageSize : maxMessageSize;
+
+	u8* record = m_loggedQueue.beginWrite(u32(sizeof(LogVerbosity)) + categoryNameSize + fileInfoSize + messageSize);
+	if (record == nullptr)
+	{
+		// The log thread never waits for the main thread
+		m_droppedLoggedCount.fetch_add(1);
+		return;
+	}
+
+	memcpy(record, &_header.verbosity, sizeof(LogVerbosity));
+	record += sizeof(LogVerbosity);
+	memcpy(record, categoryName, categoryNameSize);
+	record += categoryNameSize;
+	memcpy(record, _header.fileInfo, fileInfoSize);
+	record += fileInfoSize;
+	memcpy(record, _message, messageSize - 1);
+	record[messageSize - 1] = 0;
+	m_loggedQueue.endWrite();
+}
 
 } // namespace yae
@@ -2,34 +2,92 @@
 
 #include <core/types.h>
 #include <core/containers/HashMap.h>
+#include <core/StringPool.h>
 #include <core/Event.h>
 
 #include <core/platform.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define YAE_LOG_ASYNC (YAE_PLATFORM_WEB == 0)
+
+// Per thread queue size, messages bigger than a quarter of it are formatted by the calling thread
+#define YAE_LOG_QUEUE_SIZE (64 * 1024)
+#define YAE_LOG_MAX_THREADS 64
+
 namespace yae {
 
+// Lock-free single producer, single consumer queue of variable size records
+class CORE_API LogQueue
+{
+public:
+	LogQueue(u32 _capacity); // power of two
+	~LogQueue();
+
+	// nullptr if there is not enough room, the record is published by endWrite
+	u8* beginWrite(u32 _size);
+	void endWrite();
+
+	// nullptr if the queue is empty, the record is released by endRead
+	const u8* beginRead(u32* _outSize = nullptr);
+	void endRead();
+
+	bool isEmpty() const;
+	u32 getMaxRecordSize() const;
+
+//private:
+	u8* m_data = nullptr;
+	u32 m_capacity = 0;
+	std::atomic<u32> m_writeCursor;
+	std::atomic<u32> m_readCursor;
+	u32 m_pendingWriteSize = 0; // producer side
+	u32 m_pendingReadSize = 0; // consumer side
+};
+
+// Messages are queued by the logging threads and formatted on a background thread, which writes them to the
+// standard output and the output file. The logged event is fired on the main thread, from dispatchLogged().
+// Messages are written in the order of their log calls, across threads. Only the threads beyond YAE_LOG_MAX_THREADS,
+// which have no queue, write their messages right away and out of that order.
+// Without threads (web), messages are processed as soon as they are logged.
 class CORE_API Logger
 {
 public:
-	struct LogCategory
+	// Saved verbosity of a category, kept when the category is not registered
+	struct CategorySettings
 	{
-		String128 name;
+		InternedString name;
 		LogVerbosity verbosity;
 	};
 
 	Logger();
 	~Logger();
 
-	void log(const char* _categoryName, LogVerbosity _verbosity, const char* _fileInfo, const char* _msg);
+	void log(const LogCategory& _category, LogVerbosity _verbosity, const char* _fileInfo, const char* _msg);
 
+	// Blocks until every message logged so far is written, then dispatches them if called from the main thread
+	void flush();
+	// Fires the logged event for the messages written since the last call, main thread only
+	void dispatchLogged();
+
+	// Category verbosities are shared by every logger
 	void setCategoryVerbosity(const char* _categoryName, LogVerbosity _verbosity);
-	LogCategory& findOrAddCategory(const char* _categoryName);
-	LogVerbosity getCategoryVerbosity(const char* _categoryName);
+	LogVerbosity getCategoryVerbosity(const char* _categoryName) const;
+	// Applies the settings to the categories registered since the last call, after a module is loaded
+	void updateCategories();
 
 	void setDefaultOutputColor(OutputColor _color);
 	OutputColor getDefaultOutputColor() const;
 
-	const HashMap<StringHash, LogCategory>& getCategories() const;
+	void setStandardOutputEnabled(bool _enabled);
+	bool isStandardOutputEnabled() const;
+
+	// The file is overwritten, nullptr closes it
+	void setOutputFile(const char* _path);
+
+	const HashMap<StringHash, CategorySettings>& getCategories() const;
 
 	bool serialize(Serializer& _serializer);
 
@@ -37,8 +95,56 @@ public:
 	Event<const char*, LogVerbosity, const char*, const char*> logged;
 
 // private:
-	HashMap<StringHash, LogCategory> m_categories;
+	struct MessageHeader
+	{
+		u64 sequence;
+		const char* format; // nullptr when the message is already formatted
+		logging::FormatFunction formatFunction;
+		const char* fileInfo;
+		const char* categoryName;
+		LogVerbosity verbosity;
+		u8 outputColor;
+		u32 argumentsSize;
+		// followed by the arguments
+	};
+
+	LogQueue* _getThreadQueue();
+	u8* _beginMessage(const LogCategory& _category, LogVerbosity _verbosity, const char* _fileInfo, const char* _fmt, logging::FormatFunction _formatFunction, u32 _argumentsSize);
+	void _endMessage();
+	void _wakeThread();
+	void _threadMain();
+	// Log thread, or logging thread without YAE_LOG_ASYNC. Returns true if it stopped at a message that was given its
+	// sequence but is not published yet, the messages after it have to wait for it.
+	bool _processMessages();
+	void _writeMessage(const MessageHeader& _header, const char* _message);
+	CategorySettings& _findOrAddCategorySettings(const char* _categoryName);
+
+	HashMap<StringHash, CategorySettings> m_categories;
 	OutputColor m_defaultOutputColor = OutputColor_Default;
+	bool m_isStandardOutputEnabled = true;
+
+	u32 m_instanceId = 0;
+	std::thread::id m_mainThreadId;
+	LogQueue* m_queues[YAE_LOG_MAX_THREADS] = {};
+	std::atomic<u32> m_queueCount;
+	std::mutex m_queuesMutex;
+	std::atomic<u64> m_nextSequence;
+	std::atomic<u64> m_processedCount;
+	u64 m_nextWrittenSequence = 0; // guarded by m_processMutex
+
+	std::mutex m_processMutex; // sinks are only written by one thread at a time
+	void* m_outputFile = nullptr; // FILE*
+	LogQueue m_loggedQueue; // written messages, waiting for the main thread to dispatch them
+	std::atomic<u32> m_droppedLoggedCount;
+
+#if YAE_LOG_ASYNC
+	std::thread* m_thread = nullptr;
+	std::mutex m_threadMutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_processedCondition;
+	bool m_wakeRequested = false;
+	bool m_stopRequested = false;
+#endif
 };
 
 } // namespace yae
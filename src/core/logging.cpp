@@ -6,13 +6,60 @@
 
 #include <mirror/mirror.h>
 
+YAE_DEFINE_LOG_CATEGORY(Default)
+YAE_DEFINE_LOG_CATEGORY(program)
+YAE_DEFINE_LOG_CATEGORY(filesystem)
+
 namespace yae {
 
+YAE_CHECK_STRING_HASHES(log_category::Default_hash, log_category::program_hash, log_category::filesystem_hash);
+
+// Constant initialized, categories can register during any static initialization
+static LogCategory* s_firstCategory = nullptr;
+
+LogCategory::LogCategory(const char* _name, u32 _hash)
+	: name(_name)
+	, hash(_hash)
+{
+	next = s_firstCategory;
+	s_firstCategory = this;
+}
+
+LogCategory::~LogCategory()
+{
+	// Module categories are destroyed when their module is unloaded
+	LogCategory** categoryPtr = &s_firstCategory;
+	while (*categoryPtr != nullptr)
+	{
+		if (*categoryPtr == this)
+		{
+			*categoryPtr = next;
+			break;
+		}
+		categoryPtr = &(*categoryPtr)->next;
+	}
+}
+
 namespace logging {
 
-void log(::yae::Logger& _logger, const char* _categoryName, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _msg)
+LogCategory* getFirstCategory()
+{
+	return s_firstCategory;
+}
+
+u8* beginMessage(::yae::Logger& _logger, const LogCategory& _category, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _fmt, FormatFunction _formatFunction, u32 _argumentsSize)
+{
+	return _logger._beginMessage(_category, _verbosity, _fileInfo, _fmt, _formatFunction, _argumentsSize);
+}
+
+void endMessage(::yae::Logger& _logger)
+{
+	_logger._endMessage();
+}
+
+void log(::yae::Logger& _logger, const LogCategory& _category, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _msg)
 {
-	_logger.log(_categoryName, _verbosity, _fileInfo, _msg);
+	_logger.log(_category, _verbosity, _fileInfo, _msg);
 }
 
 }
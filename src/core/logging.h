@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
 
 namespace yae {
 
@@ -15,28 +18,105 @@ enum class LogVerbosity : u8
 	VERBOSE,
 };
 
+// Log calls more verbose than this are compiled out, whatever their category
+#ifndef YAE_LOG_COMPILED_VERBOSITY
+#if YAE_RELEASE
+#define YAE_LOG_COMPILED_VERBOSITY LOG
+#else
+#define YAE_LOG_COMPILED_VERBOSITY VERBOSE
+#endif
+#endif
+
+// Declared with YAE_DECLARE_LOG_CATEGORY and defined once with YAE_DEFINE_LOG_CATEGORY. Categories register
+// themselves when constructed, their verbosity is set by the Logger from the settings.
+struct CORE_API LogCategory
+{
+	LogCategory(const char* _name, u32 _hash);
+	~LogCategory();
+
+	const char* name;
+	u32 hash; // StringHash of the name
+	LogVerbosity verbosity = LogVerbosity::LOG; // more verbose messages are filtered at runtime
+	LogCategory* next = nullptr;
+};
+
 namespace logging {
 
-CORE_API void log(::yae::Logger& _logger, const char* _categoryName, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _msg);
+// Registered categories, in no particular order
+CORE_API LogCategory* getFirstCategory();
 
-template<typename ...Args>
-void log(::yae::Logger& _logger, const char* _categoryName, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _fmt, Args... _args)
+// Formats the packed arguments of a message, same return value as snprintf
+typedef int (*FormatFunction)(char* _buffer, size_t _bufferSize, const char* _fmt, const u8* _arguments);
+
+// Arguments are copied in the logger queue and formatted later on the log thread
+template <typename T>
+struct LogArgument
 {
-	const int BUFFER_SIZE = 512;
-	int logSize = snprintf(nullptr, 0, _fmt, _args...);
-	if (logSize < BUFFER_SIZE)
+	static_assert(std::is_trivially_copyable<T>::value, "Log arguments must be printf compatible");
+
+	static u32 getSize(const T&) { return sizeof(T); }
+	static void write(u8*& _cursor, const T& _value) { memcpy(_cursor, &_value, sizeof(T)); _cursor += sizeof(T); }
+	static T read(const u8*& _cursor) { T value; memcpy(&value, _cursor, sizeof(T)); _cursor += sizeof(T); return value; }
+};
+
+// Strings are copied, the memory they point to may be gone by the time the message is formatted
+template <>
+struct LogArgument<const char*>
+{
+	static u32 getSize(const char* _value) { return u32(strlen(_value != nullptr ? _value : "(null)")) + 1; }
+	static void write(u8*& _cursor, const char* _value)
+	{
+		u32 size = getSize(_value);
+		memcpy(_cursor, _value != nullptr ? _value : "(null)", size);
+		_cursor += size;
+	}
+	static const char* read(const u8*& _cursor)
 	{
-		char buffer[BUFFER_SIZE];
-		snprintf(buffer, BUFFER_SIZE, _fmt, _args...);
-		log(_logger, _categoryName, _verbosity, _fileInfo, buffer);
+		const char* value = (const char*)_cursor;
+		_cursor += strlen(value) + 1;
+		return value;
 	}
-	else
+};
+
+template <>
+struct LogArgument<char*> : LogArgument<const char*> {};
+
+template <typename ...Args>
+int formatArguments(char* _buffer, size_t _bufferSize, const char* _fmt, const u8* _arguments)
+{
+	// Braced initialization reads the arguments in order
+	std::tuple<decltype(LogArgument<Args>::read(_arguments))...> arguments{ LogArgument<Args>::read(_arguments)... };
+	return std::apply([&](auto... _values) { return snprintf(_buffer, _bufferSize, _fmt, _values...); }, arguments);
+}
+
+// Reserves a message in the calling thread queue, the packed arguments are written in the returned memory.
+// Returns nullptr if the arguments do not fit in a queue, the message is then formatted right away.
+CORE_API u8* beginMessage(::yae::Logger& _logger, const LogCategory& _category, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _fmt, FormatFunction _formatFunction, u32 _argumentsSize);
+CORE_API void endMessage(::yae::Logger& _logger);
+
+CORE_API void log(::yae::Logger& _logger, const LogCategory& _category, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _msg);
+
+// _fmt and _fileInfo must be string literals, they are read when the message is formatted
+template<typename ...Args>
+void log(::yae::Logger& _logger, const LogCategory& _category, yae::LogVerbosity _verbosity, const char* _fileInfo, const char* _fmt, Args... _args)
+{
+	if (_category.verbosity < _verbosity)
+		return;
+
+	u32 argumentsSize = (0u + ... + LogArgument<Args>::getSize(_args));
+	u8* arguments = beginMessage(_logger, _category, _verbosity, _fileInfo, _fmt, &formatArguments<Args...>, argumentsSize);
+	if (arguments != nullptr)
 	{
-		char* buffer = (char*)malloc(logSize + 1);
-		snprintf(buffer, logSize + 1, _fmt, _args...);
-		log(_logger, _categoryName, _verbosity, _fileInfo, buffer);
-		free(buffer);
+		(LogArgument<Args>::write(arguments, _args), ...);
+		endMessage(_logger);
+		return;
 	}
+
+	int logSize = snprintf(nullptr, 0, _fmt, _args...);
+	char* buffer = (char*)malloc(logSize + 1);
+	snprintf(buffer, logSize + 1, _fmt, _args...);
+	log(_logger, _category, _verbosity, _fileInfo, buffer);
+	free(buffer);
 }
 
 } // namespace logging
@@ -45,22 +125,51 @@ void log(::yae::Logger& _logger, const char* _categoryName, yae::LogVerbosity _v
 
 #define __FILE_AND_LINE__ __FILE__ ":" STRINGIZE(__LINE__)
 
-#define YAE_VERBOSE(_msg)						::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::VERBOSE, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_VERBOSE_CAT(_category, _msg)		::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::VERBOSE, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_VERBOSEF(_fmt, ...)					::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::VERBOSE, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
-#define YAE_VERBOSEF_CAT(_category, _fmt, ...)	::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::VERBOSE, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
-
-#define YAE_LOG(_msg)							::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::LOG, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_LOG_CAT(_category, _msg)			::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::LOG, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_LOGF(_fmt, ...)						::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::LOG, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
-#define YAE_LOGF_CAT(_category, _fmt, ...)		::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::LOG, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
-
-#define YAE_WARNING(_msg)						::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::WARNING, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_WARNING_CAT(_category, _msg)		::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::WARNING, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_WARNINGF(_fmt, ...)					::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::WARNING, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
-#define YAE_WARNINGF_CAT(_category, _fmt, ...)	::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::WARNING, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
-
-#define YAE_ERROR(_msg)							::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::ERROR, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_ERROR_CAT(_category, _msg)			::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::ERROR, __FILE_AND_LINE__, "%s", _msg)
-#define YAE_ERRORF(_fmt, ...)					::yae::logging::log(::yae::logger(), nullptr, ::yae::LogVerbosity::ERROR, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
-#define YAE_ERRORF_CAT(_category, _fmt, ...)	::yae::logging::log(::yae::logger(), _category, ::yae::LogVerbosity::ERROR, __FILE_AND_LINE__, _fmt"", __VA_ARGS__)
+// Must be used in the global namespace. Messages of the category more verbose than _verbosity are compiled out.
+#define YAE_DECLARE_LOG_CATEGORY(_api, _name, _verbosity) \
+	namespace yae { namespace log_category { \
+		extern _api ::yae::LogCategory _name; \
+		constexpr u32 _name##_hash = ::yae::hash::hashStringConstexpr(#_name); \
+		constexpr ::yae::LogVerbosity _name##_compiledVerbosity = \
+			::yae::LogVerbosity::_verbosity < ::yae::LogVerbosity::YAE_LOG_COMPILED_VERBOSITY ? ::yae::LogVerbosity::_verbosity : ::yae::LogVerbosity::YAE_LOG_COMPILED_VERBOSITY; \
+	} }
+
+#define YAE_DEFINE_LOG_CATEGORY(_name) \
+	namespace yae { namespace log_category { \
+		::yae::LogCategory _name(#_name, _name##_hash); \
+	} }
+
+YAE_DECLARE_LOG_CATEGORY(CORE_API, Default, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(CORE_API, program, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(CORE_API, filesystem, VERBOSE)
+
+#define YAE_LOG_CAT_IMPL(_category, _verbosity, _fmt, ...) \
+	do { \
+		if constexpr (::yae::LogVerbosity::_verbosity <= ::yae::log_category::_category##_compiledVerbosity) \
+		{ \
+			if (::yae::log_category::_category.verbosity >= ::yae::LogVerbosity::_verbosity) \
+			{ \
+				::yae::logging::log(::yae::logger(), ::yae::log_category::_category, ::yae::LogVerbosity::_verbosity, __FILE_AND_LINE__, _fmt, __VA_ARGS__); \
+			} \
+		} \
+	} while (0)
+
+#define YAE_VERBOSE(_msg)						YAE_LOG_CAT_IMPL(Default, VERBOSE, "%s", _msg)
+#define YAE_VERBOSE_CAT(_category, _msg)		YAE_LOG_CAT_IMPL(_category, VERBOSE, "%s", _msg)
+#define YAE_VERBOSEF(_fmt, ...)					YAE_LOG_CAT_IMPL(Default, VERBOSE, _fmt"", __VA_ARGS__)
+#define YAE_VERBOSEF_CAT(_category, _fmt, ...)	YAE_LOG_CAT_IMPL(_category, VERBOSE, _fmt"", __VA_ARGS__)
+
+#define YAE_LOG(_msg)							YAE_LOG_CAT_IMPL(Default, LOG, "%s", _msg)
+#define YAE_LOG_CAT(_category, _msg)			YAE_LOG_CAT_IMPL(_category, LOG, "%s", _msg)
+#define YAE_LOGF(_fmt, ...)						YAE_LOG_CAT_IMPL(Default, LOG, _fmt"", __VA_ARGS__)
+#define YAE_LOGF_CAT(_category, _fmt, ...)		YAE_LOG_CAT_IMPL(_category, LOG, _fmt"", __VA_ARGS__)
+
+#define YAE_WARNING(_msg)						YAE_LOG_CAT_IMPL(Default, WARNING, "%s", _msg)
+#define YAE_WARNING_CAT(_category, _msg)		YAE_LOG_CAT_IMPL(_category, WARNING, "%s", _msg)
+#define YAE_WARNINGF(_fmt, ...)					YAE_LOG_CAT_IMPL(Default, WARNING, _fmt"", __VA_ARGS__)
+#define YAE_WARNINGF_CAT(_category, _fmt, ...)	YAE_LOG_CAT_IMPL(_category, WARNING, _fmt"", __VA_ARGS__)
+
+#define YAE_ERROR(_msg)							YAE_LOG_CAT_IMPL(Default, ERROR, "%s", _msg)
+#define YAE_ERROR_CAT(_category, _msg)			YAE_LOG_CAT_IMPL(_category, ERROR, "%s", _msg)
+#define YAE_ERRORF(_fmt, ...)					YAE_LOG_CAT_IMPL(Default, ERROR, _fmt"", __VA_ARGS__)
+#define YAE_ERRORF_CAT(_category, _fmt, ...)	YAE_LOG_CAT_IMPL(_category, ERROR, _fmt"", __VA_ARGS__)
@@ -2,6 +2,15 @@
 
 #include <core/types.h>
 
+// ftell and fseek are limited to 2GB on Windows
+#ifdef _MSC_VER
+#define YAE_FTELL64 _ftelli64
+#define YAE_FSEEK64 _fseeki64
+#else
+#define YAE_FTELL64 ftello
+#define YAE_FSEEK64 fseeko
+#endif
+
 namespace yae {
 
 struct StackFrame;
@@ -29,6 +38,10 @@ CORE_API void setWorkingDirectory(const char* _path);
 CORE_API String getWorkingDirectory();
 CORE_API String getAbsolutePath(const char* _path);
 
+// Read-only file mapping, nullptr if the file can't be mapped (empty files can't)
+CORE_API const void* mapFile(const char* _path, u64* _outSize, void** _outMapping);
+CORE_API void unmapFile(const void* _data, u64 _size, void* _mapping);
+
 // DLLs
 CORE_API void* loadDynamicLibrary(const char* _path);
 CORE_API void unloadDynamicLibrary(void* _libraryHandle);
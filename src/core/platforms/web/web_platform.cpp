@@ -2,6 +2,10 @@
 
 #include <emscripten.h>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace yae {
 
@@ -42,6 +46,37 @@ String getAbsolutePath(const char* _path)
 }
 
 
+const void* mapFile(const char* _path, u64* _outSize, void** _outMapping)
+{
+	int file = open(_path, O_RDONLY);
+	if (file < 0)
+		return nullptr;
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size <= 0 || u64(fileStat.st_size) > u64(SIZE_MAX))
+	{
+		close(file);
+		return nullptr;
+	}
+
+	// The mapping keeps the file open
+	void* data = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	*_outSize = u64(fileStat.st_size);
+	*_outMapping = nullptr;
+	return data;
+}
+
+
+void unmapFile(const void* _data, u64 _size, void* _mapping)
+{
+	munmap(const_cast<void*>(_data), size_t(_size));
+}
+
+
 void* loadDynamicLibrary(const char* _path)
 {
     return dlopen(_path, RTLD_NOW);
@@ -71,6 +71,43 @@ String getAbsolutePath(const char* _path)
 	return String(buffer, &scratchAllocator());
 }
 
+const void* mapFile(const char* _path, u64* _outSize, void** _outMapping)
+{
+	HANDLE file = CreateFileA(_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	// The mapping keeps the file open
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return nullptr;
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		return nullptr;
+	}
+
+	*_outSize = u64(size.QuadPart);
+	*_outMapping = mapping;
+	return data;
+}
+
+void unmapFile(const void* _data, u64 _size, void* _mapping)
+{
+	UnmapViewOfFile(_data);
+	CloseHandle((HANDLE)_mapping);
+}
+
 void* loadDynamicLibrary(const char* _path)
 {
 	HMODULE module = LoadLibraryA(_path);
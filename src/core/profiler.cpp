@@ -2,6 +2,7 @@
 
 #include <core/memory.h>
 #include <core/string.h>
+#include <core/StringBuilder.h>
 
 namespace yae {
 
@@ -11,6 +12,7 @@ Profiler::Profiler(Allocator* _allocator)
 	, m_eventsStack(_allocator)
 	, m_runningCaptures(_allocator)
 	, m_captures(_allocator)
+	, m_counters(_allocator)
 {
 
 }
@@ -75,6 +77,11 @@ void Profiler::stopCapture(const char* _captureName)
 			capture.events.push_back(e);
 		}
 	}
+
+	for (const auto& pair : m_counters)
+	{
+		capture.counters.push_back(pair.value);
+	}
 }
 
 
@@ -90,21 +97,19 @@ void Profiler::dumpCapture(const char* _captureName, String& _outString) const
 	StringHash nameHash(_captureName);
 	const Capture* capturePtr = m_captures.get(nameHash);
 
-	_outString += string::format("-- %s: ", _captureName);
-
 	if (!capturePtr)
 	{
 		_outString = "no capture";
 		return;
 	}
 
-	Time captureTime = capturePtr->stopTime - capturePtr->startTime;
+	StringBuilder builder(&scratchAllocator());
+	builder.reserve(capturePtr->events.size() * 48);
 
-	String32 timeString;
-	time::formatTime(captureTime, timeString);
-	_outString += string::format("%s\n", timeString.c_str());
+	builder.format("-- {}: ", _captureName);
+	time::formatTime(capturePtr->stopTime - capturePtr->startTime, builder);
+	builder.append('\n');
 
-	String64 tabs;
 	DataArray<u32> stack(&scratchAllocator());
 	for (u32 i = 0; i < capturePtr->events.size(); ++i)
 	{
@@ -120,18 +125,45 @@ void Profiler::dumpCapture(const char* _captureName, String& _outString) const
 
 		stack.push_back(i);
 
-		tabs.clear();
-		for (u32 j = 1; j < stack.size(); ++j)
-		{
-			tabs += "  ";
-		}
+		builder.appendRepeated(' ', (stack.size() - 1) * 2);
+		builder.format("{}: ", e.name);
+		time::formatTime(e.stopTime - e.startTime, builder);
+		builder.append('\n');
+	}
+
+	for (const Counter& counter : capturePtr->counters)
+	{
+		builder.format("{}: {}\n", counter.name, counter.value);
+	}
+
+	_outString.reserve(_outString.size() + builder.size());
+	_outString += builder.c_str();
+}
 
-		Time eventTime = e.stopTime - e.startTime;
 
-		timeString.clear();
-		time::formatTime(eventTime, timeString);
-		_outString += string::format("%s%s: %s\n", tabs.c_str(), e.name, timeString.c_str());
+void Profiler::setCounter(const char* _name, i64 _value)
+{
+	m_counters.set(StringHash(_name), Counter{ _name, _value });
+}
+
+
+void Profiler::addCounter(const char* _name, i64 _value)
+{
+	StringHash nameHash(_name);
+	Counter* counterPtr = m_counters.get(nameHash);
+	if (counterPtr == nullptr)
+	{
+		m_counters.set(nameHash, Counter{ _name, _value });
+		return;
 	}
+	counterPtr->value += _value;
+}
+
+
+i64 Profiler::getCounter(const char* _name) const
+{
+	const Counter* counterPtr = m_counters.get(StringHash(_name));
+	return counterPtr != nullptr ? counterPtr->value : 0;
 }
 
 
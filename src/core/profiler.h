@@ -25,6 +25,10 @@ public:
 
 	void dumpCapture(const char* _captureName, String& _outString) const;
 
+	void setCounter(const char* _name, i64 _value);
+	void addCounter(const char* _name, i64 _value);
+	i64 getCounter(const char* _name) const;
+
 	void update();
 
 // private:
@@ -38,15 +42,22 @@ public:
 		Time stopTime;
 	};
 
+	struct Counter
+	{
+		const char* name;
+		i64 value;
+	};
+
 	struct Capture
 	{
 		Capture() {};
-		Capture(Allocator* _allocator) : events(_allocator) {}
+		Capture(Allocator* _allocator) : events(_allocator), counters(_allocator) {}
 
 		const char* name;
 		Time startTime;
 		Time stopTime;
 		DataArray<Event> events;
+		DataArray<Counter> counters; // values when the capture stopped
 	};
 
 	Allocator* m_allocator = nullptr;
@@ -56,6 +67,7 @@ public:
 
 	HashMap<StringHash, Capture> m_runningCaptures;
 	HashMap<StringHash, Capture> m_captures;
+	HashMap<StringHash, Counter> m_counters;
 };
 
 } // namespace yae
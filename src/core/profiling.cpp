@@ -2,20 +2,25 @@
 #include "profiling.h"
 
 #include <core/profiler.h>
+#include <core/JobSystem.h>
 
 namespace yae {
 namespace profiling {
 
 CaptureScope::CaptureScope(const char* _name)
 	: m_name(_name)
+	// The profiler is single threaded, scopes opened from job workers are ignored
+	, m_enabled(jobSystem().isMainThread())
 {
-	profiler().pushEvent(_name);
+	if (m_enabled)
+		profiler().pushEvent(_name);
 }
 
 
 CaptureScope::~CaptureScope()
 {
-	profiler().popEvent(m_name);
+	if (m_enabled)
+		profiler().popEvent(m_name);
 }
 
 void startCapture(const char* _captureName)
@@ -29,5 +34,17 @@ void stopCapture(const char* _captureName)
 	profiler().stopCapture(_captureName);
 }
 
+void setCounter(const char* _name, i64 _value)
+{
+	YAE_ASSERT_MSG(jobSystem().isMainThread(), "Profiler counters can only be written from the main thread");
+	profiler().setCounter(_name, _value);
+}
+
+void addCounter(const char* _name, i64 _value)
+{
+	YAE_ASSERT_MSG(jobSystem().isMainThread(), "Profiler counters can only be written from the main thread");
+	profiler().addCounter(_name, _value);
+}
+
 } // namespace profiling
 } // namespace yae
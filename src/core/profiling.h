@@ -11,11 +11,16 @@ struct CORE_API CaptureScope
 	~CaptureScope();
 
 	const char* m_name;
+	bool m_enabled;
 };
 
 CORE_API void startCapture(const char* _captureName);
 CORE_API void stopCapture(const char* _captureName);
 
+// Counters are named values snapshotted with the captures. _name must be a static string.
+CORE_API void setCounter(const char* _name, i64 _value);
+CORE_API void addCounter(const char* _name, i64 _value);
+
 } // namespace profiling
 } // namespace yae
 
@@ -24,9 +29,13 @@ CORE_API void stopCapture(const char* _captureName);
 #define YAE_CAPTURE_STOP(_captureName) yae::profiling::stopCapture(_captureName)
 #define YAE_CAPTURE_SCOPE(_scopeName) yae::profiling::CaptureScope __scope##__LINE__(_scopeName)
 #define YAE_CAPTURE_FUNCTION() YAE_CAPTURE_SCOPE(__PRETTY_FUNCTION__)
+#define YAE_CAPTURE_COUNTER(_counterName, _value) yae::profiling::setCounter(_counterName, _value)
+#define YAE_CAPTURE_COUNTER_ADD(_counterName, _value) yae::profiling::addCounter(_counterName, _value)
 #else
 #define YAE_CAPTURE_START(_captureName)
 #define YAE_CAPTURE_STOP(_captureName)
 #define YAE_CAPTURE_SCOPE(_scopeName)
 #define YAE_CAPTURE_FUNCTION()
+#define YAE_CAPTURE_COUNTER(_counterName, _value)
+#define YAE_CAPTURE_COUNTER_ADD(_counterName, _value)
 #endif
@@ -3,6 +3,8 @@
 #include <core/platform.h>
 #include <core/filesystem.h>
 #include <core/profiler.h>
+#include <core/JobSystem.h>
+#include <core/IOService.h>
 #include <core/logger.h>
 #include <core/string.h>
 #include <core/StringHashRepository.h>
@@ -68,6 +70,8 @@ Program::Program()
 	s_programInstance = this;
     m_logger = defaultAllocator().create<Logger>();
 	m_profiler = defaultAllocator().create<Profiler>(&toolAllocator());
+	m_jobSystem = defaultAllocator().create<JobSystem>(&defaultAllocator());
+	m_ioService = defaultAllocator().create<IOService>(&defaultAllocator());
 }
 
 
@@ -82,6 +86,12 @@ Program::~Program()
 	m_modules.clear();
 	m_modulesByName.clear();
 
+	defaultAllocator().destroy(m_ioService);
+	m_ioService = nullptr;
+
+	defaultAllocator().destroy(m_jobSystem);
+	m_jobSystem = nullptr;
+
 	defaultAllocator().destroy(m_profiler);
 	m_profiler = nullptr;
 	
@@ -182,6 +192,8 @@ void Program::init(const char** _args, int _argCount)
     filesystem::deletePath(m_hotReloadDirectory.c_str());
 	filesystem::createDirectory(m_hotReloadDirectory.c_str());
 	filesystem::createDirectory(m_settingsDirectory.c_str());
+
+	m_logger->setOutputFile((m_intermediateDirectory + "log.txt").c_str());
 #endif
 
 	YAE_LOGF("exe path: %s",  getExePath());
@@ -215,6 +227,9 @@ void Program::init(const char** _args, int _argCount)
 		YAE_SDL_VERIFY(SDL_Init(flags));
 	}
 
+	m_jobSystem->init(JobSystem::GetDefaultWorkerCount());
+	m_ioService->init(IOService::GetDefaultThreadCount());
+
 	for (Module* module : m_modules)
 	{	
 		_loadModule(module, _getModuleDLLPath(module->name.c_str()).c_str());
@@ -238,6 +253,9 @@ void Program::shutdown()
 		_unloadModule(m_modules[i]);
 	}
 
+	m_ioService->shutdown();
+	m_jobSystem->shutdown();
+
 	// SDL shutdown
 	{
 		SDL_Quit();
@@ -385,6 +403,18 @@ Profiler& Program::profiler()
 	return *m_profiler;
 }
 
+JobSystem& Program::jobSystem()
+{
+	YAE_ASSERT(m_jobSystem != nullptr);
+	return *m_jobSystem;
+}
+
+IOService& Program::ioService()
+{
+	YAE_ASSERT(m_ioService != nullptr);
+	return *m_ioService;
+}
+
 static String getSettingsFilePath()
 {
 	return filesystem::normalizePath(string::format("%s/program_settings.json", program().getSettingsDirectory()).c_str());
@@ -393,17 +423,22 @@ static String getSettingsFilePath()
 void Program::loadSettings()
 {
 	String filePath = getSettingsFilePath();
-	FileReader reader(filePath.c_str());
-	if (!reader.load())
+	IOBatch batch(&scratchAllocator());
+	batch.addRead(filePath.c_str());
+	m_ioService->submit(batch);
+	m_ioService->wait(batch);
+
+	const IOReadRequest& request = batch.getRequest(0);
+	if (request.status != IOStatus::DONE)
 	{
 		// No settings file, do nothing
 		return;
 	}
 
 	JsonSerializer serializer(&scratchAllocator());
-	if (!serializer.parseSourceData(reader.getContent(), reader.getContentSize()))
+	if (!serializer.parseSourceData(request.data, size_t(request.size)))
 	{
-		YAE_ERRORF_CAT("program", "Failed to parse json settings file \"%s\"", filePath.c_str());
+		YAE_ERRORF_CAT(program, "Failed to parse json settings file \"%s\"", filePath.c_str());
 		return;	
 	}
 
@@ -411,7 +446,7 @@ void Program::loadSettings()
 	_onSerialize(serializer);
 	serializer.endRead();
 	
-	YAE_VERBOSEF_CAT("program", "Loaded program settings from \"%s\"", filePath.c_str());
+	YAE_VERBOSEF_CAT(program, "Loaded program settings from \"%s\"", filePath.c_str());
 }
 
 void Program::saveSettings()
@@ -425,17 +460,17 @@ void Program::saveSettings()
 	FileHandle file(filePath.c_str());
 	if (!file.open(FileHandle::OPENMODE_WRITE))
 	{
-		YAE_ERRORF_CAT("program", "Failed to open \"%s\" for write", filePath.c_str());
+		YAE_ERRORF_CAT(program, "Failed to open \"%s\" for write", filePath.c_str());
 		return;
 	}
 	if (!file.write(serializer.getWriteData(), serializer.getWriteDataSize()))
 	{
-		YAE_ERRORF_CAT("program", "Failed to write into \"%s\"", filePath.c_str());
+		YAE_ERRORF_CAT(program, "Failed to write into \"%s\"", filePath.c_str());
 		return;
 	}
 	file.close();
 
-	YAE_VERBOSEF_CAT("program", "Saved program settings to \"%s\"", filePath.c_str());
+	YAE_VERBOSEF_CAT(program, "Saved program settings to \"%s\"", filePath.c_str());
 }
 
 const DataArray<Module*>& Program::getModules() const
@@ -451,6 +486,9 @@ void Program::_doFrame()
 
 	YAE_CAPTURE_START("frame");
 
+	m_logger->dispatchLogged();
+	m_ioService->update();
+
 	for (Module* module : m_modules)
 	{
 		if (module->updateProgramFunction != nullptr)
@@ -526,6 +564,7 @@ void Program::_loadModule(Module* _module, const char* _dllPath)
 	YAE_ASSERT(_module->libraryHandle);
 
 	mirror::InitNewTypes();
+	m_logger->updateCategories();
 
 	_module->beforeModuleReloadFunction = (void (*)(Program*, Module*))platform::getProcedureAddress(_module->libraryHandle, "beforeModuleReload");
 	_module->afterModuleReloadFunction = (void (*)(Program*, Module*))platform::getProcedureAddress(_module->libraryHandle, "afterModuleReload");
@@ -553,7 +592,7 @@ void Program::_loadModule(Module* _module, const char* _dllPath)
 		}
 	}
 
-	YAE_LOGF_CAT("program", "Loaded \"%s\" module from \"%s\"", _module->name.c_str(), _dllPath);
+	YAE_LOGF_CAT(program, "Loaded \"%s\" module from \"%s\"", _module->name.c_str(), _dllPath);
 }
 
 
@@ -584,10 +623,13 @@ void Program::_unloadModule(Module* _module)
 	_module->serializeSettingsFunction = nullptr;
 	_module->getDependenciesFunction = nullptr;
 
+	// Queued messages point to format strings of the module
+	m_logger->flush();
+
 	platform::unloadDynamicLibrary(_module->libraryHandle);
 	_module->libraryHandle = nullptr;
 
-	YAE_LOGF_CAT("program", "Unloaded \"%s\" module", _module->name.c_str());
+	YAE_LOGF_CAT(program, "Unloaded \"%s\" module", _module->name.c_str());
 }
 
 
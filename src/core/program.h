@@ -16,6 +16,8 @@ namespace yae {
 class Allocator;
 class Logger;
 class Profiler;
+class JobSystem;
+class IOService;
 class Module;
 
 // @TODO: Rename as Core
@@ -53,6 +55,8 @@ public:
 	// Services getters
 	Logger& logger();
 	Profiler& profiler();
+	JobSystem& jobSystem();
+	IOService& ioService();
 
 	// Settings
 	void loadSettings();
@@ -76,6 +80,8 @@ public:
 
 	Logger* m_logger = nullptr;
 	Profiler* m_profiler = nullptr;
+	JobSystem* m_jobSystem = nullptr;
+	IOService* m_ioService = nullptr;
 	lpp::LppSynchronizedAgent* m_lppAgent;
 
 	int m_argCount = 0;
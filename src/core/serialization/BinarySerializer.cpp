@@ -90,7 +90,7 @@ u32 BinarySerializer::getWriteDataSize() const
 	return m_writeDataSize;
 }
 
-void BinarySerializer::setReadData(void* _data, u32 _dataSize)
+void BinarySerializer::setReadData(const void* _data, u32 _dataSize)
 {
 	YAE_ASSERT_MSG(getMode() == SerializationMode::NONE, "ReadData can't be set during a serialization. This call should go outside of the begin/end block.");
 	m_readData = _data;
@@ -106,7 +106,7 @@ void BinarySerializer::beginRead()
 
 	Buffer buffer;
 	buffer.type = BufferType::PLAIN;
-	buffer.data = (u8*)m_readData;
+	buffer.data = (u8*)m_readData; // never written while reading
 	buffer.dataSize = m_readDataSize;
 	buffer.cursor = 0;
 	buffer.maxCursor = 0;
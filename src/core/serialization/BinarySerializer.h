@@ -20,7 +20,7 @@ public:
 	void* getWriteData() const;
 	u32 getWriteDataSize() const;
 
-	void setReadData(void* _data, u32 _dataSize);
+	void setReadData(const void* _data, u32 _dataSize); // read in place, can point to a mapped file
 	virtual void beginRead() override;
 	virtual void endRead() override;
 
@@ -87,7 +87,7 @@ public:
 	Array<Buffer> m_bufferStack;
 	void* m_writeData = nullptr;
 	u32 m_writeDataSize = 0;
-	void* m_readData = nullptr;
+	const void* m_readData = nullptr;
 	u32 m_readDataSize = 0;
 };
 
@@ -278,7 +278,7 @@ u32 JsonSerializer::getWriteDataSize()
 	return m_writeDataSize;
 }
 
-bool JsonSerializer::parseSourceData(const void* _data, u32 _dataSize)
+bool JsonSerializer::parseSourceData(const void* _data, size_t _dataSize)
 {
 	YAE_ASSERT_MSG(getMode() == SerializationMode::NONE, "Data can't be parsed during a serialization. This call should go outside of the begin/end block.");
 
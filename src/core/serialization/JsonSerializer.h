@@ -21,7 +21,7 @@ public:
 	void* getWriteData() const;
 	u32 getWriteDataSize();
 
-	bool parseSourceData(const void* _data, u32 _dataSize);
+	bool parseSourceData(const void* _data, size_t _dataSize); // read in place, can point to a mapped file
 	virtual void beginRead() override;
 	virtual void endRead() override;
 
@@ -200,5 +200,75 @@ String toUpperCase(const String& _str)
 	return toUpperCase(_str.c_str());
 }
 
+u32 decodeUtf8(const char*& _cursor, const char* _end)
+{
+	YAE_ASSERT(_cursor < _end);
+
+	const u32 REPLACEMENT_CHARACTER = 0xFFFD;
+	const u8* bytes = (const u8*)_cursor;
+	u8 lead = bytes[0];
+
+	if (lead < 0x80)
+	{
+		++_cursor;
+		return lead;
+	}
+
+	// Sequence length, value bits of the lead byte and smallest codepoint that needs that length
+	u32 length = 0;
+	u32 codepoint = 0;
+	u32 minCodepoint = 0;
+	if ((lead & 0xE0) == 0xC0)
+	{
+		length = 2;
+		codepoint = lead & 0x1F;
+		minCodepoint = 0x80;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 3;
+		codepoint = lead & 0x0F;
+		minCodepoint = 0x800;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 4;
+		codepoint = lead & 0x07;
+		minCodepoint = 0x10000;
+	}
+	else
+	{
+		// Continuation byte or invalid lead byte
+		++_cursor;
+		return REPLACEMENT_CHARACTER;
+	}
+
+	if (_end - _cursor < i64(length))
+	{
+		++_cursor;
+		return REPLACEMENT_CHARACTER;
+	}
+
+	for (u32 i = 1; i < length; ++i)
+	{
+		if ((bytes[i] & 0xC0) != 0x80)
+		{
+			++_cursor;
+			return REPLACEMENT_CHARACTER;
+		}
+		codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+	}
+
+	// Overlong encodings, surrogates and values past the last plane are not valid UTF-8
+	if (codepoint < minCodepoint || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+	{
+		++_cursor;
+		return REPLACEMENT_CHARACTER;
+	}
+
+	_cursor += length;
+	return codepoint;
+}
+
 } // namespace string
 } // namespace yae
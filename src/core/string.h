@@ -9,14 +9,24 @@ namespace string {
 
 extern const size_t INVALID_POS;
 
+// printf formatting. StringBuilder::format is faster and type safe, and does not need a new String per call.
 template<typename ... Args>
 String format(const char* _fmt, Args ..._args)
 {
     YAE_ASSERT(_fmt != nullptr);
-    size_t size = snprintf(nullptr, 0, _fmt, _args...);
+
+    // Formatted once when the result fits in the stack buffer, which is the common case
+    char buffer[256];
+    int size = snprintf(buffer, sizeof(buffer), _fmt, _args...);
     YAE_ASSERT(size > 0);
 
 	String result(&scratchAllocator());
+    if (size_t(size) < sizeof(buffer))
+    {
+        result = buffer;
+        return result;
+    }
+
     result.resize(size);
     snprintf(result.data(), size + 1, _fmt, _args...);
 
@@ -52,5 +62,9 @@ CORE_API String toLowerCase(const String& _str);
 CORE_API String toUpperCase(const char* _str);
 CORE_API String toUpperCase(const String& _str);
 
+// Decodes the UTF-8 sequence at _cursor and moves it past the sequence. Invalid or truncated sequences decode to
+// U+FFFD and only skip one byte, so that decoding always progresses.
+CORE_API u32 decodeUtf8(const char*& _cursor, const char* _end);
+
 } // namespace string
 } // namespace yae
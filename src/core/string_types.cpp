@@ -12,6 +12,16 @@ namespace yae {
 
 const char* EMPTY_STRING = "";
 
+// Appending doubles the capacity when it runs out, so that strings built with += are linear in their final size
+static size_t getAppendCapacity(size_t _bufferSize, size_t _newLength)
+{
+	if (_newLength < _bufferSize)
+		return _newLength;
+
+	size_t doubledLength = _bufferSize * 2;
+	return _newLength > doubledLength ? _newLength : doubledLength;
+}
+
 String::String(Allocator* _allocator)
 	: m_buffer(nullptr)
 	, m_allocator(_allocator)
@@ -165,7 +175,9 @@ String& String::operator=(const String& _str)
 
 String String::operator+(char _char) const
 {
-	String result = *this;
+	String result(m_allocator);
+	result.reserve(m_length + 1);
+	result += *this;
 	result += _char;
 	return result;
 }
@@ -174,7 +186,9 @@ String String::operator+(char _char) const
 
 String String::operator+(const char* _str) const
 {
-	String result = *this;
+	String result(m_allocator);
+	result.reserve(m_length + strlen(_str));
+	result += *this;
 	result += _str;
 	return result;
 }
@@ -182,7 +196,9 @@ String String::operator+(const char* _str) const
 
 String String::operator+(const String& _str) const
 {
-	String result = *this;
+	String result(m_allocator);
+	result.reserve(m_length + _str.m_length);
+	result += *this;
 	result += _str;
 	return result;
 }
@@ -190,7 +206,7 @@ String String::operator+(const String& _str) const
 
 String& String::operator+=(char _char)
 {
-	reserve(m_length + 1);
+	reserve(getAppendCapacity(m_bufferSize, m_length + 1));
 	data()[m_length] = _char;
 	m_length = m_length + 1;
 	data()[m_length] = 0;
@@ -202,7 +218,7 @@ String& String::operator+=(const char* _str)
 {
 	size_t length = strlen(_str);
 	size_t newLength = m_length + length;
-	reserve(newLength);
+	reserve(getAppendCapacity(m_bufferSize, newLength));
 	memcpy(data() + m_length, _str, length);
 	data()[newLength] = 0;
 	m_length = newLength;
@@ -214,7 +230,7 @@ String& String::operator+=(const String& _str)
 {
 	size_t length = _str.m_length;
 	size_t newLength = m_length + length;
-	reserve(newLength);
+	reserve(getAppendCapacity(m_bufferSize, newLength));
 	memcpy(data() + m_length, _str.data(), length);
 	data()[newLength] = 0;
 	m_length = newLength;
@@ -2,6 +2,7 @@
 
 #include <core/platform.h>
 #include <core/string.h>
+#include <core/StringBuilder.h>
 
 #include <climits>
 
@@ -139,6 +140,14 @@ float timeToSeconds(Time _time)
 }
 
 void formatTime(Time _time, String& _outString)
+{
+	char buffer[32];
+	StringBuilder builder(buffer, sizeof(buffer));
+	formatTime(_time, builder);
+	_outString = builder.c_str();
+}
+
+void formatTime(Time _time, StringBuilder& _builder)
 {
 	const char* units[] = {
 		"ns",
@@ -155,7 +164,7 @@ void formatTime(Time _time, String& _outString)
 		++unit;
 	}
 
-	_outString = string::format("%.2f%s", time, units[unit]);
+	_builder.format("{.2}{}", time, units[unit]);
 }
 
 } // namespace time
@@ -4,6 +4,8 @@
 
 namespace yae {
 
+class StringBuilder;
+
 struct CORE_API Time
 {
 	i64 time;
@@ -50,6 +52,7 @@ CORE_API double timeToSeconds64(Time _time);
 CORE_API float timeToSeconds(Time _time);
 
 void formatTime(Time _time, String& _outString);
+void formatTime(Time _time, StringBuilder& _builder); // appends
 
 } // namespace time
 
@@ -50,6 +50,18 @@ Logger& logger()
 }
 
 
+JobSystem& jobSystem()
+{
+	return program().jobSystem();
+}
+
+
+IOService& ioService()
+{
+	return program().ioService();
+}
+
+
 /*ResourceManager& resourceManager()
 {
 	return app().resourceManager();
@@ -81,6 +81,10 @@ typedef uint64_t	u64;
 	#define YAE_IMPLEMENTS_RENDERER_VULKAN 0
 #endif
 
+#ifndef YAE_IMPLEMENTS_RENDERER_NULL
+	#define YAE_IMPLEMENTS_RENDERER_NULL 0
+#endif
+
 // ASSERTS (should not depend on any engine construct)
 #if YAE_ASSERT_ENABLED
 #define YAE_ASSERT(_cond)					do {if (!(_cond)) { printf("Assert failed: %s\n", #_cond);       YAE_DEBUG_BREAK; }} while(0)
@@ -115,6 +119,8 @@ class Module;
 //class ResourceManager;
 class Logger;
 class Profiler;
+class JobSystem;
+class IOService;
 //class Renderer;
 //class InputSystem;
 class Serializer;
@@ -126,6 +132,8 @@ CORE_API Allocator& scratchAllocator();
 CORE_API Allocator& toolAllocator();
 CORE_API Profiler& profiler();
 CORE_API Logger& logger();
+CORE_API JobSystem& jobSystem();
+CORE_API IOService& ioService();
 
 CORE_API void setAllocators(Allocator* _defaultAllocator, Allocator* _scratchAllocator, Allocator* _toolAllocator);
 
@@ -137,6 +145,7 @@ extern Allocator* g_toolAllocator;
 
 // BASE INCLUDES
 #include <core/string_types.h>
+#include <core/hash_constexpr.h>
+#include <core/StringHash.h>
 #include <core/logging.h>
 #include <core/profiling.h>
-#include <core/StringHash.h>
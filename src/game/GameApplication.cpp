@@ -138,6 +138,7 @@ void GameApplication::_onStart()
 	YAE_ASSERT(entity2.get());
 	entity2->transform().setParent(entity1->transform());
 	entity2->transform().setLocalPosition(Vector3::FORWARD() * 10.f);
+	entity1->setMesh(pyramidMesh);
 
 	RenderCamera* gameCamera = renderer().createCamera("game");
 	gameCamera->fov = 45.f;
@@ -168,10 +169,10 @@ void GameApplication::_onStop()
 
 void GameApplication::_onUpdate(float _dt)
 {
-	RenderCamera* gameCamera = renderer().getCamera("game");
+	RenderCamera* gameCamera = renderer().getCamera("game"_sh);
 	YAE_ASSERT(gameCamera);
 
-	renderer().pushScene("game");
+	renderer().pushScene("game"_sh);
 
 	// EXIT PROGRAM
 	if (input().isKeyDown(SDL_SCANCODE_ESCAPE))
@@ -363,7 +364,7 @@ bool GameApplication::_onSerializeSettings(Serializer& _serializer)
 {
 	bool result = serialization::serializeMirrorType(_serializer, *this, "game");
 
-	RenderCamera* gameCamera = renderer().getCamera("game");
+	RenderCamera* gameCamera = renderer().getCamera("game"_sh);
 	if (gameCamera)
 	{
 		gameCamera->position = cameraPosition;
@@ -257,7 +257,7 @@ SpatialNode* SpatialSystem::findNode(NodeID _id) const
 
 SpatialSystem& spatialSystem()
 {
-	SpatialSystem* spatialSystem = (SpatialSystem*)(app().getUserData("spatialSystem"));
+	SpatialSystem* spatialSystem = (SpatialSystem*)(app().getUserData("spatialSystem"_sh));
 	YAE_ASSERT(spatialSystem);
 	return *spatialSystem;
 }
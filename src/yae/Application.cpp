@@ -22,12 +22,19 @@
 #include <yae/editor/Editor.h>
 #endif
 
+#if YAE_TESTS
+#include <yae/test/TestSystem.h>
+#endif
+
 #if YAE_IMPLEMENTS_RENDERER_VULKAN
 #include <yae/rendering/renderers/vulkan/VulkanRenderer.h>
 #endif
 #if YAE_IMPLEMENTS_RENDERER_OPENGL
 #include <yae/rendering/renderers/opengl/OpenGLRenderer.h>
 #endif
+#if YAE_IMPLEMENTS_RENDERER_NULL
+#include <yae/rendering/renderers/null/NullRenderer.h>
+#endif
 
 #include <imgui/backends/imgui_impl_sdl2.h>
 #include <core/yae_sdl.h>
@@ -77,6 +84,17 @@ void Application::requestStop()
 	m_isStopRequested = true;
 }
 
+void Application::setRendererType(RendererType _rendererType)
+{
+	YAE_ASSERT_MSG(m_renderer == nullptr, "The renderer type must be set before the application starts");
+	m_rendererType = _rendererType;
+}
+
+RendererType Application::getRendererType() const
+{
+	return m_rendererType;
+}
+
 void Application::beforeReload()
 {
 }
@@ -99,12 +117,20 @@ void Application::_start()
 	m_resourceManager->gatherResources(resourcePath.c_str());
 
 	// Init Renderer
-#if YAE_PLATFORM_WINDOWS
-	m_renderer = defaultAllocator().create<OpenGLRenderer>();
-	//m_renderer = defaultAllocator().create<VulkanRenderer>();
-#elif YAE_PLATFORM_WEB
-	m_renderer = defaultAllocator().create<OpenGLRenderer>();
+	switch (m_rendererType)
+	{
+#if YAE_IMPLEMENTS_RENDERER_VULKAN
+		case RendererType::Vulkan: m_renderer = defaultAllocator().create<VulkanRenderer>(); break;
+#endif
+#if YAE_IMPLEMENTS_RENDERER_OPENGL
+		case RendererType::OpenGL: m_renderer = defaultAllocator().create<OpenGLRenderer>(); break;
+#endif
+#if YAE_IMPLEMENTS_RENDERER_NULL
+		case RendererType::Null: m_renderer = defaultAllocator().create<NullRenderer>(); break;
 #endif
+		default: break;
+	}
+	YAE_ASSERT_MSGF(m_renderer != nullptr, "Renderer type %d is not implemented in this build", (int)m_rendererType);
 
 	u32 windowFlags = 0;
 	windowFlags |= m_renderer->getWindowFlags();
@@ -114,7 +140,7 @@ void Application::_start()
 	m_window = SDL_CreateWindow(m_name.c_str(), 0, 0, m_baseWidth, m_baseHeight, windowFlags);
 	YAE_ASSERT(m_window != nullptr);
 
-	YAE_VERBOSE_CAT("application", "Created window");
+	YAE_VERBOSE_CAT(application, "Created window");
 
 	// Init Input System
 	m_inputSystem = defaultAllocator().create<InputSystem>();
@@ -143,6 +169,11 @@ void Application::_start()
 			YAE_VERIFY(ImGui_ImplSDL2_InitForOpenGL(m_window, nullptr)); // context is not used in current imgui code
 		}
 		break;
+		case RendererType::Null:
+		{
+			YAE_VERIFY(ImGui_ImplSDL2_InitForOther(m_window));
+		}
+		break;
 	}
 
 	// Init renderer
@@ -198,7 +229,7 @@ void Application::_stop()
 
 	SDL_DestroyWindow(m_window);
 	m_window = nullptr;
-	YAE_VERBOSE_CAT("application", "Destroyed window");
+	YAE_VERBOSE_CAT(application, "Destroyed window");
 
 	m_resourceManager->flushResources();
 	defaultAllocator().destroy(m_resourceManager);
@@ -281,6 +312,7 @@ void Application::_doFrame()
 	}
 
 	_onUpdate(m_dt);
+	m_sceneSystem->updateSpatialIndex();
 
 	if (m_editor != nullptr)
 	{
@@ -344,17 +376,15 @@ Console& Application::console() const
 	return *m_console;
 }
 
-void* Application::getUserData(const char* _name) const
+void* Application::getUserData(StringHash _name) const
 {
-	StringHash hash = StringHash(_name);
-	void*const* userDataPointer = m_userData.get(hash);
+	void*const* userDataPointer = m_userData.get(_name);
 	return userDataPointer != nullptr ? *userDataPointer : nullptr;
 }
 
-void Application::setUserData(const char* _name, void* _userData)
+void Application::setUserData(StringHash _name, void* _userData)
 {
-	StringHash hash = StringHash(_name);
-	m_userData.set(hash, _userData);
+	m_userData.set(_name, _userData);
 }
 
 static String getSettingsFilePath(const Application* _app)
@@ -516,10 +546,21 @@ void Application::_registerConsoleCommands()
 			}
 		}
 	);
+#if YAE_TESTS
+	console().registerCommand("test.benchmark",
+		[](u32 _argc, const char** _argv)
+		{
+			engine().testSystem().runBenchmarks(_argc > 0 ? _argv[0] : "");
+		}
+	);
+#endif
 }
 
 void Application::_unregisterConsoleCommands()
 {
+#if YAE_TESTS
+	console().unregisterCommand("test.benchmark");
+#endif
 	console().unregisterCommand("app.window_size");
 	console().unregisterCommand("program.hotreload");
 }
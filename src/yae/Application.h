@@ -1,6 +1,7 @@
 #pragma once
 
 #include <yae/types.h>
+#include <yae/rendering/render_types.h>
 
 #include <core/containers/HashMap.h>
 #include <core/time.h>
@@ -31,6 +32,9 @@ public:
 	void start();
 	void stop();
 	void requestStop(); // if within the application update, this should be called instead of stop()
+
+	void setRendererType(RendererType _rendererType); // before start(), RendererType::Null runs without GPU
+	RendererType getRendererType() const;
 	void beforeReload();
 	void afterReload();
 
@@ -45,8 +49,9 @@ public:
 	SceneSystem& sceneSystem() const;
 	Console& console() const;
 
-	void* getUserData(const char* _name) const;
-	void setUserData(const char* _name, void* _userData);
+	// Names are usually literals, pass them as "name"_sh to hash them at compile time
+	void* getUserData(StringHash _name) const;
+	void setUserData(StringHash _name, void* _userData);
 
 	float getDeltaTime() const;
 	float getTime() const;
@@ -87,6 +92,7 @@ public:
 
 	ResourceManager* m_resourceManager = nullptr;
 	InputSystem* m_inputSystem = nullptr;
+	RendererType m_rendererType = RendererType::OpenGL;
 	Renderer* m_renderer = nullptr;
 	ImGuiContext* m_imguiContext = nullptr;
 	editor::Editor* m_editor = nullptr;
@@ -0,0 +1,572 @@
+#include "ComponentStorage.h"
+
+#include <core/hash.h>
+#include <core/memory.h>
+#include <core/serialization/serialization.h>
+#include <core/serialization/Serializer.h>
+
+namespace yae {
+
+static u32 alignUp(u32 _value, u32 _align)
+{
+	return (_value + _align - 1) / _align * _align;
+}
+
+// Archetype
+Archetype::Archetype(Allocator* _allocator)
+	: m_types(_allocator)
+	, m_components(_allocator)
+	, m_columnOffsets(_allocator)
+	, m_chunks(_allocator)
+	, m_addEdges(_allocator)
+	, m_removeEdges(_allocator)
+{
+}
+
+u32 Archetype::findComponentIndex(ComponentTypeID _type) const
+{
+	// @NOTE(remi): archetypes rarely hold more than a handful of components, a linear search is fine
+	for (u32 i = 0; i < m_types.size(); ++i)
+	{
+		if (m_types[i] == _type)
+			return i;
+	}
+	return INVALID_INDEX;
+}
+
+bool Archetype::hasComponents(const ComponentTypeID* _types, u32 _count) const
+{
+	for (u32 i = 0; i < _count; ++i)
+	{
+		if (findComponentIndex(_types[i]) == INVALID_INDEX)
+			return false;
+	}
+	return true;
+}
+
+u32 Archetype::getEntityCount() const
+{
+	return m_entityCount;
+}
+
+u32 Archetype::getChunkCount() const
+{
+	return m_chunks.size();
+}
+
+u32 Archetype::getChunkSize(u32 _chunkIndex) const
+{
+	return m_chunks[_chunkIndex].count;
+}
+
+PoolID* Archetype::getEntities(u32 _chunkIndex) const
+{
+	return (PoolID*)m_chunks[_chunkIndex].data;
+}
+
+void* Archetype::getColumn(u32 _chunkIndex, u32 _componentIndex) const
+{
+	return m_chunks[_chunkIndex].data + m_columnOffsets[_componentIndex];
+}
+
+void* Archetype::getComponent(u32 _row, u32 _componentIndex) const
+{
+	u32 chunkIndex = _row / m_chunkCapacity;
+	u32 chunkRow = _row % m_chunkCapacity;
+	return (u8*)getColumn(chunkIndex, _componentIndex) + chunkRow * m_components[_componentIndex].size;
+}
+
+// ComponentStorage
+ComponentStorage::ComponentStorage(Allocator* _allocator)
+	: m_allocator(_allocator != nullptr ? _allocator : &defaultAllocator())
+	, m_componentTypes(m_allocator)
+	, m_archetypes(m_allocator)
+	, m_archetypesBySignature(m_allocator)
+	, m_entityRecords(m_allocator)
+{
+	// The archetype 0 is always the empty one, entities without components live there
+	_findOrCreateArchetype(nullptr, 0);
+}
+
+ComponentStorage::~ComponentStorage()
+{
+	clear();
+
+	for (Archetype* archetype : m_archetypes)
+	{
+		m_allocator->destroy(archetype);
+	}
+	m_archetypes.clear();
+}
+
+void ComponentStorage::clear()
+{
+	YAE_ASSERT(m_iterationDepth == 0);
+
+	for (Archetype* archetype : m_archetypes)
+	{
+		for (u32 chunkIndex = 0; chunkIndex < archetype->m_chunks.size(); ++chunkIndex)
+		{
+			for (u32 componentIndex = 0; componentIndex < archetype->m_components.size(); ++componentIndex)
+			{
+				const ComponentType& type = archetype->m_components[componentIndex];
+				u8* column = (u8*)archetype->getColumn(chunkIndex, componentIndex);
+				for (u32 i = 0; i < archetype->m_chunks[chunkIndex].count; ++i)
+				{
+					type.destruct(column + i * type.size);
+				}
+			}
+			m_allocator->deallocate(archetype->m_chunks[chunkIndex].data);
+		}
+		archetype->m_chunks.clear();
+		archetype->m_entityCount = 0;
+	}
+
+	m_entityRecords.clear();
+	m_entityCount = 0;
+}
+
+const ComponentType* ComponentStorage::findComponentType(ComponentTypeID _type) const
+{
+	return m_componentTypes.get(_type);
+}
+
+const ComponentType* ComponentStorage::findComponentType(const char* _className) const
+{
+	for (const auto& entry : m_componentTypes)
+	{
+		if (entry.value.clss != nullptr && strcmp(entry.value.clss->getName(), _className) == 0)
+			return &entry.value;
+	}
+	return nullptr;
+}
+
+void ComponentStorage::addEntity(PoolID _entity)
+{
+	YAE_ASSERT(m_iterationDepth == 0);
+	YAE_ASSERT(_entity != INVALID_POOL_INDEX);
+
+	u32 index = extractIndexFromId(_entity);
+	if (index >= m_entityRecords.size())
+	{
+		m_entityRecords.resize(index + 1, EntityRecord());
+	}
+
+	EntityRecord& record = m_entityRecords[index];
+	YAE_ASSERT_MSG(record.id == INVALID_POOL_INDEX, "Entity slot is already in use");
+
+	record.id = _entity;
+	record.archetype = 0;
+	record.row = _pushRow(*m_archetypes[0], _entity);
+	++m_entityCount;
+}
+
+void ComponentStorage::removeEntity(PoolID _entity)
+{
+	YAE_ASSERT(m_iterationDepth == 0);
+
+	EntityRecord* record = _getRecord(_entity);
+	YAE_ASSERT(record != nullptr);
+
+	_removeRow(*m_archetypes[record->archetype], record->row, true);
+	*record = EntityRecord();
+	--m_entityCount;
+}
+
+bool ComponentStorage::hasEntity(PoolID _entity) const
+{
+	return _getRecord(_entity) != nullptr;
+}
+
+u32 ComponentStorage::getEntityCount() const
+{
+	return m_entityCount;
+}
+
+void* ComponentStorage::addComponent(PoolID _entity, ComponentTypeID _type)
+{
+	YAE_ASSERT(m_iterationDepth == 0);
+	YAE_ASSERT_MSG(m_componentTypes.has(_type), "Component type must be registered before being added");
+
+	EntityRecord* record = _getRecord(_entity);
+	YAE_ASSERT(record != nullptr);
+
+	u32 componentIndex = m_archetypes[record->archetype]->findComponentIndex(_type);
+	if (componentIndex == INVALID_INDEX)
+	{
+		_moveEntity(*record, _getArchetypeWith(record->archetype, _type));
+		componentIndex = m_archetypes[record->archetype]->findComponentIndex(_type);
+	}
+	return m_archetypes[record->archetype]->getComponent(record->row, componentIndex);
+}
+
+bool ComponentStorage::removeComponent(PoolID _entity, ComponentTypeID _type)
+{
+	YAE_ASSERT(m_iterationDepth == 0);
+
+	EntityRecord* record = _getRecord(_entity);
+	YAE_ASSERT(record != nullptr);
+
+	if (m_archetypes[record->archetype]->findComponentIndex(_type) == INVALID_INDEX)
+		return false;
+
+	_moveEntity(*record, _getArchetypeWithout(record->archetype, _type));
+	return true;
+}
+
+void* ComponentStorage::getComponent(PoolID _entity, ComponentTypeID _type) const
+{
+	const EntityRecord* record = _getRecord(_entity);
+	if (record == nullptr)
+		return nullptr;
+
+	const Archetype* archetype = m_archetypes[record->archetype];
+	u32 componentIndex = archetype->findComponentIndex(_type);
+	if (componentIndex == INVALID_INDEX)
+		return nullptr;
+
+	return archetype->getComponent(record->row, componentIndex);
+}
+
+bool ComponentStorage::hasComponent(PoolID _entity, ComponentTypeID _type) const
+{
+	const EntityRecord* record = _getRecord(_entity);
+	return record != nullptr && m_archetypes[record->archetype]->findComponentIndex(_type) != INVALID_INDEX;
+}
+
+u32 ComponentStorage::getComponentCount(PoolID _entity) const
+{
+	const EntityRecord* record = _getRecord(_entity);
+	return record != nullptr ? m_archetypes[record->archetype]->m_types.size() : 0;
+}
+
+void* ComponentStorage::getComponentAt(PoolID _entity, u32 _index, const ComponentType** _outType) const
+{
+	const EntityRecord* record = _getRecord(_entity);
+	YAE_ASSERT(record != nullptr);
+
+	const Archetype* archetype = m_archetypes[record->archetype];
+	YAE_ASSERT(_index < archetype->m_components.size());
+
+	if (_outType != nullptr)
+	{
+		*_outType = &archetype->m_components[_index];
+	}
+	return archetype->getComponent(record->row, _index);
+}
+
+bool ComponentStorage::serializeComponents(Serializer& _serializer, PoolID _entity, const char* _key)
+{
+	YAE_ASSERT(hasEntity(_entity));
+
+	if (_serializer.isWriting())
+	{
+		u32 componentCount = 0;
+		for (u32 i = 0; i < getComponentCount(_entity); ++i)
+		{
+			const ComponentType* type = nullptr;
+			getComponentAt(_entity, i, &type);
+			componentCount += type->clss != nullptr ? 1 : 0;
+		}
+
+		if (!_serializer.beginSerializeArray(componentCount, _key))
+			return false;
+
+		for (u32 i = 0; i < getComponentCount(_entity); ++i)
+		{
+			const ComponentType* type = nullptr;
+			void* component = getComponentAt(_entity, i, &type);
+			if (type->clss == nullptr)
+				continue;
+
+			String typeName(type->clss->getName(), &scratchAllocator());
+			if (!_serializer.beginSerializeObject())
+				return false;
+			if (!_serializer.serialize(typeName, "type"))
+				return false;
+			if (!serialization::serializeClassInstance(_serializer, component, type->clss, "data"))
+				return false;
+			if (!_serializer.endSerializeObject())
+				return false;
+		}
+
+		return _serializer.endSerializeArray();
+	}
+	else if (_serializer.isReading())
+	{
+		u32 componentCount = 0;
+		if (!_serializer.beginSerializeArray(componentCount, _key))
+			return false;
+
+		for (u32 i = 0; i < componentCount; ++i)
+		{
+			if (!_serializer.beginSerializeObject())
+				return false;
+
+			String typeName(&scratchAllocator());
+			if (!_serializer.serialize(typeName, "type"))
+				return false;
+
+			const ComponentType* typePtr = findComponentType(typeName.c_str());
+			if (typePtr == nullptr)
+			{
+				YAE_WARNINGF_CAT(scene, "Unknown component type \"%s\", skipping it.", typeName.c_str());
+			}
+			else
+			{
+				// addComponent may move the archetypes around, so keep a copy of the type
+				ComponentType type = *typePtr;
+				void* component = addComponent(_entity, type.typeID);
+				if (!serialization::serializeClassInstance(_serializer, component, type.clss, "data"))
+					return false;
+			}
+
+			if (!_serializer.endSerializeObject())
+				return false;
+		}
+
+		return _serializer.endSerializeArray();
+	}
+	return false;
+}
+
+u32 ComponentStorage::getArchetypeCount() const
+{
+	return m_archetypes.size();
+}
+
+const Archetype* ComponentStorage::getArchetype(u32 _index) const
+{
+	return m_archetypes[_index];
+}
+
+void ComponentStorage::_registerComponentType(const ComponentType& _type)
+{
+	YAE_ASSERT(_type.size > 0 && _type.size < YAE_COMPONENT_CHUNK_SIZE / 2);
+	YAE_ASSERT(_type.alignment > 0 && _type.alignment <= 128);
+	m_componentTypes.set(_type.typeID, _type);
+}
+
+const ComponentStorage::EntityRecord* ComponentStorage::_getRecord(PoolID _entity) const
+{
+	u32 index = extractIndexFromId(_entity);
+	if (index >= m_entityRecords.size())
+		return nullptr;
+
+	const EntityRecord& record = m_entityRecords[index];
+	return record.id == _entity ? &record : nullptr;
+}
+
+ComponentStorage::EntityRecord* ComponentStorage::_getRecord(PoolID _entity)
+{
+	return const_cast<EntityRecord*>(const_cast<const ComponentStorage*>(this)->_getRecord(_entity));
+}
+
+u32 ComponentStorage::_findOrCreateArchetype(const ComponentTypeID* _types, u32 _count)
+{
+	u32 signatureHash = _count > 0 ? hash::hash32(_types, _count * sizeof(*_types)) : 0;
+	const u32* archetypeIndexPtr = m_archetypesBySignature.get(signatureHash);
+	if (archetypeIndexPtr != nullptr)
+	{
+		const Archetype* archetype = m_archetypes[*archetypeIndexPtr];
+		if (archetype->m_types.size() == _count && (_count == 0 || memcmp(archetype->m_types.data(), _types, _count * sizeof(*_types)) == 0))
+			return *archetypeIndexPtr;
+
+		// Signature hash collision, fall back to a linear search
+		for (u32 i = 0; i < m_archetypes.size(); ++i)
+		{
+			archetype = m_archetypes[i];
+			if (archetype->m_types.size() == _count && (_count == 0 || memcmp(archetype->m_types.data(), _types, _count * sizeof(*_types)) == 0))
+				return i;
+		}
+	}
+
+	Archetype* archetype = m_allocator->create<Archetype>(m_allocator);
+	u32 bytesPerEntity = sizeof(PoolID);
+	u32 alignmentBudget = 0;
+	archetype->m_chunkAlignment = alignof(PoolID);
+	for (u32 i = 0; i < _count; ++i)
+	{
+		const ComponentType* type = m_componentTypes.get(_types[i]);
+		YAE_ASSERT(type != nullptr);
+		archetype->m_types.push_back(_types[i]);
+		archetype->m_components.push_back(*type);
+		bytesPerEntity += type->size;
+		alignmentBudget += type->alignment;
+		archetype->m_chunkAlignment = type->alignment > archetype->m_chunkAlignment ? type->alignment : archetype->m_chunkAlignment;
+	}
+
+	archetype->m_chunkCapacity = (YAE_COMPONENT_CHUNK_SIZE - alignmentBudget) / bytesPerEntity;
+	YAE_ASSERT(archetype->m_chunkCapacity > 0);
+
+	u32 offset = archetype->m_chunkCapacity * sizeof(PoolID);
+	for (u32 i = 0; i < _count; ++i)
+	{
+		const ComponentType& type = archetype->m_components[i];
+		offset = alignUp(offset, type.alignment);
+		archetype->m_columnOffsets.push_back(offset);
+		offset += archetype->m_chunkCapacity * type.size;
+	}
+	YAE_ASSERT(offset <= YAE_COMPONENT_CHUNK_SIZE);
+
+	u32 archetypeIndex = m_archetypes.size();
+	m_archetypes.push_back(archetype);
+	if (archetypeIndexPtr == nullptr)
+	{
+		m_archetypesBySignature.set(signatureHash, archetypeIndex);
+	}
+	return archetypeIndex;
+}
+
+u32 ComponentStorage::_getArchetypeWith(u32 _archetypeIndex, ComponentTypeID _type)
+{
+	const u32* edgePtr = m_archetypes[_archetypeIndex]->m_addEdges.get(_type);
+	if (edgePtr != nullptr)
+		return *edgePtr;
+
+	const Archetype* archetype = m_archetypes[_archetypeIndex];
+	DataArray<ComponentTypeID> types(&scratchAllocator());
+	types.reserve(archetype->m_types.size() + 1);
+	bool inserted = false;
+	for (ComponentTypeID type : archetype->m_types)
+	{
+		if (!inserted && _type < type)
+		{
+			types.push_back(_type);
+			inserted = true;
+		}
+		types.push_back(type);
+	}
+	if (!inserted)
+	{
+		types.push_back(_type);
+	}
+
+	u32 targetIndex = _findOrCreateArchetype(types.data(), types.size());
+	m_archetypes[_archetypeIndex]->m_addEdges.set(_type, targetIndex);
+	m_archetypes[targetIndex]->m_removeEdges.set(_type, _archetypeIndex);
+	return targetIndex;
+}
+
+u32 ComponentStorage::_getArchetypeWithout(u32 _archetypeIndex, ComponentTypeID _type)
+{
+	const u32* edgePtr = m_archetypes[_archetypeIndex]->m_removeEdges.get(_type);
+	if (edgePtr != nullptr)
+		return *edgePtr;
+
+	const Archetype* archetype = m_archetypes[_archetypeIndex];
+	DataArray<ComponentTypeID> types(&scratchAllocator());
+	types.reserve(archetype->m_types.size());
+	for (ComponentTypeID type : archetype->m_types)
+	{
+		if (type != _type)
+		{
+			types.push_back(type);
+		}
+	}
+
+	u32 targetIndex = _findOrCreateArchetype(types.data(), types.size());
+	m_archetypes[_archetypeIndex]->m_removeEdges.set(_type, targetIndex);
+	m_archetypes[targetIndex]->m_addEdges.set(_type, _archetypeIndex);
+	return targetIndex;
+}
+
+u32 ComponentStorage::_pushRow(Archetype& _archetype, PoolID _entity)
+{
+	if (_archetype.m_chunks.empty() || _archetype.m_chunks.back().count == _archetype.m_chunkCapacity)
+	{
+		ArchetypeChunk chunk;
+		chunk.data = (u8*)m_allocator->allocate(YAE_COMPONENT_CHUNK_SIZE, u8(_archetype.m_chunkAlignment));
+		chunk.count = 0;
+		_archetype.m_chunks.push_back(chunk);
+	}
+
+	u32 chunkIndex = _archetype.m_chunks.size() - 1;
+	ArchetypeChunk& chunk = _archetype.m_chunks[chunkIndex];
+	_archetype.getEntities(chunkIndex)[chunk.count] = _entity;
+	++chunk.count;
+	return _archetype.m_entityCount++;
+}
+
+void ComponentStorage::_removeRow(Archetype& _archetype, u32 _row, bool _destructComponents)
+{
+	YAE_ASSERT(_row < _archetype.m_entityCount);
+
+	u32 lastRow = _archetype.m_entityCount - 1;
+	for (u32 i = 0; i < _archetype.m_components.size(); ++i)
+	{
+		const ComponentType& type = _archetype.m_components[i];
+		void* component = _archetype.getComponent(_row, i);
+		if (_destructComponents)
+		{
+			type.destruct(component);
+		}
+		if (_row != lastRow)
+		{
+			type.move(component, _archetype.getComponent(lastRow, i));
+		}
+	}
+
+	// Swap the last entity in the removed slot
+	if (_row != lastRow)
+	{
+		u32 capacity = _archetype.m_chunkCapacity;
+		PoolID movedEntity = _archetype.getEntities(lastRow / capacity)[lastRow % capacity];
+		_archetype.getEntities(_row / capacity)[_row % capacity] = movedEntity;
+
+		EntityRecord* movedRecord = _getRecord(movedEntity);
+		YAE_ASSERT(movedRecord != nullptr);
+		movedRecord->row = _row;
+	}
+
+	ArchetypeChunk& lastChunk = _archetype.m_chunks.back();
+	--lastChunk.count;
+	--_archetype.m_entityCount;
+	if (lastChunk.count == 0)
+	{
+		m_allocator->deallocate(lastChunk.data);
+		_archetype.m_chunks.pop_back();
+	}
+}
+
+void ComponentStorage::_moveEntity(EntityRecord& _record, u32 _targetArchetype)
+{
+	Archetype& source = *m_archetypes[_record.archetype];
+	Archetype& target = *m_archetypes[_targetArchetype];
+
+	u32 sourceRow = _record.row;
+	u32 targetRow = _pushRow(target, _record.id);
+
+	// Move shared components, construct new ones
+	for (u32 i = 0; i < target.m_components.size(); ++i)
+	{
+		const ComponentType& type = target.m_components[i];
+		void* dst = target.getComponent(targetRow, i);
+		u32 sourceIndex = source.findComponentIndex(type.typeID);
+		if (sourceIndex != INVALID_INDEX)
+		{
+			type.move(dst, source.getComponent(sourceRow, sourceIndex));
+		}
+		else
+		{
+			type.construct(dst);
+		}
+	}
+
+	// Destruct the ones that are left behind
+	for (u32 i = 0; i < source.m_components.size(); ++i)
+	{
+		const ComponentType& type = source.m_components[i];
+		if (target.findComponentIndex(type.typeID) == INVALID_INDEX)
+		{
+			type.destruct(source.getComponent(sourceRow, i));
+		}
+	}
+
+	_removeRow(source, sourceRow, false);
+
+	_record.archetype = _targetArchetype;
+	_record.row = targetRow;
+}
+
+} // namespace yae
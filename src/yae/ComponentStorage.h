@@ -0,0 +1,188 @@
+#pragma once
+
+#include <yae/types.h>
+
+#include <core/containers/Array.h>
+#include <core/containers/HashMap.h>
+#include <core/containers/Pool.h>
+
+#include <mirror/mirror.h>
+
+#include <tuple>
+#include <utility>
+
+#define YAE_COMPONENT_CHUNK_SIZE (16 * 1024)
+
+namespace yae {
+
+class Serializer;
+class ComponentStorage;
+
+typedef mirror::TypeID ComponentTypeID;
+
+struct ComponentType
+{
+	ComponentTypeID typeID = mirror::UNDEFINED_TYPEID;
+	const mirror::Class* clss = nullptr; // may be null if the component is not reflected, it won't be serialized nor inspected then
+	u32 size = 0;
+	u32 alignment = 0;
+
+	void(*construct)(void* _dst) = nullptr;
+	void(*destruct)(void* _dst) = nullptr;
+	void(*move)(void* _dst, void* _src) = nullptr; // move constructs _dst from _src, then destructs _src
+};
+
+struct ArchetypeChunk
+{
+	u8* data = nullptr;
+	u32 count = 0;
+};
+
+// An archetype stores all the entities sharing the exact same set of components.
+// Entities are packed in fixed size chunks, each chunk laid out as one column per component (SoA):
+// [PoolID x capacity][Component0 x capacity][Component1 x capacity]...
+// All chunks but the last one are always full.
+class YAE_API Archetype
+{
+public:
+	Archetype(Allocator* _allocator);
+
+	u32 findComponentIndex(ComponentTypeID _type) const; // INVALID_INDEX if not found
+	bool hasComponents(const ComponentTypeID* _types, u32 _count) const;
+
+	u32 getEntityCount() const;
+	u32 getChunkCount() const;
+	u32 getChunkSize(u32 _chunkIndex) const;
+
+	PoolID* getEntities(u32 _chunkIndex) const;
+	void* getColumn(u32 _chunkIndex, u32 _componentIndex) const;
+	void* getComponent(u32 _row, u32 _componentIndex) const;
+
+//private:
+	DataArray<ComponentTypeID> m_types; // sorted
+	DataArray<ComponentType> m_components; // same order as m_types
+	DataArray<u32> m_columnOffsets;
+	u32 m_chunkCapacity = 0;
+	u32 m_chunkAlignment = 0;
+	u32 m_entityCount = 0;
+	DataArray<ArchetypeChunk> m_chunks;
+
+	// Cached archetype transitions
+	HashMap<ComponentTypeID, u32> m_addEdges;
+	HashMap<ComponentTypeID, u32> m_removeEdges;
+};
+
+// Iterates over every entity that owns at least all the queried components.
+// Matching archetypes are cached and refreshed incrementally when new archetypes appear.
+// The storage cannot be structurally modified (entities/components added or removed) while iterating.
+template <typename... Components>
+class ComponentQuery
+{
+	static_assert(sizeof...(Components) > 0, "A query needs at least one component");
+
+public:
+	ComponentQuery(ComponentStorage* _storage = nullptr, Allocator* _allocator = nullptr);
+
+	// _function(PoolID _entity, Components&... _components)
+	template <typename Function>
+	void forEach(Function&& _function);
+
+	// Same as forEach, but chunks are spread across the job system threads. _function must be thread safe.
+	template <typename Function>
+	void parallelForEach(Function&& _function);
+
+	u32 count();
+
+//private:
+	static const u32 COMPONENT_COUNT = sizeof...(Components);
+
+	void _updateArchetypes();
+	template <typename Function, size_t... I>
+	void _forEachInChunk(u32 _matchIndex, u32 _chunkIndex, Function& _function, std::index_sequence<I...>);
+
+	ComponentStorage* m_storage = nullptr;
+	ComponentTypeID m_types[COMPONENT_COUNT];
+	DataArray<u32> m_archetypes;
+	DataArray<u32> m_componentIndices; // COMPONENT_COUNT indices per matched archetype
+	u32 m_knownArchetypeCount = 0;
+};
+
+class YAE_API ComponentStorage
+{
+public:
+	ComponentStorage(Allocator* _allocator = nullptr);
+	~ComponentStorage();
+
+	void clear();
+
+	// Types
+	template <typename T>
+	ComponentTypeID registerComponentType();
+	const ComponentType* findComponentType(ComponentTypeID _type) const;
+	const ComponentType* findComponentType(const char* _className) const;
+
+	// Entities
+	void addEntity(PoolID _entity);
+	void removeEntity(PoolID _entity);
+	bool hasEntity(PoolID _entity) const;
+	u32 getEntityCount() const;
+
+	// Components
+	void* addComponent(PoolID _entity, ComponentTypeID _type); // default constructs the component, returns the existing one if any
+	bool removeComponent(PoolID _entity, ComponentTypeID _type);
+	void* getComponent(PoolID _entity, ComponentTypeID _type) const;
+	bool hasComponent(PoolID _entity, ComponentTypeID _type) const;
+	u32 getComponentCount(PoolID _entity) const;
+	void* getComponentAt(PoolID _entity, u32 _index, const ComponentType** _outType = nullptr) const;
+
+	template <typename T>
+	T& addComponent(PoolID _entity, const T& _value = T());
+	template <typename T>
+	bool removeComponent(PoolID _entity);
+	template <typename T>
+	T* getComponent(PoolID _entity) const;
+	template <typename T>
+	bool hasComponent(PoolID _entity) const;
+
+	// Queries
+	template <typename... Components>
+	ComponentQuery<Components...> query();
+
+	// Serializes all reflected components of an entity as an array of { "type": <class name>, "data": {...} }
+	bool serializeComponents(Serializer& _serializer, PoolID _entity, const char* _key = nullptr);
+
+	u32 getArchetypeCount() const;
+	const Archetype* getArchetype(u32 _index) const;
+
+//private:
+	struct EntityRecord
+	{
+		PoolID id = INVALID_POOL_INDEX;
+		u32 archetype = 0;
+		u32 row = 0;
+	};
+
+	void _registerComponentType(const ComponentType& _type);
+	const EntityRecord* _getRecord(PoolID _entity) const;
+	EntityRecord* _getRecord(PoolID _entity);
+
+	u32 _findOrCreateArchetype(const ComponentTypeID* _types, u32 _count);
+	u32 _getArchetypeWith(u32 _archetypeIndex, ComponentTypeID _type);
+	u32 _getArchetypeWithout(u32 _archetypeIndex, ComponentTypeID _type);
+
+	u32 _pushRow(Archetype& _archetype, PoolID _entity);
+	void _removeRow(Archetype& _archetype, u32 _row, bool _destructComponents);
+	void _moveEntity(EntityRecord& _record, u32 _targetArchetype);
+
+	Allocator* m_allocator = nullptr;
+	HashMap<ComponentTypeID, ComponentType> m_componentTypes;
+	DataArray<Archetype*> m_archetypes;
+	HashMap<u32, u32> m_archetypesBySignature;
+	DataArray<EntityRecord> m_entityRecords; // indexed by the PoolID index
+	u32 m_entityCount = 0;
+	u32 m_iterationDepth = 0;
+};
+
+} // namespace yae
+
+#include "ComponentStorage.inl"
@@ -0,0 +1,178 @@
+#include <core/JobSystem.h>
+
+#include <new>
+
+namespace yae {
+
+// ComponentQuery
+template <typename... Components>
+ComponentQuery<Components...>::ComponentQuery(ComponentStorage* _storage, Allocator* _allocator)
+	: m_storage(_storage)
+	, m_types{ mirror::GetTypeID<Components>()... }
+	, m_archetypes(_allocator)
+	, m_componentIndices(_allocator)
+{
+}
+
+template <typename... Components>
+template <typename Function>
+void ComponentQuery<Components...>::forEach(Function&& _function)
+{
+	YAE_ASSERT(m_storage != nullptr);
+	_updateArchetypes();
+
+	++m_storage->m_iterationDepth;
+	for (u32 matchIndex = 0; matchIndex < m_archetypes.size(); ++matchIndex)
+	{
+		const Archetype* archetype = m_storage->m_archetypes[m_archetypes[matchIndex]];
+		for (u32 chunkIndex = 0; chunkIndex < archetype->getChunkCount(); ++chunkIndex)
+		{
+			_forEachInChunk(matchIndex, chunkIndex, _function, std::index_sequence_for<Components...>{});
+		}
+	}
+	--m_storage->m_iterationDepth;
+}
+
+template <typename... Components>
+template <typename Function>
+void ComponentQuery<Components...>::parallelForEach(Function&& _function)
+{
+	YAE_ASSERT(m_storage != nullptr);
+	_updateArchetypes();
+
+	// Flatten the (archetype, chunk) pairs so that chunks can be dispatched as independent batches
+	struct ChunkRef
+	{
+		u32 matchIndex;
+		u32 chunkIndex;
+	};
+	DataArray<ChunkRef> chunks(&scratchAllocator());
+	for (u32 matchIndex = 0; matchIndex < m_archetypes.size(); ++matchIndex)
+	{
+		const Archetype* archetype = m_storage->m_archetypes[m_archetypes[matchIndex]];
+		for (u32 chunkIndex = 0; chunkIndex < archetype->getChunkCount(); ++chunkIndex)
+		{
+			chunks.push_back(ChunkRef{ matchIndex, chunkIndex });
+		}
+	}
+
+	++m_storage->m_iterationDepth;
+	jobSystem().parallelFor(chunks.size(), 1, [&](u32 _begin, u32 _end)
+	{
+		for (u32 i = _begin; i < _end; ++i)
+		{
+			_forEachInChunk(chunks[i].matchIndex, chunks[i].chunkIndex, _function, std::index_sequence_for<Components...>{});
+		}
+	});
+	--m_storage->m_iterationDepth;
+}
+
+template <typename... Components>
+u32 ComponentQuery<Components...>::count()
+{
+	YAE_ASSERT(m_storage != nullptr);
+	_updateArchetypes();
+
+	u32 result = 0;
+	for (u32 archetypeIndex : m_archetypes)
+	{
+		result += m_storage->m_archetypes[archetypeIndex]->getEntityCount();
+	}
+	return result;
+}
+
+template <typename... Components>
+void ComponentQuery<Components...>::_updateArchetypes()
+{
+	// Archetypes are never destroyed while the storage lives, so we only need to look at the new ones
+	for (u32 i = m_knownArchetypeCount; i < m_storage->m_archetypes.size(); ++i)
+	{
+		const Archetype* archetype = m_storage->m_archetypes[i];
+		if (!archetype->hasComponents(m_types, COMPONENT_COUNT))
+			continue;
+
+		m_archetypes.push_back(i);
+		for (u32 j = 0; j < COMPONENT_COUNT; ++j)
+		{
+			m_componentIndices.push_back(archetype->findComponentIndex(m_types[j]));
+		}
+	}
+	m_knownArchetypeCount = m_storage->m_archetypes.size();
+}
+
+template <typename... Components>
+template <typename Function, size_t... I>
+void ComponentQuery<Components...>::_forEachInChunk(u32 _matchIndex, u32 _chunkIndex, Function& _function, std::index_sequence<I...>)
+{
+	const Archetype* archetype = m_storage->m_archetypes[m_archetypes[_matchIndex]];
+	const u32* componentIndices = m_componentIndices.data() + _matchIndex * COMPONENT_COUNT;
+
+	const PoolID* entities = archetype->getEntities(_chunkIndex);
+	std::tuple<Components*...> columns((Components*)archetype->getColumn(_chunkIndex, componentIndices[I])...);
+
+	const u32 count = archetype->getChunkSize(_chunkIndex);
+	for (u32 i = 0; i < count; ++i)
+	{
+		_function(entities[i], std::get<I>(columns)[i]...);
+	}
+}
+
+// ComponentStorage
+template <typename T>
+ComponentTypeID ComponentStorage::registerComponentType()
+{
+	ComponentTypeID typeID = mirror::GetTypeID<T>();
+	if (m_componentTypes.has(typeID))
+		return typeID;
+
+	ComponentType type;
+	type.typeID = typeID;
+	type.clss = mirror::GetClass<T>();
+	type.size = sizeof(T);
+	type.alignment = alignof(T);
+	type.construct = [](void* _dst) { new (_dst) T(); };
+	type.destruct = [](void* _dst) { ((T*)_dst)->~T(); };
+	type.move = [](void* _dst, void* _src)
+	{
+		new (_dst) T(std::move(*(T*)_src));
+		((T*)_src)->~T();
+	};
+	_registerComponentType(type);
+	return typeID;
+}
+
+template <typename T>
+T& ComponentStorage::addComponent(PoolID _entity, const T& _value)
+{
+	ComponentTypeID typeID = registerComponentType<T>();
+	T* component = (T*)addComponent(_entity, typeID);
+	YAE_ASSERT(component != nullptr);
+	*component = _value;
+	return *component;
+}
+
+template <typename T>
+bool ComponentStorage::removeComponent(PoolID _entity)
+{
+	return removeComponent(_entity, mirror::GetTypeID<T>());
+}
+
+template <typename T>
+T* ComponentStorage::getComponent(PoolID _entity) const
+{
+	return (T*)getComponent(_entity, mirror::GetTypeID<T>());
+}
+
+template <typename T>
+bool ComponentStorage::hasComponent(PoolID _entity) const
+{
+	return hasComponent(_entity, mirror::GetTypeID<T>());
+}
+
+template <typename... Components>
+ComponentQuery<Components...> ComponentStorage::query()
+{
+	return ComponentQuery<Components...>(this, m_allocator);
+}
+
+} // namespace yae
@@ -16,24 +16,24 @@ namespace yae {
 
 void Console::init()
 {
-	YAE_VERBOSEF_CAT("console", "Initializing console...");
+	YAE_VERBOSEF_CAT(console, "Initializing console...");
 
 	logger().logged.bind(this, &Console::_onLog);
 
 	registerCommand("clear", [](u32, const char**) { console().clearLog(); });
 
-	YAE_VERBOSEF_CAT("console", "Console initialized");
+	YAE_VERBOSEF_CAT(console, "Console initialized");
 }
 
 void Console::shutdown()
 {
-	YAE_VERBOSEF_CAT("console", "Shutting down console...");
+	YAE_VERBOSEF_CAT(console, "Shutting down console...");
 
 	unregisterCommand("clear");
 
 	logger().logged.unbind(this, &Console::_onLog);
 
-	YAE_VERBOSEF_CAT("console", "Console shut down");
+	YAE_VERBOSEF_CAT(console, "Console shut down");
 }
 
 void Console::execute(const char* _command)
@@ -56,12 +56,12 @@ void Console::execute(const char* _command)
 	u32* commandIndexPtr = m_nameToCommand.get(commandHash);
 	if (commandIndexPtr != nullptr)
 	{
-		YAE_LOGF_CAT("console", "> %s", _command);
+		YAE_LOGF_CAT(console, "> %s", _command);
 		m_commands[*commandIndexPtr].callback(arguments.size(), arguments.data());
 	}
 	else
 	{
-		YAE_WARNINGF_CAT("console", "Unknown command: %s", command);
+		YAE_WARNINGF_CAT(console, "Unknown command: %s", command);
 	}
 }
 
@@ -93,7 +93,7 @@ void Console::unregisterCommand(const char* _name)
 	m_commands.erase(commandIndex);
 	for (u32 i = commandIndex; i < m_commands.size(); ++i)
 	{
-		StringHash commandHash = string::toLowerCase(m_commands[i].name);
+		StringHash commandHash = string::toLowerCase(m_commands[i].name.c_str());
 		m_nameToCommand[commandHash] = i;
 	}
 }
@@ -4,6 +4,7 @@
 
 #include <core/containers/Array.h>
 #include <core/containers/HashMap.h>
+#include <core/StringPool.h>
 
 struct ImGuiInputTextCallbackData;
 
@@ -34,7 +35,7 @@ public:
 
 	struct Command
 	{
-		String128 name;
+		InternedString name;
 		ConsoleCommand callback;
 	};
 	Array<Command> m_commands;
@@ -0,0 +1,207 @@
+#include "ContentHashDatabase.h"
+
+#include <core/filesystem.h>
+#include <core/hash.h>
+
+namespace yae {
+
+struct ContentHashFileHeader
+{
+	u32 magic;
+	u32 version;
+	u32 recordCount;
+	u32 padding;
+};
+
+struct ContentHashFileRecord
+{
+	u64 pathHash;
+	u64 size;
+	i64 writeTime;
+	u64 contentHash;
+};
+
+const u32 CONTENT_HASH_MAGIC = 0x48434159; // "YACH"
+const u32 CONTENT_HASH_VERSION = 1; // bump when the hash function changes
+
+ContentHashDatabase::ContentHashDatabase(Allocator* _allocator)
+	: m_records(_allocator)
+{
+
+}
+
+
+ContentHashDatabase::~ContentHashDatabase()
+{
+
+}
+
+
+bool ContentHashDatabase::load(const char* _path)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	m_records.clear();
+	m_isDirty = false;
+
+	FileReader reader(_path, &scratchAllocator());
+	if (!reader.load())
+		return false;
+
+	const ContentHashFileHeader* header = (const ContentHashFileHeader*)reader.getContent();
+	if (reader.getContentSize() < sizeof(ContentHashFileHeader)
+		|| header->magic != CONTENT_HASH_MAGIC
+		|| header->version != CONTENT_HASH_VERSION
+		|| reader.getContentSize() != sizeof(ContentHashFileHeader) + u64(header->recordCount) * sizeof(ContentHashFileRecord))
+	{
+		YAE_WARNINGF_CAT(resource, "Content hash database \"%s\" is invalid or out of date, every file will be hashed again", _path);
+		return false;
+	}
+
+	const ContentHashFileRecord* records = (const ContentHashFileRecord*)(header + 1);
+	m_records.reserve(header->recordCount);
+	for (u32 i = 0; i < header->recordCount; ++i)
+	{
+		FileRecord record;
+		record.size = records[i].size;
+		record.writeTime = records[i].writeTime;
+		record.contentHash = records[i].contentHash;
+		m_records.set(records[i].pathHash, record);
+	}
+
+	YAE_VERBOSEF_CAT(resource, "Loaded %d content hashes from \"%s\"", header->recordCount, _path);
+	return true;
+}
+
+
+bool ContentHashDatabase::save(const char* _path)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	if (!m_isDirty)
+		return true;
+
+	DataArray<u8> data(&scratchAllocator());
+	data.resize(sizeof(ContentHashFileHeader) + m_records.size() * sizeof(ContentHashFileRecord));
+
+	ContentHashFileHeader* header = (ContentHashFileHeader*)data.data();
+	header->magic = CONTENT_HASH_MAGIC;
+	header->version = CONTENT_HASH_VERSION;
+	header->recordCount = m_records.size();
+	header->padding = 0;
+
+	ContentHashFileRecord* record = (ContentHashFileRecord*)(header + 1);
+	for (const auto& entry : m_records)
+	{
+		record->pathHash = entry.key;
+		record->size = entry.value.size;
+		record->writeTime = entry.value.writeTime;
+		record->contentHash = entry.value.contentHash;
+		++record;
+	}
+
+	FileHandle file(_path);
+	if (!file.open(FileHandle::OPENMODE_WRITE) || !file.write(data.data(), data.size()))
+	{
+		YAE_ERRORF_CAT(resource, "Failed to write content hash database \"%s\"", _path);
+		return false;
+	}
+	file.close();
+
+	m_isDirty = false;
+	return true;
+}
+
+
+bool ContentHashDatabase::getContentHash(const char* _path, u64* _outHash)
+{
+	YAE_ASSERT(_outHash != nullptr);
+
+	u64 pathHash = _getPathHash(_path);
+	FileRecord* recordPtr = m_records.get(pathHash);
+
+	// Same size and write time, the content is assumed unchanged
+	u64 size = 0;
+	i64 writeTime = 0;
+	if (recordPtr != nullptr
+		&& filesystem::getFileStatus(_path, &size, &writeTime)
+		&& recordPtr->size == size
+		&& recordPtr->writeTime == writeTime)
+	{
+		*_outHash = recordPtr->contentHash;
+		return true;
+	}
+
+	FileRecord record;
+	if (!_hashFile(_path, &record))
+		return false;
+
+	m_records.set(pathHash, record);
+	m_isDirty = true;
+	*_outHash = record.contentHash;
+	return true;
+}
+
+
+bool ContentHashDatabase::updateContentHash(const char* _path)
+{
+	FileRecord record;
+	if (!_hashFile(_path, &record))
+	{
+		forgetFile(_path);
+		return true;
+	}
+
+	u64 pathHash = _getPathHash(_path);
+	FileRecord* recordPtr = m_records.get(pathHash);
+	bool hasChanged = recordPtr == nullptr || recordPtr->contentHash != record.contentHash;
+	m_records.set(pathHash, record);
+	m_isDirty = true;
+	return hasChanged;
+}
+
+
+void ContentHashDatabase::forgetFile(const char* _path)
+{
+	u64 pathHash = _getPathHash(_path);
+	if (m_records.has(pathHash))
+	{
+		m_records.remove(pathHash);
+		m_isDirty = true;
+	}
+}
+
+
+u32 ContentHashDatabase::getFileCount() const
+{
+	return m_records.size();
+}
+
+
+u64 ContentHashDatabase::_getPathHash(const char* _path)
+{
+	String path = filesystem::getAbsolutePath(_path);
+	return hash::hashString64(path.c_str());
+}
+
+
+bool ContentHashDatabase::_hashFile(const char* _path, FileRecord* _outRecord)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	// @NOTE(remi): the status is read before the content, a write in between makes the next check hash the file again
+	u64 size = 0;
+	i64 writeTime = 0;
+	filesystem::getFileStatus(_path, &size, &writeTime);
+
+	FileReader reader(_path, &scratchAllocator());
+	if (!reader.map(true)) // hashed entirely right away
+		return false;
+
+	_outRecord->size = reader.getContentSize();
+	_outRecord->writeTime = writeTime;
+	_outRecord->contentHash = hash::hash64(reader.getContent(), size_t(reader.getContentSize()));
+	return true;
+}
+
+} // namespace yae
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <yae/types.h>
+
+#include <core/containers/HashMap.h>
+
+namespace yae {
+
+// Content hashes of the source files, saved between runs.
+// A file is only read and hashed again when its size or write time changed, so touching a file or saving it
+// without changes does not count as a change.
+class YAE_API ContentHashDatabase
+{
+public:
+	ContentHashDatabase(Allocator* _allocator);
+	~ContentHashDatabase();
+
+	bool load(const char* _path);
+	bool save(const char* _path);
+
+	// Recorded hash of the file, hashed again if it changed on disk. false if the file can't be read.
+	bool getContentHash(const char* _path, u64* _outHash);
+	// Hashes the file again even if its write time did not change. Returns true if its content differs from the
+	// recorded one, or if it was not recorded yet.
+	bool updateContentHash(const char* _path);
+
+	void forgetFile(const char* _path);
+	u32 getFileCount() const;
+
+//private:
+	struct FileRecord
+	{
+		u64 size;
+		i64 writeTime;
+		u64 contentHash;
+	};
+
+	static u64 _getPathHash(const char* _path);
+	static bool _hashFile(const char* _path, FileRecord* _outRecord);
+
+	HashMap<u64, FileRecord> m_records;
+	bool m_isDirty = false;
+};
+
+} // namespace yae
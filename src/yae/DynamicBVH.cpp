@@ -0,0 +1,724 @@
+#include "DynamicBVH.h"
+
+#include <core/math.h>
+
+#include <algorithm>
+
+namespace yae {
+
+namespace {
+
+const u32 SAH_BIN_COUNT = 16;
+
+struct KNearestEntry
+{
+	float distanceSquared;
+	u32 node;
+	bool isResult;
+
+	// std heaps are max heaps, invert the comparison to pop the closest entry first
+	bool operator<(const KNearestEntry& _rhs) const { return distanceSquared > _rhs.distanceSquared; }
+};
+
+} // namespace
+
+DynamicBVH::DynamicBVH(Allocator* _allocator, float _margin)
+	: m_nodes(_allocator)
+	, m_margin(_margin)
+{
+}
+
+DynamicBVH::~DynamicBVH()
+{
+}
+
+void DynamicBVH::clear()
+{
+	m_nodes.clear();
+	m_root = INVALID_INDEX;
+	m_freeList = INVALID_INDEX;
+	m_proxyCount = 0;
+	m_referenceAreaRatio = 0.f;
+	m_modificationCount = 0;
+}
+
+u32 DynamicBVH::createProxy(const AABB& _bounds, u64 _userData)
+{
+	YAE_ASSERT(math::isValid(_bounds));
+
+	u32 proxy = _allocateNode();
+	Node& node = m_nodes[proxy];
+	node.leafBounds = _bounds;
+	node.bounds = math::inflate(_bounds, m_margin);
+	node.userData = _userData;
+	node.height = 0;
+
+	_insertLeaf(proxy);
+	++m_proxyCount;
+	return proxy;
+}
+
+void DynamicBVH::destroyProxy(u32 _proxy)
+{
+	YAE_ASSERT(_proxy < m_nodes.size() && m_nodes[_proxy].isLeaf() && m_nodes[_proxy].height == 0);
+
+	_removeLeaf(_proxy);
+	_freeNode(_proxy);
+	--m_proxyCount;
+}
+
+bool DynamicBVH::moveProxy(u32 _proxy, const AABB& _bounds)
+{
+	YAE_ASSERT(_proxy < m_nodes.size() && m_nodes[_proxy].height == 0);
+	YAE_ASSERT(math::isValid(_bounds));
+
+	Node& node = m_nodes[_proxy];
+	node.leafBounds = _bounds;
+
+	// Still inside its fat bounds, and the fat bounds are not unreasonably large (objects that shrank or teleported inside)
+	if (math::contains(node.bounds, _bounds) && math::contains(math::inflate(_bounds, 4.f * m_margin), node.bounds))
+		return false;
+
+	_removeLeaf(_proxy);
+	m_nodes[_proxy].bounds = math::inflate(_bounds, m_margin);
+	_insertLeaf(_proxy);
+	++m_modificationCount;
+	return true;
+}
+
+void DynamicBVH::setProxyBounds(u32 _proxy, const AABB& _bounds)
+{
+	YAE_ASSERT(_proxy < m_nodes.size() && m_nodes[_proxy].height == 0);
+	YAE_ASSERT(math::isValid(_bounds));
+
+	m_nodes[_proxy].leafBounds = _bounds;
+	++m_modificationCount;
+}
+
+const AABB& DynamicBVH::getBounds(u32 _proxy) const
+{
+	YAE_ASSERT(_proxy < m_nodes.size() && m_nodes[_proxy].height == 0);
+	return m_nodes[_proxy].leafBounds;
+}
+
+const AABB& DynamicBVH::getFatBounds(u32 _proxy) const
+{
+	YAE_ASSERT(_proxy < m_nodes.size() && m_nodes[_proxy].height == 0);
+	return m_nodes[_proxy].bounds;
+}
+
+u64 DynamicBVH::getUserData(u32 _proxy) const
+{
+	YAE_ASSERT(_proxy < m_nodes.size() && m_nodes[_proxy].height == 0);
+	return m_nodes[_proxy].userData;
+}
+
+u32 DynamicBVH::getProxyCount() const
+{
+	return m_proxyCount;
+}
+
+void DynamicBVH::refit()
+{
+	YAE_CAPTURE_FUNCTION();
+
+	if (m_root == INVALID_INDEX)
+		return;
+
+	// Iterative post-order traversal: a node is refreshed once both of its children are
+	u32 stack[YAE_BVH_STACK_SIZE];
+	u32 stackSize = 0;
+	u32 previous = INVALID_INDEX;
+	stack[stackSize++] = m_root;
+	while (stackSize > 0)
+	{
+		u32 nodeIndex = stack[stackSize - 1];
+		Node& node = m_nodes[nodeIndex];
+		if (node.isLeaf())
+		{
+			node.bounds = math::inflate(node.leafBounds, m_margin);
+			previous = nodeIndex;
+			--stackSize;
+		}
+		else if (previous == node.child2)
+		{
+			node.bounds = math::merge(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+			previous = nodeIndex;
+			--stackSize;
+		}
+		else
+		{
+			YAE_ASSERT_MSG(stackSize + 1 <= YAE_BVH_STACK_SIZE, "BVH traversal stack overflow");
+			stack[stackSize++] = previous == node.child1 ? node.child2 : node.child1;
+		}
+	}
+}
+
+void DynamicBVH::rebuild()
+{
+	YAE_CAPTURE_FUNCTION();
+
+	if (m_root == INVALID_INDEX)
+		return;
+
+	// Keep the leaves, they are the proxy ids, and give all the internal nodes back
+	DataArray<u32> leaves(m_nodes.allocator());
+	leaves.reserve(m_proxyCount);
+	for (u32 i = 0; i < m_nodes.size(); ++i)
+	{
+		Node& node = m_nodes[i];
+		if (node.height < 0)
+			continue;
+
+		if (node.isLeaf())
+		{
+			node.bounds = math::inflate(node.leafBounds, m_margin);
+			node.parent = INVALID_INDEX;
+			leaves.push_back(i);
+		}
+		else
+		{
+			_freeNode(i);
+		}
+	}
+	YAE_ASSERT(leaves.size() == m_proxyCount);
+
+	m_root = _buildTopDown(leaves.data(), leaves.size());
+	m_nodes[m_root].parent = INVALID_INDEX;
+
+	m_referenceAreaRatio = getAreaRatio();
+	m_modificationCount = 0;
+}
+
+bool DynamicBVH::optimize(float _maxDegradation)
+{
+	// Only worth measuring once a good part of the tree has been shuffled around
+	if (m_modificationCount == 0 || m_modificationCount < m_proxyCount / 4)
+		return false;
+
+	if (m_referenceAreaRatio > 0.f && getAreaRatio() <= m_referenceAreaRatio * _maxDegradation)
+	{
+		m_modificationCount = 0;
+		return false;
+	}
+
+	rebuild();
+	return true;
+}
+
+u32 DynamicBVH::getHeight() const
+{
+	if (m_root == INVALID_INDEX)
+		return 0;
+	return u32(m_nodes[m_root].height);
+}
+
+float DynamicBVH::getAreaRatio() const
+{
+	if (m_root == INVALID_INDEX)
+		return 0.f;
+
+	float rootArea = math::surfaceArea(m_nodes[m_root].bounds);
+	if (rootArea <= 0.f)
+		return 0.f;
+
+	float totalArea = 0.f;
+	for (const Node& node : m_nodes)
+	{
+		if (node.height <= 0)
+			continue;
+		totalArea += math::surfaceArea(node.bounds);
+	}
+	return totalArea / rootArea;
+}
+
+bool DynamicBVH::validate() const
+{
+	if (m_root == INVALID_INDEX)
+		return m_proxyCount == 0;
+
+	if (m_nodes[m_root].parent != INVALID_INDEX)
+		return false;
+
+	u32 freeCount = 0;
+	for (u32 i = m_freeList; i != INVALID_INDEX; i = m_nodes[i].parent)
+	{
+		++freeCount;
+	}
+	u32 leafCount = 0;
+	for (const Node& node : m_nodes)
+	{
+		if (node.height == 0)
+			++leafCount;
+	}
+	// A full binary tree has n - 1 internal nodes for n leaves
+	if (leafCount != m_proxyCount || freeCount + 2 * m_proxyCount - 1 != m_nodes.size())
+		return false;
+
+	return _validateNode(m_root);
+}
+
+u32 DynamicBVH::queryAABB(const AABB& _aabb, DataArray<u32>& _outProxies) const
+{
+	u32 previousSize = _outProxies.size();
+	queryAABB(_aabb, [&](u32 _proxy) { _outProxies.push_back(_proxy); });
+	return _outProxies.size() - previousSize;
+}
+
+u32 DynamicBVH::querySphere(const Sphere& _sphere, DataArray<u32>& _outProxies) const
+{
+	u32 previousSize = _outProxies.size();
+	querySphere(_sphere, [&](u32 _proxy) { _outProxies.push_back(_proxy); });
+	return _outProxies.size() - previousSize;
+}
+
+u32 DynamicBVH::queryFrustum(const Frustum& _frustum, DataArray<u32>& _outProxies) const
+{
+	u32 previousSize = _outProxies.size();
+	queryFrustum(_frustum, [&](u32 _proxy) { _outProxies.push_back(_proxy); });
+	return _outProxies.size() - previousSize;
+}
+
+u32 DynamicBVH::queryKNearest(const Vector3& _point, u32 _count, DataArray<u32>& _outProxies, float _maxDistance) const
+{
+	if (m_root == INVALID_INDEX || _count == 0)
+		return 0;
+
+	// Best-first search: node distances are lower bounds of their leaves distances, so exact leaf distances
+	// pushed back in the same heap come out in order.
+	const float maxDistanceSquared = _maxDistance < FLT_MAX ? _maxDistance * _maxDistance : FLT_MAX;
+	DataArray<KNearestEntry> heap(m_nodes.allocator());
+	heap.push_back(KNearestEntry{ math::distanceSquared(m_nodes[m_root].bounds, _point), m_root, false });
+
+	u32 found = 0;
+	while (!heap.empty() && found < _count)
+	{
+		std::pop_heap(heap.begin(), heap.end());
+		KNearestEntry entry = heap.back();
+		heap.pop_back();
+
+		if (entry.distanceSquared > maxDistanceSquared)
+			break;
+
+		const Node& node = m_nodes[entry.node];
+		if (entry.isResult)
+		{
+			_outProxies.push_back(entry.node);
+			++found;
+		}
+		else if (node.isLeaf())
+		{
+			heap.push_back(KNearestEntry{ math::distanceSquared(node.leafBounds, _point), entry.node, true });
+			std::push_heap(heap.begin(), heap.end());
+		}
+		else
+		{
+			heap.push_back(KNearestEntry{ math::distanceSquared(m_nodes[node.child1].bounds, _point), node.child1, false });
+			std::push_heap(heap.begin(), heap.end());
+			heap.push_back(KNearestEntry{ math::distanceSquared(m_nodes[node.child2].bounds, _point), node.child2, false });
+			std::push_heap(heap.begin(), heap.end());
+		}
+	}
+	return found;
+}
+
+bool DynamicBVH::raycast(const Ray& _ray, float _maxDistance, BVHRaycastHit& _outHit) const
+{
+	return raycast(_ray, _maxDistance, [](u32, float&) { return true; }, _outHit);
+}
+
+u32 DynamicBVH::_allocateNode()
+{
+	u32 nodeIndex;
+	if (m_freeList != INVALID_INDEX)
+	{
+		nodeIndex = m_freeList;
+		m_freeList = m_nodes[nodeIndex].parent;
+	}
+	else
+	{
+		nodeIndex = m_nodes.size();
+		m_nodes.push_back(Node());
+	}
+
+	Node& node = m_nodes[nodeIndex];
+	node.parent = INVALID_INDEX;
+	node.child1 = INVALID_INDEX;
+	node.child2 = INVALID_INDEX;
+	node.userData = 0;
+	node.height = 0;
+	return nodeIndex;
+}
+
+void DynamicBVH::_freeNode(u32 _node)
+{
+	Node& node = m_nodes[_node];
+	node.parent = m_freeList;
+	node.child1 = INVALID_INDEX;
+	node.child2 = INVALID_INDEX;
+	node.height = -1;
+	m_freeList = _node;
+}
+
+void DynamicBVH::_insertLeaf(u32 _leaf)
+{
+	if (m_root == INVALID_INDEX)
+	{
+		m_root = _leaf;
+		m_nodes[m_root].parent = INVALID_INDEX;
+		return;
+	}
+
+	// Find the best sibling by descending the tree with the surface area heuristic
+	AABB leafBounds = m_nodes[_leaf].bounds;
+	u32 index = m_root;
+	while (!m_nodes[index].isLeaf())
+	{
+		const Node& node = m_nodes[index];
+		const Node& child1 = m_nodes[node.child1];
+		const Node& child2 = m_nodes[node.child2];
+
+		float area = math::surfaceArea(node.bounds);
+		float combinedArea = math::surfaceArea(math::merge(node.bounds, leafBounds));
+
+		// Cost of creating a new parent for this node and the new leaf
+		float cost = 2.f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.f * (combinedArea - area);
+
+		float cost1 = math::surfaceArea(math::merge(leafBounds, child1.bounds)) + inheritanceCost;
+		if (!child1.isLeaf())
+			cost1 -= math::surfaceArea(child1.bounds);
+
+		float cost2 = math::surfaceArea(math::merge(leafBounds, child2.bounds)) + inheritanceCost;
+		if (!child2.isLeaf())
+			cost2 -= math::surfaceArea(child2.bounds);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+	u32 sibling = index;
+
+	// Create a new parent
+	u32 oldParent = m_nodes[sibling].parent;
+	u32 newParent = _allocateNode();
+	{
+		Node& parent = m_nodes[newParent];
+		parent.parent = oldParent;
+		parent.bounds = math::merge(leafBounds, m_nodes[sibling].bounds);
+		parent.height = m_nodes[sibling].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = _leaf;
+	}
+
+	if (oldParent != INVALID_INDEX)
+	{
+		Node& parent = m_nodes[oldParent];
+		if (parent.child1 == sibling)
+			parent.child1 = newParent;
+		else
+			parent.child2 = newParent;
+	}
+	else
+	{
+		m_root = newParent;
+	}
+	m_nodes[sibling].parent = newParent;
+	m_nodes[_leaf].parent = newParent;
+
+	_refreshAncestors(m_nodes[_leaf].parent);
+}
+
+void DynamicBVH::_removeLeaf(u32 _leaf)
+{
+	if (_leaf == m_root)
+	{
+		m_root = INVALID_INDEX;
+		return;
+	}
+
+	u32 parent = m_nodes[_leaf].parent;
+	u32 grandParent = m_nodes[parent].parent;
+	u32 sibling = m_nodes[parent].child1 == _leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	if (grandParent != INVALID_INDEX)
+	{
+		Node& grandParentNode = m_nodes[grandParent];
+		if (grandParentNode.child1 == parent)
+			grandParentNode.child1 = sibling;
+		else
+			grandParentNode.child2 = sibling;
+		m_nodes[sibling].parent = grandParent;
+		_freeNode(parent);
+
+		_refreshAncestors(grandParent);
+	}
+	else
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = INVALID_INDEX;
+		_freeNode(parent);
+	}
+	m_nodes[_leaf].parent = INVALID_INDEX;
+}
+
+u32 DynamicBVH::_balance(u32 _node)
+{
+	// Rotates the taller grandchild up when the two subtrees heights differ by more than one
+	u32 iA = _node;
+	Node& A = m_nodes[iA];
+	if (A.isLeaf() || A.height < 2)
+		return iA;
+
+	u32 iB = A.child1;
+	u32 iC = A.child2;
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+
+	i32 balance = C.height - B.height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		u32 iF = C.child1;
+		u32 iG = C.child2;
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		if (C.parent != INVALID_INDEX)
+		{
+			Node& parent = m_nodes[C.parent];
+			if (parent.child1 == iA)
+				parent.child1 = iC;
+			else
+				parent.child2 = iC;
+		}
+		else
+		{
+			m_root = iC;
+		}
+
+		if (F.height > G.height)
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.bounds = math::merge(B.bounds, G.bounds);
+			C.bounds = math::merge(A.bounds, F.bounds);
+			A.height = 1 + math::max(B.height, G.height);
+			C.height = 1 + math::max(A.height, F.height);
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.bounds = math::merge(B.bounds, F.bounds);
+			C.bounds = math::merge(A.bounds, G.bounds);
+			A.height = 1 + math::max(B.height, F.height);
+			C.height = 1 + math::max(A.height, G.height);
+		}
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		u32 iD = B.child1;
+		u32 iE = B.child2;
+		Node& D = m_nodes[iD];
+		Node& E = m_nodes[iE];
+
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		if (B.parent != INVALID_INDEX)
+		{
+			Node& parent = m_nodes[B.parent];
+			if (parent.child1 == iA)
+				parent.child1 = iB;
+			else
+				parent.child2 = iB;
+		}
+		else
+		{
+			m_root = iB;
+		}
+
+		if (D.height > E.height)
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.bounds = math::merge(C.bounds, E.bounds);
+			B.bounds = math::merge(A.bounds, D.bounds);
+			A.height = 1 + math::max(C.height, E.height);
+			B.height = 1 + math::max(A.height, D.height);
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.bounds = math::merge(C.bounds, D.bounds);
+			B.bounds = math::merge(A.bounds, E.bounds);
+			A.height = 1 + math::max(C.height, D.height);
+			B.height = 1 + math::max(A.height, E.height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+void DynamicBVH::_refreshAncestors(u32 _node)
+{
+	u32 index = _node;
+	while (index != INVALID_INDEX)
+	{
+		index = _balance(index);
+
+		Node& node = m_nodes[index];
+		const Node& child1 = m_nodes[node.child1];
+		const Node& child2 = m_nodes[node.child2];
+		node.height = 1 + math::max(child1.height, child2.height);
+		node.bounds = math::merge(child1.bounds, child2.bounds);
+
+		index = node.parent;
+	}
+}
+
+u32 DynamicBVH::_buildTopDown(u32* _leaves, u32 _count)
+{
+	YAE_ASSERT(_count > 0);
+	if (_count == 1)
+		return _leaves[0];
+
+	AABB bounds = AABB::EMPTY();
+	AABB centroidBounds = AABB::EMPTY();
+	for (u32 i = 0; i < _count; ++i)
+	{
+		const AABB& leafBounds = m_nodes[_leaves[i]].bounds;
+		bounds = math::merge(bounds, leafBounds);
+		centroidBounds = math::merge(centroidBounds, math::center(leafBounds));
+	}
+
+	Vector3 centroidSize = math::size(centroidBounds);
+	u32 axis = 0;
+	if (centroidSize.y > centroidSize[axis]) axis = 1;
+	if (centroidSize.z > centroidSize[axis]) axis = 2;
+
+	u32 splitIndex = _count / 2;
+	if (centroidSize[axis] > 0.f)
+	{
+		// Bin the centroids along the largest axis and pick the cheapest split plane
+		struct Bin
+		{
+			AABB bounds = AABB::EMPTY();
+			u32 count = 0;
+		};
+		Bin bins[SAH_BIN_COUNT];
+		const float binScale = float(SAH_BIN_COUNT) / centroidSize[axis];
+		const float axisMin = centroidBounds.min[axis];
+		auto computeBin = [&](u32 _leaf)
+		{
+			float centroid = math::center(m_nodes[_leaf].bounds)[axis];
+			return math::min(u32((centroid - axisMin) * binScale), SAH_BIN_COUNT - 1);
+		};
+
+		for (u32 i = 0; i < _count; ++i)
+		{
+			Bin& bin = bins[computeBin(_leaves[i])];
+			bin.bounds = math::merge(bin.bounds, m_nodes[_leaves[i]].bounds);
+			++bin.count;
+		}
+
+		float rightAreas[SAH_BIN_COUNT];
+		u32 rightCounts[SAH_BIN_COUNT];
+		AABB accumulatedBounds = AABB::EMPTY();
+		u32 accumulatedCount = 0;
+		for (u32 i = SAH_BIN_COUNT - 1; i > 0; --i)
+		{
+			accumulatedBounds = math::merge(accumulatedBounds, bins[i].bounds);
+			accumulatedCount += bins[i].count;
+			rightAreas[i] = accumulatedCount > 0 ? math::surfaceArea(accumulatedBounds) : 0.f;
+			rightCounts[i] = accumulatedCount;
+		}
+
+		float bestCost = FLT_MAX;
+		u32 bestSplit = 0;
+		accumulatedBounds = AABB::EMPTY();
+		accumulatedCount = 0;
+		for (u32 i = 0; i < SAH_BIN_COUNT - 1; ++i)
+		{
+			accumulatedBounds = math::merge(accumulatedBounds, bins[i].bounds);
+			accumulatedCount += bins[i].count;
+			if (accumulatedCount == 0 || rightCounts[i + 1] == 0)
+				continue;
+
+			float cost = math::surfaceArea(accumulatedBounds) * float(accumulatedCount) + rightAreas[i + 1] * float(rightCounts[i + 1]);
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = i;
+			}
+		}
+
+		if (bestCost < FLT_MAX)
+		{
+			u32* middle = std::partition(_leaves, _leaves + _count, [&](u32 _leaf) { return computeBin(_leaf) <= bestSplit; });
+			splitIndex = u32(middle - _leaves);
+		}
+		else
+		{
+			std::nth_element(_leaves, _leaves + splitIndex, _leaves + _count, [&](u32 _a, u32 _b)
+			{
+				return math::center(m_nodes[_a].bounds)[axis] < math::center(m_nodes[_b].bounds)[axis];
+			});
+		}
+	}
+	YAE_ASSERT(splitIndex > 0 && splitIndex < _count);
+
+	u32 child1 = _buildTopDown(_leaves, splitIndex);
+	u32 child2 = _buildTopDown(_leaves + splitIndex, _count - splitIndex);
+
+	u32 nodeIndex = _allocateNode();
+	Node& node = m_nodes[nodeIndex];
+	node.child1 = child1;
+	node.child2 = child2;
+	node.bounds = bounds;
+	node.height = 1 + math::max(m_nodes[child1].height, m_nodes[child2].height);
+	m_nodes[child1].parent = nodeIndex;
+	m_nodes[child2].parent = nodeIndex;
+	return nodeIndex;
+}
+
+bool DynamicBVH::_validateNode(u32 _node) const
+{
+	const Node& node = m_nodes[_node];
+	if (node.isLeaf())
+		return node.height == 0 && node.child2 == INVALID_INDEX && math::contains(node.bounds, node.leafBounds);
+
+	if (node.child2 == INVALID_INDEX)
+		return false;
+
+	const Node& child1 = m_nodes[node.child1];
+	const Node& child2 = m_nodes[node.child2];
+	if (child1.parent != _node || child2.parent != _node)
+		return false;
+	if (node.height != 1 + math::max(child1.height, child2.height))
+		return false;
+	if (!math::contains(node.bounds, child1.bounds) || !math::contains(node.bounds, child2.bounds))
+		return false;
+
+	return _validateNode(node.child1) && _validateNode(node.child2);
+}
+
+} // namespace yae
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/math/bounds.h>
+
+#include <core/containers/Array.h>
+#include <core/containers/Pool.h>
+
+#include <cfloat>
+
+#define YAE_BVH_STACK_SIZE 256
+
+namespace yae {
+
+struct BVHRaycastHit
+{
+	u32 proxy = INVALID_INDEX;
+	u64 userData = 0;
+	float distance = 0.f;
+};
+
+// Dynamic AABB tree, one leaf per proxy.
+// Leaves store the proxy exact bounds and a "fat" version inflated by a margin. Moving a proxy inside its fat bounds costs
+// nothing, otherwise the leaf is reinserted (SAH guided descent and AVL like rotations keep the tree balanced).
+// When a large part of the proxies moved, it is cheaper to update their bounds in place and call refit() or rebuild().
+// Proxy ids are leaf indices and stay valid until the proxy is destroyed, including across rebuilds.
+class YAE_API DynamicBVH
+{
+public:
+	DynamicBVH(Allocator* _allocator = nullptr, float _margin = .1f);
+	~DynamicBVH();
+
+	void clear();
+
+	// Proxies
+	u32 createProxy(const AABB& _bounds, u64 _userData = 0);
+	void destroyProxy(u32 _proxy);
+	bool moveProxy(u32 _proxy, const AABB& _bounds); // returns true if the proxy had to be reinserted
+	void setProxyBounds(u32 _proxy, const AABB& _bounds); // does not touch the tree, refit() or rebuild() must be called before querying
+
+	const AABB& getBounds(u32 _proxy) const;
+	const AABB& getFatBounds(u32 _proxy) const;
+	u64 getUserData(u32 _proxy) const;
+	u32 getProxyCount() const;
+
+	// Maintenance
+	void refit(); // recomputes every bounds bottom-up, keeping the topology
+	void rebuild(); // top-down binned SAH build of the whole tree
+	bool optimize(float _maxDegradation = 1.5f); // rebuilds if the tree quality degraded too much since the last build, returns true if it did
+
+	u32 getHeight() const;
+	float getAreaRatio() const; // sum of the internal nodes areas over the root area, lower is better
+	bool validate() const;
+
+	// Queries. Results are appended to the output arrays, they are tested against the proxies exact bounds.
+	u32 queryAABB(const AABB& _aabb, DataArray<u32>& _outProxies) const;
+	u32 querySphere(const Sphere& _sphere, DataArray<u32>& _outProxies) const;
+	u32 queryFrustum(const Frustum& _frustum, DataArray<u32>& _outProxies) const;
+	u32 queryKNearest(const Vector3& _point, u32 _count, DataArray<u32>& _outProxies, float _maxDistance = FLT_MAX) const; // sorted by distance
+	bool raycast(const Ray& _ray, float _maxDistance, BVHRaycastHit& _outHit) const; // closest proxy bounds hit
+
+	// _callback(u32 _proxy)
+	template <typename Callback>
+	void queryAABB(const AABB& _aabb, Callback&& _callback) const;
+	template <typename Callback>
+	void querySphere(const Sphere& _sphere, Callback&& _callback) const;
+	template <typename Callback>
+	void queryFrustum(const Frustum& _frustum, Callback&& _callback) const;
+
+	// _callback(u32 _proxy, float& _inOutDistance) -> bool
+	// Called for each proxy whose bounds are hit closer than the current closest hit, with the distance to the bounds.
+	// Return true to accept the hit, after optionally refining the distance with an exact test.
+	template <typename Callback>
+	bool raycast(const Ray& _ray, float _maxDistance, Callback&& _callback, BVHRaycastHit& _outHit) const;
+
+//private:
+	struct Node
+	{
+		AABB bounds; // fat bounds for leaves
+		AABB leafBounds; // exact bounds, leaves only
+		u64 userData = 0;
+		u32 parent = INVALID_INDEX; // next free node when in the free list
+		u32 child1 = INVALID_INDEX;
+		u32 child2 = INVALID_INDEX;
+		i32 height = -1; // 0 for leaves, -1 for free nodes
+
+		bool isLeaf() const { return child1 == INVALID_INDEX; }
+	};
+
+	u32 _allocateNode();
+	void _freeNode(u32 _node);
+	void _insertLeaf(u32 _leaf);
+	void _removeLeaf(u32 _leaf);
+	u32 _balance(u32 _node);
+	void _refreshAncestors(u32 _node);
+	u32 _buildTopDown(u32* _leaves, u32 _count);
+	bool _validateNode(u32 _node) const;
+
+	template <typename Callback>
+	void _collectLeaves(u32 _node, Callback& _callback) const;
+
+	DataArray<Node> m_nodes;
+	u32 m_root = INVALID_INDEX;
+	u32 m_freeList = INVALID_INDEX;
+	u32 m_proxyCount = 0;
+	float m_margin = .1f;
+
+	// Tree quality tracking
+	float m_referenceAreaRatio = 0.f;
+	u32 m_modificationCount = 0;
+};
+
+} // namespace yae
+
+#include "DynamicBVH.inl"
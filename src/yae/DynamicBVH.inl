@@ -0,0 +1,188 @@
+namespace yae {
+
+template <typename Callback>
+void DynamicBVH::queryAABB(const AABB& _aabb, Callback&& _callback) const
+{
+	if (m_root == INVALID_INDEX)
+		return;
+
+	u32 stack[YAE_BVH_STACK_SIZE];
+	u32 stackSize = 0;
+	stack[stackSize++] = m_root;
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if (!math::overlaps(node.bounds, _aabb))
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (math::overlaps(node.leafBounds, _aabb))
+			{
+				_callback(u32(&node - m_nodes.data()));
+			}
+		}
+		else
+		{
+			YAE_ASSERT_MSG(stackSize + 2 <= YAE_BVH_STACK_SIZE, "BVH traversal stack overflow");
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicBVH::querySphere(const Sphere& _sphere, Callback&& _callback) const
+{
+	if (m_root == INVALID_INDEX)
+		return;
+
+	u32 stack[YAE_BVH_STACK_SIZE];
+	u32 stackSize = 0;
+	stack[stackSize++] = m_root;
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if (!math::overlaps(node.bounds, _sphere))
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (math::overlaps(node.leafBounds, _sphere))
+			{
+				_callback(u32(&node - m_nodes.data()));
+			}
+		}
+		else
+		{
+			YAE_ASSERT_MSG(stackSize + 2 <= YAE_BVH_STACK_SIZE, "BVH traversal stack overflow");
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicBVH::queryFrustum(const Frustum& _frustum, Callback&& _callback) const
+{
+	if (m_root == INVALID_INDEX)
+		return;
+
+	u32 stack[YAE_BVH_STACK_SIZE];
+	u32 stackSize = 0;
+	stack[stackSize++] = m_root;
+	while (stackSize > 0)
+	{
+		u32 nodeIndex = stack[--stackSize];
+		const Node& node = m_nodes[nodeIndex];
+		math::FrustumTest result = math::test(_frustum, node.bounds);
+		if (result == math::FrustumTest::OUTSIDE)
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (result == math::FrustumTest::INSIDE || math::overlaps(_frustum, node.leafBounds))
+			{
+				_callback(nodeIndex);
+			}
+		}
+		else if (result == math::FrustumTest::INSIDE)
+		{
+			// The whole subtree is visible, no need to test anything further down
+			_collectLeaves(nodeIndex, _callback);
+		}
+		else
+		{
+			YAE_ASSERT_MSG(stackSize + 2 <= YAE_BVH_STACK_SIZE, "BVH traversal stack overflow");
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+}
+
+template <typename Callback>
+bool DynamicBVH::raycast(const Ray& _ray, float _maxDistance, Callback&& _callback, BVHRaycastHit& _outHit) const
+{
+	if (m_root == INVALID_INDEX)
+		return false;
+
+	Vector3 inverseDirection(1.f / _ray.direction.x, 1.f / _ray.direction.y, 1.f / _ray.direction.z);
+	float closestDistance = _maxDistance;
+	bool hasHit = false;
+
+	u32 stack[YAE_BVH_STACK_SIZE];
+	u32 stackSize = 0;
+	stack[stackSize++] = m_root;
+	while (stackSize > 0)
+	{
+		u32 nodeIndex = stack[--stackSize];
+		const Node& node = m_nodes[nodeIndex];
+
+		float distance;
+		if (!math::raycast(_ray, inverseDirection, node.bounds, closestDistance, distance))
+			continue;
+
+		if (node.isLeaf())
+		{
+			if (!math::raycast(_ray, inverseDirection, node.leafBounds, closestDistance, distance))
+				continue;
+
+			if (_callback(nodeIndex, distance) && distance <= closestDistance)
+			{
+				closestDistance = distance;
+				_outHit.proxy = nodeIndex;
+				_outHit.userData = node.userData;
+				_outHit.distance = distance;
+				hasHit = true;
+			}
+		}
+		else
+		{
+			// Push the farthest child first so that the closest one is visited first and shrinks the ray early
+			const Node& child1 = m_nodes[node.child1];
+			const Node& child2 = m_nodes[node.child2];
+			float distance1 = FLT_MAX;
+			float distance2 = FLT_MAX;
+			bool hit1 = math::raycast(_ray, inverseDirection, child1.bounds, closestDistance, distance1);
+			bool hit2 = math::raycast(_ray, inverseDirection, child2.bounds, closestDistance, distance2);
+
+			YAE_ASSERT_MSG(stackSize + 2 <= YAE_BVH_STACK_SIZE, "BVH traversal stack overflow");
+			if (distance1 < distance2)
+			{
+				if (hit2) stack[stackSize++] = node.child2;
+				if (hit1) stack[stackSize++] = node.child1;
+			}
+			else
+			{
+				if (hit1) stack[stackSize++] = node.child1;
+				if (hit2) stack[stackSize++] = node.child2;
+			}
+		}
+	}
+	return hasHit;
+}
+
+template <typename Callback>
+void DynamicBVH::_collectLeaves(u32 _node, Callback& _callback) const
+{
+	u32 stack[YAE_BVH_STACK_SIZE];
+	u32 stackSize = 0;
+	stack[stackSize++] = _node;
+	while (stackSize > 0)
+	{
+		u32 nodeIndex = stack[--stackSize];
+		const Node& node = m_nodes[nodeIndex];
+		if (node.isLeaf())
+		{
+			_callback(nodeIndex);
+		}
+		else
+		{
+			YAE_ASSERT_MSG(stackSize + 2 <= YAE_BVH_STACK_SIZE, "BVH traversal stack overflow");
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+}
+
+} // namespace yae
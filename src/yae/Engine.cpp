@@ -9,6 +9,7 @@
 #include <yae/resource.h>
 #include <yae/Application.h>
 #include <yae/FileWatchSystem.h>
+#include <yae/ContentHashDatabase.h>
 #if YAE_TESTS
 #include <yae/test/TestSystem.h>
 #endif
@@ -78,6 +79,12 @@ void Engine::init()
 		m_fileWatchSystem->init();
 	}
 
+	{
+		YAE_ASSERT(m_contentHashDatabase == nullptr);
+		m_contentHashDatabase = defaultAllocator().create<ContentHashDatabase>(&defaultAllocator());
+		m_contentHashDatabase->load(_getContentHashDatabasePath().c_str());
+	}
+
 	m_isInitialized = true;
 }
 
@@ -86,6 +93,12 @@ void Engine::shutdown()
 	YAE_ASSERT(m_isInitialized);
 	m_isInitialized = false;
 
+	{
+		m_contentHashDatabase->save(_getContentHashDatabasePath().c_str());
+		defaultAllocator().destroy(m_contentHashDatabase);
+		m_contentHashDatabase = nullptr;
+	}
+
 	{
 		m_fileWatchSystem->shutdown();
 		defaultAllocator().destroy(m_fileWatchSystem);
@@ -170,6 +183,8 @@ void Engine::update()
 	YAE_ASSERT(m_isInitialized);
 	DataArray<Application*> tempApplications(m_applications, &scratchAllocator());
 
+	m_fileWatchSystem->update();
+
 	// Events
 	{
 		auto getWindowId = [](const SDL_Event& _event)
@@ -224,7 +239,7 @@ void Engine::update()
 		SDL_Event event;
 		while (SDL_PollEvent(&event))
 		{
-			YAE_VERBOSEF_CAT("SDL", "SDL event -> type=0x%04x time=%d", event.type, event.common.timestamp);
+			YAE_VERBOSEF_CAT(SDL, "SDL event -> type=0x%04x time=%d", event.type, event.common.timestamp);
 
 			u32 windowId = getWindowId(event);
 			for (Application* application : tempApplications)
@@ -276,6 +291,25 @@ FileWatchSystem& Engine::fileWatchSystem()
 	return *m_fileWatchSystem;
 }
 
+ContentHashDatabase& Engine::contentHashDatabase()
+{
+	YAE_ASSERT(m_contentHashDatabase != nullptr);
+	return *m_contentHashDatabase;
+}
+
+String Engine::_getContentHashDatabasePath() const
+{
+	return string::format("%scontent_hashes.bin", program().getIntermediateDirectory());
+}
+
+#if YAE_TESTS
+TestSystem& Engine::testSystem()
+{
+	YAE_ASSERT(m_testSystem != nullptr);
+	return *m_testSystem;
+}
+#endif
+
 bool Engine::serializeSettings(yae::Serializer& _serializer)
 {
 	u32 applicationCount = m_applications.size();
@@ -7,6 +7,7 @@ namespace yae {
 
 class TestSystem;
 class FileWatchSystem;
+class ContentHashDatabase;
 
 class YAE_API Engine
 {
@@ -25,15 +26,22 @@ public:
 
 	Application* currentApplication();
 	FileWatchSystem& fileWatchSystem();
+	ContentHashDatabase& contentHashDatabase();
+#if YAE_TESTS
+	TestSystem& testSystem();
+#endif
 
 	bool serializeSettings(yae::Serializer& _serializer);
 
 //private:
+	String _getContentHashDatabasePath() const;
+
 	DataArray<Application*> m_applications;
 	DataArray<Application*> m_applicationStack;
 
 	TestSystem* m_testSystem = nullptr;
 	FileWatchSystem* m_fileWatchSystem = nullptr;
+	ContentHashDatabase* m_contentHashDatabase = nullptr;
 	
 	bool m_isInitialized = false;
 
@@ -1,9 +1,23 @@
 #include "FileWatchSystem.h"
 
 #include <core/filesystem.h>
+#include <core/hash.h>
 
-#define YAE_FILEWATCH_ENABLED (YAE_PLATFORM_WINDOWS == 1)
-#if YAE_FILEWATCH_ENABLED
+// Not part of the engine build, which only targets Windows and web
+#if defined(__linux__) && YAE_PLATFORM_WEB == 0
+#define YAE_FILEWATCH_INOTIFY 1
+#else
+#define YAE_FILEWATCH_INOTIFY 0
+#endif
+
+#define YAE_FILEWATCH_ENABLED (YAE_PLATFORM_WINDOWS == 1 || YAE_FILEWATCH_INOTIFY == 1)
+#if YAE_FILEWATCH_INOTIFY
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif YAE_FILEWATCH_ENABLED
 #include <FileWatch/FileWatch.hpp>
 #endif
 
@@ -11,14 +25,174 @@
 
 namespace yae {
 
+// Changes closer than this are merged, editors and tools often write a file in several steps
+static const float DEBOUNCE_DELAY_MS = 100.f;
+
+static bool IsCreation(FileChangeType _changeType)
+{
+	return _changeType == FileChangeType::ADDED || _changeType == FileChangeType::RENAMED_NEW;
+}
+
+FileWatchSystem::EventQueue::EventQueue()
+	: m_pushCursor(0)
+	, m_popCursor(0)
+{
+	for (u32 i = 0; i < CAPACITY; ++i)
+	{
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+bool FileWatchSystem::EventQueue::push(const Event& _event)
+{
+	Cell* cell = nullptr;
+	u32 position = m_pushCursor.load(std::memory_order_relaxed);
+	while (true)
+	{
+		cell = &m_cells[position & (CAPACITY - 1)];
+		i32 difference = i32(cell->sequence.load(std::memory_order_acquire) - position);
+		if (difference == 0)
+		{
+			if (m_pushCursor.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			position = m_pushCursor.load(std::memory_order_relaxed);
+		}
+	}
+
+	cell->event = _event;
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+bool FileWatchSystem::EventQueue::pop(Event& _outEvent)
+{
+	u32 position = m_popCursor.load(std::memory_order_relaxed);
+	Cell& cell = m_cells[position & (CAPACITY - 1)];
+	if (i32(cell.sequence.load(std::memory_order_acquire) - (position + 1)) < 0)
+		return false;
+
+	_outEvent = cell.event;
+	cell.sequence.store(position + CAPACITY, std::memory_order_release);
+	m_popCursor.store(position + 1, std::memory_order_relaxed);
+	return true;
+}
+
 void FileWatchSystem::init()
 {
+#if YAE_FILEWATCH_INOTIFY
+	m_inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_inotifyDescriptor < 0)
+	{
+		YAE_ERRORF_CAT(filewatch, "Failed to initialize inotify (errno %d)", errno);
+		return;
+	}
+	YAE_VERIFY(pipe(m_wakePipe) == 0);
 
+	_startWatchThread();
+#endif
 }
 
 void FileWatchSystem::shutdown()
 {
 	YAE_ASSERT(m_fileWatchers.size() == 0);
+
+#if YAE_FILEWATCH_INOTIFY
+	_stopWatchThread();
+
+	if (m_inotifyDescriptor >= 0)
+	{
+		close(m_wakePipe[0]);
+		close(m_wakePipe[1]);
+		close(m_inotifyDescriptor);
+		m_wakePipe[0] = m_wakePipe[1] = m_inotifyDescriptor = -1;
+	}
+#endif
+
+	m_pendingEvents.clear();
+}
+
+void FileWatchSystem::update()
+{
+	YAE_CAPTURE_FUNCTION();
+
+	Time now = time::now();
+
+	// Merge the new changes into the pending ones
+	Event event;
+	while (m_events.pop(event))
+	{
+		PendingEvent* pendingEventPtr = m_pendingEvents.find([](const PendingEvent& _pendingEvent, void* _data)
+		{
+			return _pendingEvent.fileId == ((Event*)_data)->fileId;
+		}, &event);
+
+		if (pendingEventPtr == nullptr)
+		{
+			FileWatcher** fileWatcherPtr = m_fileWatchers.get(StringHash(event.fileId));
+
+			PendingEvent pendingEvent;
+			pendingEvent.fileId = event.fileId;
+			pendingEvent.changeType = event.changeType;
+			pendingEvent.lastChangeTime = now;
+			pendingEvent.existedBefore = fileWatcherPtr != nullptr ? (*fileWatcherPtr)->exists : !IsCreation(event.changeType);
+			m_pendingEvents.push_back(pendingEvent);
+			continue;
+		}
+
+		// The notified change is computed from the state before the burst and the last change, once it settled
+		pendingEventPtr->changeType = event.changeType;
+		pendingEventPtr->lastChangeTime = now;
+	}
+
+	u32 droppedEventCount = m_droppedEventCount.exchange(0);
+	if (droppedEventCount > 0)
+	{
+		YAE_WARNINGF_CAT(filewatch, "%d file changes were dropped, the event queue is full", droppedEventCount);
+	}
+
+	// Notify the changes that settled
+	for (u32 i = 0; i < m_pendingEvents.size();)
+	{
+		PendingEvent pendingEvent = m_pendingEvents[i];
+		if ((now - pendingEvent.lastChangeTime).asMilliSeconds() < DEBOUNCE_DELAY_MS)
+		{
+			++i;
+			continue;
+		}
+		m_pendingEvents.erase(i);
+
+		// The watcher may have been stopped in the meantime
+		FileWatcher** fileWatcherPtr = m_fileWatchers.get(StringHash(pendingEvent.fileId));
+		if (fileWatcherPtr == nullptr)
+			continue;
+
+		// Editors often save by deleting and recreating the file, or by renaming a temporary file over it
+		FileWatcher* fileWatcher = *fileWatcherPtr;
+		bool existsAfter = pendingEvent.changeType != FileChangeType::REMOVED && pendingEvent.changeType != FileChangeType::RENAMED_OLD;
+		FileChangeType changeType = pendingEvent.changeType;
+		if (pendingEvent.existedBefore && existsAfter)
+		{
+			changeType = FileChangeType::MODIFIED;
+		}
+		else if (!pendingEvent.existedBefore && existsAfter && changeType == FileChangeType::MODIFIED)
+		{
+			changeType = FileChangeType::ADDED; // created then written
+		}
+		else if (!pendingEvent.existedBefore && !existsAfter)
+		{
+			continue; // created then removed, nothing changed
+		}
+
+		fileWatcher->exists = existsAfter;
+		fileWatcher->fileChangedFunction(fileWatcher->filePath.c_str(), changeType, fileWatcher->userData);
+	}
 }
 
 void FileWatchSystem::startFileWatcher(const char* _filePath, FileWatchFunction _onFileChangedFunction, void* _userData)
@@ -34,6 +208,7 @@ void FileWatchSystem::startFileWatcher(const char* _filePath, FileWatchFunction
 	fileWatcher->filePath = _filePath;
 	fileWatcher->fileChangedFunction = _onFileChangedFunction;
 	fileWatcher->userData = _userData;
+	fileWatcher->id = id.getHash();
 	m_fileWatchers.set(id, fileWatcher);
 
 	_startFileWatch(fileWatcher);
@@ -54,18 +229,27 @@ void FileWatchSystem::stopFileWatcher(const char* _filePath)
 
 void FileWatchSystem::pauseAllWatchers()
 {
+#if YAE_FILEWATCH_INOTIFY
+	// @NOTE(remi): the directory watches are kept, changes made in the meantime are read when resuming
+	_stopWatchThread();
+#else
 	for (auto pair : m_fileWatchers)
 	{
 		_stopFileWatch(pair.value);
 	}
+#endif
 }
 
 void FileWatchSystem::resumeAllWatchers()
 {
+#if YAE_FILEWATCH_INOTIFY
+	_startWatchThread();
+#else
 	for (auto pair : m_fileWatchers)
 	{
 		_startFileWatch(pair.value);
 	}
+#endif
 }
 
 void FileWatchSystem::_startFileWatch(FileWatcher* _fileWatcher)
@@ -75,14 +259,49 @@ void FileWatchSystem::_startFileWatch(FileWatcher* _fileWatcher)
 #if YAE_FILEWATCH_ENABLED
 	if (!filesystem::doesPathExists(_fileWatcher->filePath.c_str()))
 	{
-		YAE_ERRORF_CAT("filewatch", "Can't start filewatch on \"%s\": path does not exists", _fileWatcher->filePath.c_str());
+		YAE_ERRORF_CAT(filewatch, "Can't start filewatch on \"%s\": path does not exists", _fileWatcher->filePath.c_str());
 		_fileWatcher->fileWatch = nullptr;
 		return;
 	}
+#endif
+
+#if YAE_FILEWATCH_INOTIFY
+	if (m_inotifyDescriptor < 0)
+		return;
+
+	String fileName(filesystem::getFileName(_fileWatcher->filePath.c_str()), &scratchAllocator());
+	String directory(&scratchAllocator());
+	if (fileName.size() < _fileWatcher->filePath.size())
+	{
+		directory = filesystem::getDirectory(_fileWatcher->filePath.c_str());
+	}
+	else
+	{
+		directory = "./";
+	}
+
+	// Watches are per directory, adding the same directory again returns its existing watch
+	const u32 mask = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+	i32 directoryWatch = inotify_add_watch(m_inotifyDescriptor, directory.c_str(), mask);
+	if (directoryWatch < 0)
+	{
+		YAE_ERRORF_CAT(filewatch, "Can't start filewatch on \"%s\": failed to watch \"%s\" (errno %d)", _fileWatcher->filePath.c_str(), directory.c_str(), errno);
+		return;
+	}
+	_fileWatcher->directoryWatch = directoryWatch;
 
+	DirectoryFile directoryFile;
+	directoryFile.directoryWatch = directoryWatch;
+	directoryFile.fileNameHash = hash::hashString(fileName.c_str());
+	directoryFile.fileId = _fileWatcher->id;
+
+	std::lock_guard<std::mutex> lock(m_directoryFilesMutex);
+	m_directoryFiles.push_back(directoryFile);
+#elif YAE_FILEWATCH_ENABLED
+	u32 fileId = _fileWatcher->id;
 	_fileWatcher->fileWatch = defaultAllocator().create<filewatch::FileWatch<std::string>>(
 		_fileWatcher->filePath.c_str(),
-		[_fileWatcher](const std::string& _path, const filewatch::Event _changeType)
+		[this, fileId](const std::string& _path, const filewatch::Event _changeType)
 		{
 			FileChangeType changeType;
 			switch(_changeType)
@@ -94,7 +313,7 @@ void FileWatchSystem::_startFileWatch(FileWatcher* _fileWatcher)
 			case filewatch::Event::renamed_new: changeType = FileChangeType::RENAMED_NEW; break;
 			}
 
-			_fileWatcher->fileChangedFunction(_path.c_str(), changeType, _fileWatcher->userData);
+			_pushEvent(fileId, changeType);
 		}
 	);
 #else
@@ -106,7 +325,32 @@ void FileWatchSystem::_stopFileWatch(FileWatcher* _fileWatcher)
 {
 	YAE_ASSERT(_fileWatcher != nullptr);
 
-#if YAE_FILEWATCH_ENABLED
+#if YAE_FILEWATCH_INOTIFY
+	if (_fileWatcher->directoryWatch < 0)
+		return;
+
+	bool isDirectoryWatched = false;
+	{
+		std::lock_guard<std::mutex> lock(m_directoryFilesMutex);
+		for (u32 i = 0; i < m_directoryFiles.size();)
+		{
+			const DirectoryFile& directoryFile = m_directoryFiles[i];
+			if (directoryFile.fileId == _fileWatcher->id)
+			{
+				m_directoryFiles.erase(i);
+				continue;
+			}
+			isDirectoryWatched = isDirectoryWatched || directoryFile.directoryWatch == _fileWatcher->directoryWatch;
+			++i;
+		}
+	}
+
+	if (!isDirectoryWatched)
+	{
+		inotify_rm_watch(m_inotifyDescriptor, _fileWatcher->directoryWatch);
+	}
+	_fileWatcher->directoryWatch = -1;
+#elif YAE_FILEWATCH_ENABLED
 	auto watcher = (filewatch::FileWatch<std::string>*)_fileWatcher->fileWatch;
 	if (watcher != nullptr)
 	{
@@ -118,4 +362,99 @@ void FileWatchSystem::_stopFileWatch(FileWatcher* _fileWatcher)
 #endif
 }
 
+void FileWatchSystem::_pushEvent(u32 _fileId, FileChangeType _changeType)
+{
+	Event event;
+	event.fileId = _fileId;
+	event.changeType = _changeType;
+	if (!m_events.push(event))
+	{
+		m_droppedEventCount.fetch_add(1);
+	}
+}
+
+void FileWatchSystem::_startWatchThread()
+{
+#if YAE_FILEWATCH_INOTIFY
+	if (m_inotifyDescriptor < 0)
+		return;
+
+	YAE_ASSERT(m_watchThread == nullptr);
+	m_watchThread = defaultAllocator().create<std::thread>(&FileWatchSystem::_watchThreadMain, this);
+#endif
+}
+
+void FileWatchSystem::_stopWatchThread()
+{
+#if YAE_FILEWATCH_INOTIFY
+	if (m_watchThread == nullptr)
+		return;
+
+	char wake = 0;
+	YAE_VERIFY(write(m_wakePipe[1], &wake, 1) == 1);
+	m_watchThread->join();
+	defaultAllocator().destroy(m_watchThread);
+	m_watchThread = nullptr;
+	YAE_VERIFY(read(m_wakePipe[0], &wake, 1) == 1);
+#endif
+}
+
+void FileWatchSystem::_watchThreadMain()
+{
+#if YAE_FILEWATCH_INOTIFY
+	alignas(inotify_event) char buffer[16 * 1024];
+	pollfd descriptors[2];
+	descriptors[0].fd = m_inotifyDescriptor;
+	descriptors[0].events = POLLIN;
+	descriptors[1].fd = m_wakePipe[0];
+	descriptors[1].events = POLLIN;
+
+	while (true)
+	{
+		if (poll(descriptors, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+
+		// Stop requested
+		if (descriptors[1].revents != 0)
+			return;
+
+		ssize_t readSize = read(m_inotifyDescriptor, buffer, sizeof(buffer));
+		if (readSize <= 0)
+			continue;
+
+		std::lock_guard<std::mutex> lock(m_directoryFilesMutex);
+		for (ssize_t offset = 0; offset < readSize;)
+		{
+			const inotify_event* event = (const inotify_event*)(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			// Events on the directory itself have no name
+			if (event->len == 0)
+				continue;
+
+			FileChangeType changeType;
+			if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE)) changeType = FileChangeType::MODIFIED;
+			else if (event->mask & IN_CREATE) changeType = FileChangeType::ADDED;
+			else if (event->mask & IN_DELETE) changeType = FileChangeType::REMOVED;
+			else if (event->mask & IN_MOVED_FROM) changeType = FileChangeType::RENAMED_OLD;
+			else if (event->mask & IN_MOVED_TO) changeType = FileChangeType::RENAMED_NEW;
+			else continue;
+
+			u32 fileNameHash = hash::hashString(event->name);
+			for (const DirectoryFile& directoryFile : m_directoryFiles)
+			{
+				if (directoryFile.directoryWatch == event->wd && directoryFile.fileNameHash == fileNameHash)
+				{
+					_pushEvent(directoryFile.fileId, changeType);
+				}
+			}
+		}
+	}
+#endif
+}
+
 } // namespace yae
@@ -3,6 +3,11 @@
 #include <yae/types.h>
 
 #include <core/containers/HashMap.h>
+#include <core/time.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace yae {
 
@@ -17,11 +22,19 @@ enum class FileChangeType : u8
 
 typedef void(*FileWatchFunction)(const char*, FileChangeType, void*);
 
+// Changes are detected on watch threads and queued, update() calls the watcher functions on the main thread.
+// Bursts of changes on a file are merged into one call, made once the file has not changed for a short delay. The call
+// reports the net change: a file that existed before the burst and still exists after it is MODIFIED, whatever steps
+// the burst was made of (deleted and recreated, renamed over...).
+// On Windows, each watched file has its own thread. On Linux, every watched file is handled by a single thread watching
+// their directories with inotify. @NOTE(remi): the engine build has no Linux target yet, so the inotify backend is not
+// built nor tested by it.
 class YAE_API FileWatchSystem
 {
 public:
 	void init();
 	void shutdown();
+	void update();
 
 	void startFileWatcher(const char* _filePath, FileWatchFunction _onFileChangedFunction, void* _userData = nullptr);
 	void stopFileWatcher(const char* _filePath);
@@ -37,13 +50,76 @@ public:
 		FileWatchFunction fileChangedFunction = nullptr;
 		void* userData = nullptr;
 		void* fileWatch = nullptr;
+		u32 id = 0; // hash of filePath
+		bool exists = true; // as of the last notified change, watched files must exist when the watch starts
+		i32 directoryWatch = -1; // inotify
+	};
+
+	struct Event
+	{
+		u32 fileId;
+		FileChangeType changeType;
+	};
+
+	struct PendingEvent
+	{
+		u32 fileId;
+		FileChangeType changeType; // last change of the burst
+		Time lastChangeTime;
+		bool existedBefore; // whether the file existed when the burst started
+	};
+
+	// Bounded lock-free queue, watch threads push and the main thread pops
+	class EventQueue
+	{
+	public:
+		static const u32 CAPACITY = 1024; // power of two
+
+		EventQueue();
+
+		bool push(const Event& _event); // false if the queue is full
+		bool pop(Event& _outEvent);
+
+	//private:
+		struct Cell
+		{
+			std::atomic<u32> sequence;
+			Event event;
+		};
+
+		Cell m_cells[CAPACITY];
+		std::atomic<u32> m_pushCursor;
+		std::atomic<u32> m_popCursor;
+	};
+
+	// File watched in an inotify directory watch
+	struct DirectoryFile
+	{
+		i32 directoryWatch;
+		u32 fileNameHash;
+		u32 fileId;
 	};
 
 	void _startFileWatch(FileWatcher* _fileWatcher);
 	void _stopFileWatch(FileWatcher* _fileWatcher);
+	void _pushEvent(u32 _fileId, FileChangeType _changeType); // watch threads
+
+	void _startWatchThread();
+	void _stopWatchThread();
+	void _watchThreadMain();
 
 	HashMap<StringHash, FileWatcher*> m_fileWatchers;
 
+	EventQueue m_events;
+	std::atomic<u32> m_droppedEventCount{ 0 };
+	DataArray<PendingEvent> m_pendingEvents;
+
+	// inotify
+	i32 m_inotifyDescriptor = -1;
+	i32 m_wakePipe[2] = { -1, -1 };
+	std::thread* m_watchThread = nullptr;
+	std::mutex m_directoryFilesMutex;
+	DataArray<DirectoryFile> m_directoryFiles; // guarded by m_directoryFilesMutex
 };
 
 } // namespace
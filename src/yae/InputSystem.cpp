@@ -12,7 +12,7 @@ void InputSystem::init(SDL_Window* _window)
 
 	m_window = _window;
 
-	YAE_VERBOSE_CAT("input", "Initialized Input System");
+	YAE_VERBOSE_CAT(input, "Initialized Input System");
 }
 
 void InputSystem::beginFrame()
@@ -110,14 +110,14 @@ void InputSystem::processEvent(const SDL_Event& _event)
 
 			YAE_VERIFY(SDL_GameControllerOpen(index) != nullptr);
 
-			YAE_LOGF_CAT("input", "Controller \"%s\" connected (index=%d instanceId=%d)", name, index, instanceId);
+			YAE_LOGF_CAT(input, "Controller \"%s\" connected (index=%d instanceId=%d)", name, index, instanceId);
 		}
 		break;
 
 		case SDL_CONTROLLERDEVICEREMAPPED:
 		{
 			SDL_JoystickID instanceId = _event.cdevice.which;
-			YAE_LOGF_CAT("input", "Controller remapped (instanceId=%d)", instanceId);
+			YAE_LOGF_CAT(input, "Controller remapped (instanceId=%d)", instanceId);
 			YAE_ASSERT_MSG(false, "What does remapping means ?");
 		}
 		break;
@@ -141,7 +141,7 @@ void InputSystem::processEvent(const SDL_Event& _event)
 			memset(m_gamepadStates[index].buttonStates, 0, sizeof(m_gamepadStates[index].buttonStates));
 			memset(m_gamepadStates[index].axisStates, 0, sizeof(m_gamepadStates[index].axisStates));
 
-			YAE_LOGF_CAT("input", "Controller \"%s\" disconnected (index=%d instanceId=%d)", name, index, instanceId);
+			YAE_LOGF_CAT(input, "Controller \"%s\" disconnected (index=%d instanceId=%d)", name, index, instanceId);
 		}
 		break;
 
@@ -176,7 +176,7 @@ void InputSystem::shutdown()
 {
 	YAE_CAPTURE_FUNCTION();
 
-	YAE_VERBOSE_CAT("input", "Shutdown Input System");
+	YAE_VERBOSE_CAT(input, "Shutdown Input System");
 }
 
 bool InputSystem::wasKeyJustPressed(int _key) const
@@ -439,7 +439,7 @@ void InputSystem::_notifyKeyEvent(int _scancode, int _action, int _mods)
         keyState.down = false;
     }
 
-	YAE_VERBOSEF_CAT("input", "key event: %d, %d, %d", _scancode, _action, _mods);
+	YAE_VERBOSEF_CAT(input, "key event: %d, %d, %d", _scancode, _action, _mods);
 }
 
 void InputSystem::_notifyMouseButtonEvent(MouseButton _button, int _action, int _mods)
@@ -458,7 +458,7 @@ void InputSystem::_notifyMouseButtonEvent(MouseButton _button, int _action, int
         buttonState.down = false;
     }
 
-	YAE_VERBOSEF_CAT("input", "mouse button event: %d, %d, %d", _button, _action, _mods);
+	YAE_VERBOSEF_CAT(input, "mouse button event: %d, %d, %d", _button, _action, _mods);
 }
 
 
@@ -466,7 +466,7 @@ void InputSystem::_notifyMouseScrollEvent(double _xOffset, double _yOffset)
 {
 	m_mouseScrollDelta = Vector2(float(_xOffset), float(_yOffset));
 
-	YAE_VERBOSEF_CAT("input", "mouse scroll event: %.2f, %.2f", _xOffset, _yOffset);
+	YAE_VERBOSEF_CAT(input, "mouse scroll event: %.2f, %.2f", _xOffset, _yOffset);
 }
 
 void InputSystem::_notifyMouseMotionEvent(int _x, int _xDelta, int _y, int _yDelta)
@@ -476,7 +476,7 @@ void InputSystem::_notifyMouseMotionEvent(int _x, int _xDelta, int _y, int _yDel
 	m_mouseYAxis.delta += _yDelta;
 	m_mouseYAxis.value = _y;
 
-	YAE_VERBOSEF_CAT("input", "mouse motion event: pos:%d,%d / movement:%d,%d", _x, _y, _xDelta, _yDelta);
+	YAE_VERBOSEF_CAT(input, "mouse motion event: pos:%d,%d / movement:%d,%d", _x, _y, _xDelta, _yDelta);
 }
 
 void InputSystem::_notifyGamepadButtonEvent(GamepadID _gamepadId, GamepadButton _button, int _action)
@@ -496,7 +496,7 @@ void InputSystem::_notifyGamepadButtonEvent(GamepadID _gamepadId, GamepadButton
         buttonState.down = false;
     }
 
-	YAE_VERBOSEF_CAT("input", "gamepad button event: id=%d button=%d, action=%d", _gamepadId, _button, _action);	
+	YAE_VERBOSEF_CAT(input, "gamepad button event: id=%d button=%d, action=%d", _gamepadId, _button, _action);	
 }
 
 void InputSystem::_notifyGamepadAxisEvent(GamepadID _gamepadId, GamepadAxis _axis, float _value)
@@ -509,7 +509,7 @@ void InputSystem::_notifyGamepadAxisEvent(GamepadID _gamepadId, GamepadAxis _axi
 	axisState.delta = _value - axisState.value;
 	axisState.value = _value;
 
-	YAE_VERBOSEF_CAT("input", "gamepad axis event: id=%d axis=%d, value=%.3f", _gamepadId, _axis, _value);	
+	YAE_VERBOSEF_CAT(input, "gamepad axis event: id=%d axis=%d, value=%.3f", _gamepadId, _axis, _value);	
 }
 
 } // namespace yae
@@ -4,11 +4,13 @@
 #include <core/time.h>
 #include <core/hash.h>
 #include <core/filesystem.h>
+#include <core/IOService.h>
 
 #include <yae/resources/Resource.h>
 #include <yae/resource.h>
 #include <yae/Engine.h>
 #include <yae/FileWatchSystem.h>
+#include <yae/ContentHashDatabase.h>
 
 namespace yae {
 
@@ -31,20 +33,47 @@ void ResourceManager::gatherResources(const char* _path)
 {
 	String path = String(filesystem::normalizePath(_path), &scratchAllocator());
 
-	YAE_VERBOSEF_CAT("resource", "Gathering resources inside \"%s\"...", path.c_str());
+	YAE_VERBOSEF_CAT(resource, "Gathering resources inside \"%s\"...", path.c_str());
 
-	filesystem::walkDirectory(path.c_str(), [](const filesystem::Entry& _entry, void* _userData)
+	// Gather the resource files that are not registered yet
+	Array<String> filePaths(&scratchAllocator());
 	{
-		String extension(filesystem::getExtension(_entry.path.c_str()), &scratchAllocator());
-		if (strcmp(extension.c_str(), "res") == 0)
+		Array<filesystem::Entry> entries(&scratchAllocator());
+		filesystem::parseDirectoryContent(path.c_str(), entries, true, filesystem::EntryType_File);
+		for (const filesystem::Entry& entry : entries)
 		{
-			resource::findOrCreateFromFile(_entry.path.c_str());
+			if (strcmp(filesystem::getExtension(entry.path.c_str()).c_str(), "res") != 0)
+				continue;
+
+			String filePath(filesystem::getAbsolutePath(entry.path.c_str()), &scratchAllocator());
+			if (findResource(filePath.c_str()) == nullptr)
+			{
+				filePaths.push_back(filePath);
+			}
 		}
-		return true;
 	}
-	, true, filesystem::EntryType_File);
 
-	YAE_VERBOSEF_CAT("resource", "Gathering done.");
+	// Read them all at once, then create the resources
+	IOBatch batch(&scratchAllocator(), 256 * 1024);
+	for (const String& filePath : filePaths)
+	{
+		batch.addRead(filePath.c_str());
+	}
+	ioService().submit(batch);
+	ioService().wait(batch);
+
+	for (u32 i = 0; i < batch.getRequestCount(); ++i)
+	{
+		const IOReadRequest& request = batch.getRequest(i);
+		if (request.status != IOStatus::DONE)
+		{
+			YAE_ERRORF_CAT(resource, "Failed to read \"%s\"", request.path);
+			continue;
+		}
+		resource::findOrCreateFromFileData(request.path, request.data, size_t(request.size));
+	}
+
+	YAE_VERBOSEF_CAT(resource, "Gathering done.");
 }
 
 void ResourceManager::registerResource(const char* _name, Resource* _resource)
@@ -53,13 +82,12 @@ void ResourceManager::registerResource(const char* _name, Resource* _resource)
 	YAE_ASSERT(_resource->m_manager == nullptr);
 	YAE_ASSERT(std::find(m_resources.begin(), m_resources.end(), _resource) == m_resources.end());
 
-	YAE_VERIFY(string::safeCopyToBuffer(_resource->m_name, _name, countof(_resource->m_name)) < countof(_resource->m_name));
+	_resource->m_name = _name;
 
 	// Register by name
 	{
-		StringHash nameHash = StringHash(_resource->m_name);	
-		YAE_ASSERT(m_resourcesByName.get(nameHash) == nullptr);
-		m_resourcesByName.set(nameHash, _resource);	
+		YAE_ASSERT(m_resourcesByName.get(_resource->m_name) == nullptr);
+		m_resourcesByName.set(_resource->m_name, _resource);
 	}
 	
 	// Register by id
@@ -98,7 +126,7 @@ void ResourceManager::registerResource(const char* _name, Resource* _resource)
 	_resource->m_manager = this;
 
 	m_resources.push_back(_resource);
-	YAE_VERBOSEF_CAT("resource", "Registered \"%s\"(%s)...", _resource->m_name, _resource->getClass()->getName());
+	YAE_VERBOSEF_CAT(resource, "Registered \"%s\"(%s)...", _resource->getName(), _resource->getClass()->getName());
 }
 
 void ResourceManager::unregisterResource(Resource* _resource)
@@ -131,9 +159,8 @@ void ResourceManager::unregisterResource(Resource* _resource)
 
 	// unregister by name
 	{
-		StringHash nameHash = StringHash(_resource->m_name);	
-		YAE_ASSERT(m_resourcesByName.get(nameHash) != nullptr);
-		m_resourcesByName.remove(nameHash);
+		YAE_ASSERT(m_resourcesByName.get(_resource->m_name) != nullptr);
+		m_resourcesByName.remove(_resource->m_name);
 	}
 
 	// unregister by id
@@ -142,14 +169,18 @@ void ResourceManager::unregisterResource(Resource* _resource)
 		m_resourcesByID.remove(_resource->getID());
 	}
 
-	YAE_VERBOSEF_CAT("resource", "Unregistered \"%s\"...", _resource->m_name);
-	_resource->m_name[0] = 0;
+	YAE_VERBOSEF_CAT(resource, "Unregistered \"%s\"...", _resource->getName());
+	_resource->m_name = InternedString();
 }
 
 Resource* ResourceManager::findResource(const char* _name) const
 {
-	StringHash id = StringHash(_name);
-	Resource*const* resourcePtr = m_resourcesByName.get(id);
+	// Names of registered resources are always interned
+	InternedString name = InternedString::Find(_name);
+	if (name.isEmpty())
+		return nullptr;
+
+	Resource*const* resourcePtr = m_resourcesByName.get(name);
 	if (resourcePtr == nullptr)
 		return nullptr;
 
@@ -204,7 +235,10 @@ void ResourceManager::flagResourceForReload(Resource* _resource)
 	YAE_ASSERT(_resource->m_manager == this);
 
 	m_resourcesToReloadMutex.lock();
-	m_resourcesToReload.push_back(_resource);
+	if (m_resourcesToReload.find(_resource) == nullptr)
+	{
+		m_resourcesToReload.push_back(_resource);
+	}
 	m_resourcesToReloadMutex.unlock();
 }
 
@@ -212,9 +246,16 @@ static void OnFileChanged(const char* _filePath, FileChangeType _changeType, voi
 {
 	if (_changeType == FileChangeType::MODIFIED)
 	{
+		// Touched or saved without changes
+		if (!engine().contentHashDatabase().updateContentHash(_filePath))
+		{
+			YAE_VERBOSEF_CAT(resource, "\"%s\" written without changes, reload skipped.", _filePath);
+			return;
+		}
+
 		Resource* resource = (Resource*)_userData;
 		resource->requestReload();
-		YAE_VERBOSEF_CAT("resource", "\"%s\" modified.", _filePath);
+		YAE_VERBOSEF_CAT(resource, "\"%s\" modified.", _filePath);
 	}
 }
 
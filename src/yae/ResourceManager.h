@@ -3,6 +3,7 @@
 #include <yae/types.h>
 #include <yae/resources/ResourceID.h>
 #include <core/containers/HashMap.h>
+#include <core/StringPool.h>
 
 #include <mirror/mirror.h>
 
@@ -51,7 +52,7 @@ public:
 	void _processReloadDependencies();
 
 	DataArray<Resource*> m_resources;
-	HashMap<StringHash, Resource*> m_resourcesByName;
+	HashMap<InternedString, Resource*> m_resourcesByName;
 	HashMap<ResourceID, Resource*> m_resourcesByID;
 	mutable HashMap<mirror::TypeID, DataArray<Resource*>> m_resourcesByType;
 
@@ -201,11 +201,54 @@ void SceneGraphNode::setWorldMatrix(const Matrix4& _matrix)
 void SceneGraphNode::setLocalMatrix(const Matrix4& _matrix)
 {
 	yae::math::decompose(_matrix, m_localTransform.position, m_localTransform.rotation, m_localTransform.scale);
+	_setWorldTransformDirty();
+}
+
+void SceneGraphNode::setLocalBounds(const AABB& _bounds)
+{
+	YAE_ASSERT(math::isValid(_bounds));
+	m_localBounds = _bounds;
+	sceneSystem()._updateSpatialProxy(*this);
+}
+
+void SceneGraphNode::clearLocalBounds()
+{
+	m_localBounds = AABB::EMPTY();
+	sceneSystem()._updateSpatialProxy(*this);
+}
+
+bool SceneGraphNode::hasBounds() const
+{
+	return math::isValid(m_localBounds);
+}
+
+const AABB& SceneGraphNode::getLocalBounds() const
+{
+	return m_localBounds;
+}
+
+AABB SceneGraphNode::getWorldBounds() const
+{
+	if (!hasBounds())
+		return AABB::EMPTY();
+
+	return math::transform(m_localBounds, getWorldMatrix());
+}
+
+u32 SceneGraphNode::getSpatialProxy() const
+{
+	return m_spatialProxy;
 }
 
 void SceneGraphNode::_setWorldTransformDirty()
 {
 	m_isWorldTransformDirty = true;
+	if (m_spatialProxy != INVALID_INDEX && !m_isSpatialProxyDirty)
+	{
+		m_isSpatialProxyDirty = true;
+		sceneSystem()._flagSpatialProxyDirty(m_id);
+	}
+
 	for (ID<SceneGraphNode> childID : m_children)
 	{
 		SceneGraphNode* child = childID.get();
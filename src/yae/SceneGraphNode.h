@@ -2,6 +2,7 @@
 
 #include <yae/types.h>
 #include <yae/ID.h>
+#include <yae/math/bounds.h>
 
 #include <core/containers/Pool.h>
 
@@ -42,6 +43,14 @@ public:
 	void setWorldMatrix(const Matrix4& _matrix);
 	void setLocalMatrix(const Matrix4& _matrix);
 
+	// Bounds are expressed in local space. Nodes with bounds are tracked by the scene system spatial index.
+	void setLocalBounds(const AABB& _bounds);
+	void clearLocalBounds();
+	bool hasBounds() const;
+	const AABB& getLocalBounds() const;
+	AABB getWorldBounds() const;
+	u32 getSpatialProxy() const; // INVALID_INDEX if the node has no bounds
+
 //private:
 	void _setWorldTransformDirty();
 	void _refreshWorldTransform() const; // not actually const, but we allow cache refresh in const functions
@@ -53,6 +62,10 @@ public:
 	Transform m_localTransform = Transform::IDENTITY();
 	mutable Transform m_worldTransform;
 	mutable bool m_isWorldTransformDirty = true;
+
+	AABB m_localBounds = AABB::EMPTY();
+	u32 m_spatialProxy = INVALID_INDEX;
+	bool m_isSpatialProxyDirty = false;
 };
 
 } // namespace yae
@@ -1,6 +1,7 @@
 #include "SceneSystem.h"
 
 #include <yae/Application.h>
+#include <yae/resources/Mesh.h>
 
 namespace yae {
 
@@ -30,6 +31,37 @@ SceneGraphNode& Entity::transform()
 	return *m_transform;
 }
 
+bool Entity::serializeComponents(Serializer& _serializer, const char* _key)
+{
+	return sceneSystem().componentStorage().serializeComponents(_serializer, m_id.id, _key);
+}
+
+void Entity::setMesh(Mesh* _mesh)
+{
+	if (_mesh == nullptr)
+	{
+		if (removeComponent<MeshComponent>())
+		{
+			transform().clearLocalBounds();
+		}
+		return;
+	}
+
+	MeshComponent* meshComponent = getComponent<MeshComponent>();
+	if (meshComponent == nullptr)
+	{
+		meshComponent = &addComponent<MeshComponent>();
+	}
+	meshComponent->mesh = _mesh;
+	sceneSystem()._updateMeshBounds(*this, *meshComponent);
+}
+
+Mesh* Entity::getMesh() const
+{
+	MeshComponent* meshComponent = getComponent<MeshComponent>();
+	return meshComponent != nullptr ? meshComponent->mesh : nullptr;
+}
+
 void Scene::init(ID<Scene> _id, const char* _name)
 {
 	m_id = _id;
@@ -42,13 +74,16 @@ void Scene::shutdown()
 
 void SceneSystem::init()
 {
-
+	m_meshQuery = m_componentStorage.query<MeshComponent>();
+	m_meshBoundsVersion = Mesh::GetBoundsVersion();
 }
 
 void SceneSystem::shutdown()
 {
 	YAE_ASSERT(m_entityPool.size() == 0);
 	YAE_ASSERT(m_scenePool.size() == 0);
+	YAE_ASSERT(m_componentStorage.getEntityCount() == 0);
+	YAE_ASSERT(m_spatialIndex.getProxyCount() == 0);
 }
 
 ID<Entity> SceneSystem::createEntity(const char* _name, ID<Scene> _sceneId)
@@ -58,6 +93,7 @@ ID<Entity> SceneSystem::createEntity(const char* _name, ID<Scene> _sceneId)
 	YAE_ASSERT(entity != nullptr);
 
 	entity->init(id, _sceneId, _name);
+	m_componentStorage.addEntity(id.id);
 
 	return id; 
 }
@@ -66,6 +102,7 @@ void SceneSystem::destroyEntity(ID<Entity> _id)
 {
 	YAE_ASSERT(_id.get() != nullptr);
 
+	m_componentStorage.removeEntity(_id.id);
 	_id->shutdown();
 
 	YAE_VERIFY(m_entityPool.remove(_id.id));
@@ -124,6 +161,13 @@ ID<SceneGraphNode> SceneSystem::createSceneGraphNode()
 
 void SceneSystem::destroySceneGraphNode(ID<SceneGraphNode> _id)
 {
+	SceneGraphNode* sceneGraphNode = m_sceneGraphNodePool.get(_id.id);
+	if (sceneGraphNode != nullptr && sceneGraphNode->m_spatialProxy != INVALID_INDEX)
+	{
+		m_spatialIndex.destroyProxy(sceneGraphNode->m_spatialProxy);
+		sceneGraphNode->m_spatialProxy = INVALID_INDEX;
+	}
+
 	YAE_VERIFY(m_sceneGraphNodePool.remove(_id.id));
 }
 
@@ -137,6 +181,112 @@ SceneGraphNode* SceneSystem::getSceneGraphNode(ID<SceneGraphNode> _id)
 	return m_sceneGraphNodePool.get(_id.id);
 }
 
+ComponentStorage& SceneSystem::componentStorage()
+{
+	return m_componentStorage;
+}
+
+const DynamicBVH& SceneSystem::spatialIndex() const
+{
+	return m_spatialIndex;
+}
+
+ID<SceneGraphNode> SceneSystem::getSpatialProxyNode(u32 _proxy) const
+{
+	return ID<SceneGraphNode>(m_spatialIndex.getUserData(_proxy), const_cast<Pool<SceneGraphNode>*>(&m_sceneGraphNodePool));
+}
+
+void SceneSystem::updateSpatialIndex()
+{
+	YAE_CAPTURE_FUNCTION();
+
+	// Picks up meshes that were reloaded since last frame, only the entities whose bounds actually changed get their node dirtied
+	if (m_meshBoundsVersion != Mesh::GetBoundsVersion())
+	{
+		m_meshBoundsVersion = Mesh::GetBoundsVersion();
+		m_meshQuery.forEach([this](PoolID _entity, MeshComponent& _meshComponent)
+		{
+			Entity* entity = m_entityPool.get(_entity);
+			YAE_ASSERT(entity != nullptr);
+			_updateMeshBounds(*entity, _meshComponent);
+		});
+	}
+
+	// When a large part of the scene moved, updating the leaves in place and refitting is cheaper than reinserting each of them
+	const bool refit = m_dirtySpatialNodes.size() > m_spatialIndex.getProxyCount() / 8;
+	for (ID<SceneGraphNode> id : m_dirtySpatialNodes)
+	{
+		SceneGraphNode* sceneGraphNode = m_sceneGraphNodePool.get(id.id);
+		if (sceneGraphNode == nullptr || !sceneGraphNode->m_isSpatialProxyDirty)
+			continue;
+
+		sceneGraphNode->m_isSpatialProxyDirty = false;
+		if (sceneGraphNode->m_spatialProxy == INVALID_INDEX)
+			continue;
+
+		if (refit)
+		{
+			m_spatialIndex.setProxyBounds(sceneGraphNode->m_spatialProxy, sceneGraphNode->getWorldBounds());
+		}
+		else
+		{
+			m_spatialIndex.moveProxy(sceneGraphNode->m_spatialProxy, sceneGraphNode->getWorldBounds());
+		}
+	}
+	m_dirtySpatialNodes.clear();
+
+	if (refit)
+	{
+		m_spatialIndex.refit();
+	}
+	m_spatialIndex.optimize();
+}
+
+void SceneSystem::_updateSpatialProxy(SceneGraphNode& _node)
+{
+	if (_node.hasBounds())
+	{
+		if (_node.m_spatialProxy == INVALID_INDEX)
+		{
+			_node.m_spatialProxy = m_spatialIndex.createProxy(_node.getWorldBounds(), _node.m_id.id);
+		}
+		else
+		{
+			m_spatialIndex.moveProxy(_node.m_spatialProxy, _node.getWorldBounds());
+		}
+		_node.m_isSpatialProxyDirty = false;
+	}
+	else if (_node.m_spatialProxy != INVALID_INDEX)
+	{
+		m_spatialIndex.destroyProxy(_node.m_spatialProxy);
+		_node.m_spatialProxy = INVALID_INDEX;
+		_node.m_isSpatialProxyDirty = false;
+	}
+}
+
+void SceneSystem::_flagSpatialProxyDirty(ID<SceneGraphNode> _id)
+{
+	m_dirtySpatialNodes.push_back(_id);
+}
+
+void SceneSystem::_updateMeshBounds(Entity& _entity, MeshComponent& _meshComponent)
+{
+	// Unloaded meshes have empty bounds
+	AABB bounds = _meshComponent.mesh != nullptr ? _meshComponent.mesh->getBounds() : AABB::EMPTY();
+	if (memcmp(&bounds, &_meshComponent.bounds, sizeof(AABB)) == 0)
+		return;
+
+	_meshComponent.bounds = bounds;
+	if (math::isValid(bounds))
+	{
+		_entity.transform().setLocalBounds(bounds);
+	}
+	else
+	{
+		_entity.transform().clearLocalBounds();
+	}
+}
+
 SceneSystem& sceneSystem()
 {
 	return app().sceneSystem();
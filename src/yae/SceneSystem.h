@@ -3,12 +3,23 @@
 #include <yae/types.h>
 
 #include <core/containers/Pool.h>
+#include <core/StringPool.h>
+#include <yae/ComponentStorage.h>
+#include <yae/DynamicBVH.h>
 #include <yae/SceneGraphNode.h>
 #include <yae/ID.h>
 
 namespace yae {
 
 class Scene;
+class Mesh;
+
+// Mesh attached to an entity with Entity::setMesh. The entity node bounds follow the mesh bounds, including when the mesh is reloaded.
+struct MeshComponent
+{
+	Mesh* mesh = nullptr;
+	AABB bounds = AABB::EMPTY(); // last bounds applied to the node
+};
 
 // Elements
 class YAE_API Entity
@@ -20,11 +31,27 @@ public:
 	const SceneGraphNode& transform() const;
 	SceneGraphNode& transform();
 
+	// Components are stored in the scene system's ComponentStorage
+	template <typename T>
+	T& addComponent(const T& _value = T());
+	template <typename T>
+	bool removeComponent();
+	template <typename T>
+	T* getComponent() const;
+	template <typename T>
+	bool hasComponent() const;
+
+	bool serializeComponents(Serializer& _serializer, const char* _key = "components");
+
+	// Adds or updates the MeshComponent and sets the node bounds, nullptr removes both
+	void setMesh(Mesh* _mesh);
+	Mesh* getMesh() const;
+
 //private:
 	ID<Entity> m_id;
 	ID<Scene> m_scene;
 	ID<SceneGraphNode> m_transform;
-	String64 m_name;
+	InternedString m_name;
 };
 
 class YAE_API Scene
@@ -35,7 +62,7 @@ public:
 
 //private:
 	ID<Scene> m_id;
-	String64 m_name;
+	InternedString m_name;
 };
 
 // System
@@ -60,7 +87,27 @@ public:
 	const SceneGraphNode* getSceneGraphNode(ID<SceneGraphNode> _id) const;
 	SceneGraphNode* getSceneGraphNode(ID<SceneGraphNode> _id);
 
+	ComponentStorage& componentStorage();
+	template <typename... Components>
+	ComponentQuery<Components...> query();
+
+	// Every scene graph node with bounds owns a proxy in the spatial index, its user data is the node PoolID.
+	// Moved nodes and reloaded meshes are only synced when updateSpatialIndex is called, once per frame after the update.
+	// Nothing is done if no node moved and no mesh was (re)loaded since the last call.
+	const DynamicBVH& spatialIndex() const;
+	ID<SceneGraphNode> getSpatialProxyNode(u32 _proxy) const;
+	void updateSpatialIndex();
+
 //private:
+	void _updateSpatialProxy(SceneGraphNode& _node);
+	void _flagSpatialProxyDirty(ID<SceneGraphNode> _id);
+	void _updateMeshBounds(Entity& _entity, MeshComponent& _meshComponent);
+
+	ComponentStorage m_componentStorage;
+	DynamicBVH m_spatialIndex;
+	DataArray<ID<SceneGraphNode>> m_dirtySpatialNodes;
+	ComponentQuery<MeshComponent> m_meshQuery;
+	u32 m_meshBoundsVersion = 0; // Mesh::GetBoundsVersion() when the mesh components were last checked
 	Pool<Entity> m_entityPool;
 	Pool<Scene> m_scenePool;
 	Pool<SceneGraphNode> m_sceneGraphNodePool;
@@ -69,3 +116,5 @@ public:
 YAE_API SceneSystem& sceneSystem();
 
 } // namespace yae
+
+#include "SceneSystem.inl"
@@ -0,0 +1,33 @@
+namespace yae {
+
+template <typename T>
+T& Entity::addComponent(const T& _value)
+{
+	return sceneSystem().componentStorage().addComponent<T>(m_id.id, _value);
+}
+
+template <typename T>
+bool Entity::removeComponent()
+{
+	return sceneSystem().componentStorage().removeComponent<T>(m_id.id);
+}
+
+template <typename T>
+T* Entity::getComponent() const
+{
+	return sceneSystem().componentStorage().getComponent<T>(m_id.id);
+}
+
+template <typename T>
+bool Entity::hasComponent() const
+{
+	return sceneSystem().componentStorage().hasComponent<T>(m_id.id);
+}
+
+template <typename... Components>
+ComponentQuery<Components...> SceneSystem::query()
+{
+	return m_componentStorage.query<Components...>();
+}
+
+} // namespace yae
@@ -337,7 +337,12 @@ void Editor::update(float _dt)
 	                ImGui::TableNextColumn();
 	                ImGui::PushID(pair.value.name.c_str());
                 	ImGui::SetNextItemWidth(-FLT_MIN);
-	    			changedSettings = ImGui::EditMirrorType("", (void*)&pair.value.verbosity, mirror::GetType(pair.value.verbosity)) || changedSettings;
+                	LogVerbosity verbosity = pair.value.verbosity;
+	    			if (ImGui::EditMirrorType("", (void*)&verbosity, mirror::GetType(verbosity)))
+	    			{
+	    				logger().setCategoryVerbosity(pair.value.name.c_str(), verbosity);
+	    				changedSettings = true;
+	    			}
 	    			ImGui::PopID();
 	    		}
 	            ImGui::EndTable();
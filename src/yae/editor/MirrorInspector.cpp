@@ -1,6 +1,7 @@
 #include "MirrorInspector.h"
 
 #include <yae/imgui_extension.h>
+#include <yae/SceneSystem.h>
 #include <core/containers/Array.h>
 
 #include <imgui/imgui.h>
@@ -62,6 +63,36 @@ struct TestData
 	MIRROR_GETCLASS();
 };
 
+static void editEntityComponents(SceneSystem& _sceneSystem, PoolID _entityId)
+{
+	ComponentStorage& storage = _sceneSystem.componentStorage();
+	const Entity* entity = _sceneSystem.getEntity(ID<Entity>(_entityId, &_sceneSystem.m_entityPool));
+	YAE_ASSERT(entity != nullptr);
+
+	ImGui::PushID((void*)(uintptr_t)_entityId);
+	if (ImGui::TreeNode("entity", "%s (%d components)", entity->m_name.c_str(), storage.getComponentCount(_entityId)))
+	{
+		for (u32 i = 0; i < storage.getComponentCount(_entityId); ++i)
+		{
+			const ComponentType* type = nullptr;
+			void* component = storage.getComponentAt(_entityId, i, &type);
+			if (type->clss == nullptr)
+			{
+				ImGui::TextDisabled("<unreflected component>");
+				continue;
+			}
+
+			if (ImGui::TreeNode(type->clss->getName()))
+			{
+				ImGui::EditMirrorClassInstance(component, type->clss);
+				ImGui::TreePop();
+			}
+		}
+		ImGui::TreePop();
+	}
+	ImGui::PopID();
+}
+
 bool MirrorInspector::update()
 {
 	bool changedSettings = false;
@@ -72,6 +103,24 @@ bool MirrorInspector::update()
 		{
 			static TestData s_testData;
 			ImGui::EditMirrorClassInstance(&s_testData, s_testData.getClass());
+
+			if (ImGui::CollapsingHeader("Entities"))
+			{
+				SceneSystem& scenes = sceneSystem();
+				const ComponentStorage& storage = scenes.componentStorage();
+				for (u32 archetypeIndex = 0; archetypeIndex < storage.getArchetypeCount(); ++archetypeIndex)
+				{
+					const Archetype* archetype = storage.getArchetype(archetypeIndex);
+					for (u32 chunkIndex = 0; chunkIndex < archetype->getChunkCount(); ++chunkIndex)
+					{
+						const PoolID* entities = archetype->getEntities(chunkIndex);
+						for (u32 i = 0; i < archetype->getChunkSize(chunkIndex); ++i)
+						{
+							editEntityComponents(scenes, entities[i]);
+						}
+					}
+				}
+			}
 		}
 		ImGui::End();
 
@@ -0,0 +1,39 @@
+#include "log_categories.h"
+
+YAE_DEFINE_LOG_CATEGORY(application)
+YAE_DEFINE_LOG_CATEGORY(benchmark)
+YAE_DEFINE_LOG_CATEGORY(console)
+YAE_DEFINE_LOG_CATEGORY(filewatch)
+YAE_DEFINE_LOG_CATEGORY(im3d)
+YAE_DEFINE_LOG_CATEGORY(input)
+YAE_DEFINE_LOG_CATEGORY(renderer)
+YAE_DEFINE_LOG_CATEGORY(resource)
+YAE_DEFINE_LOG_CATEGORY(scene)
+YAE_DEFINE_LOG_CATEGORY(SDL)
+YAE_DEFINE_LOG_CATEGORY(test)
+YAE_DEFINE_LOG_CATEGORY(vulkan)
+YAE_DEFINE_LOG_CATEGORY(vulkan_internal)
+
+namespace yae {
+
+// Categories are looked up by name hash in the log settings
+YAE_CHECK_STRING_HASHES(
+	log_category::Default_hash,
+	log_category::program_hash,
+	log_category::filesystem_hash,
+	log_category::application_hash,
+	log_category::benchmark_hash,
+	log_category::console_hash,
+	log_category::filewatch_hash,
+	log_category::im3d_hash,
+	log_category::input_hash,
+	log_category::renderer_hash,
+	log_category::resource_hash,
+	log_category::scene_hash,
+	log_category::SDL_hash,
+	log_category::test_hash,
+	log_category::vulkan_hash,
+	log_category::vulkan_internal_hash
+);
+
+} // namespace yae
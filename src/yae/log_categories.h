@@ -0,0 +1,17 @@
+#pragma once
+
+#include <core/types.h>
+
+YAE_DECLARE_LOG_CATEGORY(YAE_API, application, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, benchmark, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, console, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, filewatch, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, im3d, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, input, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, renderer, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, resource, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, scene, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, SDL, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, test, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, vulkan, VERBOSE)
+YAE_DECLARE_LOG_CATEGORY(YAE_API, vulkan_internal, VERBOSE)
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/math/vector3.h>
+
+namespace yae {
+
+// - AABB -
+struct YAE_API AABB
+{
+	Vector3 min;
+	Vector3 max;
+
+	// Ctors
+	AABB(); // leaves uninitialized
+	AABB(const Vector3& _min, const Vector3& _max);
+
+	// Constants
+	static AABB EMPTY(); // inverted bounds, any merge will make it valid
+};
+
+// - Sphere -
+struct YAE_API Sphere
+{
+	Vector3 center;
+	float radius;
+
+	// Ctors
+	Sphere(); // leaves uninitialized
+	Sphere(const Vector3& _center, float _radius);
+};
+
+// - Ray -
+struct YAE_API Ray
+{
+	Vector3 origin;
+	Vector3 direction; // expected to be normalized
+
+	// Ctors
+	Ray(); // leaves uninitialized
+	Ray(const Vector3& _origin, const Vector3& _direction);
+};
+
+// - Frustum -
+// Planes are stored as (normal, distance) with normals pointing inside: dot(normal, p) + distance >= 0 for any point inside.
+struct YAE_API Frustum
+{
+	enum Plane
+	{
+		PLANE_LEFT = 0,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+		PLANE_COUNT
+	};
+
+	Vector4 planes[PLANE_COUNT];
+
+	// Ctors
+	Frustum(); // leaves uninitialized
+	static Frustum FromViewProjection(const Matrix4& _viewProjection);
+};
+
+namespace math {
+
+// AABB
+inline bool isValid(const AABB& _aabb);
+inline Vector3 center(const AABB& _aabb);
+inline Vector3 extents(const AABB& _aabb); // half size
+inline Vector3 size(const AABB& _aabb);
+inline float surfaceArea(const AABB& _aabb);
+
+inline AABB merge(const AABB& _a, const AABB& _b);
+inline AABB merge(const AABB& _aabb, const Vector3& _point);
+inline AABB inflate(const AABB& _aabb, float _margin);
+inline AABB transform(const AABB& _aabb, const Matrix4& _matrix);
+
+inline bool contains(const AABB& _outer, const AABB& _inner);
+inline bool contains(const AABB& _aabb, const Vector3& _point);
+inline bool overlaps(const AABB& _a, const AABB& _b);
+inline bool overlaps(const AABB& _aabb, const Sphere& _sphere);
+inline float distanceSquared(const AABB& _aabb, const Vector3& _point);
+
+// Slab test. _inverseDirection is 1/_ray.direction, precomputed by the caller since it is shared by many tests.
+// _outDistance is the entry distance along the ray, or 0 if the origin is inside the box.
+inline bool raycast(const Ray& _ray, const Vector3& _inverseDirection, const AABB& _aabb, float _maxDistance, float& _outDistance);
+inline bool raycast(const Ray& _ray, const AABB& _aabb, float _maxDistance, float& _outDistance);
+
+// Sphere
+inline Sphere boundingSphere(const AABB& _aabb);
+inline bool overlaps(const Sphere& _a, const Sphere& _b);
+inline bool contains(const Sphere& _sphere, const Vector3& _point);
+
+// Frustum
+enum class FrustumTest
+{
+	OUTSIDE,
+	INTERSECTS,
+	INSIDE
+};
+inline FrustumTest test(const Frustum& _frustum, const AABB& _aabb);
+inline bool overlaps(const Frustum& _frustum, const AABB& _aabb);
+inline bool overlaps(const Frustum& _frustum, const Sphere& _sphere);
+
+} // namespace math
+} // namespace yae
+
+#include "bounds.inl"
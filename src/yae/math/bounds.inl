@@ -0,0 +1,266 @@
+#include <core/math.h>
+
+#include <cfloat>
+
+namespace yae {
+
+// - AABB -
+inline AABB::AABB()
+{
+}
+
+inline AABB::AABB(const Vector3& _min, const Vector3& _max)
+	: min(_min)
+	, max(_max)
+{
+}
+
+inline AABB AABB::EMPTY()
+{
+	return AABB(Vector3(FLT_MAX), Vector3(-FLT_MAX));
+}
+
+// - Sphere -
+inline Sphere::Sphere()
+{
+}
+
+inline Sphere::Sphere(const Vector3& _center, float _radius)
+	: center(_center)
+	, radius(_radius)
+{
+}
+
+// - Ray -
+inline Ray::Ray()
+{
+}
+
+inline Ray::Ray(const Vector3& _origin, const Vector3& _direction)
+	: origin(_origin)
+	, direction(_direction)
+{
+}
+
+// - Frustum -
+inline Frustum::Frustum()
+{
+}
+
+inline Frustum Frustum::FromViewProjection(const Matrix4& _viewProjection)
+{
+	// Gribb & Hartmann plane extraction, matrices are column major so row i is (m[0][i], m[1][i], m[2][i], m[3][i]).
+	// Clip space is expected to be OpenGL's [-w, w] on all axes. With a [0, w] depth range the near plane is just a bit conservative.
+	const Matrix4& m = _viewProjection;
+	Vector4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+	Vector4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+	Vector4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+	Vector4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	Frustum frustum;
+	frustum.planes[PLANE_LEFT] = row3 + row0;
+	frustum.planes[PLANE_RIGHT] = row3 - row0;
+	frustum.planes[PLANE_BOTTOM] = row3 + row1;
+	frustum.planes[PLANE_TOP] = row3 - row1;
+	frustum.planes[PLANE_NEAR] = row3 + row2;
+	frustum.planes[PLANE_FAR] = row3 - row2;
+
+	for (u32 i = 0; i < PLANE_COUNT; ++i)
+	{
+		Vector4& plane = frustum.planes[i];
+		float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.f)
+		{
+			plane /= length;
+		}
+	}
+	return frustum;
+}
+
+namespace math {
+
+// AABB
+bool isValid(const AABB& _aabb)
+{
+	return _aabb.min.x <= _aabb.max.x && _aabb.min.y <= _aabb.max.y && _aabb.min.z <= _aabb.max.z;
+}
+
+Vector3 center(const AABB& _aabb)
+{
+	return (_aabb.min + _aabb.max) * .5f;
+}
+
+Vector3 extents(const AABB& _aabb)
+{
+	return (_aabb.max - _aabb.min) * .5f;
+}
+
+Vector3 size(const AABB& _aabb)
+{
+	return _aabb.max - _aabb.min;
+}
+
+float surfaceArea(const AABB& _aabb)
+{
+	Vector3 s = size(_aabb);
+	return 2.f * (s.x * s.y + s.y * s.z + s.z * s.x);
+}
+
+AABB merge(const AABB& _a, const AABB& _b)
+{
+	return AABB(
+		Vector3(min(_a.min.x, _b.min.x), min(_a.min.y, _b.min.y), min(_a.min.z, _b.min.z)),
+		Vector3(max(_a.max.x, _b.max.x), max(_a.max.y, _b.max.y), max(_a.max.z, _b.max.z))
+	);
+}
+
+AABB merge(const AABB& _aabb, const Vector3& _point)
+{
+	return AABB(
+		Vector3(min(_aabb.min.x, _point.x), min(_aabb.min.y, _point.y), min(_aabb.min.z, _point.z)),
+		Vector3(max(_aabb.max.x, _point.x), max(_aabb.max.y, _point.y), max(_aabb.max.z, _point.z))
+	);
+}
+
+AABB inflate(const AABB& _aabb, float _margin)
+{
+	return AABB(_aabb.min - _margin, _aabb.max + _margin);
+}
+
+AABB transform(const AABB& _aabb, const Matrix4& _matrix)
+{
+	// Arvo's method: transform the center, and project the extents on the absolute value of the rotation/scale part
+	Vector3 c = center(_aabb);
+	Vector3 e = extents(_aabb);
+
+	Vector3 newCenter = _matrix * c;
+	Vector3 newExtents;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		newExtents[i] = abs(_matrix[0][i]) * e.x + abs(_matrix[1][i]) * e.y + abs(_matrix[2][i]) * e.z;
+	}
+	return AABB(newCenter - newExtents, newCenter + newExtents);
+}
+
+bool contains(const AABB& _outer, const AABB& _inner)
+{
+	return
+		_outer.min.x <= _inner.min.x && _outer.min.y <= _inner.min.y && _outer.min.z <= _inner.min.z &&
+		_outer.max.x >= _inner.max.x && _outer.max.y >= _inner.max.y && _outer.max.z >= _inner.max.z;
+}
+
+bool contains(const AABB& _aabb, const Vector3& _point)
+{
+	return
+		_aabb.min.x <= _point.x && _aabb.min.y <= _point.y && _aabb.min.z <= _point.z &&
+		_aabb.max.x >= _point.x && _aabb.max.y >= _point.y && _aabb.max.z >= _point.z;
+}
+
+bool overlaps(const AABB& _a, const AABB& _b)
+{
+	return
+		_a.min.x <= _b.max.x && _a.max.x >= _b.min.x &&
+		_a.min.y <= _b.max.y && _a.max.y >= _b.min.y &&
+		_a.min.z <= _b.max.z && _a.max.z >= _b.min.z;
+}
+
+bool overlaps(const AABB& _aabb, const Sphere& _sphere)
+{
+	return distanceSquared(_aabb, _sphere.center) <= _sphere.radius * _sphere.radius;
+}
+
+float distanceSquared(const AABB& _aabb, const Vector3& _point)
+{
+	float result = 0.f;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		float v = _point[i];
+		if (v < _aabb.min[i]) result += (_aabb.min[i] - v) * (_aabb.min[i] - v);
+		if (v > _aabb.max[i]) result += (v - _aabb.max[i]) * (v - _aabb.max[i]);
+	}
+	return result;
+}
+
+bool raycast(const Ray& _ray, const Vector3& _inverseDirection, const AABB& _aabb, float _maxDistance, float& _outDistance)
+{
+	float tMin = 0.f;
+	float tMax = _maxDistance;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		float t1 = (_aabb.min[i] - _ray.origin[i]) * _inverseDirection[i];
+		float t2 = (_aabb.max[i] - _ray.origin[i]) * _inverseDirection[i];
+		// @NOTE(remi): written so that NaNs (0 * inf when the ray is axis aligned and touches a slab) don't reject the box
+		tMin = max(tMin, min(t1, t2));
+		tMax = min(tMax, max(t1, t2));
+	}
+
+	if (tMin > tMax)
+		return false;
+
+	_outDistance = tMin;
+	return true;
+}
+
+bool raycast(const Ray& _ray, const AABB& _aabb, float _maxDistance, float& _outDistance)
+{
+	Vector3 inverseDirection(1.f / _ray.direction.x, 1.f / _ray.direction.y, 1.f / _ray.direction.z);
+	return raycast(_ray, inverseDirection, _aabb, _maxDistance, _outDistance);
+}
+
+// Sphere
+Sphere boundingSphere(const AABB& _aabb)
+{
+	return Sphere(center(_aabb), length(extents(_aabb)));
+}
+
+bool overlaps(const Sphere& _a, const Sphere& _b)
+{
+	float radius = _a.radius + _b.radius;
+	return lengthSquared(_a.center - _b.center) <= radius * radius;
+}
+
+bool contains(const Sphere& _sphere, const Vector3& _point)
+{
+	return lengthSquared(_point - _sphere.center) <= _sphere.radius * _sphere.radius;
+}
+
+// Frustum
+FrustumTest test(const Frustum& _frustum, const AABB& _aabb)
+{
+	Vector3 c = center(_aabb);
+	Vector3 e = extents(_aabb);
+
+	FrustumTest result = FrustumTest::INSIDE;
+	for (u32 i = 0; i < Frustum::PLANE_COUNT; ++i)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		float distance = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+		float radius = abs(plane.x) * e.x + abs(plane.y) * e.y + abs(plane.z) * e.z;
+
+		if (distance < -radius)
+			return FrustumTest::OUTSIDE;
+		if (distance < radius)
+			result = FrustumTest::INTERSECTS;
+	}
+	return result;
+}
+
+bool overlaps(const Frustum& _frustum, const AABB& _aabb)
+{
+	return test(_frustum, _aabb) != FrustumTest::OUTSIDE;
+}
+
+bool overlaps(const Frustum& _frustum, const Sphere& _sphere)
+{
+	for (u32 i = 0; i < Frustum::PLANE_COUNT; ++i)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		float distance = plane.x * _sphere.center.x + plane.y * _sphere.center.y + plane.z * _sphere.center.z + plane.w;
+		if (distance < -_sphere.radius)
+			return false;
+	}
+	return true;
+}
+
+} // namespace math
+} // namespace yae
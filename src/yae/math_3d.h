@@ -6,6 +6,7 @@
 #include <yae/math/vector4.h>
 #include <yae/math/quaternion.h>
 #include <yae/math/matrix4.h>
+#include <yae/math/bounds.h>
 
 namespace yae {
 
@@ -0,0 +1,137 @@
+#include "GlyphRunCache.h"
+
+#include <core/hash.h>
+
+namespace yae {
+
+GlyphRunCache::GlyphRunCache(Allocator* _allocator)
+	: m_runs(_allocator)
+	, m_text(_allocator)
+	, m_quads(_allocator)
+	, m_runIndices(_allocator)
+{
+}
+
+const GlyphRun* GlyphRunCache::find(u32 _fontId, const char* _text, u32 _textLength, u32 _frame)
+{
+	const u32* runIndex = m_runIndices.get(_computeKey(_fontId, _text, _textLength));
+	if (runIndex == nullptr)
+		return nullptr;
+
+	GlyphRun& run = m_runs[*runIndex];
+	if (!_matches(run, _fontId, _text, _textLength))
+		return nullptr;
+
+	run.lastUsedFrame = _frame;
+	return &run;
+}
+
+const GlyphRun& GlyphRunCache::add(u32 _fontId, const char* _text, u32 _textLength, const GlyphQuad* _quads, u32 _quadCount, u32 _frame)
+{
+	YAE_ASSERT(_text != nullptr || _textLength == 0);
+	YAE_ASSERT(_quads != nullptr || _quadCount == 0);
+
+	GlyphRun run;
+	run.fontId = _fontId;
+	run.firstChar = m_text.size();
+	run.textLength = _textLength;
+	run.firstQuad = m_quads.size();
+	run.quadCount = _quadCount;
+	run.lastUsedFrame = _frame;
+
+	m_text.push_back(_text, _textLength);
+	m_quads.push_back(_quads, _quadCount);
+	m_runIndices.set(_computeKey(_fontId, _text, _textLength), m_runs.size());
+	return m_runs.push_back(run);
+}
+
+const GlyphQuad* GlyphRunCache::getQuads(u32 _firstQuad, u32 _quadCount) const
+{
+	YAE_ASSERT(_firstQuad + _quadCount <= m_quads.size());
+	return m_quads.data() + _firstQuad;
+}
+
+void GlyphRunCache::evict(u32 _oldestFrame)
+{
+	bool hasStaleRuns = false;
+	for (const GlyphRun& run : m_runs)
+	{
+		if (run.lastUsedFrame < _oldestFrame)
+		{
+			hasStaleRuns = true;
+			break;
+		}
+	}
+	if (!hasStaleRuns && m_runIndices.size() == m_runs.size())
+		return;
+
+	YAE_CAPTURE_FUNCTION();
+
+	// Runs were appended in order, so live data only ever moves down
+	u32 runCount = 0;
+	u32 textSize = 0;
+	u32 quadCount = 0;
+	for (u32 i = 0; i < m_runs.size(); ++i)
+	{
+		GlyphRun run = m_runs[i];
+		u32 key = _computeKey(run.fontId, m_text.data() + run.firstChar, run.textLength);
+		u32* runIndex = m_runIndices.get(key);
+		YAE_ASSERT(runIndex != nullptr);
+
+		// Runs replaced by a colliding text are not reachable anymore
+		if (*runIndex != i)
+			continue;
+
+		if (run.lastUsedFrame < _oldestFrame)
+		{
+			m_runIndices.remove(key);
+			continue;
+		}
+
+		memmove(m_text.data() + textSize, m_text.data() + run.firstChar, run.textLength);
+		memmove(m_quads.data() + quadCount, m_quads.data() + run.firstQuad, run.quadCount * sizeof(GlyphQuad));
+		run.firstChar = textSize;
+		run.firstQuad = quadCount;
+		textSize += run.textLength;
+		quadCount += run.quadCount;
+
+		*runIndex = runCount;
+		m_runs[runCount] = run;
+		++runCount;
+	}
+	m_runs.resize(runCount);
+	m_text.resize(textSize);
+	m_quads.resize(quadCount);
+}
+
+void GlyphRunCache::clear()
+{
+	m_runs.clear();
+	m_text.clear();
+	m_quads.clear();
+	m_runIndices.clear();
+}
+
+u32 GlyphRunCache::getRunCount() const
+{
+	return m_runs.size();
+}
+
+u32 GlyphRunCache::getQuadCount() const
+{
+	return m_quads.size();
+}
+
+u32 GlyphRunCache::_computeKey(u32 _fontId, const char* _text, u32 _textLength)
+{
+	return hash::hash32(_text, _textLength) ^ (_fontId * 0x9E3779B1u);
+}
+
+bool GlyphRunCache::_matches(const GlyphRun& _run, u32 _fontId, const char* _text, u32 _textLength) const
+{
+	return _run.fontId == _fontId
+		&& _run.textLength == _textLength
+		&& memcmp(m_text.data() + _run.firstChar, _text, _textLength) == 0;
+}
+
+} // namespace yae
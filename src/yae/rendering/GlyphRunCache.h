@@ -0,0 +1,63 @@
+#pragma once
+
+#include <yae/types.h>
+#include <core/containers/Array.h>
+#include <core/containers/HashMap.h>
+
+namespace yae {
+
+// Glyph rectangle relative to the text origin, and its rectangle in the font atlas
+struct GlyphQuad
+{
+	float x0 = 0.f;
+	float y0 = 0.f;
+	float x1 = 0.f;
+	float y1 = 0.f;
+	u16 u0 = 0; // atlas pixel coordinates
+	u16 v0 = 0;
+	u16 u1 = 0;
+	u16 v1 = 0;
+};
+
+// Shaped text, its characters and quads live in the cache storage
+struct GlyphRun
+{
+	u32 fontId = 0;
+	u32 firstChar = 0;
+	u32 textLength = 0;
+	u32 firstQuad = 0;
+	u32 quadCount = 0;
+	u32 lastUsedFrame = 0;
+};
+
+// Keeps the quads of the text shaped in the previous frames, so that strings drawn again unchanged are not decoded
+// and laid out every frame. Runs are keyed by font and text. The ones not drawn for a while are evicted, which
+// compacts the storage: quad offsets of the runs are only stable until the next evict().
+class YAE_API GlyphRunCache
+{
+public:
+	GlyphRunCache(Allocator* _allocator = nullptr);
+
+	// Marks the run as used in _frame, nullptr if the text has not been shaped with this font
+	const GlyphRun* find(u32 _fontId, const char* _text, u32 _textLength, u32 _frame);
+	const GlyphRun& add(u32 _fontId, const char* _text, u32 _textLength, const GlyphQuad* _quads, u32 _quadCount, u32 _frame);
+	const GlyphQuad* getQuads(u32 _firstQuad, u32 _quadCount) const;
+
+	// Forgets the runs last used before _oldestFrame
+	void evict(u32 _oldestFrame);
+	void clear();
+
+	u32 getRunCount() const;
+	u32 getQuadCount() const;
+
+//private:
+	static u32 _computeKey(u32 _fontId, const char* _text, u32 _textLength);
+	bool _matches(const GlyphRun& _run, u32 _fontId, const char* _text, u32 _textLength) const;
+
+	DataArray<GlyphRun> m_runs;
+	DataArray<char> m_text;
+	DataArray<GlyphQuad> m_quads;
+	HashMap<u32, u32> m_runIndices; // by key, a colliding text replaces the run it collides with
+};
+
+} // namespace yae
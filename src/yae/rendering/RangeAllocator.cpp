@@ -0,0 +1,110 @@
+#include "RangeAllocator.h"
+
+namespace yae {
+
+RangeAllocator::RangeAllocator(Allocator* _allocator)
+	: m_freeRanges(_allocator)
+{
+}
+
+u32 RangeAllocator::allocate(u32 _count)
+{
+	YAE_ASSERT(_count > 0);
+
+	for (u32 i = 0; i < m_freeRanges.size(); ++i)
+	{
+		RangeAllocatorRange& range = m_freeRanges[i];
+		if (range.count < _count)
+			continue;
+
+		u32 first = range.first;
+		range.first += _count;
+		range.count -= _count;
+		if (range.count == 0)
+		{
+			m_freeRanges.erase(i);
+		}
+		return first;
+	}
+
+	u32 first = m_top;
+	m_top += _count;
+	return first;
+}
+
+void RangeAllocator::free(u32 _first, u32 _count)
+{
+	YAE_ASSERT(_count > 0);
+	YAE_ASSERT(_first + _count <= m_top);
+
+	// Last range, give it back to the top along with the free range right before it
+	if (_first + _count == m_top)
+	{
+		m_top = _first;
+		if (m_freeRanges.size() > 0 && m_freeRanges.back().first + m_freeRanges.back().count == m_top)
+		{
+			m_top = m_freeRanges.back().first;
+			m_freeRanges.pop_back();
+		}
+		return;
+	}
+
+	u32 index = 0;
+	while (index < m_freeRanges.size() && m_freeRanges[index].first < _first)
+	{
+		++index;
+	}
+	YAE_ASSERT(index == m_freeRanges.size() || _first + _count <= m_freeRanges[index].first);
+
+	bool mergesPrevious = index > 0 && m_freeRanges[index - 1].first + m_freeRanges[index - 1].count == _first;
+	bool mergesNext = index < m_freeRanges.size() && _first + _count == m_freeRanges[index].first;
+	if (mergesPrevious && mergesNext)
+	{
+		m_freeRanges[index - 1].count += _count + m_freeRanges[index].count;
+		m_freeRanges.erase(index);
+	}
+	else if (mergesPrevious)
+	{
+		m_freeRanges[index - 1].count += _count;
+	}
+	else if (mergesNext)
+	{
+		m_freeRanges[index].first = _first;
+		m_freeRanges[index].count += _count;
+	}
+	else
+	{
+		RangeAllocatorRange range;
+		range.first = _first;
+		range.count = _count;
+		m_freeRanges.push_back(range);
+		for (u32 i = m_freeRanges.size() - 1; i > index; --i)
+		{
+			m_freeRanges[i] = m_freeRanges[i - 1];
+		}
+		m_freeRanges[index] = range;
+	}
+}
+
+void RangeAllocator::clear()
+{
+	m_freeRanges.clear();
+	m_top = 0;
+}
+
+u32 RangeAllocator::getTop() const
+{
+	return m_top;
+}
+
+u32 RangeAllocator::getFreeCount() const
+{
+	u32 count = 0;
+	for (const RangeAllocatorRange& range : m_freeRanges)
+	{
+		count += range.count;
+	}
+	return count;
+}
+
+} // namespace yae
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <yae/types.h>
+#include <core/containers/Array.h>
+
+namespace yae {
+
+struct RangeAllocatorRange
+{
+	u32 first = 0;
+	u32 count = 0;
+};
+
+// Allocates ranges of elements in a linear space (e.g. a GPU buffer), first fit.
+// Freed ranges are merged with their neighbors, ranges freed at the end lower the top back.
+// The space grows without bound: the owner must make sure its storage holds getTop() elements.
+class YAE_API RangeAllocator
+{
+public:
+	RangeAllocator(Allocator* _allocator = nullptr);
+
+	u32 allocate(u32 _count); // returns the first element of the range
+	void free(u32 _first, u32 _count);
+	void clear();
+
+	u32 getTop() const; // end of the highest allocated range
+	u32 getFreeCount() const; // free elements below the top
+
+//private:
+	DataArray<RangeAllocatorRange> m_freeRanges; // sorted, all below the top
+	u32 m_top = 0;
+};
+
+} // namespace yae
@@ -9,6 +9,10 @@
 #include <yae/resources/ShaderFile.h>
 #include <yae/resources/ShaderProgram.h>
 #include <yae/resources/Texture.h>
+#include <yae/rendering/culling.h>
+#include <yae/rendering/sorting.h>
+#include <core/hash.h>
+#include <core/JobSystem.h>
 #include <core/string.h>
 
 #include <im3d/im3d.h>
@@ -119,6 +123,11 @@ void RenderCamera::unproject(const Vector2& _screenPosition, Vector3& _outRayOri
 	math::unproject(_screenPosition, view, projection, Vector4(0.f, 0.f, viewportSize.x, viewportSize.y), _outRayOrigin, _outRayDirection);
 }
 
+bool RenderCamera::isVisible(const DrawCommand& _command) const
+{
+	return m_visibilityBit == 0 || (_command.visibilityMask & m_visibilityBit) != 0;
+}
+
 bool Renderer::init(SDL_Window* _window)
 {
 	YAE_CAPTURE_FUNCTION();
@@ -191,6 +200,7 @@ void Renderer::shutdown()
 		defaultAllocator().destroy(pair.value);
 	}
 	m_cameras.clear();
+	m_glyphRuns.clear();
 
 	for (auto& pair : m_scenes)
 	{
@@ -212,6 +222,17 @@ void Renderer::beginFrame()
 {
 	_beginFrame();
 
+	YAE_CAPTURE_COUNTER("renderer.culling.visible", 0);
+	YAE_CAPTURE_COUNTER("renderer.culling.culled", 0);
+	YAE_CAPTURE_COUNTER("renderer.uploadedBytes", 0);
+	YAE_CAPTURE_COUNTER("renderer.drawCalls", 0);
+	YAE_CAPTURE_COUNTER("renderer.programBinds", 0);
+	YAE_CAPTURE_COUNTER("renderer.textureBinds", 0);
+	YAE_CAPTURE_COUNTER("renderer.vertexArrayBinds", 0);
+	YAE_CAPTURE_COUNTER("renderer.uniformUploads", 0);
+	YAE_CAPTURE_COUNTER("renderer.instancedBatches", 0);
+	YAE_CAPTURE_COUNTER("renderer.indirectCommands", 0);
+
 	// Prepare all scenes
 	for (const auto& pair : m_scenes)
 	{
@@ -305,6 +326,13 @@ void Renderer::beginFrame()
 
 void Renderer::render()
 {
+	// Cull deferred mesh draws and copy the visible ones, then merge the text of each font
+	for (const auto& pair : m_scenes)
+	{
+		_cullMeshDraws(pair.value);
+		_batchTextDraws(pair.value);
+	}
+
 	_beginRender();
 
 	// Prepare all scenes
@@ -331,6 +359,7 @@ void Renderer::render()
 		if (camera->m_scene == nullptr)
 			continue;
 
+		_sortDrawCommands(camera);
 		_renderCamera(camera);
 
 		Im3d::SetContext(*camera->m_scene->m_im3d);
@@ -353,9 +382,17 @@ void Renderer::endFrame()
 	{
 		RenderScene* scene = pair.value;
 		scene->m_drawCommands.clear();
+		scene->m_meshDraws.clear();
+		scene->m_textDraws.clear();
 	}
 	m_vertices.clear();
 	m_indices.clear();
+	m_instanceTransforms.clear();
+	m_glyphVertices.clear();
+
+	// Text not drawn for a few frames is shaped again if it comes back
+	++m_frameIndex;
+	m_glyphRuns.evict(m_frameIndex > YAE_GLYPH_RUN_LIFETIME ? m_frameIndex - YAE_GLYPH_RUN_LIFETIME : 0);
 
 	// Clear objects pending destruction
 	for (RenderTarget* renderTarget : m_renderTargetsPendingDestruction)
@@ -438,122 +475,67 @@ void Renderer::drawMesh(const Matrix4& _transform, const Mesh* _mesh, const Shad
 {
 	YAE_ASSERT(_mesh != nullptr);
 
-	drawMesh(
-		_transform,
-		_mesh->getVertices().data(), _mesh->getVertices().size(),
-		_mesh->getIndices().data(), _mesh->getIndices().size(),
-		_shaderProgram != nullptr ? _shaderProgram->getPrimitiveMode() : PrimitiveMode::TRIANGLES,
-		_shaderProgram != nullptr ? _shaderProgram->getShaderProgramHandle() : 0,
-		_texture != nullptr ? _texture->getTextureHandle() : 0
-	);
+	MeshDraw draw;
+	draw.transform = _transform;
+	draw.mesh = _mesh;
+	draw.primitiveMode = _shaderProgram != nullptr ? _shaderProgram->getPrimitiveMode() : PrimitiveMode::TRIANGLES;
+	draw.shader = _shaderProgram != nullptr ? _shaderProgram->getShaderProgramHandle() : 0;
+	draw.texture = _texture != nullptr ? _texture->getTextureHandle() : 0;
+	_getCurrentScene()->m_meshDraws.push_back(draw);
 }
 
-void Renderer::drawMesh(const Matrix4& _transform, const Vertex* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, PrimitiveMode _primitiveMode, const ShaderProgramHandle& _shader, const TextureHandle& _texture)
+void Renderer::drawMeshInstanced(const Matrix4* _transforms, u32 _transformCount, const Mesh* _mesh, const ShaderProgram* _shaderProgram, const Texture* _texture)
 {
-	RenderScene* scene = _getCurrentScene();
-
-	u32 shader = (u32)_shader;
-	DataArray<DrawCommand>* commandArray = scene->m_drawCommands.get(shader);
-	if (commandArray == nullptr)
-	{
-		commandArray = &scene->m_drawCommands.set(shader, DataArray<DrawCommand>());
-	}
-
-	u32 baseIndex = m_vertices.size();
-	u32 startIndex = m_indices.size();
-
-	DrawCommand command;
-	command.primitiveMode = _primitiveMode;
-	command.transform = _transform;
-	command.indexOffset = startIndex;
-	command.elementCount = _indicesCount;
-	command.textureId = _texture;
-	commandArray->push_back(command);
-
-	m_vertices.push_back(_vertices, _verticesCount);
+	YAE_CAPTURE_FUNCTION();
 
-	m_indices.resize(m_indices.size() + _indicesCount);
-	for (u32 i = 0; i < _indicesCount; ++i)
+	YAE_ASSERT(_mesh != nullptr);
+	YAE_ASSERT(_transforms != nullptr || _transformCount == 0);
+
+	MeshDraw draw;
+	draw.mesh = _mesh;
+	draw.primitiveMode = _shaderProgram != nullptr ? _shaderProgram->getPrimitiveMode() : PrimitiveMode::TRIANGLES;
+	draw.shader = _shaderProgram != nullptr ? _shaderProgram->getShaderProgramHandle() : 0;
+	draw.texture = _texture != nullptr ? _texture->getTextureHandle() : 0;
+
+	// Instances are culled individually, then batched back together with any other draw of the same mesh
+	DataArray<MeshDraw>& meshDraws = _getCurrentScene()->m_meshDraws;
+	meshDraws.reserve(meshDraws.size() + _transformCount);
+	for (u32 i = 0; i < _transformCount; ++i)
 	{
-		m_indices[startIndex + i] = baseIndex + _indices[i];
+		draw.transform = _transforms[i];
+		meshDraws.push_back(draw);
 	}
 }
 
-
-void Renderer::drawText(const Matrix4& _transform, const FontFile* _font, const char* _text)
+void Renderer::drawMesh(const Matrix4& _transform, const Vertex* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, PrimitiveMode _primitiveMode, const ShaderProgramHandle& _shader, const TextureHandle& _texture)
 {
-	RenderScene* scene = _getCurrentScene();
+	_pushDrawCommand(_getCurrentScene(), _transform, _vertices, _verticesCount, _indices, _indicesCount, _primitiveMode, _shader, _texture, ~0u);
+}
 
-	u32 shader = m_fontShader->getShaderProgramHandle();
-	DataArray<DrawCommand>* commandArray = scene->m_drawCommands.get(shader);
-	if (commandArray == nullptr)
-	{
-		commandArray = &scene->m_drawCommands.set(shader, DataArray<DrawCommand>());
-	}
+void Renderer::drawText(const Matrix4& _transform, FontFile* _font, const char* _text)
+{
+	YAE_ASSERT(_font != nullptr && _font->isLoaded());
+	YAE_ASSERT(_text != nullptr);
 
-	u32 indicesStart = m_indices.size();
-	u32 verticesStart = m_vertices.size();
+	// Text drawn in the previous frames is not shaped again
 	u32 textLength = strlen(_text);
-
-	m_vertices.resize(m_vertices.size() + textLength * 4);
-	m_indices.resize(m_indices.size() + textLength * 6);
-
-	float xPos = 0.f;
-	float yPos = 0.f;
-	Vertex vertices[4];
-	Vector3 _color(1.f, 1.f, 1.f);
-	vertices[0].color = _color;
-	vertices[1].color = _color;
-	vertices[2].color = _color;
-	vertices[3].color = _color;
-	u32 indices[6] =
+	const GlyphRun* run = m_glyphRuns.find(_font->getFontId(), _text, textLength, m_frameIndex);
+	if (run == nullptr)
 	{
-		0, 1, 2,
-		0, 2, 3
-	};
-
-	stbtt_aligned_quad quad;
-	u32 indicesOffset = verticesStart;
-	for (u32 i = 0; i < textLength; ++i)
-	{
-
-		stbtt_GetPackedQuad(
-			_font->m_packedChar,
-			_font->m_atlasWidth, _font->m_atlasHeight,
-			_text[i],
-			&xPos, &yPos,
-			&quad,
-			1
-		);
-
-		vertices[0].pos = Vector3(-quad.x0, -quad.y0, 0.f);
-		vertices[1].pos = Vector3(-quad.x1, -quad.y0, 0.f);
-		vertices[2].pos = Vector3(-quad.x1, -quad.y1, 0.f);
-		vertices[3].pos = Vector3(-quad.x0, -quad.y1, 0.f);
-		vertices[0].texCoord = Vector2(quad.s0, quad.t0);
-		vertices[1].texCoord = Vector2(quad.s1, quad.t0);
-		vertices[2].texCoord = Vector2(quad.s1, quad.t1);
-		vertices[3].texCoord = Vector2(quad.s0, quad.t1);
-		vertices[0].normal = Vector3(0.f, 0.f, 1.f);
-		vertices[1].normal = Vector3(0.f, 0.f, 1.f);
-		vertices[2].normal = Vector3(0.f, 0.f, 1.f);
-		vertices[3].normal = Vector3(0.f, 0.f, 1.f);
-		memcpy(m_vertices.data() + verticesStart + (i * 4), vertices, sizeof(*vertices) * 4);
-
-		for (u32 j = 0; j < 6; ++j)
-		{
-			m_indices[indicesStart + (i * 6) + j] = indices[j] + indicesOffset;
-		}
-		indicesOffset += 4;
+		m_shapedQuads.clear();
+		_font->shapeText(_text, textLength, m_shapedQuads);
+		run = &m_glyphRuns.add(_font->getFontId(), _text, textLength, m_shapedQuads.data(), m_shapedQuads.size(), m_frameIndex);
 	}
 
-	DrawCommand command;
-	command.primitiveMode = PrimitiveMode::TRIANGLES;
-	command.transform = _transform;
-	command.indexOffset = indicesStart;
-	command.elementCount = textLength * 6;
-	command.textureId = _font->m_fontTexture;
-	commandArray->push_back(command);
+	if (run->quadCount == 0)
+		return;
+
+	TextDraw draw;
+	draw.transform = _transform;
+	draw.font = _font;
+	draw.firstQuad = run->firstQuad;
+	draw.quadCount = run->quadCount;
+	_getCurrentScene()->m_textDraws.push_back(draw);
 }
 
 RenderScene* Renderer::createScene(const char* _sceneName)
@@ -577,15 +559,14 @@ void Renderer::destroyScene(RenderScene* _scene)
 	defaultAllocator().destroy(_scene);
 }
 
-void Renderer::destroyScene(const char* _sceneName)
+void Renderer::destroyScene(StringHash _sceneName)
 {
 	destroyScene(getScene(_sceneName));
 }
 
-RenderScene* Renderer::getScene(const char* _sceneName) const
+RenderScene* Renderer::getScene(StringHash _sceneName) const
 {
-	StringHash nameHash(_sceneName);
-	RenderScene*const* scenePtr = m_scenes.get(nameHash);
+	RenderScene*const* scenePtr = m_scenes.get(_sceneName);
 	return scenePtr != nullptr ? *scenePtr : nullptr;
 }
 
@@ -597,7 +578,7 @@ void Renderer::pushScene(RenderScene* _scene)
 	Im3d::SetContext(*_scene->m_im3d);
 }
 
-void Renderer::pushScene(const char* _sceneName)
+void Renderer::pushScene(StringHash _sceneName)
 {
 	pushScene(getScene(_sceneName));
 }
@@ -631,19 +612,351 @@ void Renderer::destroyCamera(RenderCamera* _camera)
 	defaultAllocator().destroy(_camera);
 }
 
-void Renderer::destroyCamera(const char* _cameraName)
+void Renderer::destroyCamera(StringHash _cameraName)
 {
 	destroyCamera(getCamera(_cameraName));
 }
 
 
-RenderCamera* Renderer::getCamera(const char* _cameraName) const
+RenderCamera* Renderer::getCamera(StringHash _cameraName) const
 {
-	StringHash nameHash(_cameraName);
-	RenderCamera*const* cameraPtr = m_cameras.get(nameHash);
+	RenderCamera*const* cameraPtr = m_cameras.get(_cameraName);
 	return cameraPtr != nullptr ? *cameraPtr : nullptr;
 }
 
+void Renderer::_cullMeshDraws(RenderScene* _scene)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	// Cameras beyond the mask capacity do not cull, so everything has to be kept for them
+	const u32 cameraCount = _scene->m_cameras.size();
+	const bool cullingEnabled = cameraCount <= YAE_MAX_CULLING_CAMERAS;
+	Frustum frustums[YAE_MAX_CULLING_CAMERAS];
+	for (u32 i = 0; i < cameraCount; ++i)
+	{
+		RenderCamera* camera = _scene->m_cameras[i];
+		camera->m_visibilityBit = cullingEnabled ? (1u << i) : 0;
+		if (cullingEnabled)
+		{
+			frustums[i] = Frustum::FromViewProjection(camera->computeViewProjectionMatrix());
+		}
+	}
+
+	// @NOTE(remi): cameras may have been added or removed since last frame, their bits must be refreshed even when there is nothing to cull
+	const u32 drawCount = _scene->m_meshDraws.size();
+	if (drawCount == 0)
+		return;
+
+	m_visibilityMasks.resize(drawCount);
+	if (cullingEnabled)
+	{
+		m_cullingBounds.resize(drawCount * 6);
+		culling::BoundsStream bounds;
+		bounds.centerX = m_cullingBounds.data();
+		bounds.centerY = bounds.centerX + drawCount;
+		bounds.centerZ = bounds.centerY + drawCount;
+		bounds.extentX = bounds.centerZ + drawCount;
+		bounds.extentY = bounds.extentX + drawCount;
+		bounds.extentZ = bounds.extentY + drawCount;
+
+		const MeshDraw* draws = _scene->m_meshDraws.data();
+		u32* visibilityMasks = m_visibilityMasks.data();
+		jobSystem().parallelFor(drawCount, YAE_CULLING_BATCH_SIZE, [&](u32 _begin, u32 _end)
+		{
+			for (u32 i = _begin; i < _end; ++i)
+			{
+				const AABB& localBounds = draws[i].mesh->getBounds();
+				if (math::isValid(localBounds))
+				{
+					culling::storeBounds(localBounds, draws[i].transform, bounds, i);
+					visibilityMasks[i] = 0;
+				}
+				else
+				{
+					// No bounds (empty or not loaded mesh), never culled
+					culling::storeBounds(AABB(Vector3::ZERO(), Vector3::ZERO()), Matrix4::IDENTITY(), bounds, i);
+					visibilityMasks[i] = ~0u;
+				}
+			}
+
+			culling::BoundsStream batch;
+			batch.centerX = bounds.centerX + _begin;
+			batch.centerY = bounds.centerY + _begin;
+			batch.centerZ = bounds.centerZ + _begin;
+			batch.extentX = bounds.extentX + _begin;
+			batch.extentY = bounds.extentY + _begin;
+			batch.extentZ = bounds.extentZ + _begin;
+			for (u32 i = 0; i < cameraCount; ++i)
+			{
+				culling::cullBounds(frustums[i], batch, _end - _begin, 1u << i, visibilityMasks + _begin);
+			}
+		});
+	}
+	else
+	{
+		for (u32& mask : m_visibilityMasks)
+		{
+			mask = ~0u;
+		}
+	}
+
+	// Only push what at least one camera can see
+	u32 visibleCount = 0;
+	m_batchKeys.clear();
+	m_batchDraws.clear();
+	for (u32 i = 0; i < drawCount; ++i)
+	{
+		if (m_visibilityMasks[i] == 0)
+			continue;
+
+		++visibleCount;
+		const MeshDraw& draw = _scene->m_meshDraws[i];
+		if (draw.mesh->getMeshHandle() == 0)
+		{
+			// No GPU buffers (not loaded yet or failed), stream the vertices with the dynamic geometry
+			_pushDrawCommand(
+				_scene,
+				draw.transform,
+				draw.mesh->getVertices().data(), draw.mesh->getVertices().size(),
+				draw.mesh->getIndices().data(), draw.mesh->getIndices().size(),
+				draw.primitiveMode,
+				draw.shader,
+				draw.texture,
+				m_visibilityMasks[i]
+			);
+			continue;
+		}
+
+		// Draws with identical state and visibility get the same key, the visibility mask takes the low bits
+		u32 state[] = { (u32)draw.mesh->getMeshHandle(), (u32)draw.shader, (u32)draw.texture, (u32)draw.primitiveMode };
+		m_batchKeys.push_back((u64(hash::hash32(state, sizeof(state))) << 32) | u64(m_visibilityMasks[i]));
+		m_batchDraws.push_back(i);
+	}
+
+	// Sorting by key makes the draws of each batch contiguous, while keeping their submission order
+	const u32 batchedCount = m_batchDraws.size();
+	m_sortKeysScratch.resize(batchedCount);
+	m_sortValuesScratch.resize(batchedCount);
+	sorting::radixSort(m_batchKeys.data(), m_batchDraws.data(), batchedCount, m_sortKeysScratch.data(), m_sortValuesScratch.data());
+
+	u32 batchCount = 0;
+	m_instanceTransforms.reserve(m_instanceTransforms.size() + batchedCount);
+	for (u32 batchStart = 0; batchStart < batchedCount;)
+	{
+		const MeshDraw& first = _scene->m_meshDraws[m_batchDraws[batchStart]];
+		u32 batchEnd = batchStart;
+		while (batchEnd < batchedCount && m_batchKeys[batchEnd] == m_batchKeys[batchStart])
+		{
+			// Guard against hash collisions
+			const MeshDraw& draw = _scene->m_meshDraws[m_batchDraws[batchEnd]];
+			if (draw.mesh->getMeshHandle() != first.mesh->getMeshHandle() || draw.shader != first.shader || draw.texture != first.texture || draw.primitiveMode != first.primitiveMode)
+				break;
+
+			m_instanceTransforms.push_back(draw.transform);
+			++batchEnd;
+		}
+
+		_pushInstancedDrawCommand(
+			_scene,
+			first.mesh->getMeshHandle(), first.mesh->getIndices().size(),
+			first.primitiveMode,
+			first.shader,
+			first.texture,
+			u32(m_batchKeys[batchStart]), // visibility mask
+			batchEnd - batchStart,
+			math::translation(first.transform)
+		);
+		++batchCount;
+		batchStart = batchEnd;
+	}
+
+	_scene->m_meshDraws.clear();
+
+	YAE_CAPTURE_COUNTER_ADD("renderer.culling.visible", visibleCount);
+	YAE_CAPTURE_COUNTER_ADD("renderer.culling.culled", drawCount - visibleCount);
+	YAE_CAPTURE_COUNTER_ADD("renderer.instancedBatches", batchCount);
+}
+
+void Renderer::_batchTextDraws(RenderScene* _scene)
+{
+	if (_scene->m_textDraws.empty())
+		return;
+
+	YAE_CAPTURE_FUNCTION();
+
+	const u32 white = 0xFFFFFFFF;
+
+	// One command per font, the glyphs are transformed here so that strings with different transforms can be merged
+	m_batchFonts.clear();
+	for (const TextDraw& draw : _scene->m_textDraws)
+	{
+		if (m_batchFonts.find(draw.font) == nullptr)
+		{
+			m_batchFonts.push_back(draw.font);
+		}
+	}
+
+	for (FontFile* font : m_batchFonts)
+	{
+		font->updateAtlasTexture();
+
+		u32 quadCount = 0;
+		u32 drawCount = 0;
+		Vector3 center = Vector3::ZERO();
+		for (const TextDraw& draw : _scene->m_textDraws)
+		{
+			if (draw.font != font)
+				continue;
+
+			quadCount += draw.quadCount;
+			center += math::translation(draw.transform);
+			++drawCount;
+		}
+
+		u32 firstVertex = m_glyphVertices.size();
+		u32 firstIndex = m_indices.size();
+		m_glyphVertices.resize(firstVertex + quadCount * 4);
+		m_indices.resize(firstIndex + quadCount * 6);
+		GlyphVertex* vertex = m_glyphVertices.data() + firstVertex;
+		u32* index = m_indices.data() + firstIndex;
+		u32 baseVertex = firstVertex;
+
+		for (const TextDraw& draw : _scene->m_textDraws)
+		{
+			if (draw.font != font)
+				continue;
+
+			// Text space is y down and drawn mirrored, as the quads of stbtt_GetPackedQuad have always been
+			Vector3 origin = draw.transform * Vector3::ZERO();
+			Vector3 axisX = (draw.transform * Vector3(-1.f, 0.f, 0.f)) - origin;
+			Vector3 axisY = (draw.transform * Vector3(0.f, -1.f, 0.f)) - origin;
+
+			const GlyphQuad* quad = m_glyphRuns.getQuads(draw.firstQuad, draw.quadCount);
+			for (u32 i = 0; i < draw.quadCount; ++i, ++quad)
+			{
+				Vector3 left = origin + axisX * quad->x0;
+				Vector3 right = origin + axisX * quad->x1;
+				Vector3 top = axisY * quad->y0;
+				Vector3 bottom = axisY * quad->y1;
+
+				vertex[0] = { left + top, quad->u0, quad->v0, white };
+				vertex[1] = { right + top, quad->u1, quad->v0, white };
+				vertex[2] = { right + bottom, quad->u1, quad->v1, white };
+				vertex[3] = { left + bottom, quad->u0, quad->v1, white };
+				vertex += 4;
+
+				index[0] = baseVertex;
+				index[1] = baseVertex + 1;
+				index[2] = baseVertex + 2;
+				index[3] = baseVertex;
+				index[4] = baseVertex + 2;
+				index[5] = baseVertex + 3;
+				index += 6;
+				baseVertex += 4;
+			}
+		}
+
+		DrawCommand& command = _addDrawCommand(_scene, m_fontShader->getShaderProgramHandle());
+		command.pass = RenderPass::BLENDED;
+		command.primitiveMode = PrimitiveMode::TRIANGLES;
+		command.instanceCount = 1; // glyph vertices are already in world space, no instance transform
+		command.indexOffset = firstIndex;
+		command.elementCount = quadCount * 6;
+		command.textureId = font->m_fontTexture;
+		command.sortPosition = center / float(drawCount);
+		command.vertexLayout = VertexLayout::GLYPH;
+	}
+
+	_scene->m_textDraws.clear();
+}
+
+void Renderer::_pushDrawCommand(RenderScene* _scene, const Matrix4& _transform, const Vertex* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, PrimitiveMode _primitiveMode, const ShaderProgramHandle& _shader, const TextureHandle& _texture, u32 _visibilityMask)
+{
+	u32 baseIndex = m_vertices.size();
+	u32 startIndex = m_indices.size();
+
+	DrawCommand& command = _addDrawCommand(_scene, _shader);
+	command.primitiveMode = _primitiveMode;
+	command.firstInstance = m_instanceTransforms.size();
+	command.instanceCount = 1;
+	command.indexOffset = startIndex;
+	command.elementCount = _indicesCount;
+	command.textureId = _texture;
+	command.visibilityMask = _visibilityMask;
+	command.sortPosition = math::translation(_transform);
+	m_instanceTransforms.push_back(_transform);
+
+	m_vertices.push_back(_vertices, _verticesCount);
+
+	m_indices.resize(m_indices.size() + _indicesCount);
+	for (u32 i = 0; i < _indicesCount; ++i)
+	{
+		m_indices[startIndex + i] = baseIndex + _indices[i];
+	}
+}
+
+void Renderer::_pushInstancedDrawCommand(RenderScene* _scene, const MeshHandle& _mesh, u32 _indicesCount, PrimitiveMode _primitiveMode, const ShaderProgramHandle& _shader, const TextureHandle& _texture, u32 _visibilityMask, u32 _instanceCount, const Vector3& _sortPosition)
+{
+	YAE_ASSERT(_mesh != 0);
+	YAE_ASSERT(_instanceCount > 0 && _instanceCount <= m_instanceTransforms.size());
+
+	// The instance transforms have just been pushed
+	DrawCommand& command = _addDrawCommand(_scene, _shader);
+	command.primitiveMode = _primitiveMode;
+	command.firstInstance = m_instanceTransforms.size() - _instanceCount;
+	command.instanceCount = _instanceCount;
+	command.mesh = _mesh;
+	command.indexOffset = 0;
+	command.elementCount = _indicesCount;
+	command.textureId = _texture;
+	command.visibilityMask = _visibilityMask;
+	command.sortPosition = _sortPosition;
+}
+
+DrawCommand& Renderer::_addDrawCommand(RenderScene* _scene, const ShaderProgramHandle& _shader)
+{
+	_scene->m_drawCommands.push_back(DrawCommand());
+	DrawCommand& command = _scene->m_drawCommands.back();
+	command.shader = _shader;
+	return command;
+}
+
+void Renderer::_sortDrawCommands(const RenderCamera* _camera)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	const RenderScene* scene = _camera->m_scene;
+	const u32 commandCount = scene->m_drawCommands.size();
+
+	m_sortKeys.resize(commandCount);
+	m_sortedDrawCommands.resize(commandCount);
+
+	Matrix4 view = _camera->computeViewMatrix();
+	const float depthRange = _camera->farPlane - _camera->nearPlane;
+	const float inverseDepthRange = depthRange > 0.f ? 1.f / depthRange : 0.f;
+
+	// Invisible commands and commands without a shader do not get a key
+	u32 keyCount = 0;
+	for (u32 i = 0; i < commandCount; ++i)
+	{
+		const DrawCommand& command = scene->m_drawCommands[i];
+		if (command.shader == 0 || !_camera->isVisible(command))
+			continue;
+
+		Vector3 viewPosition = view * command.sortPosition;
+		float depth = (-viewPosition.z - _camera->nearPlane) * inverseDepthRange;
+		m_sortKeys[keyCount] = sorting::makeDrawKey(command.pass, command.shader, command.textureId, depth, command.mesh);
+		m_sortedDrawCommands[keyCount] = i;
+		++keyCount;
+	}
+	m_sortKeys.resize(keyCount);
+	m_sortedDrawCommands.resize(keyCount);
+
+	m_sortKeysScratch.resize(keyCount);
+	m_sortValuesScratch.resize(keyCount);
+	sorting::radixSort(m_sortKeys.data(), m_sortedDrawCommands.data(), keyCount, m_sortKeysScratch.data(), m_sortValuesScratch.data());
+}
+
 RenderScene* Renderer::_getCurrentScene() const
 {
 	YAE_ASSERT(m_sceneStack.size() > 0);
@@ -3,8 +3,16 @@
 #include <yae/types.h>
 #include <yae/rendering/render_types.h>
 #include <yae/math_types.h>
+#include <yae/rendering/StreamArray.h>
+#include <yae/rendering/GlyphRunCache.h>
 #include <core/containers/HashMap.h>
 
+// Cameras of a scene are given one bit each in the draw commands visibility mask
+#define YAE_MAX_CULLING_CAMERAS 32
+
+// Frames a shaped text stays cached without being drawn
+#define YAE_GLYPH_RUN_LIFETIME 60
+
 
 struct SDL_Window;
 struct ImGuiContext;
@@ -28,11 +36,40 @@ class RenderTarget;
 
 struct YAE_API DrawCommand
 {
+	RenderPass pass = RenderPass::SOLID;
+	ShaderProgramHandle shader = 0;
 	PrimitiveMode primitiveMode;
-	Matrix4 transform;
+	u32 firstInstance = 0; // transforms in Renderer::m_instanceTransforms
+	u32 instanceCount = 1;
+	MeshHandle mesh = 0; // 0 for geometry streamed this frame in Renderer::m_vertices/m_indices
 	u32 indexOffset;
 	u32 elementCount;
 	TextureHandle textureId;
+	u32 visibilityMask = ~0u; // one bit per scene camera, see RenderCamera::m_visibilityBit
+	Vector3 sortPosition = Vector3::ZERO(); // world position used for depth sorting, kept on the CPU since the instances may live in GPU memory
+	VertexLayout vertexLayout = VertexLayout::STANDARD; // streamed glyph batches read Renderer::m_glyphVertices
+};
+
+// Mesh draws are deferred until render(), where they are culled against the scene cameras.
+// Visible draws sharing mesh, shader, texture and visibility are batched into one instanced command.
+// They reference the mesh GPU buffers, the mesh must stay alive until then.
+struct YAE_API MeshDraw
+{
+	Matrix4 transform;
+	const Mesh* mesh;
+	PrimitiveMode primitiveMode;
+	ShaderProgramHandle shader;
+	TextureHandle texture;
+};
+
+// Text draws are deferred until render() too, where all the text of a font in a scene is merged in one command.
+// The quads are the ones of a run in Renderer::m_glyphRuns, valid until the end of the frame.
+struct YAE_API TextDraw
+{
+	Matrix4 transform;
+	FontFile* font;
+	u32 firstQuad;
+	u32 quadCount;
 };
 
 class YAE_API RenderScene
@@ -47,7 +84,9 @@ public:
 //private:
 	char m_name[128] = {};
 	DataArray<RenderCamera*> m_cameras;
-	HashMap<ShaderProgramHandle, DataArray<DrawCommand>> m_drawCommands;
+	DataArray<DrawCommand> m_drawCommands; // in submission order, sorted per camera before rendering
+	DataArray<MeshDraw> m_meshDraws;
+	DataArray<TextDraw> m_textDraws;
 	Im3d::Context* m_im3d = nullptr;
 };
 
@@ -65,6 +104,8 @@ public:
 	Vector3 project(const Vector3& _worldPosition) const;
 	void unproject(const Vector2& _screenPosition, Vector3& _outRayOrigin, Vector3& _outRayDirection) const;
 
+	bool isVisible(const DrawCommand& _command) const;
+
 	Vector3 position = Vector3::ZERO();
 	Quaternion rotation = Quaternion::IDENTITY();
 	float fov = 45.f;
@@ -76,6 +117,7 @@ public:
 //private:
 	char m_name[128] = {};
 	RenderScene* m_scene = nullptr;
+	u32 m_visibilityBit = 0; // 0 if the camera does not take part in culling
 };
 
 class YAE_API RenderTarget
@@ -114,9 +156,18 @@ public:
 	void notifyFrameBufferResized(int _width, int _height);
 
 	virtual bool createTexture(const void* _data, int _width, int _height, int _channels, TextureHandle& _outTextureHandle) = 0;
+	// Uploads a pre-built mip chain, from the full size level down
+	virtual bool createTexture(TextureFormat _format, u32 _width, u32 _height, const TextureMip* _mips, u32 _mipCount, TextureHandle& _outTextureHandle) = 0;
+	virtual bool isTextureFormatSupported(TextureFormat _format) const = 0;
+	// Replaces the content of a texture created from raw pixels, its size may change
+	virtual void updateTexture(TextureHandle& _inTextureHandle, const void* _data, int _width, int _height, int _channels) = 0;
 	virtual void applyTextureParameters(TextureHandle& _inTextureHandle, const TextureParameters& _parameters) = 0;
 	virtual void destroyTexture(TextureHandle& _inTextureHandle) = 0;
 
+	// Persistent vertex and index buffers, uploaded once. _vertices are encoded in _vertexFormat, see vertex_format.h
+	virtual bool createMesh(const VertexFormat& _vertexFormat, const void* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, MeshHandle& _outMeshHandle) = 0;
+	virtual void destroyMesh(MeshHandle& _inMeshHandle) = 0;
+
 	RenderTarget* createRenderTarget(bool _fullScreen = true, u32 _width = 0, u32 _height = 0);
 	void destroyRenderTarget(RenderTarget* _renderTarget);
 	void resizeRenderTarget(RenderTarget* _renderTarget, u32 _width, u32 _height);
@@ -128,21 +179,22 @@ public:
 	virtual void destroyShaderProgram(ShaderProgramHandle& _shaderProgramHandle) = 0;
 
 	void drawMesh(const Matrix4& _transform, const Mesh* _mesh, const ShaderProgram* _shaderProgram, const Texture* _texture);
+	void drawMeshInstanced(const Matrix4* _transforms, u32 _transformCount, const Mesh* _mesh, const ShaderProgram* _shaderProgram, const Texture* _texture);
 	void drawMesh(const Matrix4& _transform, const Vertex* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, PrimitiveMode _primitiveMode, const ShaderProgramHandle& _shader, const TextureHandle& _texture);
-	void drawText(const Matrix4& _transform, const FontFile* _font, const char* _text);
+	void drawText(const Matrix4& _transform, FontFile* _font, const char* _text);
 
 	RenderScene* createScene(const char* _sceneName);
 	void destroyScene(RenderScene* _scene);
-	void destroyScene(const char* _sceneName);
-	RenderScene* getScene(const char* _sceneName) const;
+	void destroyScene(StringHash _sceneName);
+	RenderScene* getScene(StringHash _sceneName) const;
 	void pushScene(RenderScene* _scene);
-	void pushScene(const char* _sceneName);
+	void pushScene(StringHash _sceneName);
 	void popScene();
 
 	RenderCamera* createCamera(const char* _cameraName);
 	void destroyCamera(RenderCamera* _camera);
-	void destroyCamera(const char* _cameraName);
-	RenderCamera* getCamera(const char* _cameraName) const;
+	void destroyCamera(StringHash _cameraName);
+	RenderCamera* getCamera(StringHash _cameraName) const;
 
 //private:
 	virtual bool _init() = 0;
@@ -166,6 +218,12 @@ public:
 	virtual void _endRender() = 0;
 	virtual void _endFrame() = 0;
 
+	void _cullMeshDraws(RenderScene* _scene);
+	void _batchTextDraws(RenderScene* _scene);
+	void _pushDrawCommand(RenderScene* _scene, const Matrix4& _transform, const Vertex* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, PrimitiveMode _primitiveMode, const ShaderProgramHandle& _shader, const TextureHandle& _texture, u32 _visibilityMask);
+	void _pushInstancedDrawCommand(RenderScene* _scene, const MeshHandle& _mesh, u32 _indicesCount, PrimitiveMode _primitiveMode, const ShaderProgramHandle& _shader, const TextureHandle& _texture, u32 _visibilityMask, u32 _instanceCount, const Vector3& _sortPosition);
+	DrawCommand& _addDrawCommand(RenderScene* _scene, const ShaderProgramHandle& _shader);
+	void _sortDrawCommands(const RenderCamera* _camera);
 	RenderScene* _getCurrentScene() const;
 	void _destroyRenderTargetsPendingDestruction();
 
@@ -175,8 +233,23 @@ public:
 	ShaderProgram* m_fontShader = nullptr;
 	Mesh* m_quad = nullptr;
 
-	DataArray<Vertex> m_vertices;
-	DataArray<u32> m_indices;
+	// Streamed every frame, backends may map them on GPU memory from _beginFrame to _beginRender: only access them in between
+	StreamArray<Vertex> m_vertices; // dynamic geometry
+	StreamArray<u32> m_indices;
+	StreamArray<Matrix4> m_instanceTransforms; // one per instance of every draw command
+	StreamArray<GlyphVertex> m_glyphVertices; // text, indexed from m_indices like the dynamic geometry
+	GlyphRunCache m_glyphRuns; // text shaped in the last frames
+	DataArray<GlyphQuad> m_shapedQuads; // scratch
+	DataArray<FontFile*> m_batchFonts; // scratch
+	u32 m_frameIndex = 0;
+	DataArray<u64> m_batchKeys;
+	DataArray<u32> m_batchDraws;
+	DataArray<float> m_cullingBounds; // culling::BoundsStream storage
+	DataArray<u32> m_visibilityMasks;
+	DataArray<u32> m_sortedDrawCommands; // indices in the scene draw commands of the camera being rendered, see _sortDrawCommands
+	DataArray<u64> m_sortKeys;
+	DataArray<u64> m_sortKeysScratch;
+	DataArray<u32> m_sortValuesScratch;
 	HashMap<StringHash, RenderScene*> m_scenes;
 	HashMap<StringHash, RenderCamera*> m_cameras;
 	DataArray<RenderTarget*> m_renderTargets;
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <yae/types.h>
+#include <core/containers/Array.h>
+
+#include <type_traits>
+
+namespace yae {
+
+// Array of data streamed to the GPU every frame.
+// A backend can map it onto GPU visible memory with setStorage() so that the data is written in place, without any
+// intermediate copy. If the mapped storage gets too small, the content moves to heap storage for the rest of the frame
+// and the backend falls back to a regular upload, see overflowed().
+template <typename T>
+class StreamArray
+{
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+public:
+	StreamArray(Allocator* _allocator = nullptr);
+
+	void setStorage(T* _storage, u32 _capacity); // must be empty, nullptr goes back to heap storage
+	bool isMapped() const; // content is in the storage given to setStorage()
+	bool overflowed() const; // a storage was given but it was too small
+	u32 getRequiredCapacity() const; // highest size reached since the last setStorage()
+
+	// Edit
+	void resize(u32 _newSize);
+	void reserve(u32 _newCapacity);
+	void clear();
+	T& push_back(const T& _item);
+	void push_back(const T* _items, u32 _itemCount);
+
+	// Accessors
+	T& operator[](u32 _i);
+	const T& operator[](u32 _i) const;
+	u32 size() const;
+	u32 capacity() const;
+	bool empty() const;
+	T* data() const;
+
+	// Iterators
+	T* begin();
+	const T* begin() const;
+	T* end();
+	const T* end() const;
+
+private:
+	void _grow(u32 _minCapacity);
+
+	T* m_data = nullptr;
+	u32 m_size = 0;
+	u32 m_capacity = 0;
+	u32 m_requiredCapacity = 0;
+	T* m_storage = nullptr;
+	DataArray<T> m_heapStorage;
+};
+
+} // namespace yae
+
+#include "StreamArray.inl"
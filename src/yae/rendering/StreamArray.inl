@@ -0,0 +1,197 @@
+#pragma once
+
+namespace yae {
+
+template <typename T>
+StreamArray<T>::StreamArray(Allocator* _allocator)
+	: m_heapStorage(_allocator)
+{
+}
+
+
+template <typename T>
+void StreamArray<T>::setStorage(T* _storage, u32 _capacity)
+{
+	YAE_ASSERT_MSG(m_size == 0, "Stream storage can only be changed while empty");
+	YAE_ASSERT(_storage != nullptr || _capacity == 0);
+
+	m_storage = _storage;
+	m_requiredCapacity = 0;
+	if (_storage != nullptr)
+	{
+		m_data = _storage;
+		m_capacity = _capacity;
+	}
+	else
+	{
+		m_data = m_heapStorage.data();
+		m_capacity = m_heapStorage.size();
+	}
+}
+
+
+template <typename T>
+bool StreamArray<T>::isMapped() const
+{
+	return m_storage != nullptr && m_data == m_storage;
+}
+
+
+template <typename T>
+bool StreamArray<T>::overflowed() const
+{
+	return m_storage != nullptr && m_data != m_storage;
+}
+
+
+template <typename T>
+u32 StreamArray<T>::getRequiredCapacity() const
+{
+	return m_requiredCapacity;
+}
+
+
+template <typename T>
+void StreamArray<T>::resize(u32 _newSize)
+{
+	if (_newSize > m_capacity)
+	{
+		_grow(_newSize);
+	}
+	m_size = _newSize;
+	m_requiredCapacity = m_size > m_requiredCapacity ? m_size : m_requiredCapacity;
+}
+
+
+template <typename T>
+void StreamArray<T>::reserve(u32 _newCapacity)
+{
+	if (_newCapacity > m_capacity)
+	{
+		_grow(_newCapacity);
+	}
+}
+
+
+template <typename T>
+void StreamArray<T>::clear()
+{
+	m_size = 0;
+}
+
+
+template <typename T>
+T& StreamArray<T>::push_back(const T& _item)
+{
+	resize(m_size + 1);
+	m_data[m_size - 1] = _item;
+	return m_data[m_size - 1];
+}
+
+
+template <typename T>
+void StreamArray<T>::push_back(const T* _items, u32 _itemCount)
+{
+	u32 start = m_size;
+	resize(m_size + _itemCount);
+	memcpy(m_data + start, _items, _itemCount * sizeof(T));
+}
+
+
+template <typename T>
+T& StreamArray<T>::operator[](u32 _i)
+{
+	YAE_ASSERT(_i < m_size);
+	return m_data[_i];
+}
+
+
+template <typename T>
+const T& StreamArray<T>::operator[](u32 _i) const
+{
+	YAE_ASSERT(_i < m_size);
+	return m_data[_i];
+}
+
+
+template <typename T>
+u32 StreamArray<T>::size() const
+{
+	return m_size;
+}
+
+
+template <typename T>
+u32 StreamArray<T>::capacity() const
+{
+	return m_capacity;
+}
+
+
+template <typename T>
+bool StreamArray<T>::empty() const
+{
+	return m_size == 0;
+}
+
+
+template <typename T>
+T* StreamArray<T>::data() const
+{
+	return m_data;
+}
+
+
+template <typename T>
+T* StreamArray<T>::begin()
+{
+	return m_data;
+}
+
+
+template <typename T>
+const T* StreamArray<T>::begin() const
+{
+	return m_data;
+}
+
+
+template <typename T>
+T* StreamArray<T>::end()
+{
+	return m_data + m_size;
+}
+
+
+template <typename T>
+const T* StreamArray<T>::end() const
+{
+	return m_data + m_size;
+}
+
+
+template <typename T>
+void StreamArray<T>::_grow(u32 _minCapacity)
+{
+	// Heap storage is only ever grown, it keeps its capacity across frames
+	u32 newCapacity = m_capacity * 2 + 8;
+	newCapacity = newCapacity < _minCapacity ? _minCapacity : newCapacity;
+
+	if (m_data == m_heapStorage.data())
+	{
+		m_heapStorage.resize(newCapacity);
+	}
+	else
+	{
+		// Leaving the mapped storage
+		if (newCapacity > m_heapStorage.size())
+		{
+			m_heapStorage.resize(newCapacity);
+		}
+		memcpy(m_heapStorage.data(), m_data, m_size * sizeof(T));
+	}
+	m_data = m_heapStorage.data();
+	m_capacity = m_heapStorage.size();
+}
+
+} // namespace yae
@@ -0,0 +1,106 @@
+#include "culling.h"
+
+#include <core/math.h>
+
+#if YAE_CULLING_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace yae {
+namespace culling {
+
+void storeBounds(const AABB& _localBounds, const Matrix4& _transform, BoundsStream& _outBounds, u32 _index)
+{
+	AABB worldBounds = math::transform(_localBounds, _transform);
+	Vector3 center = math::center(worldBounds);
+	Vector3 extents = math::extents(worldBounds);
+
+	_outBounds.centerX[_index] = center.x;
+	_outBounds.centerY[_index] = center.y;
+	_outBounds.centerZ[_index] = center.z;
+	_outBounds.extentX[_index] = extents.x;
+	_outBounds.extentY[_index] = extents.y;
+	_outBounds.extentZ[_index] = extents.z;
+}
+
+static bool isOutside(const Frustum& _frustum, const BoundsStream& _bounds, u32 _index)
+{
+	for (u32 i = 0; i < Frustum::PLANE_COUNT; ++i)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		float distance = plane.x * _bounds.centerX[_index] + plane.y * _bounds.centerY[_index] + plane.z * _bounds.centerZ[_index] + plane.w;
+		float radius = math::abs(plane.x) * _bounds.extentX[_index] + math::abs(plane.y) * _bounds.extentY[_index] + math::abs(plane.z) * _bounds.extentZ[_index];
+		if (distance + radius < 0.f)
+			return true;
+	}
+	return false;
+}
+
+void cullBounds(const Frustum& _frustum, const BoundsStream& _bounds, u32 _count, u32 _visibilityBit, u32* _inOutVisibilityMasks)
+{
+	u32 i = 0;
+
+#if YAE_CULLING_SIMD
+	// Splat each plane once, then test four bounds per iteration: outside if dot(n, c) + w + dot(|n|, e) < 0 for any plane
+	__m128 planeX[Frustum::PLANE_COUNT];
+	__m128 planeY[Frustum::PLANE_COUNT];
+	__m128 planeZ[Frustum::PLANE_COUNT];
+	__m128 planeW[Frustum::PLANE_COUNT];
+	__m128 absPlaneX[Frustum::PLANE_COUNT];
+	__m128 absPlaneY[Frustum::PLANE_COUNT];
+	__m128 absPlaneZ[Frustum::PLANE_COUNT];
+	for (u32 p = 0; p < Frustum::PLANE_COUNT; ++p)
+	{
+		const Vector4& plane = _frustum.planes[p];
+		planeX[p] = _mm_set1_ps(plane.x);
+		planeY[p] = _mm_set1_ps(plane.y);
+		planeZ[p] = _mm_set1_ps(plane.z);
+		planeW[p] = _mm_set1_ps(plane.w);
+		absPlaneX[p] = _mm_set1_ps(math::abs(plane.x));
+		absPlaneY[p] = _mm_set1_ps(math::abs(plane.y));
+		absPlaneZ[p] = _mm_set1_ps(math::abs(plane.z));
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= _count; i += 4)
+	{
+		__m128 centerX = _mm_loadu_ps(_bounds.centerX + i);
+		__m128 centerY = _mm_loadu_ps(_bounds.centerY + i);
+		__m128 centerZ = _mm_loadu_ps(_bounds.centerZ + i);
+		__m128 extentX = _mm_loadu_ps(_bounds.extentX + i);
+		__m128 extentY = _mm_loadu_ps(_bounds.extentY + i);
+		__m128 extentZ = _mm_loadu_ps(_bounds.extentZ + i);
+
+		__m128 outside = zero;
+		for (u32 p = 0; p < Frustum::PLANE_COUNT; ++p)
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(planeX[p], centerX), _mm_mul_ps(planeY[p], centerY)),
+				_mm_add_ps(_mm_mul_ps(planeZ[p], centerZ), planeW[p])
+			);
+			__m128 radius = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(absPlaneX[p], extentX), _mm_mul_ps(absPlaneY[p], extentY)),
+				_mm_mul_ps(absPlaneZ[p], extentZ)
+			);
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		int outsideMask = _mm_movemask_ps(outside);
+		if ((outsideMask & 1) == 0) _inOutVisibilityMasks[i + 0] |= _visibilityBit;
+		if ((outsideMask & 2) == 0) _inOutVisibilityMasks[i + 1] |= _visibilityBit;
+		if ((outsideMask & 4) == 0) _inOutVisibilityMasks[i + 2] |= _visibilityBit;
+		if ((outsideMask & 8) == 0) _inOutVisibilityMasks[i + 3] |= _visibilityBit;
+	}
+#endif
+
+	for (; i < _count; ++i)
+	{
+		if (!isOutside(_frustum, _bounds, i))
+		{
+			_inOutVisibilityMasks[i] |= _visibilityBit;
+		}
+	}
+}
+
+} // namespace culling
+} // namespace yae
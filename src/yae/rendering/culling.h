@@ -0,0 +1,38 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/math/bounds.h>
+
+#ifndef YAE_CULLING_SIMD
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define YAE_CULLING_SIMD 1
+	#else
+		#define YAE_CULLING_SIMD 0
+	#endif
+#endif
+
+// Number of bounds processed per culling job batch
+#define YAE_CULLING_BATCH_SIZE 256
+
+namespace yae {
+namespace culling {
+
+// Bounds stored as separate center/extents streams (SoA) so that they can be tested four at a time.
+struct YAE_API BoundsStream
+{
+	float* centerX = nullptr;
+	float* centerY = nullptr;
+	float* centerZ = nullptr;
+	float* extentX = nullptr;
+	float* extentY = nullptr;
+	float* extentZ = nullptr;
+};
+
+// Transforms local bounds to world space and stores them at _index in the stream
+YAE_API void storeBounds(const AABB& _localBounds, const Matrix4& _transform, BoundsStream& _outBounds, u32 _index);
+
+// Sets _visibilityBit in _inOutVisibilityMasks[i] for each bounds overlapping the frustum
+YAE_API void cullBounds(const Frustum& _frustum, const BoundsStream& _bounds, u32 _count, u32 _visibilityBit, u32* _inOutVisibilityMasks);
+
+} // namespace culling
+} // namespace yae
@@ -0,0 +1,429 @@
+#include "mesh_cooking.h"
+
+#include <core/containers/HashMap.h>
+#include <core/hash.h>
+#include <core/math.h>
+#include <yae/math/vector3.h>
+#include <yae/rendering/sorting.h>
+
+namespace yae {
+namespace mesh_cooking {
+
+struct CookedMeshHeader
+{
+	u32 magic;
+	u32 version;
+	u32 sourceHash;
+	u32 vertexCount;
+	u32 indexCount;
+	VertexCacheStatistics sourceStatistics;
+	VertexCacheStatistics statistics;
+};
+const u32 COOKED_MESH_MAGIC = 0x534D4159; // "YAMS"
+
+const u32 INVALID_INDEX = ~0u;
+const u32 CACHE_SIZE = YAE_MESH_VERTEX_CACHE_SIZE;
+
+// Timestamps start above the cache size so that the zero initialized vertices are out of the cache
+const u32 FIRST_CACHE_TIMESTAMP = CACHE_SIZE + 1;
+
+static bool isInCache(u32 _cacheTime, u32 _timestamp)
+{
+	return _timestamp - _cacheTime <= CACHE_SIZE;
+}
+
+// Float bits to a key sorting the largest values first
+static u32 makeDescendingKey(float _value)
+{
+	u32 bits;
+	memcpy(&bits, &_value, sizeof(bits));
+	u32 ascendingKey = (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+	return ~ascendingKey;
+}
+
+u32 weldVertices(Vertex* _vertices, u32 _vertexCount, u32* _outRemap)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	// Welded vertices sharing a hash are chained, so that colliding vertices are compared instead of merged
+	HashMap<u32, u32> firstVertexByHash(&scratchAllocator());
+	DataArray<u32> nextVertexWithSameHash(&scratchAllocator());
+	nextVertexWithSameHash.resize(_vertexCount);
+
+	u32 weldedCount = 0;
+	for (u32 i = 0; i < _vertexCount; ++i)
+	{
+		u32 vertexHash = hash::hash32(&_vertices[i], sizeof(Vertex));
+		const u32* firstVertex = firstVertexByHash.get(vertexHash);
+
+		u32 weldedIndex = INVALID_INDEX;
+		if (firstVertex != nullptr)
+		{
+			for (u32 candidate = *firstVertex; candidate != INVALID_INDEX; candidate = nextVertexWithSameHash[candidate])
+			{
+				if (memcmp(&_vertices[candidate], &_vertices[i], sizeof(Vertex)) == 0)
+				{
+					weldedIndex = candidate;
+					break;
+				}
+			}
+		}
+
+		// Slots below i have all been read already, the vertex can be moved down
+		if (weldedIndex == INVALID_INDEX)
+		{
+			weldedIndex = weldedCount++;
+			_vertices[weldedIndex] = _vertices[i];
+			nextVertexWithSameHash[weldedIndex] = firstVertex != nullptr ? *firstVertex : INVALID_INDEX;
+			firstVertexByHash.set(vertexHash, weldedIndex);
+		}
+		_outRemap[i] = weldedIndex;
+	}
+	return weldedCount;
+}
+
+void optimizeVertexCache(u32* _indices, u32 _indexCount, u32 _vertexCount)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_indexCount % 3 == 0);
+	u32 triangleCount = _indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Triangles using each vertex
+	DataArray<u32> adjacencyOffsets(&scratchAllocator());
+	DataArray<u32> adjacency(&scratchAllocator());
+	DataArray<u32> liveCounts(&scratchAllocator()); // triangles not emitted yet
+	adjacencyOffsets.resize(_vertexCount + 1);
+	adjacency.resize(_indexCount);
+	liveCounts.resize(_vertexCount);
+	memset(liveCounts.data(), 0, _vertexCount * sizeof(u32));
+	for (u32 i = 0; i < _indexCount; ++i)
+	{
+		YAE_ASSERT(_indices[i] < _vertexCount);
+		++liveCounts[_indices[i]];
+	}
+	adjacencyOffsets[0] = 0;
+	for (u32 i = 0; i < _vertexCount; ++i)
+	{
+		adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveCounts[i];
+	}
+	{
+		DataArray<u32> cursors(&scratchAllocator());
+		cursors.push_back(adjacencyOffsets.data(), _vertexCount);
+		for (u32 i = 0; i < _indexCount; ++i)
+		{
+			adjacency[cursors[_indices[i]]++] = i / 3;
+		}
+	}
+
+	DataArray<u32> cacheTimes(&scratchAllocator());
+	DataArray<u8> isEmitted(&scratchAllocator());
+	DataArray<u32> deadEnds(&scratchAllocator()); // vertices of the emitted triangles, most recent last
+	DataArray<u32> candidates(&scratchAllocator());
+	DataArray<u32> output(&scratchAllocator());
+	cacheTimes.resize(_vertexCount);
+	memset(cacheTimes.data(), 0, _vertexCount * sizeof(u32));
+	isEmitted.resize(triangleCount);
+	memset(isEmitted.data(), 0, triangleCount);
+	deadEnds.reserve(_indexCount);
+	output.reserve(_indexCount);
+
+	// Tipsify (Sander et al. 2007): fan out all the remaining triangles of a vertex, then move on to the
+	// vertex of the fan that will still be in the cache once its own triangles are emitted
+	u32 timestamp = FIRST_CACHE_TIMESTAMP;
+	u32 cursor = 0; // vertices below are done
+	u32 vertex = _indices[0];
+	while (vertex != INVALID_INDEX)
+	{
+		candidates.clear();
+		for (u32 i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i)
+		{
+			u32 triangle = adjacency[i];
+			if (isEmitted[triangle])
+				continue;
+
+			for (u32 j = 0; j < 3; ++j)
+			{
+				u32 triangleVertex = _indices[triangle * 3 + j];
+				output.push_back(triangleVertex);
+				deadEnds.push_back(triangleVertex);
+				candidates.push_back(triangleVertex);
+				--liveCounts[triangleVertex];
+				if (!isInCache(cacheTimes[triangleVertex], timestamp))
+				{
+					cacheTimes[triangleVertex] = timestamp++;
+				}
+			}
+			isEmitted[triangle] = 1;
+		}
+
+		vertex = INVALID_INDEX;
+		i32 bestPriority = -1;
+		for (u32 candidate : candidates)
+		{
+			if (liveCounts[candidate] == 0)
+				continue;
+
+			// Oldest vertex that stays in the cache while its triangles are emitted, any vertex otherwise
+			i32 priority = 0;
+			u32 age = timestamp - cacheTimes[candidate];
+			if (age + 2 * liveCounts[candidate] <= CACHE_SIZE)
+			{
+				priority = i32(age);
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				vertex = candidate;
+			}
+		}
+
+		// Dead end: restart from a recently used vertex, or from the next one in input order
+		while (vertex == INVALID_INDEX && !deadEnds.empty())
+		{
+			u32 deadEnd = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveCounts[deadEnd] > 0)
+			{
+				vertex = deadEnd;
+			}
+		}
+		while (vertex == INVALID_INDEX && cursor < _vertexCount)
+		{
+			if (liveCounts[cursor] > 0)
+			{
+				vertex = cursor;
+			}
+			else
+			{
+				++cursor;
+			}
+		}
+	}
+
+	YAE_ASSERT(output.size() == _indexCount);
+	memcpy(_indices, output.data(), _indexCount * sizeof(u32));
+}
+
+void optimizeOverdraw(u32* _indices, u32 _indexCount, const Vertex* _vertices, u32 _vertexCount)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_indexCount % 3 == 0);
+	u32 triangleCount = _indexCount / 3;
+	if (triangleCount < 2)
+		return;
+
+	// Clusters start at the triangles missing the cache for all their vertices, reordering them costs little
+	DataArray<u32> clusterStarts(&scratchAllocator());
+	{
+		DataArray<u32> cacheTimes(&scratchAllocator());
+		cacheTimes.resize(_vertexCount);
+		memset(cacheTimes.data(), 0, _vertexCount * sizeof(u32));
+		u32 timestamp = FIRST_CACHE_TIMESTAMP;
+		for (u32 triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			u32 missCount = 0;
+			for (u32 j = 0; j < 3; ++j)
+			{
+				u32 vertex = _indices[triangle * 3 + j];
+				if (!isInCache(cacheTimes[vertex], timestamp))
+				{
+					cacheTimes[vertex] = timestamp++;
+					++missCount;
+				}
+			}
+			if (triangle == 0 || missCount == 3)
+			{
+				clusterStarts.push_back(triangle);
+			}
+		}
+		clusterStarts.push_back(triangleCount);
+	}
+	u32 clusterCount = clusterStarts.size() - 1;
+	if (clusterCount < 2)
+		return;
+
+	// Area weighted centroids and normals
+	DataArray<Vector3> clusterCentroids(&scratchAllocator());
+	DataArray<Vector3> clusterNormals(&scratchAllocator());
+	clusterCentroids.resize(clusterCount);
+	clusterNormals.resize(clusterCount);
+	Vector3 meshCentroid = Vector3::ZERO();
+	float meshArea = 0.f;
+	for (u32 cluster = 0; cluster < clusterCount; ++cluster)
+	{
+		Vector3 centroid = Vector3::ZERO();
+		Vector3 normal = Vector3::ZERO();
+		float area = 0.f;
+		for (u32 triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle)
+		{
+			const Vector3& p0 = _vertices[_indices[triangle * 3 + 0]].pos;
+			const Vector3& p1 = _vertices[_indices[triangle * 3 + 1]].pos;
+			const Vector3& p2 = _vertices[_indices[triangle * 3 + 2]].pos;
+			Vector3 triangleNormal = math::cross(p1 - p0, p2 - p0);
+			float triangleArea = math::length(triangleNormal);
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.f);
+			normal += triangleNormal;
+			area += triangleArea;
+		}
+		meshCentroid += centroid;
+		meshArea += area;
+		clusterCentroids[cluster] = area > 0.f ? centroid / area : centroid;
+		clusterNormals[cluster] = math::safeNormalize(normal);
+	}
+	if (meshArea > 0.f)
+	{
+		meshCentroid /= meshArea;
+	}
+
+	// Clusters facing away from the mesh center are on its outside, they occlude the others
+	DataArray<u64> keys(&scratchAllocator());
+	DataArray<u32> clusters(&scratchAllocator());
+	DataArray<u64> tmpKeys(&scratchAllocator());
+	DataArray<u32> tmpClusters(&scratchAllocator());
+	keys.resize(clusterCount);
+	clusters.resize(clusterCount);
+	tmpKeys.resize(clusterCount);
+	tmpClusters.resize(clusterCount);
+	for (u32 cluster = 0; cluster < clusterCount; ++cluster)
+	{
+		float occlusionPotential = math::dot(clusterCentroids[cluster] - meshCentroid, clusterNormals[cluster]);
+		keys[cluster] = makeDescendingKey(occlusionPotential);
+		clusters[cluster] = cluster;
+	}
+	sorting::radixSort(keys.data(), clusters.data(), clusterCount, tmpKeys.data(), tmpClusters.data());
+
+	DataArray<u32> output(&scratchAllocator());
+	output.reserve(_indexCount);
+	for (u32 cluster : clusters)
+	{
+		u32 firstIndex = clusterStarts[cluster] * 3;
+		u32 endIndex = clusterStarts[cluster + 1] * 3;
+		output.push_back(_indices + firstIndex, endIndex - firstIndex);
+	}
+	memcpy(_indices, output.data(), _indexCount * sizeof(u32));
+}
+
+u32 optimizeVertexFetch(Vertex* _vertices, u32 _vertexCount, u32* _indices, u32 _indexCount)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	DataArray<u32> remap(&scratchAllocator());
+	remap.resize(_vertexCount);
+	memset(remap.data(), 0xFF, _vertexCount * sizeof(u32));
+
+	u32 fetchedCount = 0;
+	for (u32 i = 0; i < _indexCount; ++i)
+	{
+		u32& newIndex = remap[_indices[i]];
+		if (newIndex == INVALID_INDEX)
+		{
+			newIndex = fetchedCount++;
+		}
+		_indices[i] = newIndex;
+	}
+
+	DataArray<Vertex> reordered(&scratchAllocator());
+	reordered.resize(fetchedCount);
+	for (u32 i = 0; i < _vertexCount; ++i)
+	{
+		if (remap[i] != INVALID_INDEX)
+		{
+			reordered[remap[i]] = _vertices[i];
+		}
+	}
+	memcpy(_vertices, reordered.data(), fetchedCount * sizeof(Vertex));
+	return fetchedCount;
+}
+
+VertexCacheStatistics analyzeVertexCache(const u32* _indices, u32 _indexCount, u32 _vertexCount)
+{
+	VertexCacheStatistics statistics;
+	if (_indexCount < 3)
+		return statistics;
+
+	DataArray<u32> cacheTimes(&scratchAllocator());
+	cacheTimes.resize(_vertexCount);
+	memset(cacheTimes.data(), 0, _vertexCount * sizeof(u32));
+
+	u32 timestamp = FIRST_CACHE_TIMESTAMP;
+	u32 usedVertexCount = 0;
+	for (u32 i = 0; i < _indexCount; ++i)
+	{
+		u32 vertex = _indices[i];
+		YAE_ASSERT(vertex < _vertexCount);
+		if (isInCache(cacheTimes[vertex], timestamp))
+			continue;
+
+		if (cacheTimes[vertex] == 0)
+		{
+			++usedVertexCount;
+		}
+		cacheTimes[vertex] = timestamp++;
+	}
+
+	u32 missCount = timestamp - FIRST_CACHE_TIMESTAMP;
+	statistics.acmr = float(missCount) / float(_indexCount / 3);
+	statistics.atvr = float(missCount) / float(usedVertexCount);
+	return statistics;
+}
+
+void cookMesh(const Vertex* _vertices, u32 _vertexCount, const u32* _indices, u32 _indexCount, const VertexCacheStatistics& _sourceStatistics, u32 _sourceHash, DataArray<u8>& _outData)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	CookedMeshHeader header = {};
+	header.magic = COOKED_MESH_MAGIC;
+	header.version = YAE_MESH_COOK_VERSION;
+	header.sourceHash = _sourceHash;
+	header.vertexCount = _vertexCount;
+	header.indexCount = _indexCount;
+	header.sourceStatistics = _sourceStatistics;
+	header.statistics = analyzeVertexCache(_indices, _indexCount, _vertexCount);
+
+	u32 verticesSize = _vertexCount * sizeof(Vertex);
+	u32 indicesSize = _indexCount * sizeof(u32);
+	_outData.resize(sizeof(header) + verticesSize + indicesSize);
+	memcpy(_outData.data(), &header, sizeof(header));
+	memcpy(_outData.data() + sizeof(header), _vertices, verticesSize);
+	memcpy(_outData.data() + sizeof(header) + verticesSize, _indices, indicesSize);
+}
+
+bool readCookedMesh(const void* _data, u32 _dataSize, CookedMesh& _outMesh)
+{
+	if (_dataSize < sizeof(CookedMeshHeader))
+		return false;
+
+	const CookedMeshHeader* header = (const CookedMeshHeader*)_data;
+	u64 expectedSize = sizeof(CookedMeshHeader) + u64(header->vertexCount) * sizeof(Vertex) + u64(header->indexCount) * sizeof(u32);
+	if (header->magic != COOKED_MESH_MAGIC
+		|| header->version != YAE_MESH_COOK_VERSION
+		|| header->indexCount % 3 != 0
+		|| expectedSize != _dataSize)
+	{
+		return false;
+	}
+
+	const Vertex* vertices = (const Vertex*)(header + 1);
+	const u32* indices = (const u32*)(vertices + header->vertexCount);
+	for (u32 i = 0; i < header->indexCount; ++i)
+	{
+		if (indices[i] >= header->vertexCount)
+			return false;
+	}
+
+	_outMesh.sourceHash = header->sourceHash;
+	_outMesh.vertices = vertices;
+	_outMesh.vertexCount = header->vertexCount;
+	_outMesh.indices = indices;
+	_outMesh.indexCount = header->indexCount;
+	_outMesh.sourceStatistics = header->sourceStatistics;
+	_outMesh.statistics = header->statistics;
+	return true;
+}
+
+} // namespace mesh_cooking
+} // namespace yae
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/rendering/render_types.h>
+#include <core/containers/Array.h>
+
+// Bump when the cooked output changes, cooked files of other versions are rebuilt
+#define YAE_MESH_COOK_VERSION 1
+
+// Post-transform cache size the indices are ordered for, and measured with
+#define YAE_MESH_VERTEX_CACHE_SIZE 16
+
+namespace yae {
+namespace mesh_cooking {
+
+// Post-transform vertex cache efficiency, simulated with a FIFO cache of YAE_MESH_VERTEX_CACHE_SIZE entries
+struct YAE_API VertexCacheStatistics
+{
+	float acmr = 0.f; // average cache miss ratio, transformed vertices per triangle: 3 at worst, around 0.5 for a regular grid
+	float atvr = 0.f; // average transform to vertex ratio, 1 is optimal
+};
+
+// Cooked mesh, the vertices and indices point into the buffer it was read from
+struct YAE_API CookedMesh
+{
+	u32 sourceHash = 0;
+	const Vertex* vertices = nullptr;
+	u32 vertexCount = 0;
+	const u32* indices = nullptr;
+	u32 indexCount = 0;
+	VertexCacheStatistics sourceStatistics; // before optimization
+	VertexCacheStatistics statistics;
+};
+
+// Merges the bitwise identical vertices of an unindexed triangle list. _outRemap receives the welded index of every
+// vertex, returns the welded vertex count: the first occurrences are moved to the front of _vertices, in order.
+YAE_API u32 weldVertices(Vertex* _vertices, u32 _vertexCount, u32* _outRemap);
+
+// Reorders the triangles for the post-transform cache (Tipsify), triangles are kept as is.
+YAE_API void optimizeVertexCache(u32* _indices, u32 _indexCount, u32 _vertexCount);
+
+// Reorders clusters of the cache optimized triangles so that the ones likely to occlude the others are drawn first.
+// Clusters start where the cache would be flushed anyway, the cache efficiency is mostly kept.
+YAE_API void optimizeOverdraw(u32* _indices, u32 _indexCount, const Vertex* _vertices, u32 _vertexCount);
+
+// Reorders the vertices in the order the indices first use them, so that the vertex fetch reads memory linearly.
+// Unreferenced vertices are dropped, returns the new vertex count.
+YAE_API u32 optimizeVertexFetch(Vertex* _vertices, u32 _vertexCount, u32* _indices, u32 _indexCount);
+
+YAE_API VertexCacheStatistics analyzeVertexCache(const u32* _indices, u32 _indexCount, u32 _vertexCount);
+
+// Writes the whole cooked container in _outData
+YAE_API void cookMesh(const Vertex* _vertices, u32 _vertexCount, const u32* _indices, u32 _indexCount, const VertexCacheStatistics& _sourceStatistics, u32 _sourceHash, DataArray<u8>& _outData);
+
+// Reads a cooked container, fails if it is invalid or was produced by another cook version
+YAE_API bool readCookedMesh(const void* _data, u32 _dataSize, CookedMesh& _outMesh);
+
+} // namespace mesh_cooking
+} // namespace yae
@@ -11,10 +11,14 @@
 	#define YAE_IMPLEMENTS_RENDERER_VULKAN 0
 #endif
 
+#ifndef YAE_IMPLEMENTS_RENDERER_NULL
+	#define YAE_IMPLEMENTS_RENDERER_NULL 0
+#endif
+
 #if YAE_IMPLEMENTS_RENDERER_VULKAN
 #include <vulkan/vulkan.h>
 
-#define VK_VERIFY(_exp) if ((_exp) != VK_SUCCESS) { YAE_ERROR_CAT("vulkan", "Failed Vulkan call: "#_exp); YAE_ASSERT(false); }
+#define VK_VERIFY(_exp) if ((_exp) != VK_SUCCESS) { YAE_ERROR_CAT(vulkan, "Failed Vulkan call: "#_exp); YAE_ASSERT(false); }
 
 VK_DEFINE_HANDLE(VmaAllocator);
 VK_DEFINE_HANDLE(VmaAllocation);
@@ -25,7 +29,8 @@ namespace yae {
 enum class RendererType : u8
 {
 	Vulkan,
-	OpenGL
+	OpenGL,
+	Null, // no GPU, used to run headless
 };
 
 #if YAE_IMPLEMENTS_RENDERER_VULKAN
@@ -83,6 +88,22 @@ struct YAE_API TextureParameters
 	TextureFilter filter = TextureFilter::LINEAR;
 };
 
+// Formats of the pixel data given to the renderer, block compressed formats are encoded in 4x4 pixel blocks
+enum class TextureFormat : u8
+{
+	RGBA8 = 0,
+	BC1, // 8 bytes per block, opaque RGB (DXT1)
+	BC3, // 16 bytes per block, RGB with interpolated alpha (DXT5)
+	COUNT
+};
+
+// One level of a mip chain, tightly packed in the texture format
+struct YAE_API TextureMip
+{
+	const void* data = nullptr;
+	u32 size = 0;
+};
+
 /*
 struct MeshHandle
 {
@@ -119,6 +140,59 @@ struct Vertex {
 	}
 };
 
+// Vertex attributes, in the order they are interleaved. The index is the shader location.
+enum class VertexAttribute : u8
+{
+	POSITION = 0,
+	TEXCOORD,
+	NORMAL,
+	COLOR,
+	COUNT
+};
+
+// Storage of a mesh vertex attribute on the GPU, quantized formats are converted back to floats by the vertex fetch
+enum class VertexAttributeFormat : u8
+{
+	FLOAT2 = 0,
+	FLOAT3,
+	HALF4, // 3 half floats and padding
+	UNORM16x2, // [0, 1]
+	SNORM10x3, // packed 10:10:10:2, [-1, 1]
+	UNORM8x4, // [0, 1], alpha is always 1
+	COUNT
+};
+
+// Layout of the vertices of a mesh in its GPU buffers, see vertex_format.h
+struct YAE_API VertexFormat
+{
+	VertexAttributeFormat attributes[u32(VertexAttribute::COUNT)] =
+	{
+		VertexAttributeFormat::FLOAT3,
+		VertexAttributeFormat::FLOAT2,
+		VertexAttributeFormat::FLOAT3,
+		VertexAttributeFormat::FLOAT3
+	}; // same layout as Vertex
+
+	VertexAttributeFormat get(VertexAttribute _attribute) const { return attributes[u32(_attribute)]; }
+	bool operator==(const VertexFormat& _other) const { return memcmp(attributes, _other.attributes, sizeof(attributes)) == 0; }
+	bool operator!=(const VertexFormat& _other) const { return !(*this == _other); }
+};
+
+// Text vertex, 20 bytes instead of the 44 of Vertex: glyphs need neither normal nor float texture coordinates
+struct GlyphVertex
+{
+	Vector3 pos; // world space, glyph batches are drawn without instance transform
+	u16 u, v; // atlas pixel coordinates, independent of the atlas size
+	u32 color; // RGBA8
+};
+
+// Layout of the vertices a draw command reads
+enum class VertexLayout : u8
+{
+	STANDARD = 0, // Vertex
+	GLYPH, // GlyphVertex
+};
+
 enum class ShaderType : u8
 {
 	UNDEFINED = 0,
@@ -127,6 +201,13 @@ enum class ShaderType : u8
 	FRAGMENT,
 };
 
+// Passes are rendered in order, see sorting::makeDrawKey
+enum class RenderPass : u8
+{
+	SOLID = 0, // sorted by state, front to back
+	BLENDED, // sorted back to front
+};
+
 enum class PrimitiveMode : u8
 {
 	POINTS = 0,
@@ -0,0 +1,252 @@
+#include "NullRenderer.h"
+
+#include <yae/rendering/vertex_format.h>
+
+#include <im3d/im3d.h>
+#include <imgui/imgui.h>
+#include <core/yae_sdl.h>
+
+namespace yae {
+
+u32 NullRenderer::getWindowFlags() const
+{
+	return SDL_WINDOW_HIDDEN;
+}
+
+void NullRenderer::waitIdle()
+{
+}
+
+bool NullRenderer::createTexture(const void* _data, int _width, int _height, int _channels, TextureHandle& _outTextureHandle)
+{
+	_outTextureHandle = _createHandle();
+	m_currentStats.uploadedBytes += u64(_width) * u64(_height) * u64(_channels > 1 ? 4 : 1);
+	return true;
+}
+
+bool NullRenderer::createTexture(TextureFormat _format, u32 _width, u32 _height, const TextureMip* _mips, u32 _mipCount, TextureHandle& _outTextureHandle)
+{
+	YAE_ASSERT(_mips != nullptr && _mipCount > 0);
+
+	_outTextureHandle = _createHandle();
+	for (u32 i = 0; i < _mipCount; ++i)
+	{
+		m_currentStats.uploadedBytes += _mips[i].size;
+	}
+	return true;
+}
+
+bool NullRenderer::isTextureFormatSupported(TextureFormat _format) const
+{
+	// Behaves like a desktop GPU, so that headless runs go through the compressed path
+	return true;
+}
+
+void NullRenderer::updateTexture(TextureHandle& _inTextureHandle, const void* _data, int _width, int _height, int _channels)
+{
+	YAE_ASSERT(_inTextureHandle != 0);
+	m_currentStats.uploadedBytes += u64(_width) * u64(_height) * u64(_channels > 1 ? 4 : 1);
+}
+
+void NullRenderer::applyTextureParameters(TextureHandle& _inTextureHandle, const TextureParameters& _parameters)
+{
+	YAE_ASSERT(_inTextureHandle != 0);
+}
+
+void NullRenderer::destroyTexture(TextureHandle& _inTextureHandle)
+{
+	_destroyHandle(_inTextureHandle);
+}
+
+bool NullRenderer::createMesh(const VertexFormat& _vertexFormat, const void* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, MeshHandle& _outMeshHandle)
+{
+	_outMeshHandle = _createHandle();
+	m_currentStats.uploadedBytes += _verticesCount * vertex_format::getStride(_vertexFormat) + _indicesCount * sizeof(*_indices);
+	return true;
+}
+
+void NullRenderer::destroyMesh(MeshHandle& _inMeshHandle)
+{
+	_destroyHandle(_inMeshHandle);
+}
+
+bool NullRenderer::createShader(ShaderType _type, const char* _source, size_t _sourceSize, ShaderHandle& _outShaderHandle)
+{
+	_outShaderHandle = _createHandle();
+	return true;
+}
+
+void NullRenderer::destroyShader(ShaderHandle& _shaderHandle)
+{
+	_destroyHandle(_shaderHandle);
+}
+
+bool NullRenderer::createShaderProgram(ShaderHandle* _shaderHandles, u16 _shaderHandleCount, ShaderProgramHandle& _outShaderProgramHandle)
+{
+	for (u16 i = 0; i < _shaderHandleCount; ++i)
+	{
+		YAE_ASSERT(_shaderHandles[i] != 0);
+	}
+	_outShaderProgramHandle = _createHandle();
+	return true;
+}
+
+void NullRenderer::destroyShaderProgram(ShaderProgramHandle& _shaderProgramHandle)
+{
+	_destroyHandle(_shaderProgramHandle);
+}
+
+const NullRendererStats& NullRenderer::getFrameStats() const
+{
+	return m_frameStats;
+}
+
+u32 NullRenderer::getLiveHandleCount() const
+{
+	return m_liveHandleCount;
+}
+
+bool NullRenderer::_init()
+{
+	YAE_VERBOSE_CAT(renderer, "Null renderer initialized, nothing will be drawn");
+	return true;
+}
+
+void NullRenderer::_shutdown()
+{
+	if (m_liveHandleCount != 0)
+	{
+		YAE_WARNINGF_CAT(renderer, "%d renderer resources have not been destroyed", m_liveHandleCount);
+	}
+}
+
+bool NullRenderer::_initImGui()
+{
+	// Build the font atlas ourselves, this is normally done by the rendering backend
+	ImGuiIO& io = ImGui::GetIO();
+	io.BackendRendererName = "yae_null";
+
+	unsigned char* pixels = nullptr;
+	int width = 0, height = 0;
+	io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+	io.Fonts->SetTexID((ImTextureID)(intptr_t)_createHandle());
+	return true;
+}
+
+void NullRenderer::_renderImGui()
+{
+	ImDrawData* drawData = ImGui::GetDrawData();
+	if (drawData == nullptr)
+		return;
+
+	m_currentStats.uploadedBytes += drawData->TotalVtxCount * sizeof(ImDrawVert) + drawData->TotalIdxCount * sizeof(ImDrawIdx);
+}
+
+void NullRenderer::_shutdownImGui()
+{
+	ImGuiIO& io = ImGui::GetIO();
+	u32 fontTexture = (u32)(intptr_t)io.Fonts->TexID;
+	_destroyHandle(fontTexture);
+	io.Fonts->SetTexID((ImTextureID)0);
+	io.BackendRendererName = nullptr;
+}
+
+bool NullRenderer::_initIm3d()
+{
+	return true;
+}
+
+void NullRenderer::_shutdownIm3d()
+{
+}
+
+void NullRenderer::_renderIm3d(const RenderCamera* _camera)
+{
+	for (u32 i = 0, n = Im3d::GetDrawListCount(); i < n; ++i)
+	{
+		const Im3d::DrawList& drawList = Im3d::GetDrawLists()[i];
+		m_currentStats.uploadedBytes += drawList.m_vertexCount * sizeof(Im3d::VertexData);
+	}
+}
+
+void NullRenderer::_initRenderTarget(RenderTarget& _renderTarget)
+{
+	YAE_ASSERT(_renderTarget.m_width != 0);
+	YAE_ASSERT(_renderTarget.m_height != 0);
+
+	_renderTarget.m_frameBuffer = _createHandle();
+	_renderTarget.m_renderTexture = _createHandle();
+	_renderTarget.m_depthTexture = _createHandle();
+}
+
+void NullRenderer::_resizeRenderTarget(RenderTarget& _renderTarget)
+{
+	YAE_ASSERT(_renderTarget.m_width != 0);
+	YAE_ASSERT(_renderTarget.m_height != 0);
+}
+
+void NullRenderer::_shutdownRenderTarget(RenderTarget& _renderTarget)
+{
+	_destroyHandle(_renderTarget.m_depthTexture);
+	_destroyHandle(_renderTarget.m_renderTexture);
+	_destroyHandle(_renderTarget.m_frameBuffer);
+}
+
+void NullRenderer::_beginFrame()
+{
+	m_currentStats = NullRendererStats();
+}
+
+void NullRenderer::_beginRender()
+{
+	// Culling and copies are done at this point
+	for (const auto& pair : m_scenes)
+	{
+		m_currentStats.drawCommands += pair.value->m_drawCommands.size();
+	}
+	m_currentStats.verticesCopied = m_vertices.size();
+	m_currentStats.indicesCopied = m_indices.size();
+	m_currentStats.instances = m_instanceTransforms.size();
+	m_currentStats.glyphVerticesCopied = m_glyphVertices.size();
+
+	u64 streamedBytes = m_vertices.size() * sizeof(*m_vertices.data()) + m_indices.size() * sizeof(*m_indices.data()) + m_instanceTransforms.size() * sizeof(Matrix4)
+		+ m_glyphVertices.size() * sizeof(GlyphVertex);
+	m_currentStats.uploadedBytes += streamedBytes;
+	YAE_CAPTURE_COUNTER_ADD("renderer.uploadedBytes", streamedBytes);
+}
+
+void NullRenderer::_renderCamera(const RenderCamera* _camera)
+{
+	YAE_ASSERT(_camera != nullptr);
+	YAE_ASSERT(_camera->m_scene != nullptr);
+
+	// Commands are already culled and sorted, see Renderer::_sortDrawCommands
+	++m_currentStats.cameraCount;
+	m_currentStats.drawCalls += m_sortedDrawCommands.size();
+	YAE_CAPTURE_COUNTER_ADD("renderer.drawCalls", m_sortedDrawCommands.size());
+}
+
+void NullRenderer::_endRender()
+{
+}
+
+void NullRenderer::_endFrame()
+{
+	m_frameStats = m_currentStats;
+}
+
+u32 NullRenderer::_createHandle()
+{
+	++m_liveHandleCount;
+	return m_nextHandle++;
+}
+
+void NullRenderer::_destroyHandle(u32& _handle)
+{
+	YAE_ASSERT(_handle != 0);
+	YAE_ASSERT(m_liveHandleCount > 0);
+	--m_liveHandleCount;
+	_handle = 0;
+}
+
+} // namespace yae
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/rendering/Renderer.h>
+
+namespace yae {
+
+struct YAE_API NullRendererStats
+{
+	u32 drawCommands = 0; // submitted to all scenes
+	u32 drawCalls = 0; // visible commands, summed over cameras
+	u32 cameraCount = 0;
+	u32 verticesCopied = 0; // dynamic geometry copied in the frame buffers
+	u32 indicesCopied = 0;
+	u32 instances = 0; // per instance transforms streamed in the frame
+	u32 glyphVerticesCopied = 0; // text batches
+	u64 uploadedBytes = 0; // what a GPU backend would have uploaded: dynamic geometry, ImGui, Im3d, and resources created during the frame
+};
+
+// Renderer backend without GPU, for headless runs and benchmarking the CPU side of the renderer.
+// Resources get fake handles, nothing is drawn and every frame only records statistics.
+class YAE_API NullRenderer : public Renderer
+{
+public:
+	virtual RendererType getType() const override { return RendererType::Null; }
+
+	virtual u32 getWindowFlags() const override;
+
+	virtual void waitIdle() override;
+
+	virtual bool createTexture(const void* _data, int _width, int _height, int _channels, TextureHandle& _outTextureHandle) override;
+	virtual bool createTexture(TextureFormat _format, u32 _width, u32 _height, const TextureMip* _mips, u32 _mipCount, TextureHandle& _outTextureHandle) override;
+	virtual bool isTextureFormatSupported(TextureFormat _format) const override;
+	virtual void updateTexture(TextureHandle& _inTextureHandle, const void* _data, int _width, int _height, int _channels) override;
+	virtual void applyTextureParameters(TextureHandle& _inTextureHandle, const TextureParameters& _parameters) override;
+	virtual void destroyTexture(TextureHandle& _inTextureHandle) override;
+
+	virtual bool createMesh(const VertexFormat& _vertexFormat, const void* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, MeshHandle& _outMeshHandle) override;
+	virtual void destroyMesh(MeshHandle& _inMeshHandle) override;
+
+	virtual bool createShader(ShaderType _type, const char* _source, size_t _sourceSize, ShaderHandle& _outShaderHandle) override;
+	virtual void destroyShader(ShaderHandle& _shaderHandle) override;
+
+	virtual bool createShaderProgram(ShaderHandle* _shaderHandles, u16 _shaderHandleCount, ShaderProgramHandle& _outShaderProgramHandle) override;
+	virtual void destroyShaderProgram(ShaderProgramHandle& _shaderProgramHandle) override;
+
+	const NullRendererStats& getFrameStats() const; // last completed frame
+	u32 getLiveHandleCount() const;
+
+//private:
+	virtual bool _init() override;
+	virtual void _shutdown() override;
+
+	virtual bool _initImGui() override;
+	virtual void _renderImGui() override;
+	virtual void _shutdownImGui() override;
+
+	virtual bool _initIm3d() override;
+	virtual void _shutdownIm3d() override;
+	virtual void _renderIm3d(const RenderCamera* _camera) override;
+
+	virtual void _initRenderTarget(RenderTarget& _renderTarget) override;
+	virtual void _resizeRenderTarget(RenderTarget& _renderTarget) override;
+	virtual void _shutdownRenderTarget(RenderTarget& _renderTarget) override;
+
+	virtual void _beginFrame() override;
+	virtual void _beginRender() override;
+	virtual void _renderCamera(const RenderCamera* _camera) override;
+	virtual void _endRender() override;
+	virtual void _endFrame() override;
+
+	u32 _createHandle();
+	void _destroyHandle(u32& _handle);
+
+	u32 m_nextHandle = 1;
+	u32 m_liveHandleCount = 0;
+
+	NullRendererStats m_currentStats;
+	NullRendererStats m_frameStats;
+};
+
+} // namespace yae
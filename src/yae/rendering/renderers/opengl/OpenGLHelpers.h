@@ -14,7 +14,7 @@
 #endif
 
 #define YAE_GL_VERIFY(_instruction) { _instruction; GLint ___error = glGetError(); YAE_ASSERT_MSGF(___error == GL_NO_ERROR, "GL Error %s(0x%04x) -> " #_instruction, yae::glErrorToString(___error), ___error); }
-#define YAE_GL_TEST(_instruction) [&](){ _instruction; GLint ___error = glGetError(); if (___error != GL_NO_ERROR) { YAE_ERRORF_CAT("renderer", "GL Error %s(0x%04x) -> ", #_instruction, yae::glErrorToString(___error), ___error); } return ___error == GL_NO_ERROR; }()
+#define YAE_GL_TEST(_instruction) [&](){ _instruction; GLint ___error = glGetError(); if (___error != GL_NO_ERROR) { YAE_ERRORF_CAT(renderer, "GL Error %s(0x%04x) -> ", #_instruction, yae::glErrorToString(___error), ___error); } return ___error == GL_NO_ERROR; }()
 
 namespace yae {
 
@@ -3,12 +3,16 @@
 #include <core/filesystem.h>
 #include <core/Program.h>
 #include <core/gl3w.h>
+#include <core/hash.h>
+#include <core/math.h>
+#include <core/string.h>
 
 #include <yae/resources/ShaderFile.h>
 #include <yae/resources/FontFile.h>
 #include <yae/resources/File.h>
 #include <yae/resource.h>
 #include <yae/rendering/renderers/opengl/OpenGLHelpers.h>
+#include <yae/rendering/vertex_format.h>
 
 
 #include <imgui/backends/imgui_impl_opengl3.h>
@@ -32,6 +36,24 @@ const char* OPENGL_SHADER_VERSION = "#version 300 es";
 
 #define YAE_RENDER_IM3D (YAE_OPENGL_ES == 0)
 
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// Initial streaming buffers capacities, per frame segment. They grow when a frame does not fit.
+const u32 STREAM_VERTEX_CAPACITY = 64 * 1024;
+const u32 STREAM_INDEX_CAPACITY = 3 * STREAM_VERTEX_CAPACITY;
+const u32 STREAM_INSTANCE_CAPACITY = 16 * 1024;
+const u32 STREAM_GLYPH_VERTEX_CAPACITY = 16 * 1024;
+const u32 STREAM_INDIRECT_CAPACITY = 4 * 1024;
+
+// Initial shared mesh buffers capacities
+const u32 MESH_VERTEX_CAPACITY = 256 * 1024;
+const u32 MESH_INDEX_CAPACITY = 3 * MESH_VERTEX_CAPACITY;
+
 
 GLuint primitiveModeToGlPrimitiveMode(yae::PrimitiveMode _primitiveMode)
 {
@@ -56,15 +78,130 @@ GLuint textureFilterToGlTextureFilter(yae::TextureFilter _textureFilter)
 	}
 }
 
+void setupVertexAttributes(size_t _offset = 0)
+{
+	YAE_GL_VERIFY(glEnableVertexAttribArray(0));
+	YAE_GL_VERIFY(glEnableVertexAttribArray(1));
+	YAE_GL_VERIFY(glEnableVertexAttribArray(2));
+	YAE_GL_VERIFY(glEnableVertexAttribArray(3));
+	YAE_GL_VERIFY(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(yae::Vertex), (const GLvoid*)(_offset))); // Vertex
+	YAE_GL_VERIFY(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(yae::Vertex), (const GLvoid*)(_offset + sizeof(float)*3))); // TexCoord
+	YAE_GL_VERIFY(glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(yae::Vertex), (const GLvoid*)(_offset + sizeof(float)*5))); // Normal
+	YAE_GL_VERIFY(glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(yae::Vertex), (const GLvoid*)(_offset + sizeof(float)*8))); // Color
+}
+
+void vertexAttributeFormatToGl(yae::VertexAttributeFormat _format, GLint& _outSize, GLenum& _outType, GLboolean& _outNormalized)
+{
+	switch (_format)
+	{
+	case yae::VertexAttributeFormat::FLOAT2: _outSize = 2; _outType = GL_FLOAT; _outNormalized = GL_FALSE; break;
+	case yae::VertexAttributeFormat::FLOAT3: _outSize = 3; _outType = GL_FLOAT; _outNormalized = GL_FALSE; break;
+	case yae::VertexAttributeFormat::HALF4: _outSize = 3; _outType = GL_HALF_FLOAT; _outNormalized = GL_FALSE; break; // padding skipped
+	case yae::VertexAttributeFormat::UNORM16x2: _outSize = 2; _outType = GL_UNSIGNED_SHORT; _outNormalized = GL_TRUE; break;
+	case yae::VertexAttributeFormat::SNORM10x3: _outSize = 4; _outType = GL_INT_2_10_10_10_REV; _outNormalized = GL_TRUE; break; // packed formats are 4 components
+	case yae::VertexAttributeFormat::UNORM8x4: _outSize = 4; _outType = GL_UNSIGNED_BYTE; _outNormalized = GL_TRUE; break;
+	default: YAE_ASSERT(false); _outSize = 3; _outType = GL_FLOAT; _outNormalized = GL_FALSE; break;
+	}
+}
+
+// Same locations as the standard layout, quantized attributes are converted back to floats by the vertex fetch
+void setupMeshVertexAttributes(const yae::VertexFormat& _format)
+{
+	GLsizei stride = (GLsizei)yae::vertex_format::getStride(_format);
+	for (GLuint location = 0; location < GLuint(yae::VertexAttribute::COUNT); ++location)
+	{
+		GLint size;
+		GLenum type;
+		GLboolean normalized;
+		vertexAttributeFormatToGl(_format.attributes[location], size, type, normalized);
+		size_t offset = yae::vertex_format::getOffset(_format, yae::VertexAttribute(location));
+		YAE_GL_VERIFY(glEnableVertexAttribArray(location));
+		YAE_GL_VERIFY(glVertexAttribPointer(location, size, type, normalized, stride, (const GLvoid*)offset));
+	}
+}
+
+// Same locations as the standard layout, without normal
+void setupGlyphVertexAttributes(size_t _offset)
+{
+	YAE_GL_VERIFY(glEnableVertexAttribArray(0));
+	YAE_GL_VERIFY(glEnableVertexAttribArray(1));
+	YAE_GL_VERIFY(glEnableVertexAttribArray(3));
+	YAE_GL_VERIFY(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(yae::GlyphVertex), (const GLvoid*)(_offset + offsetof(yae::GlyphVertex, pos)))); // Vertex
+	YAE_GL_VERIFY(glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(yae::GlyphVertex), (const GLvoid*)(_offset + offsetof(yae::GlyphVertex, u)))); // TexCoord, in atlas pixels
+	YAE_GL_VERIFY(glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(yae::GlyphVertex), (const GLvoid*)(_offset + offsetof(yae::GlyphVertex, color)))); // Color
+}
+
+void channelsToGlFormat(int _channels, GLuint& _outInternalFormat, GLuint& _outFormat)
+{
+#if YAE_OPENGL_ES
+	switch(_channels)
+	{
+		case 1:
+		{
+			_outInternalFormat = GL_ALPHA;
+			_outFormat = GL_ALPHA;
+		}
+		break;
+		default:
+		{
+			_outInternalFormat = GL_RGBA;
+			_outFormat = GL_RGBA;
+		}
+		break;
+	}
+#else
+	switch(_channels)
+	{
+		case 1:
+		{
+			_outInternalFormat = GL_R8;
+			_outFormat = GL_RED;
+		}
+		break;
+		default:
+		{
+			_outInternalFormat = GL_RGBA8;
+			_outFormat = GL_RGBA;
+		}
+		break;
+	}
+#endif
+}
+
+// Per instance model matrix, one column per attribute
+void setupInstanceAttributes(GLuint _instanceBuffer, size_t _offset)
+{
+	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer));
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		GLuint location = 4 + column;
+		YAE_GL_VERIFY(glEnableVertexAttribArray(location));
+		YAE_GL_VERIFY(glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(yae::Matrix4), (const GLvoid*)(_offset + sizeof(float) * 4 * column)));
+		YAE_GL_VERIFY(glVertexAttribDivisor(location, 1));
+	}
+}
+
+bool hasExtension(const char* _name)
+{
+	GLint extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+	for (GLint i = 0; i < extensionCount; ++i)
+	{
+		if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), _name) == 0)
+			return true;
+	}
+	return false;
+}
+
 void glDebugCallback(GLenum _source, GLenum _type, GLuint _id, GLenum _severity, GLsizei _length, const GLchar* _msg, const void* _data)
 {
 	if (_id == 0x20071) return; // Message about buffer usage hints when calling glBufferData
 
 	switch(_severity)
 	{
-		case GL_DEBUG_SEVERITY_HIGH: YAE_ERRORF_CAT("renderer", "gldebug 0x%04x:0x%04x:0x%04x: %s", _source, _type, _id, _msg); break;
-		case GL_DEBUG_SEVERITY_MEDIUM: YAE_WARNINGF_CAT("renderer", "gldebug 0x%04x:0x%04x:0x%04x: %s", _source, _type, _id, _msg); break;
-		default: YAE_VERBOSEF_CAT("renderer", "gldebug 0x%04x:0x%04x:0x%04x: %s", _source, _type, _id, _msg); break;
+		case GL_DEBUG_SEVERITY_HIGH: YAE_ERRORF_CAT(renderer, "gldebug 0x%04x:0x%04x:0x%04x: %s", _source, _type, _id, _msg); break;
+		case GL_DEBUG_SEVERITY_MEDIUM: YAE_WARNINGF_CAT(renderer, "gldebug 0x%04x:0x%04x:0x%04x: %s", _source, _type, _id, _msg); break;
+		default: YAE_VERBOSEF_CAT(renderer, "gldebug 0x%04x:0x%04x:0x%04x: %s", _source, _type, _id, _msg); break;
 	}
 }
 
@@ -101,7 +238,7 @@ bool OpenGLRenderer::_init()
 
 	if (SDL_GL_SetSwapInterval(-1) < 0)
 	{
-		YAE_VERBOSE_CAT("renderer", "Adaptative VSync not suported, falling back to normal vsync");
+		YAE_VERBOSE_CAT(renderer, "Adaptative VSync not suported, falling back to normal vsync");
 		YAE_SDL_VERIFY(SDL_GL_SetSwapInterval(1));
 	}
 
@@ -133,7 +270,7 @@ bool OpenGLRenderer::_init()
 
 	if (gl3wIsSupported(OPENGL_VERSION_MAJOR, OPENGL_VERSION_MINOR) == false)
 	{
-		YAE_ERRORF_CAT("renderer", "OpenGL Version %d.%d not supported by gl3w.", OPENGL_VERSION_MAJOR, OPENGL_VERSION_MINOR);
+		YAE_ERRORF_CAT(renderer, "OpenGL Version %d.%d not supported by gl3w.", OPENGL_VERSION_MAJOR, OPENGL_VERSION_MINOR);
 		return false;
 	}
 
@@ -141,55 +278,118 @@ bool OpenGLRenderer::_init()
 	glGetIntegerv(GL_CONTEXT_FLAGS, &v);
 	if (v & GL_CONTEXT_FLAG_DEBUG_BIT)
 	{
-		YAE_VERBOSE_CAT("renderer", "OpenGL debug context present");
+		YAE_VERBOSE_CAT(renderer, "OpenGL debug context present");
 		glDebugMessageCallback(&glDebugCallback, nullptr);
 	}
 #endif
 
 	const char* glVersion = (const char*)glGetString(GL_VERSION);
-	YAE_LOGF_CAT("renderer", "OpenGL Version: \"%s\"", glVersion);
+	YAE_LOGF_CAT(renderer, "OpenGL Version: \"%s\"", glVersion);
 
+	int maxVertexAttribs;
+	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertexAttribs);
+	YAE_ASSERT(maxVertexAttribs >= 8);
+
+	// Dynamic geometry vertex array, its vertex attributes are pointed at the current stream segment every frame
 	YAE_GL_VERIFY(glGenVertexArrays(1, &m_vao));
-	YAE_GL_VERIFY(glBindVertexArray(m_vao));
+	YAE_GL_VERIFY(glGenVertexArrays(1, &m_glyphVertexArray));
 
-	GLuint buffers[2] = {} ; // 0 is vertices, 1 is indices
-	YAE_GL_VERIFY(glGenBuffers(2, buffers));
-	m_vertexBufferObject = buffers[0];
-	m_indexBufferObject = buffers[1];
+#if YAE_OPENGL_ES == 0
+	GLint majorVersion = 0, minorVersion = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+	glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+	bool hasBufferStorage = (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 4)) || hasExtension("GL_ARB_buffer_storage");
+	m_streamMode = hasBufferStorage ? OpenGLStreamMode::PERSISTENT : OpenGLStreamMode::UNSYNCHRONIZED;
+#else
+	m_streamMode = OpenGLStreamMode::SUB_DATA;
+#endif
+	const char* streamModeNames[] = { "persistent", "unsynchronized", "sub data" };
+	YAE_VERBOSEF_CAT(renderer, "Streaming buffers mode: %s", streamModeNames[u8(m_streamMode)]);
 
-	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, (GLuint)m_vertexBufferObject));
-	YAE_GL_VERIFY(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (GLuint)m_indexBufferObject));
+	// Emscripten exposes the WebGL extensions with a GL_ prefix
+	m_isS3tcSupported = hasExtension("GL_EXT_texture_compression_s3tc") || hasExtension("GL_WEBGL_compressed_texture_s3tc");
+	YAE_VERBOSEF_CAT(renderer, "S3TC texture compression %s", m_isS3tcSupported ? "supported" : "not supported");
 
-	int maxVertexAttribs;
-	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertexAttribs);
-	YAE_ASSERT(maxVertexAttribs >= 4);
+	// Program binaries are only valid for the driver that produced them
+	m_driverIdentity = string::format("%s|%s|%s", (const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER), glVersion);
+#if YAE_OPENGL_ES == 0
+	GLint programBinaryFormatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &programBinaryFormatCount);
+	if (programBinaryFormatCount > 0)
+	{
+		String cacheDirectory = string::format("%s/shader_cache/", program().getIntermediateDirectory());
+		filesystem::createDirectory(cacheDirectory.c_str());
+		m_isProgramCacheEnabled = filesystem::doesPathExists(cacheDirectory.c_str());
+		if (m_isProgramCacheEnabled)
+		{
+			_scanProgramCache();
+		}
+	}
+#endif
+	YAE_VERBOSEF_CAT(renderer, "Program binary cache %s", m_isProgramCacheEnabled ? "enabled" : "disabled");
 
-	YAE_GL_VERIFY(glEnableVertexAttribArray(0));
-	YAE_GL_VERIFY(glEnableVertexAttribArray(1));
-	YAE_GL_VERIFY(glEnableVertexAttribArray(2));
-	YAE_GL_VERIFY(glEnableVertexAttribArray(3));
-	YAE_GL_VERIFY(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)0)); // Vertex
-	YAE_GL_VERIFY(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(sizeof(float)*3))); // TexCoord
-	YAE_GL_VERIFY(glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(sizeof(float)*5))); // Normal
-	YAE_GL_VERIFY(glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(sizeof(float)*8))); // Color
+	_createStreamBuffer(m_vertexStream, GL_ARRAY_BUFFER, sizeof(Vertex), STREAM_VERTEX_CAPACITY);
+	_createStreamBuffer(m_indexStream, GL_ELEMENT_ARRAY_BUFFER, sizeof(u32), STREAM_INDEX_CAPACITY);
+	_createStreamBuffer(m_instanceStream, GL_ARRAY_BUFFER, sizeof(Matrix4), STREAM_INSTANCE_CAPACITY);
+	_createStreamBuffer(m_glyphVertexStream, GL_ARRAY_BUFFER, sizeof(GlyphVertex), STREAM_GLYPH_VERTEX_CAPACITY);
+#if YAE_OPENGL_ES == 0
+	_createStreamBuffer(m_indirectStream, GL_DRAW_INDIRECT_BUFFER, sizeof(OpenGLDrawElementsIndirectCommand), STREAM_INDIRECT_CAPACITY);
+#endif
 
-	YAE_GL_VERIFY(glBindVertexArray(0));
+	YAE_VERIFY(_getMeshVertexPool(VertexFormat()) == 0);
+	_createPoolBuffer(m_meshIndices, GL_ELEMENT_ARRAY_BUFFER, sizeof(u32), MESH_INDEX_CAPACITY);
+	_setupMeshVertexArrays();
 
 	return true;
 }
 
 void OpenGLRenderer::_shutdown()
 {
+	// Release leaked shaders
+	for (auto& pair : m_shaderSources)
+	{
+		if (pair.value.shaderId != 0)
+		{
+			glDeleteShader(pair.value.shaderId);
+		}
+		defaultAllocator().deallocate(pair.value.source);
+	}
+	m_shaderSources.clear();
+
+	// Release leaked meshes along with the shared buffers
+	m_meshAllocations.clear();
+	for (u32 i = 0; i < m_meshVertexPoolCount; ++i)
+	{
+		OpenGLMeshVertexPool& pool = m_meshVertexPools[i];
+		_destroyPoolBuffer(pool.vertices);
+		glDeleteVertexArrays(1, &pool.vertexArray);
+		pool.vertexArray = 0;
+	}
+	m_meshVertexPoolCount = 0;
+	_destroyPoolBuffer(m_meshIndices);
+
 	glDeleteBuffers(1, &m_quadVertexBuffer);
 	m_quadVertexBuffer = 0;
 	glDeleteVertexArrays(1, &m_quadVertexArray);
 	m_quadVertexArray = 0;
 
-	GLuint buffers[2] = { m_vertexBufferObject, m_indexBufferObject};
-	glDeleteBuffers(2, buffers);
-	m_vertexBufferObject = 0;
-	m_indexBufferObject = 0;
+	// Leave the mapped storage before it is released
+	m_vertices.setStorage(nullptr, 0);
+	m_indices.setStorage(nullptr, 0);
+	m_instanceTransforms.setStorage(nullptr, 0);
+	m_glyphVertices.setStorage(nullptr, 0);
+
+	_waitStreamFences();
+	_destroyStreamBuffer(m_vertexStream);
+	_destroyStreamBuffer(m_indexStream);
+	_destroyStreamBuffer(m_instanceStream);
+	_destroyStreamBuffer(m_glyphVertexStream);
+#if YAE_OPENGL_ES == 0
+	_destroyStreamBuffer(m_indirectStream);
+#endif
 
+	glDeleteVertexArrays(1, &m_glyphVertexArray);
+	m_glyphVertexArray = 0;
 	glDeleteVertexArrays(1, &m_vao);
 	m_vao = 0;
 
@@ -208,40 +408,7 @@ bool OpenGLRenderer::createTexture(const void* _data, int _width, int _height, i
 
 	GLuint internalFormat;
 	GLuint format;
-
-#if YAE_OPENGL_ES
-	switch(_channels)
-	{
-		case 1:
-		{
-			internalFormat = GL_ALPHA;
-			format = GL_ALPHA;
-		}
-		break;
-		default:
-		{
-			internalFormat = GL_RGBA;
-			format = GL_RGBA;
-		}
-		break;
-	}
-#else
-	switch(_channels)
-	{
-		case 1:
-		{
-			internalFormat = GL_R8;
-			format = GL_RED;
-		}
-		break;
-		default:
-		{
-			internalFormat = GL_RGBA8;
-			format = GL_RGBA;
-		}
-		break;
-	}
-#endif
+	channelsToGlFormat(_channels, internalFormat, format);
 
 	GLuint textureId;
     YAE_GL_VERIFY(glGenTextures(1, &textureId));
@@ -257,19 +424,105 @@ bool OpenGLRenderer::createTexture(const void* _data, int _width, int _height, i
     	GL_UNSIGNED_BYTE, // type
     	_data
     ));
+	YAE_GL_VERIFY(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+
+	_outTextureHandle = textureId;
+	return true;
+}
+
+void OpenGLRenderer::updateTexture(TextureHandle& _inTextureHandle, const void* _data, int _width, int _height, int _channels)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_inTextureHandle != 0);
+
+	GLuint internalFormat;
+	GLuint format;
+	channelsToGlFormat(_channels, internalFormat, format);
+
+	// Respecifying the level keeps the texture name, draw commands already referencing it stay valid
+	YAE_GL_VERIFY(glBindTexture(GL_TEXTURE_2D, (GLuint)_inTextureHandle));
+	YAE_GL_VERIFY(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, _width, _height, 0, format, GL_UNSIGNED_BYTE, _data));
+	YAE_GL_VERIFY(glBindTexture(GL_TEXTURE_2D, 0));
+
+	YAE_CAPTURE_COUNTER_ADD("renderer.uploadedBytes", size_t(_width) * size_t(_height) * (_channels > 1 ? 4 : 1));
+}
+
+bool OpenGLRenderer::createTexture(TextureFormat _format, u32 _width, u32 _height, const TextureMip* _mips, u32 _mipCount, TextureHandle& _outTextureHandle)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_mips != nullptr && _mipCount > 0);
+	if (!isTextureFormatSupported(_format))
+	{
+		YAE_ERRORF_CAT(renderer, "Unsupported texture format %d", u32(_format));
+		return false;
+	}
+
+	GLuint textureId;
+	YAE_GL_VERIFY(glGenTextures(1, &textureId));
+	YAE_GL_VERIFY(glBindTexture(GL_TEXTURE_2D, textureId));
+	for (u32 level = 0; level < _mipCount; ++level)
+	{
+		GLsizei width = GLsizei(math::max(_width >> level, 1u));
+		GLsizei height = GLsizei(math::max(_height >> level, 1u));
+		switch (_format)
+		{
+			case TextureFormat::BC1:
+			{
+				YAE_GL_VERIFY(glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, width, height, 0, _mips[level].size, _mips[level].data));
+			}
+			break;
+			case TextureFormat::BC3:
+			{
+				YAE_GL_VERIFY(glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, width, height, 0, _mips[level].size, _mips[level].data));
+			}
+			break;
+			default:
+			{
+#if YAE_OPENGL_ES
+				YAE_GL_VERIFY(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, _mips[level].data));
+#else
+				YAE_GL_VERIFY(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, _mips[level].data));
+#endif
+			}
+			break;
+		}
+	}
+	// Also tells applyTextureParameters whether to use mipmapped filtering
+	YAE_GL_VERIFY(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _mipCount - 1));
 
 	_outTextureHandle = textureId;
 	return true;
 }
 
+bool OpenGLRenderer::isTextureFormatSupported(TextureFormat _format) const
+{
+	switch (_format)
+	{
+		case TextureFormat::RGBA8: return true;
+		case TextureFormat::BC1:
+		case TextureFormat::BC3: return m_isS3tcSupported;
+		default: return false;
+	}
+}
+
 void OpenGLRenderer::applyTextureParameters(TextureHandle& _inTextureHandle, const TextureParameters& _parameters)
 {
 	YAE_CAPTURE_FUNCTION();
 
 	YAE_GL_VERIFY(glBindTexture(GL_TEXTURE_2D, _inTextureHandle));
 
+	GLint maxLevel = 0;
+	YAE_GL_VERIFY(glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel));
+
 	GLuint textureFilter = textureFilterToGlTextureFilter(_parameters.filter);
-	YAE_GL_VERIFY(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, textureFilter));
+	GLuint minFilter = textureFilter;
+	if (maxLevel > 0)
+	{
+		minFilter = _parameters.filter == TextureFilter::NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+	}
+	YAE_GL_VERIFY(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
 	YAE_GL_VERIFY(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, textureFilter));
 }
 
@@ -281,6 +534,62 @@ void OpenGLRenderer::destroyTexture(TextureHandle& _inTextureHandle)
     YAE_GL_VERIFY(glDeleteTextures(1, &textureId));
 }
 
+bool OpenGLRenderer::createMesh(const VertexFormat& _vertexFormat, const void* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, MeshHandle& _outMeshHandle)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_vertices != nullptr && _verticesCount > 0);
+	YAE_ASSERT(_indices != nullptr && _indicesCount > 0);
+
+	u32 poolIndex = _getMeshVertexPool(_vertexFormat);
+	if (poolIndex == ~0u)
+		return false;
+	OpenGLPoolBuffer& vertexPool = m_meshVertexPools[poolIndex].vertices;
+
+	OpenGLMeshAllocation allocation;
+	allocation.vertexPool = poolIndex;
+	allocation.firstVertex = _allocatePoolRange(vertexPool, _verticesCount);
+	allocation.vertexCount = _verticesCount;
+	allocation.firstIndex = _allocatePoolRange(m_meshIndices, _indicesCount);
+	allocation.indexCount = _indicesCount;
+
+	// Indices are offset to the mesh vertices, there is no base vertex support in GLES
+	DataArray<u32> indices(&scratchAllocator());
+	indices.resize(_indicesCount);
+	for (u32 i = 0; i < _indicesCount; ++i)
+	{
+		indices[i] = allocation.firstVertex + _indices[i];
+	}
+
+	YAE_GL_VERIFY(glBindVertexArray(m_meshVertexPools[poolIndex].vertexArray));
+	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, (GLuint)vertexPool.buffer));
+	YAE_GL_VERIFY(glBufferSubData(GL_ARRAY_BUFFER, GLintptr(allocation.firstVertex) * vertexPool.stride, GLsizeiptr(_verticesCount) * vertexPool.stride, _vertices));
+	YAE_GL_VERIFY(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (GLuint)m_meshIndices.buffer));
+	YAE_GL_VERIFY(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, allocation.firstIndex * sizeof(u32), _indicesCount * sizeof(u32), indices.data()));
+	YAE_GL_VERIFY(glBindVertexArray(0));
+	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+	YAE_CAPTURE_COUNTER_ADD("renderer.uploadedBytes", _verticesCount * vertexPool.stride + _indicesCount * sizeof(*_indices));
+
+	_outMeshHandle = m_nextMeshHandle++;
+	m_meshAllocations.set(_outMeshHandle, allocation);
+	return true;
+}
+
+void OpenGLRenderer::destroyMesh(MeshHandle& _inMeshHandle)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	// Frames in flight may still read the ranges, buffer updates reusing them are synchronized by the driver
+	const OpenGLMeshAllocation* allocation = m_meshAllocations.get(_inMeshHandle);
+	YAE_ASSERT(allocation != nullptr);
+	m_meshVertexPools[allocation->vertexPool].vertices.ranges.free(allocation->firstVertex, allocation->vertexCount);
+	m_meshIndices.ranges.free(allocation->firstIndex, allocation->indexCount);
+
+	m_meshAllocations.remove(_inMeshHandle);
+	_inMeshHandle = 0;
+}
+
 bool OpenGLRenderer::createShader(ShaderType _type, const char* _code, size_t _codeSize, ShaderHandle& _outShaderHandle)
 {
 	YAE_CAPTURE_FUNCTION();
@@ -300,44 +609,42 @@ bool OpenGLRenderer::createShader(ShaderType _type, const char* _code, size_t _c
 	defines = "#define OPENGL_ES\n";
 #endif
 
-	const char* code[] = {version, "\n", defines, _code};
-	GLint codeSize[] = {-1, -1, -1, (GLint)_codeSize};
-	GLuint shaderId = glCreateShader(glShaderType);
-	YAE_ASSERT(shaderId != 0);
-	YAE_GL_VERIFY(glShaderSource(shaderId, countof(code), code, codeSize));
-	YAE_GL_VERIFY(glCompileShader(shaderId));
+	String header = string::format("%s\n%s", version, defines);
+	OpenGLShaderSource shaderSource;
+	shaderSource.type = glShaderType;
+	shaderSource.sourceSize = u32(header.size() + _codeSize);
+	shaderSource.source = (char*)defaultAllocator().allocate(shaderSource.sourceSize);
+	memcpy(shaderSource.source, header.c_str(), header.size());
+	memcpy(shaderSource.source + header.size(), _code, _codeSize);
 
-	GLint status = 0, logLength = 0;
-    YAE_GL_VERIFY(glGetShaderiv(shaderId, GL_COMPILE_STATUS, &status));
-    YAE_GL_VERIFY(glGetShaderiv(shaderId, GL_INFO_LOG_LENGTH, &logLength));
-
-    if (logLength > 1)
-    {
-    	String buf(&scratchAllocator());
-    	buf.resize(logLength);
-        YAE_GL_VERIFY(glGetShaderInfoLog(shaderId, logLength, NULL, (GLchar*)buf.data()));
-    	YAE_ERRORF("Shader compilation result:\n%s", buf.c_str());
-    }
-
-    if ((GLboolean)status == GL_TRUE)
-    {
-    	_outShaderHandle = shaderId;
-    }
-    else
-    {
-    	glDeleteShader(shaderId);
-    	YAE_ERROR("Failed to compile shader.");
-    }
-
-	return (GLboolean)status == GL_TRUE;
+	// A stage that is part of a cached program most likely compiles, it is deferred to createShaderProgram and skipped if the binary loads
+	if (!m_isProgramCacheEnabled || !m_cachedStageHashes.has(_computeStageHash(shaderSource)))
+	{
+		if (!_compileShader(shaderSource, shaderSource.shaderId))
+		{
+			defaultAllocator().deallocate(shaderSource.source);
+			return false;
+		}
+	}
+
+	_outShaderHandle = m_nextShaderHandle++;
+	m_shaderSources.set(_outShaderHandle, shaderSource);
+	return true;
 }
 
 void OpenGLRenderer::destroyShader(ShaderHandle& _shaderHandle)
 {
 	YAE_CAPTURE_FUNCTION();
 
-	GLuint shaderId = (GLuint)_shaderHandle;
-	YAE_GL_VERIFY(glDeleteShader(shaderId));
+	OpenGLShaderSource* shaderSource = m_shaderSources.get(_shaderHandle);
+	YAE_ASSERT(shaderSource != nullptr);
+	if (shaderSource->shaderId != 0)
+	{
+		YAE_GL_VERIFY(glDeleteShader(shaderSource->shaderId));
+	}
+	defaultAllocator().deallocate(shaderSource->source);
+	m_shaderSources.remove(_shaderHandle);
+	_shaderHandle = 0;
 }
 
 
@@ -346,52 +653,45 @@ bool OpenGLRenderer::createShaderProgram(ShaderHandle* _shaderHandles, u16 _shad
 	YAE_CAPTURE_FUNCTION();
 
 	GLuint programId = glCreateProgram();
-	bool error = false;
-	for (u16 i = 0; i < _shaderHandleCount; ++i)
+
+	bool isLinked = false;
+	OpenGLProgramCacheKey cacheKey;
+	if (m_isProgramCacheEnabled)
 	{
-		YAE_ASSERT(_shaderHandles[i] != 0);
-		GLint compiled;
-        error = error || !YAE_GL_TEST(glGetShaderiv((GLuint)_shaderHandles[i], GL_COMPILE_STATUS, &compiled));
-        error = error || compiled == 0;
-    	error = error || !YAE_GL_TEST(glAttachShader(programId, (GLuint)_shaderHandles[i]));
+		cacheKey = _computeProgramCacheKey(_shaderHandles, _shaderHandleCount);
+		isLinked = _loadProgramBinary(programId, cacheKey);
 	}
-	error = error || !YAE_GL_TEST(glLinkProgram(programId));
 
-	GLint status = 0, logLength = 0;
-    YAE_GL_VERIFY(glGetProgramiv(programId, GL_LINK_STATUS, &status));
-    YAE_GL_VERIFY(glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &logLength));
-    if ((GLboolean)status == GL_TRUE)
-    {
-    	_outShaderProgramHandle = programId;
-    }
-    else
-    {
-    	YAE_ERROR("Failed to link shader program.");
-    }
-
-    if (logLength > 1)
-    {
-    	String buf(&scratchAllocator());
-    	buf.resize(logLength);
-        YAE_GL_VERIFY(glGetProgramInfoLog(programId, logLength, NULL, (GLchar*)buf.data()));
-    	YAE_ERRORF("Shader program linking result:\n%s", buf.c_str());
-    }
-    if (error)
+	if (!isLinked)
+	{
+		isLinked = _compileAndLinkProgram(programId, _shaderHandles, _shaderHandleCount);
+		if (isLinked && m_isProgramCacheEnabled)
+		{
+			_saveProgramBinary(programId, cacheKey);
+		}
+	}
+
+	if (!isLinked)
 	{
 		glDeleteProgram(programId);
 		return false;
 	}
 
-	YAE_GL_VERIFY(glBindVertexArray(m_vao)); // It fixes the issue of location not being right at draw time, but I'm really sure we need to do that here. I should definitely read about Vertex Arrays
-
-    YAE_GL_VERIFY(glBindAttribLocation(programId, 0, "inPosition"));
-	YAE_GL_VERIFY(glBindAttribLocation(programId, 1, "inTexCoord"));
-	YAE_GL_VERIFY(glBindAttribLocation(programId, 2, "inNormal"));
-	YAE_GL_VERIFY(glBindAttribLocation(programId, 3, "inColor"));
-
-	YAE_GL_VERIFY(glBindVertexArray(0));
+	// Cache uniform locations, the sampler always reads from the first texture unit so it is set once and for all
+	OpenGLProgramUniforms uniforms;
+	uniforms.viewProj = glGetUniformLocation(programId, "viewProj");
+	uniforms.texture = glGetUniformLocation(programId, "texture");
+	YAE_GL_VERIFY();
+	if (uniforms.texture >= 0)
+	{
+		YAE_GL_VERIFY(glUseProgram(programId));
+		YAE_GL_VERIFY(glUniform1i(uniforms.texture, 0));
+		YAE_GL_VERIFY(glUseProgram(0));
+	}
+	m_programUniforms.set(programId, uniforms);
 
-    return (GLboolean)status == GL_TRUE;
+	_outShaderProgramHandle = programId;
+	return true;
 }
 
 
@@ -401,6 +701,7 @@ void OpenGLRenderer::destroyShaderProgram(ShaderProgramHandle& _shaderProgramHan
 
 	GLuint programId = (GLuint)_shaderProgramHandle;
 	YAE_GL_VERIFY(glDeleteProgram(programId));
+	m_programUniforms.remove(_shaderProgramHandle);
 }
 
 const char* OpenGLRenderer::getShaderVersion() const
@@ -510,6 +811,33 @@ void OpenGLRenderer::_shutdownRenderTarget(RenderTarget& _renderTarget)
 void OpenGLRenderer::_beginFrame()
 {
 	ImGui_ImplOpenGL3_NewFrame();
+
+	// Move on to the next segment of the streaming buffers, once the GPU is done reading it
+	m_streamFrame = (m_streamFrame + 1) % YAE_GL_STREAM_FRAMES;
+	if (m_streamFences[m_streamFrame] != nullptr)
+	{
+		YAE_CAPTURE_SCOPE("wait stream fence");
+
+		GLsync fence = (GLsync)m_streamFences[m_streamFrame];
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		while (result == GL_TIMEOUT_EXPIRED)
+		{
+			result = glClientWaitSync(fence, 0, 1000000000);
+		}
+		YAE_ASSERT(result != GL_WAIT_FAILED);
+		glDeleteSync(fence);
+		m_streamFences[m_streamFrame] = nullptr;
+	}
+	m_indirectCursor = 0;
+
+	// The frame dynamic geometry and instances are written in place
+	if (m_streamMode != OpenGLStreamMode::SUB_DATA)
+	{
+		m_vertices.setStorage((Vertex*)_mapStreamSegment(m_vertexStream), m_vertexStream.capacity);
+		m_indices.setStorage((u32*)_mapStreamSegment(m_indexStream), m_indexStream.capacity);
+		m_instanceTransforms.setStorage((Matrix4*)_mapStreamSegment(m_instanceStream), m_instanceStream.capacity);
+		m_glyphVertices.setStorage((GlyphVertex*)_mapStreamSegment(m_glyphVertexStream), m_glyphVertexStream.capacity);
+	}
 }
 
 void OpenGLRenderer::_beginRender()
@@ -518,6 +846,54 @@ void OpenGLRenderer::_beginRender()
 
 	Vector2 frameBufferSize = getFrameBufferSize();
     glScissor(0, 0, frameBufferSize.x, frameBufferSize.y);
+
+	// This frame dynamic geometry and instances are shared by all cameras, meshes already live in their own buffers
+	{
+		YAE_CAPTURE_SCOPE("upload dynamic geometry");
+
+		if (m_streamMode == OpenGLStreamMode::UNSYNCHRONIZED)
+		{
+			_unmapStreamSegment(m_vertexStream);
+			_unmapStreamSegment(m_indexStream);
+			_unmapStreamSegment(m_instanceStream);
+			_unmapStreamSegment(m_glyphVertexStream);
+		}
+
+		// Only what did not fit in the mapped segments, or everything when nothing is mapped
+		_uploadStream(m_vertexStream, m_vertices.data(), m_vertices.size(), m_vertices.isMapped());
+		_uploadStream(m_indexStream, m_indices.data(), m_indices.size(), m_indices.isMapped());
+		_uploadStream(m_instanceStream, m_instanceTransforms.data(), m_instanceTransforms.size(), m_instanceTransforms.isMapped());
+		_uploadStream(m_glyphVertexStream, m_glyphVertices.data(), m_glyphVertices.size(), m_glyphVertices.isMapped());
+
+		YAE_GL_VERIFY(glBindVertexArray(m_vao));
+		YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, (GLuint)m_vertexStream.buffer));
+		setupVertexAttributes(_getStreamOffset(m_vertexStream));
+
+		// Glyph batches share the index stream, which may have been reallocated
+		YAE_GL_VERIFY(glBindVertexArray(m_glyphVertexArray));
+		YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, (GLuint)m_glyphVertexStream.buffer));
+		setupGlyphVertexAttributes(_getStreamOffset(m_glyphVertexStream));
+		YAE_GL_VERIFY(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (GLuint)m_indexStream.buffer));
+		YAE_GL_VERIFY(glBindVertexArray(0));
+		YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+		size_t streamedSize = m_vertices.size() * sizeof(Vertex) + m_indices.size() * sizeof(u32) + m_instanceTransforms.size() * sizeof(Matrix4)
+			+ m_glyphVertices.size() * sizeof(GlyphVertex);
+		YAE_CAPTURE_COUNTER_ADD("renderer.uploadedBytes", streamedSize);
+
+		// The unmapped segments must not be reached through the stream arrays anymore, the draw commands only keep offsets in them
+		if (m_streamMode == OpenGLStreamMode::UNSYNCHRONIZED)
+		{
+			m_vertices.clear();
+			m_indices.clear();
+			m_instanceTransforms.clear();
+			m_glyphVertices.clear();
+			m_vertices.setStorage(nullptr, 0);
+			m_indices.setStorage(nullptr, 0);
+			m_instanceTransforms.setStorage(nullptr, 0);
+			m_glyphVertices.setStorage(nullptr, 0);
+		}
+	}
 }
 
 void OpenGLRenderer::_renderCamera(const RenderCamera* _camera)
@@ -534,12 +910,6 @@ void OpenGLRenderer::_renderCamera(const RenderCamera* _camera)
 
 		YAE_GL_VERIFY(glBindVertexArray(m_vao));
 
-		YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, (GLuint)m_vertexBufferObject));
-	    YAE_GL_VERIFY(glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(*m_vertices.data()), m_vertices.data(), GL_STATIC_DRAW));
-
-	    YAE_GL_VERIFY(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (GLuint)m_indexBufferObject));
-	    YAE_GL_VERIFY(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(*m_indices.data()), m_indices.data(), GL_STATIC_DRAW));
-
 	    YAE_GL_VERIFY(glActiveTexture(GL_TEXTURE0));
 	    YAE_GL_VERIFY(glEnable(GL_DEPTH_TEST));
 	    YAE_GL_VERIFY(glDepthFunc(GL_LEQUAL));
@@ -579,62 +949,168 @@ void OpenGLRenderer::_renderCamera(const RenderCamera* _camera)
 	    glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
 	}
 
-	for (auto& pair : scene->m_drawCommands)
+	// Commands are sorted by state (see sorting::makeDrawKey): consecutive commands sharing program, vertex array, texture
+	// and primitive mode make a run, drawn with a single multi draw indirect. Between runs only what differs is bound.
+	m_drawRuns.clear();
+	m_indirectCommands.clear();
 	{
-		YAE_CAPTURE_SCOPE("draw command pass");
-
-		GLuint shader = (GLuint)pair.key;
-		if (shader == 0)
-			continue;
+		YAE_CAPTURE_SCOPE("build draw runs");
 
-		YAE_GL_VERIFY(glUseProgram(shader));
+		// Streamed commands index and instance offsets are relative to the current stream segment
+		u32 indexStreamBase = m_streamFrame * m_indexStream.capacity;
+		u32 instanceStreamBase = m_streamFrame * m_instanceStream.capacity;
 
-		GLint viewProjLocation = glGetUniformLocation((GLuint)shader, "viewProj");
-		YAE_GL_VERIFY();
-		if (viewProjLocation >= 0)
+		const DrawCommand* previous = nullptr;
+		for (u32 i = 0; i < m_sortedDrawCommands.size(); ++i)
 		{
-			YAE_GL_VERIFY(glUniformMatrix4fv(viewProjLocation, 1, GL_FALSE, (float*)&viewProj));
-		}
+			const DrawCommand& cmd = scene->m_drawCommands[m_sortedDrawCommands[i]];
+			const OpenGLMeshAllocation* allocation = nullptr;
+			u32 vertexArray = m_vao;
+			if (cmd.mesh != 0)
+			{
+				allocation = m_meshAllocations.get(cmd.mesh);
+				YAE_ASSERT(allocation != nullptr);
+				vertexArray = m_meshVertexPools[allocation->vertexPool].vertexArray;
+			}
+			else if (cmd.vertexLayout == VertexLayout::GLYPH)
+			{
+				vertexArray = m_glyphVertexArray;
+			}
 
-		GLint modelLocation = glGetUniformLocation((GLuint)shader, "model");
-		YAE_GL_VERIFY();
+			bool startsRun = previous == nullptr
+				|| cmd.shader != previous->shader
+				|| cmd.textureId != previous->textureId
+				|| cmd.primitiveMode != previous->primitiveMode
+				|| vertexArray != m_drawRuns.back().vertexArray;
+			if (startsRun)
+			{
+				OpenGLDrawRun run;
+				run.firstCommand = i;
+				run.firstIndirectCommand = m_indirectCursor + m_indirectCommands.size();
+				run.vertexArray = vertexArray;
+				m_drawRuns.push_back(run);
+			}
+			++m_drawRuns.back().commandCount;
 
-		GLint textureLocation = glGetUniformLocation((GLuint)shader, "texture");
-		YAE_GL_VERIFY();
-		if (textureLocation >= 0)
-		{
-			YAE_GL_VERIFY(glUniform1i(textureLocation, 0));
+			OpenGLDrawElementsIndirectCommand indirect;
+			indirect.count = cmd.elementCount;
+			indirect.instanceCount = cmd.instanceCount;
+			indirect.firstIndex = (allocation != nullptr ? allocation->firstIndex : indexStreamBase) + cmd.indexOffset;
+			indirect.baseVertex = 0;
+			indirect.baseInstance = instanceStreamBase + cmd.firstInstance;
+			m_indirectCommands.push_back(indirect);
 
+			previous = &cmd;
 		}
+	}
+
+#if YAE_OPENGL_ES == 0
+	// After the commands of the cameras already rendered this frame
+	_uploadStream(m_indirectStream, m_indirectCommands.data(), m_indirectCommands.size(), false, m_indirectCursor);
+	m_indirectCursor += m_indirectCommands.size();
+	YAE_GL_VERIFY(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, (GLuint)m_indirectStream.buffer));
+#endif
 
-		for (DrawCommand& cmd : pair.value)
+	u32 drawCalls = 0;
+	u32 programBinds = 0;
+	u32 textureBinds = 0;
+	u32 vertexArrayBinds = 0;
+	u32 uniformUploads = 0;
+	{
+		YAE_CAPTURE_SCOPE("draw commands");
+
+		GLuint boundProgram = 0;
+		GLuint boundVertexArray = m_vao;
+		GLuint boundTexture = 0;
+		bool isTextureBound = false;
+		const OpenGLProgramUniforms* uniforms = nullptr;
+
+	#if YAE_OPENGL_ES
+		// No base instance support, instance attributes are pointed at the command first instance instead
+		YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, (GLuint)m_instanceStream.buffer));
+	#endif
+
+		for (const OpenGLDrawRun& run : m_drawRuns)
 		{
-			YAE_GL_VERIFY(glBindTexture(GL_TEXTURE_2D, (GLuint)cmd.textureId));
+			const DrawCommand& cmd = scene->m_drawCommands[m_sortedDrawCommands[run.firstCommand]];
 
-			if (modelLocation >= 0)
+			GLuint program = (GLuint)cmd.shader;
+			if (program != boundProgram)
 			{
-				YAE_GL_VERIFY(glUniformMatrix4fv(modelLocation, 1, GL_FALSE, (float*)&cmd.transform));
+				YAE_GL_VERIFY(glUseProgram(program));
+				boundProgram = program;
+				++programBinds;
+
+				uniforms = m_programUniforms.get(cmd.shader);
+				YAE_ASSERT(uniforms != nullptr);
+
+				if (uniforms->viewProj >= 0)
+				{
+					YAE_GL_VERIFY(glUniformMatrix4fv(uniforms->viewProj, 1, GL_FALSE, (float*)&viewProj));
+					++uniformUploads;
+				}
 			}
 
-			void* offset = (void*)(intptr_t)(cmd.indexOffset * sizeof(*m_indices.data()));
-    		YAE_GL_VERIFY(glDrawElements(
-    			primitiveModeToGlPrimitiveMode(cmd.primitiveMode), 
-    			cmd.elementCount, 
-    			GL_UNSIGNED_INT, 
-    			offset
-    		));
-		}
+			GLuint vertexArray = (GLuint)run.vertexArray;
+			if (vertexArray != boundVertexArray)
+			{
+				YAE_GL_VERIFY(glBindVertexArray(vertexArray));
+				boundVertexArray = vertexArray;
+				++vertexArrayBinds;
+			}
 
-		pair.value.clear();
+			GLuint texture = (GLuint)cmd.textureId;
+			if (!isTextureBound || texture != boundTexture)
+			{
+				YAE_GL_VERIFY(glBindTexture(GL_TEXTURE_2D, texture));
+				boundTexture = texture;
+				isTextureBound = true;
+				++textureBinds;
+			}
+
+			GLenum mode = primitiveModeToGlPrimitiveMode(cmd.primitiveMode);
+		#if YAE_OPENGL_ES
+			// No multi draw indirect either, the run commands are drawn one by one
+			const OpenGLDrawElementsIndirectCommand* indirect = m_indirectCommands.data() + run.firstIndirectCommand - m_indirectCursor;
+			for (u32 i = 0; i < run.commandCount; ++i, ++indirect)
+			{
+				setupInstanceAttributes(m_instanceStream.buffer, indirect->baseInstance * sizeof(Matrix4));
+				YAE_GL_VERIFY(glDrawElementsInstanced(mode, indirect->count, GL_UNSIGNED_INT, (void*)(intptr_t)(indirect->firstIndex * sizeof(u32)), indirect->instanceCount));
+				++drawCalls;
+			}
+		#else
+			size_t indirectOffset = _getStreamOffset(m_indirectStream) + run.firstIndirectCommand * sizeof(OpenGLDrawElementsIndirectCommand);
+			YAE_GL_VERIFY(glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, (void*)(intptr_t)indirectOffset, run.commandCount, 0));
+			++drawCalls;
+		#endif
+		}
 	}
 
+	YAE_CAPTURE_COUNTER_ADD("renderer.drawCalls", drawCalls);
+	YAE_CAPTURE_COUNTER_ADD("renderer.programBinds", programBinds);
+	YAE_CAPTURE_COUNTER_ADD("renderer.textureBinds", textureBinds);
+	YAE_CAPTURE_COUNTER_ADD("renderer.vertexArrayBinds", vertexArrayBinds);
+	YAE_CAPTURE_COUNTER_ADD("renderer.uniformUploads", uniformUploads);
+	YAE_CAPTURE_COUNTER_ADD("renderer.indirectCommands", m_indirectCommands.size());
+
+	// Unbind the vertex array first, the element buffer binding is part of its state
+#if YAE_OPENGL_ES == 0
+	YAE_GL_VERIFY(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+#endif
+	YAE_GL_VERIFY(glBindVertexArray(0));
 	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    YAE_GL_VERIFY(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-    YAE_GL_VERIFY(glBindVertexArray(0));
+	YAE_GL_VERIFY(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
 
 void OpenGLRenderer::_endRender()
 {
+	// Signaled once the GPU is done with this frame segment of the streaming buffers
+	if (m_streamMode != OpenGLStreamMode::SUB_DATA)
+	{
+		YAE_ASSERT(m_streamFences[m_streamFrame] == nullptr);
+		m_streamFences[m_streamFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
 	SDL_GL_SwapWindow(m_window);
 }
 
@@ -648,9 +1124,9 @@ bool OpenGLRenderer::_initIm3d()
 
 #if YAE_RENDER_IM3D
 	FileReader shaderReader("./data/shaders/im3d.glsl", &scratchAllocator());
-	if (!shaderReader.load())
+	if (!shaderReader.map())
 	{
-		YAE_ERRORF_CAT("im3d", "Failed to open shader file \"%s\".", shaderReader.getPath());
+		YAE_ERRORF_CAT(im3d, "Failed to open shader file \"%s\".", shaderReader.getPath());
 		return false;
 	}
 
@@ -838,4 +1314,529 @@ Matrix4 OpenGLRenderer::_computeFixedViewProjectionMatrix(const RenderCamera* _c
 	return projectionMatrix * viewMatrix;
 }
 
+bool OpenGLRenderer::_compileShader(const OpenGLShaderSource& _shaderSource, u32& _outShaderId)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	GLuint shaderId = glCreateShader(_shaderSource.type);
+	YAE_ASSERT(shaderId != 0);
+
+	const char* code[] = { _shaderSource.source };
+	GLint codeSize[] = { (GLint)_shaderSource.sourceSize };
+	YAE_GL_VERIFY(glShaderSource(shaderId, countof(code), code, codeSize));
+	YAE_GL_VERIFY(glCompileShader(shaderId));
+
+	GLint status = 0, logLength = 0;
+	YAE_GL_VERIFY(glGetShaderiv(shaderId, GL_COMPILE_STATUS, &status));
+	YAE_GL_VERIFY(glGetShaderiv(shaderId, GL_INFO_LOG_LENGTH, &logLength));
+	if (logLength > 1)
+	{
+		String buf(&scratchAllocator());
+		buf.resize(logLength);
+		YAE_GL_VERIFY(glGetShaderInfoLog(shaderId, logLength, NULL, (GLchar*)buf.data()));
+		YAE_ERRORF_CAT(renderer, "Shader compilation result:\n%s", buf.c_str());
+	}
+
+	if ((GLboolean)status != GL_TRUE)
+	{
+		YAE_ERROR_CAT(renderer, "Failed to compile shader.");
+		glDeleteShader(shaderId);
+		return false;
+	}
+
+	_outShaderId = shaderId;
+	return true;
+}
+
+bool OpenGLRenderer::_compileAndLinkProgram(u32 _programId, const ShaderHandle* _shaderHandles, u16 _shaderHandleCount)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	GLuint shaderIds[YAE_GL_MAX_PROGRAM_STAGES];
+	bool isDeferred[YAE_GL_MAX_PROGRAM_STAGES];
+	YAE_ASSERT(_shaderHandleCount <= countof(shaderIds));
+
+	// Deferred stages are compiled for this link only, their binary is cached with the program
+	bool error = false;
+	u16 attachedCount = 0;
+	for (; attachedCount < _shaderHandleCount && !error; ++attachedCount)
+	{
+		const OpenGLShaderSource* shaderSource = m_shaderSources.get(_shaderHandles[attachedCount]);
+		YAE_ASSERT(shaderSource != nullptr);
+
+		u32 shaderId = shaderSource->shaderId;
+		isDeferred[attachedCount] = shaderId == 0;
+		if (isDeferred[attachedCount] && !_compileShader(*shaderSource, shaderId))
+			break;
+
+		shaderIds[attachedCount] = shaderId;
+		error = !YAE_GL_TEST(glAttachShader(_programId, shaderId));
+	}
+	error = error || attachedCount < _shaderHandleCount;
+
+	if (!error)
+	{
+		// Attribute locations must be bound before linking to be taken into account
+		YAE_GL_VERIFY(glBindAttribLocation(_programId, 0, "inPosition"));
+		YAE_GL_VERIFY(glBindAttribLocation(_programId, 1, "inTexCoord"));
+		YAE_GL_VERIFY(glBindAttribLocation(_programId, 2, "inNormal"));
+		YAE_GL_VERIFY(glBindAttribLocation(_programId, 3, "inColor"));
+		YAE_GL_VERIFY(glBindAttribLocation(_programId, 4, "inModel")); // mat4, takes locations 4 to 7
+
+	#if YAE_OPENGL_ES == 0
+		if (m_isProgramCacheEnabled)
+		{
+			YAE_GL_VERIFY(glProgramParameteri(_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+		}
+	#endif
+
+		error = !YAE_GL_TEST(glLinkProgram(_programId));
+
+		GLint status = 0, logLength = 0;
+		YAE_GL_VERIFY(glGetProgramiv(_programId, GL_LINK_STATUS, &status));
+		YAE_GL_VERIFY(glGetProgramiv(_programId, GL_INFO_LOG_LENGTH, &logLength));
+		if (logLength > 1)
+		{
+			String buf(&scratchAllocator());
+			buf.resize(logLength);
+			YAE_GL_VERIFY(glGetProgramInfoLog(_programId, logLength, NULL, (GLchar*)buf.data()));
+			YAE_ERRORF_CAT(renderer, "Shader program linking result:\n%s", buf.c_str());
+		}
+		if ((GLboolean)status != GL_TRUE)
+		{
+			YAE_ERROR_CAT(renderer, "Failed to link shader program.");
+			error = true;
+		}
+	}
+
+	// Stages are not needed anymore once linked
+	for (u16 i = 0; i < attachedCount; ++i)
+	{
+		glDetachShader(_programId, shaderIds[i]);
+		if (isDeferred[i])
+		{
+			glDeleteShader(shaderIds[i]);
+		}
+	}
+	glGetError(); // detaching a shader that failed to attach is fine
+
+	return !error;
+}
+
+OpenGLProgramCacheKey OpenGLRenderer::_computeProgramCacheKey(const ShaderHandle* _shaderHandles, u16 _shaderHandleCount) const
+{
+	// Bump when something that ends up in the binary changes outside of the sources (e.g. attribute locations)
+	const u32 PROGRAM_CACHE_VERSION = 1;
+	const u64 PROGRAM_CACHE_CHECK_SEED = 0x9e3779b97f4a7c15ull;
+
+	YAE_ASSERT(_shaderHandleCount <= YAE_GL_MAX_PROGRAM_STAGES);
+
+	OpenGLProgramCacheKey key;
+	DataArray<u8> keyData(&scratchAllocator());
+	keyData.push_back((const u8*)&PROGRAM_CACHE_VERSION, sizeof(PROGRAM_CACHE_VERSION));
+	keyData.push_back((const u8*)m_driverIdentity.c_str(), m_driverIdentity.size());
+	for (u16 i = 0; i < _shaderHandleCount; ++i)
+	{
+		const OpenGLShaderSource* shaderSource = m_shaderSources.get(_shaderHandles[i]);
+		YAE_ASSERT(shaderSource != nullptr);
+		keyData.push_back((const u8*)&shaderSource->type, sizeof(shaderSource->type));
+		keyData.push_back((const u8*)shaderSource->source, shaderSource->sourceSize);
+		key.stageHashes[i] = _computeStageHash(*shaderSource);
+	}
+	key.stageCount = _shaderHandleCount;
+	key.hash = hash::hash64(keyData.data(), keyData.size());
+	key.check = hash::hash64(keyData.data(), keyData.size(), PROGRAM_CACHE_CHECK_SEED);
+	return key;
+}
+
+u64 OpenGLRenderer::_computeStageHash(const OpenGLShaderSource& _shaderSource) const
+{
+	u64 seed = hash::hash64(m_driverIdentity.c_str(), m_driverIdentity.size()) + _shaderSource.type;
+	return hash::hash64(_shaderSource.source, _shaderSource.sourceSize, seed);
+}
+
+String OpenGLRenderer::_getProgramCachePath(const OpenGLProgramCacheKey& _key) const
+{
+	return string::format("%s/shader_cache/%016llx.bin", program().getIntermediateDirectory(), (unsigned long long)_key.hash);
+}
+
+struct ProgramBinaryHeader
+{
+	u32 magic;
+	u32 format; // GLenum
+	u64 keyHash;
+	u64 keyCheck;
+	u32 size;
+	u32 stageCount;
+	u64 stageHashes[YAE_GL_MAX_PROGRAM_STAGES];
+};
+const u32 PROGRAM_BINARY_MAGIC = 0x33424159; // "YAB3"
+const u64 PROGRAM_CACHE_MAX_SIZE = 64 * 1024 * 1024;
+
+bool OpenGLRenderer::_loadProgramBinary(u32 _programId, const OpenGLProgramCacheKey& _key)
+{
+#if YAE_OPENGL_ES == 0
+	YAE_CAPTURE_FUNCTION();
+
+	String path = _getProgramCachePath(_key);
+	FileReader reader(path.c_str(), &scratchAllocator());
+	if (!reader.map())
+		return false;
+
+	const ProgramBinaryHeader* header = (const ProgramBinaryHeader*)reader.getContent();
+	if (reader.getContentSize() < sizeof(ProgramBinaryHeader)
+		|| header->magic != PROGRAM_BINARY_MAGIC
+		|| header->keyHash != _key.hash
+		|| header->keyCheck != _key.check
+		|| header->size != reader.getContentSize() - sizeof(ProgramBinaryHeader))
+	{
+		// Overwritten when the program is saved again
+		YAE_WARNINGF_CAT(renderer, "Invalid program binary \"%s\"", path.c_str());
+		return false;
+	}
+
+	// The driver may still reject it (e.g. after an update that kept the same version string), the program is then rebuilt
+	glGetError();
+	glProgramBinary(_programId, header->format, header + 1, header->size);
+	GLint status = 0;
+	glGetProgramiv(_programId, GL_LINK_STATUS, &status);
+	if (glGetError() != GL_NO_ERROR || (GLboolean)status != GL_TRUE)
+	{
+		YAE_VERBOSEF_CAT(renderer, "Program binary \"%s\" rejected by the driver", path.c_str());
+		return false;
+	}
+
+	YAE_VERBOSEF_CAT(renderer, "Loaded program binary \"%s\"", path.c_str());
+	return true;
+#else
+	return false;
+#endif
+}
+
+void OpenGLRenderer::_saveProgramBinary(u32 _programId, const OpenGLProgramCacheKey& _key)
+{
+#if YAE_OPENGL_ES == 0
+	YAE_CAPTURE_FUNCTION();
+
+	GLint binarySize = 0;
+	YAE_GL_VERIFY(glGetProgramiv(_programId, GL_PROGRAM_BINARY_LENGTH, &binarySize));
+	if (binarySize <= 0)
+		return;
+
+	DataArray<u8> data(&scratchAllocator());
+	data.resize(sizeof(ProgramBinaryHeader) + binarySize);
+	ProgramBinaryHeader* header = (ProgramBinaryHeader*)data.data();
+	GLenum format = 0;
+	YAE_GL_VERIFY(glGetProgramBinary(_programId, binarySize, nullptr, &format, header + 1));
+	header->magic = PROGRAM_BINARY_MAGIC;
+	header->format = format;
+	header->keyHash = _key.hash;
+	header->keyCheck = _key.check;
+	header->size = u32(binarySize);
+	header->stageCount = _key.stageCount;
+	memcpy(header->stageHashes, _key.stageHashes, sizeof(header->stageHashes));
+
+	String path = _getProgramCachePath(_key);
+	FileHandle file(path.c_str());
+	if (!file.open(FileHandle::OPENMODE_WRITE) || !file.write(data.data(), data.size()))
+	{
+		YAE_WARNINGF_CAT(renderer, "Failed to write program binary \"%s\"", path.c_str());
+		return;
+	}
+	file.close();
+#endif
+}
+
+void OpenGLRenderer::_scanProgramCache()
+{
+	YAE_CAPTURE_FUNCTION();
+
+	// @NOTE(remi): a program gets a new binary each time one of its shaders is edited, the previous ones are never read again.
+	// They cannot be told apart from the binaries of other programs, so the oldest ones go once the cache is over budget.
+	String cacheDirectory = string::format("%s/shader_cache/", program().getIntermediateDirectory());
+	Array<filesystem::Entry> entries(&scratchAllocator());
+	filesystem::parseDirectoryContent(cacheDirectory.c_str(), entries, false, filesystem::EntryType_File);
+
+	DataArray<u64> sizes(&scratchAllocator());
+	DataArray<i64> writeTimes(&scratchAllocator());
+	sizes.resize(entries.size(), 0);
+	writeTimes.resize(entries.size(), 0);
+	u64 totalSize = 0;
+	for (u32 i = 0; i < entries.size(); ++i)
+	{
+		filesystem::getFileStatus(entries[i].path.c_str(), &sizes[i], &writeTimes[i]);
+		totalSize += sizes[i];
+	}
+
+	while (totalSize > PROGRAM_CACHE_MAX_SIZE)
+	{
+		u32 oldest = entries.size();
+		for (u32 i = 0; i < entries.size(); ++i)
+		{
+			if (sizes[i] > 0 && (oldest == entries.size() || writeTimes[i] < writeTimes[oldest]))
+			{
+				oldest = i;
+			}
+		}
+		if (oldest == entries.size())
+			break;
+
+		YAE_VERBOSEF_CAT(renderer, "Deleting old program binary \"%s\"", entries[oldest].path.c_str());
+		filesystem::deletePath(entries[oldest].path.c_str());
+		totalSize -= sizes[oldest];
+		sizes[oldest] = 0;
+	}
+
+	// Only the headers are read
+	for (u32 i = 0; i < entries.size(); ++i)
+	{
+		if (sizes[i] < sizeof(ProgramBinaryHeader))
+			continue;
+
+		ProgramBinaryHeader header;
+		FileHandle file(entries[i].path.c_str());
+		if (!file.open(FileHandle::OPENMODE_READ))
+			continue;
+
+		if (file.read(&header, sizeof(header)) == sizeof(header) && header.magic == PROGRAM_BINARY_MAGIC && header.stageCount <= YAE_GL_MAX_PROGRAM_STAGES)
+		{
+			for (u32 j = 0; j < header.stageCount; ++j)
+			{
+				m_cachedStageHashes.set(header.stageHashes[j], true);
+			}
+		}
+		file.close();
+	}
+}
+
+void OpenGLRenderer::_createStreamBuffer(OpenGLStreamBuffer& _stream, u32 _target, u32 _stride, u32 _capacity)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_stream.buffer == 0);
+
+	_stream.target = _target;
+	_stream.stride = _stride;
+	_stream.capacity = _capacity;
+	GLsizeiptr size = GLsizeiptr(_stride) * _capacity * YAE_GL_STREAM_FRAMES;
+
+	// Index buffers are bound through the dynamic geometry vertex array, which keeps the binding
+	YAE_GL_VERIFY(glBindVertexArray(m_vao));
+	YAE_GL_VERIFY(glGenBuffers(1, (GLuint*)&_stream.buffer));
+	YAE_GL_VERIFY(glBindBuffer(_target, (GLuint)_stream.buffer));
+#if YAE_OPENGL_ES == 0
+	if (m_streamMode == OpenGLStreamMode::PERSISTENT)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		YAE_GL_VERIFY(glBufferStorage(_target, size, nullptr, flags));
+		_stream.mapping = (u8*)glMapBufferRange(_target, 0, size, flags);
+		YAE_ASSERT(_stream.mapping != nullptr);
+	}
+	else
+#endif
+	{
+		YAE_GL_VERIFY(glBufferData(_target, size, nullptr, GL_STREAM_DRAW));
+	}
+
+	// Every vertex array reads its instances from the instance stream
+	if (&_stream == &m_instanceStream)
+	{
+		setupInstanceAttributes(_stream.buffer, 0);
+		_setupMeshVertexArrays();
+	}
+
+	YAE_GL_VERIFY(glBindVertexArray(0));
+	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void OpenGLRenderer::_destroyStreamBuffer(OpenGLStreamBuffer& _stream)
+{
+	// Persistent mappings are released with the buffer
+	GLuint buffer = (GLuint)_stream.buffer;
+	glDeleteBuffers(1, &buffer);
+	_stream = OpenGLStreamBuffer();
+}
+
+u8* OpenGLRenderer::_mapStreamSegment(OpenGLStreamBuffer& _stream)
+{
+	YAE_ASSERT(m_streamMode != OpenGLStreamMode::SUB_DATA);
+
+	if (m_streamMode == OpenGLStreamMode::PERSISTENT)
+		return _stream.mapping + _getStreamOffset(_stream);
+
+	// The segment fence has been waited on, no need for the driver to synchronize
+	YAE_ASSERT(_stream.mapping == nullptr);
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+	YAE_GL_VERIFY(glBindVertexArray(m_vao));
+	YAE_GL_VERIFY(glBindBuffer(_stream.target, (GLuint)_stream.buffer));
+	_stream.mapping = (u8*)glMapBufferRange(_stream.target, _getStreamOffset(_stream), GLsizeiptr(_stream.stride) * _stream.capacity, flags);
+	YAE_ASSERT(_stream.mapping != nullptr);
+	YAE_GL_VERIFY(glBindVertexArray(0));
+	return _stream.mapping;
+}
+
+void OpenGLRenderer::_unmapStreamSegment(OpenGLStreamBuffer& _stream)
+{
+	YAE_ASSERT(m_streamMode == OpenGLStreamMode::UNSYNCHRONIZED);
+
+	if (_stream.mapping == nullptr)
+		return;
+
+	YAE_GL_VERIFY(glBindVertexArray(m_vao));
+	YAE_GL_VERIFY(glBindBuffer(_stream.target, (GLuint)_stream.buffer));
+	YAE_VERIFY(glUnmapBuffer(_stream.target) == GL_TRUE);
+	YAE_GL_VERIFY(glBindVertexArray(0));
+	_stream.mapping = nullptr;
+}
+
+void OpenGLRenderer::_uploadStream(OpenGLStreamBuffer& _stream, const void* _data, u32 _count, bool _isMapped, u32 _first)
+{
+	if (_isMapped || _count == 0)
+		return;
+
+	if (_first + _count > _stream.capacity)
+	{
+		// Reallocate with room to spare, the old buffer is released by the driver once the frames in flight are done with it
+		YAE_CAPTURE_SCOPE("grow stream buffer");
+
+		u32 target = _stream.target;
+		u32 stride = _stream.stride;
+		u32 capacity = math::max(_stream.capacity * 2, _first + _count);
+		YAE_VERBOSEF_CAT(renderer, "Growing streaming buffer to %u elements per frame", capacity);
+
+		_destroyStreamBuffer(_stream);
+		_createStreamBuffer(_stream, target, stride, capacity);
+	}
+
+	size_t offset = _getStreamOffset(_stream) + size_t(_first) * _stream.stride;
+	size_t size = size_t(_count) * _stream.stride;
+	if (m_streamMode == OpenGLStreamMode::PERSISTENT)
+	{
+		memcpy(_stream.mapping + offset, _data, size);
+	}
+	else
+	{
+		YAE_GL_VERIFY(glBindVertexArray(m_vao));
+		YAE_GL_VERIFY(glBindBuffer(_stream.target, (GLuint)_stream.buffer));
+		YAE_GL_VERIFY(glBufferSubData(_stream.target, offset, size, _data));
+		YAE_GL_VERIFY(glBindVertexArray(0));
+	}
+}
+
+void OpenGLRenderer::_waitStreamFences()
+{
+	for (u32 i = 0; i < YAE_GL_STREAM_FRAMES; ++i)
+	{
+		if (m_streamFences[i] == nullptr)
+			continue;
+
+		GLsync fence = (GLsync)m_streamFences[i];
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+		glDeleteSync(fence);
+		m_streamFences[i] = nullptr;
+	}
+}
+
+size_t OpenGLRenderer::_getStreamOffset(const OpenGLStreamBuffer& _stream) const
+{
+	return size_t(m_streamFrame) * _stream.capacity * _stream.stride;
+}
+
+void OpenGLRenderer::_createPoolBuffer(OpenGLPoolBuffer& _pool, u32 _target, u32 _stride, u32 _capacity)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_pool.buffer == 0);
+
+	_pool.target = _target;
+	_pool.stride = _stride;
+	_pool.capacity = _capacity;
+
+	// Bound through the first mesh vertex array, which keeps the index buffer binding until _setupMeshVertexArrays
+	YAE_ASSERT(m_meshVertexPoolCount > 0);
+	YAE_GL_VERIFY(glBindVertexArray(m_meshVertexPools[0].vertexArray));
+	YAE_GL_VERIFY(glGenBuffers(1, (GLuint*)&_pool.buffer));
+	YAE_GL_VERIFY(glBindBuffer(_target, (GLuint)_pool.buffer));
+	YAE_GL_VERIFY(glBufferData(_target, GLsizeiptr(_stride) * _capacity, nullptr, GL_STATIC_DRAW));
+	YAE_GL_VERIFY(glBindVertexArray(0));
+	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void OpenGLRenderer::_destroyPoolBuffer(OpenGLPoolBuffer& _pool)
+{
+	GLuint buffer = (GLuint)_pool.buffer;
+	glDeleteBuffers(1, &buffer);
+	_pool.buffer = 0;
+	_pool.capacity = 0;
+	_pool.ranges.clear();
+}
+
+u32 OpenGLRenderer::_allocatePoolRange(OpenGLPoolBuffer& _pool, u32 _count)
+{
+	u32 first = _pool.ranges.allocate(_count);
+	u32 requiredCapacity = _pool.ranges.getTop();
+	if (requiredCapacity <= _pool.capacity)
+		return first;
+
+	// Move the content to a bigger buffer, at the same offsets
+	YAE_CAPTURE_SCOPE("grow mesh buffer");
+
+	GLuint oldBuffer = (GLuint)_pool.buffer;
+	size_t oldSize = size_t(_pool.capacity) * _pool.stride;
+	u32 capacity = math::max(_pool.capacity * 2, requiredCapacity);
+	YAE_VERBOSEF_CAT(renderer, "Growing mesh buffer to %u elements", capacity);
+
+	_pool.buffer = 0;
+	_createPoolBuffer(_pool, _pool.target, _pool.stride, capacity);
+
+	YAE_GL_VERIFY(glBindBuffer(GL_COPY_READ_BUFFER, oldBuffer));
+	YAE_GL_VERIFY(glBindBuffer(GL_COPY_WRITE_BUFFER, (GLuint)_pool.buffer));
+	YAE_GL_VERIFY(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize));
+	YAE_GL_VERIFY(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+	YAE_GL_VERIFY(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+	YAE_GL_VERIFY(glDeleteBuffers(1, &oldBuffer));
+
+	_setupMeshVertexArrays();
+
+	return first;
+}
+
+u32 OpenGLRenderer::_getMeshVertexPool(const VertexFormat& _format)
+{
+	for (u32 i = 0; i < m_meshVertexPoolCount; ++i)
+	{
+		if (m_meshVertexPools[i].format == _format)
+			return i;
+	}
+
+	if (m_meshVertexPoolCount == YAE_GL_MAX_MESH_VERTEX_FORMATS)
+	{
+		YAE_ERRORF_CAT(renderer, "Too many mesh vertex formats, the maximum is %u", YAE_GL_MAX_MESH_VERTEX_FORMATS);
+		return ~0u;
+	}
+
+	u32 poolIndex = m_meshVertexPoolCount++;
+	OpenGLMeshVertexPool& pool = m_meshVertexPools[poolIndex];
+	pool.format = _format;
+	YAE_GL_VERIFY(glGenVertexArrays(1, &pool.vertexArray));
+	_createPoolBuffer(pool.vertices, GL_ARRAY_BUFFER, vertex_format::getStride(_format), MESH_VERTEX_CAPACITY);
+	_setupMeshVertexArrays();
+	return poolIndex;
+}
+
+void OpenGLRenderer::_setupMeshVertexArrays()
+{
+	for (u32 i = 0; i < m_meshVertexPoolCount; ++i)
+	{
+		const OpenGLMeshVertexPool& pool = m_meshVertexPools[i];
+		YAE_GL_VERIFY(glBindVertexArray(pool.vertexArray));
+		YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, (GLuint)pool.vertices.buffer));
+		setupMeshVertexAttributes(pool.format);
+		YAE_GL_VERIFY(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (GLuint)m_meshIndices.buffer));
+		setupInstanceAttributes(m_instanceStream.buffer, 0);
+	}
+	YAE_GL_VERIFY(glBindVertexArray(0));
+	YAE_GL_VERIFY(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
 } // namespace yae
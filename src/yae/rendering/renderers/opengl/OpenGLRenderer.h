@@ -2,13 +2,110 @@
 
 #include <yae/types.h>
 #include <yae/rendering/Renderer.h>
+#include <yae/rendering/RangeAllocator.h>
+#include <core/containers/Array.h>
 #include <core/containers/HashMap.h>
 
 #include <im3d/im3d.h>
+
+// Frames the streaming buffers are split into, so that the CPU never writes what the GPU may still be reading
+#define YAE_GL_STREAM_FRAMES 3
+#define YAE_GL_MAX_MESH_VERTEX_FORMATS 8
+#define YAE_GL_MAX_PROGRAM_STAGES 8
+
 namespace yae {
 
 class ShaderResource;
 
+// Stages found in a cached program binary are only compiled if that binary cannot be used when linking,
+// the others are compiled on creation so that errors are reported to the shader resource.
+struct OpenGLShaderSource
+{
+	u32 type = 0; // GLenum
+	char* source = nullptr; // with version and defines
+	u32 sourceSize = 0;
+	u32 shaderId = 0; // 0 while compilation is deferred
+};
+
+// Identifies a linked program binary: the sources, stage types and driver it was built from
+struct OpenGLProgramCacheKey
+{
+	u64 hash = 0; // names the cache file
+	u64 check = 0; // independent hash of the same data, stored in the file and compared on load to rule out collisions
+	u64 stageHashes[YAE_GL_MAX_PROGRAM_STAGES] = {};
+	u32 stageCount = 0;
+};
+
+struct OpenGLProgramUniforms
+{
+	i32 viewProj = -1;
+	i32 texture = -1;
+};
+
+// Mesh geometry range in the shared mesh buffers, indices are already offset by firstVertex
+struct OpenGLMeshAllocation
+{
+	u32 vertexPool = 0; // in OpenGLRenderer::m_meshVertexPools
+	u32 firstVertex = 0;
+	u32 vertexCount = 0;
+	u32 firstIndex = 0;
+	u32 indexCount = 0;
+};
+
+// Buffer sub-allocated in ranges of elements, grown by copy when full so that allocations never move
+struct OpenGLPoolBuffer
+{
+	u32 buffer = 0;
+	u32 target = 0;
+	u32 stride = 0;
+	u32 capacity = 0; // elements
+	RangeAllocator ranges;
+};
+
+// Vertex buffer shared by the meshes of one vertex format, with the vertex array reading it
+struct OpenGLMeshVertexPool
+{
+	VertexFormat format;
+	u32 vertexArray = 0;
+	OpenGLPoolBuffer vertices;
+};
+
+// Layout expected by glMultiDrawElementsIndirect
+struct OpenGLDrawElementsIndirectCommand
+{
+	u32 count;
+	u32 instanceCount;
+	u32 firstIndex;
+	i32 baseVertex;
+	u32 baseInstance;
+};
+
+// Consecutive sorted commands sharing program, vertex array, texture and primitive mode
+struct OpenGLDrawRun
+{
+	u32 firstCommand = 0; // in Renderer::m_sortedDrawCommands
+	u32 commandCount = 0;
+	u32 firstIndirectCommand = 0; // in the indirect stream current segment
+	u32 vertexArray = 0;
+};
+
+enum class OpenGLStreamMode : u8
+{
+	PERSISTENT, // glBufferStorage, mapped once for the buffer lifetime
+	UNSYNCHRONIZED, // current frame segment mapped with glMapBufferRange between _beginFrame and _beginRender
+	SUB_DATA // no buffer mapping (GLES), written with glBufferSubData from the heap
+};
+
+// Ring buffer of YAE_GL_STREAM_FRAMES segments, one per frame in flight
+struct OpenGLStreamBuffer
+{
+	u32 buffer = 0;
+	u32 target = 0;
+	u32 stride = 0;
+	u32 capacity = 0; // elements per segment
+	u8* mapping = nullptr; // whole buffer if persistent, current segment if unsynchronized
+};
+
 class YAE_API OpenGLRenderer : public Renderer
 {
 public:
@@ -20,9 +117,15 @@ public:
 	virtual void waitIdle() override;
 
 	virtual bool createTexture(const void* _data, int _width, int _height, int _channels, TextureHandle& _outTextureHandle) override;
+	virtual bool createTexture(TextureFormat _format, u32 _width, u32 _height, const TextureMip* _mips, u32 _mipCount, TextureHandle& _outTextureHandle) override;
+	virtual bool isTextureFormatSupported(TextureFormat _format) const override;
+	virtual void updateTexture(TextureHandle& _inTextureHandle, const void* _data, int _width, int _height, int _channels) override;
 	virtual void applyTextureParameters(TextureHandle& _inTextureHandle, const TextureParameters& _parameters) override;
 	virtual void destroyTexture(TextureHandle& _inTextureHandle) override;
 
+	virtual bool createMesh(const VertexFormat& _vertexFormat, const void* _vertices, u32 _verticesCount, const u32* _indices, u32 _indicesCount, MeshHandle& _outMeshHandle) override;
+	virtual void destroyMesh(MeshHandle& _inMeshHandle) override;
+
 	virtual bool createShader(ShaderType _type, const char* _source, size_t _sourceSize, ShaderHandle& _outShaderHandle) override;
 	virtual void destroyShader(ShaderHandle& _shaderHandle) override;
 
@@ -55,11 +158,65 @@ public:
 
 	Matrix4 _computeFixedViewProjectionMatrix(const RenderCamera* _camera) const;
 
+	bool _compileShader(const OpenGLShaderSource& _shaderSource, u32& _outShaderId);
+	bool _compileAndLinkProgram(u32 _programId, const ShaderHandle* _shaderHandles, u16 _shaderHandleCount);
+	u64 _computeStageHash(const OpenGLShaderSource& _shaderSource) const;
+	OpenGLProgramCacheKey _computeProgramCacheKey(const ShaderHandle* _shaderHandles, u16 _shaderHandleCount) const;
+	String _getProgramCachePath(const OpenGLProgramCacheKey& _key) const;
+	bool _loadProgramBinary(u32 _programId, const OpenGLProgramCacheKey& _key);
+	void _saveProgramBinary(u32 _programId, const OpenGLProgramCacheKey& _key);
+	void _scanProgramCache(); // deletes the oldest binaries while the cache is over its size budget, and lists the stages of the others
+
+	void _createStreamBuffer(OpenGLStreamBuffer& _stream, u32 _target, u32 _stride, u32 _capacity);
+	void _destroyStreamBuffer(OpenGLStreamBuffer& _stream);
+	u8* _mapStreamSegment(OpenGLStreamBuffer& _stream);
+	void _unmapStreamSegment(OpenGLStreamBuffer& _stream);
+	void _uploadStream(OpenGLStreamBuffer& _stream, const void* _data, u32 _count, bool _isMapped, u32 _first = 0); // _first in the current segment
+	void _waitStreamFences();
+	size_t _getStreamOffset(const OpenGLStreamBuffer& _stream) const; // current frame segment, in bytes
+
+	void _createPoolBuffer(OpenGLPoolBuffer& _pool, u32 _target, u32 _stride, u32 _capacity);
+	void _destroyPoolBuffer(OpenGLPoolBuffer& _pool);
+	u32 _allocatePoolRange(OpenGLPoolBuffer& _pool, u32 _count); // grows the buffer if needed
+	u32 _getMeshVertexPool(const VertexFormat& _format); // created on first use, ~0u when there are too many formats
+	void _setupMeshVertexArrays(); // after any mesh or instance buffer reallocation
+
 	void* m_glContext = nullptr;
 
+	// Dynamic geometry and instances, written by the base renderer straight into the current frame segment
 	u32 m_vao = 0;
-	u32 m_vertexBufferObject = 0;
-	u32 m_indexBufferObject = 0;
+	OpenGLStreamMode m_streamMode = OpenGLStreamMode::SUB_DATA;
+	OpenGLStreamBuffer m_vertexStream;
+	OpenGLStreamBuffer m_indexStream;
+	OpenGLStreamBuffer m_instanceStream; // bound to the instance attributes of every vertex array
+	u32 m_glyphVertexArray = 0; // glyph batches, indexed from the index stream
+	OpenGLStreamBuffer m_glyphVertexStream;
+	void* m_streamFences[YAE_GL_STREAM_FRAMES] = {}; // GLsync, signaled when the GPU is done with a segment
+	u32 m_streamFrame = 0;
+
+	// Desktop only, filled per camera
+	OpenGLStreamBuffer m_indirectStream;
+	u32 m_indirectCursor = 0; // commands already written in the current segment
+	DataArray<OpenGLDrawElementsIndirectCommand> m_indirectCommands;
+	DataArray<OpenGLDrawRun> m_drawRuns;
+
+	// Persistent meshes of a vertex format share one vertex array, so that a single multi draw can cover different meshes.
+	// The first pool is the float layout, created at init: pool buffers are bound through its vertex array.
+	OpenGLMeshVertexPool m_meshVertexPools[YAE_GL_MAX_MESH_VERTEX_FORMATS];
+	u32 m_meshVertexPoolCount = 0;
+	OpenGLPoolBuffer m_meshIndices; // shared by every vertex format
+	HashMap<MeshHandle, OpenGLMeshAllocation> m_meshAllocations;
+	MeshHandle m_nextMeshHandle = 1;
+	HashMap<ShaderProgramHandle, OpenGLProgramUniforms> m_programUniforms; // cached at link time
+	HashMap<ShaderHandle, OpenGLShaderSource> m_shaderSources;
+	ShaderHandle m_nextShaderHandle = 1;
+
+	bool m_isS3tcSupported = false; // BC1 and BC3 textures
+
+	// Linked program binaries, stored in the intermediate directory
+	bool m_isProgramCacheEnabled = false;
+	HashMap<u64, bool> m_cachedStageHashes; // stages of the binaries in the cache, see _computeStageHash
+	String m_driverIdentity; // vendor, renderer and version, binaries are only valid for the driver that produced them
 
 	u32 m_im3dVertexArray = 0;
 	u32 m_im3dVertexBuffer = 0;
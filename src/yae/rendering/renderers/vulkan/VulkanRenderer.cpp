@@ -36,19 +36,19 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
 {
 	if (_messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT)
 	{
-		YAE_VERBOSEF_CAT("vulkan_internal", "%s", _pCallbackData->pMessage);
+		YAE_VERBOSEF_CAT(vulkan_internal, "%s", _pCallbackData->pMessage);
 	}
 	else if (_messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT)
 	{
-		YAE_LOGF_CAT("vulkan_internal", "%s", _pCallbackData->pMessage);
+		YAE_LOGF_CAT(vulkan_internal, "%s", _pCallbackData->pMessage);
 	}
 	else if (_messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
 	{
-		YAE_WARNINGF_CAT("vulkan_internal", "%s", _pCallbackData->pMessage);
+		YAE_WARNINGF_CAT(vulkan_internal, "%s", _pCallbackData->pMessage);
 	}
 	else if (_messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
 	{
-		YAE_ERRORF_CAT("vulkan_internal", "%s", _pCallbackData->pMessage);
+		YAE_ERRORF_CAT(vulkan_internal, "%s", _pCallbackData->pMessage);
 	}
 
 	return VK_FALSE;
@@ -125,12 +125,12 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 			if (!found)
 			{
 				++missingExtensionSupport;
-				YAE_ERRORF_CAT("vulkan", "Extension \"%s\" not supported.", extensionName);
+				YAE_ERRORF_CAT(vulkan, "Extension \"%s\" not supported.", extensionName);
 			}
 		}
 		if (missingExtensionSupport > 0)
 		{
-			YAE_ERRORF_CAT("vulkan", "Can't create Vulkan m_instance, missing %d extensions support.", missingExtensionSupport);
+			YAE_ERRORF_CAT(vulkan, "Can't create Vulkan m_instance, missing %d extensions support.", missingExtensionSupport);
 			return false;
 		}
 	}
@@ -166,18 +166,18 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 			if (!found)
 			{
 				++missingLayerSupport;
-				YAE_ERRORF_CAT("vulkan", "Layer \"%s\" not supported.", layerName);
+				YAE_ERRORF_CAT(vulkan, "Layer \"%s\" not supported.", layerName);
 			}
 		}
 		if (missingLayerSupport > 0)
 		{
-			YAE_ERRORF_CAT("vulkan", "Can't create Vulkan m_instance, missing %d layer support.", missingLayerSupport);
+			YAE_ERRORF_CAT(vulkan, "Can't create Vulkan m_instance, missing %d layer support.", missingLayerSupport);
 			return false;
 		}
 	}
 
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Vulkan Instance...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Vulkan Instance...");
 
 		VkApplicationInfo appInfo{};
 		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -213,7 +213,7 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 		}
 
 		VK_VERIFY(vkCreateInstance(&createInfo, nullptr, &m_instance));
-		YAE_VERBOSE_CAT("vulkan", "Created Vulkan instance");
+		YAE_VERBOSE_CAT(vulkan, "Created Vulkan instance");
 	}
 	YAE_ASSERT(m_instance != VK_NULL_HANDLE);
 
@@ -222,13 +222,13 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 	{
 		vkCreateDebugUtilsMessengerEXT = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_instance, "vkCreateDebugUtilsMessengerEXT");
 		if (vkCreateDebugUtilsMessengerEXT == nullptr) {
-			YAE_ERROR_CAT("vulkan", "Can't get \"vkCreateDebugUtilsMessengerEXT\". An extension is probably missing");
+			YAE_ERROR_CAT(vulkan, "Can't get \"vkCreateDebugUtilsMessengerEXT\". An extension is probably missing");
 			return false;
 		}
 
 		vkDestroyDebugUtilsMessengerEXT = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_instance, "vkDestroyDebugUtilsMessengerEXT");
 		if (vkDestroyDebugUtilsMessengerEXT == nullptr) {
-			YAE_ERROR_CAT("vulkan", "Can't get \"vkDestroyDebugUtilsMessengerEXT\". An extension is probably missing");
+			YAE_ERROR_CAT(vulkan, "Can't get \"vkDestroyDebugUtilsMessengerEXT\". An extension is probably missing");
 			return false;
 		}
 	}
@@ -236,19 +236,19 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 	// Debug Messenger
 	if (m_validationLayersEnabled)
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Debug Messenger...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Debug Messenger...");
 		VkDebugUtilsMessengerCreateInfoEXT createInfo;
 		PopulateDebugUtilsMessengerCreateInfo(createInfo);
 
 		VK_VERIFY(vkCreateDebugUtilsMessengerEXT(m_instance, &createInfo, nullptr, &m_debugMessenger));
-		YAE_VERBOSE_CAT("vulkan", "Created Debug Messenger");
+		YAE_VERBOSE_CAT(vulkan, "Created Debug Messenger");
 	}
 
 	// Create Surface
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Surface...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Surface...");
 		VK_VERIFY(glfwCreateWindowSurface(m_instance, m_window, nullptr, &m_surface));
-		YAE_VERBOSE_CAT("vulkan", "Created Surface");
+		YAE_VERBOSE_CAT(vulkan, "Created Surface");
 	}
 	YAE_ASSERT(m_surface != VK_NULL_HANDLE);
 
@@ -258,7 +258,7 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 	};
 	const size_t deviceExtensionCount = countof(deviceExtensions);
 	{
-		YAE_VERBOSE_CAT("vulkan", "Picking Physical Device...");
+		YAE_VERBOSE_CAT(vulkan, "Picking Physical Device...");
 
 		u32 availablePhysicalDeviceCount;
 		VK_VERIFY(vkEnumeratePhysicalDevices(m_instance, &availablePhysicalDeviceCount, nullptr));
@@ -317,19 +317,19 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 
 		if (m_physicalDevice == VK_NULL_HANDLE)
 		{
-			YAE_ERROR_CAT("vulkan", "Failed to find any suitable GPU");
+			YAE_ERROR_CAT(vulkan, "Failed to find any suitable GPU");
 			return false;
 		}
 
 		m_queueIndices = vulkan::findQueueFamilies(m_physicalDevice, m_surface);
 		vkGetPhysicalDeviceProperties(m_physicalDevice, &m_physicalDeviceProperties);
-		YAE_VERBOSEF_CAT("vulkan", "Picked physical device \"%s\"", m_physicalDeviceProperties.deviceName);
+		YAE_VERBOSEF_CAT(vulkan, "Picked physical device \"%s\"", m_physicalDeviceProperties.deviceName);
 	}
 	YAE_ASSERT(m_physicalDevice != VK_NULL_HANDLE);
 
 	// Create Logical Device
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Logical Device...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Logical Device...");
 
 		VkPhysicalDeviceFeatures deviceFeatures{};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
@@ -362,13 +362,13 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 		createInfo.queueCreateInfoCount = static_cast<u32>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 		VK_VERIFY(vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device));
-		YAE_VERBOSE_CAT("vulkan", "Created Logical Device");
+		YAE_VERBOSE_CAT(vulkan, "Created Logical Device");
 	}
 	YAE_ASSERT(m_device != VK_NULL_HANDLE);
 
 	// Create Allocator
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Allocator...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Allocator...");
 
 		VmaAllocatorCreateInfo allocatorInfo{};
 		allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_2;
@@ -377,7 +377,7 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 		allocatorInfo.instance = m_instance;
 		VK_VERIFY(vmaCreateAllocator(&allocatorInfo, &m_allocator));
 
-		YAE_VERBOSE_CAT("vulkan", "Created Allocator");
+		YAE_VERBOSE_CAT(vulkan, "Created Allocator");
 	}
 
 	// Get Queues
@@ -386,18 +386,18 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 
 	// Create Command Pools
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Command Pool...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Command Pool...");
 		VkCommandPoolCreateInfo poolInfo{};
 		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 		poolInfo.queueFamilyIndex = m_queueIndices.graphicsFamily;
 		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;;
 		VK_VERIFY(vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool));
-		YAE_VERBOSE_CAT("vulkan", "Created Command Pool");
+		YAE_VERBOSE_CAT(vulkan, "Created Command Pool");
 	}
 
 	// Create Descriptor Pools
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Descriptor Pools...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Descriptor Pools...");
 
 		const u32 POOL_SIZE = 1000;
 		VkDescriptorPoolSize pool_sizes[] =
@@ -421,12 +421,12 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 		pool_info.poolSizeCount = u32(countof(pool_sizes));
 		pool_info.pPoolSizes = pool_sizes;
 		VK_VERIFY(vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_descriptorPool));
-		YAE_VERBOSE_CAT("vulkan", "Created Descriptor Pools");
+		YAE_VERBOSE_CAT(vulkan, "Created Descriptor Pools");
 	}
 
 	// Create Descriptors Set Layout
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Descriptors Set Layout...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Descriptors Set Layout...");
 
 		VkDescriptorSetLayoutBinding uboLayoutBinding;
 		uboLayoutBinding.binding = 0;
@@ -452,7 +452,7 @@ bool VulkanRenderer::init(GLFWwindow* _window)
 		layoutInfo.bindingCount = u32(countof(bindings));
 		layoutInfo.pBindings = bindings;
 		VK_VERIFY(vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_descriptorSetLayout));
-		YAE_VERBOSE_CAT("vulkan", "Created Descriptors Set Layout");
+		YAE_VERBOSE_CAT(vulkan, "Created Descriptors Set Layout");
 	}
 
 	int windowWidth, windowHeight;
@@ -506,42 +506,42 @@ void VulkanRenderer::shutdown()
 
 	vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
 	m_descriptorSetLayout = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Descriptor Set Layout");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Descriptor Set Layout");
 
 	vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
 	m_descriptorPool = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Descriptor Sets");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Descriptor Sets");
 
 	vkDestroyCommandPool(m_device, m_commandPool, nullptr);
 	m_commandPool = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Command Pool");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Command Pool");
 
 	m_presentQueue = VK_NULL_HANDLE;
 	m_graphicsQueue = VK_NULL_HANDLE;
 
 	vmaDestroyAllocator(m_allocator);
 	m_allocator = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Allocator");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Allocator");
 
 	vkDestroyDevice(m_device, nullptr);
 	m_device = VK_NULL_HANDLE;
 	m_physicalDevice = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Device");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Device");
 
 	vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
 	m_surface = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Surface");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Surface");
 
 	if (m_validationLayersEnabled)
 	{
 		vkDestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
 		m_debugMessenger = VK_NULL_HANDLE;
-		YAE_VERBOSE_CAT("vulkan", "Destroyed Debug Messenger");
+		YAE_VERBOSE_CAT(vulkan, "Destroyed Debug Messenger");
 	}
 
 	vkDestroyInstance(m_instance, nullptr);
 	m_instance = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Vulkan instance");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Vulkan instance");
 
 	m_window = nullptr;
 }
@@ -772,7 +772,7 @@ bool VulkanRenderer::createTexture(void* _data, int _width, int _height, int _ch
 		samplerInfo.maxLod = 0.f;
 
 		VK_VERIFY(vkCreateSampler(m_device, &samplerInfo, nullptr, &_outTextureHandle.sampler));
-		YAE_VERBOSE_CAT("vulkan", "Created Texture Sampler");
+		YAE_VERBOSE_CAT(vulkan, "Created Texture Sampler");
 	}
 
 	return true;
@@ -802,7 +802,7 @@ bool VulkanRenderer::createMesh(Vertex* _vertices, u32 _verticesCount, u32* _ind
 
 	// Create Vertex Buffer
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Vertex Buffer...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Vertex Buffer...");
 
 		VkDeviceSize bufferSize = sizeof(*_vertices) * _verticesCount;
 		VkBuffer stagingBuffer = VK_NULL_HANDLE;
@@ -833,12 +833,12 @@ bool VulkanRenderer::createMesh(Vertex* _vertices, u32 _verticesCount, u32* _ind
 		vulkan::copyBuffer(m_device, m_commandPool, m_graphicsQueue, stagingBuffer, _outMeshHandle.vertexBuffer, bufferSize);
 
 		vulkan::destroyBuffer(m_allocator, stagingBuffer, stagingBufferMemory);
-		YAE_VERBOSE_CAT("vulkan", "Created Vertex Buffer");
+		YAE_VERBOSE_CAT(vulkan, "Created Vertex Buffer");
 	}
 
 	// Create Index Buffer
 	{
-		YAE_VERBOSE_CAT("vulkan", "Creating Index Buffer...");
+		YAE_VERBOSE_CAT(vulkan, "Creating Index Buffer...");
 		VkDeviceSize bufferSize = sizeof(*_indices) * _indicesCount;
 		VkBuffer stagingBuffer = VK_NULL_HANDLE;
 		VmaAllocation stagingBufferMemory = VK_NULL_HANDLE;
@@ -871,7 +871,7 @@ bool VulkanRenderer::createMesh(Vertex* _vertices, u32 _verticesCount, u32* _ind
 
 		_outMeshHandle.indicesCount = _indicesCount;
 
-		YAE_VERBOSE_CAT("vulkan", "Created Index Buffer");
+		YAE_VERBOSE_CAT(vulkan, "Created Index Buffer");
 	}
 
 	return true;
@@ -893,7 +893,7 @@ bool VulkanRenderer::createShader(const void* _code, size_t _codeSize, ShaderHan
 
 	if (vkCreateShaderModule(m_device, &createInfo, nullptr, &_outShaderHandle.shaderModule) != VK_SUCCESS)
 	{
-		YAE_ERROR_CAT("vulkan", "Failed to create shader module");
+		YAE_ERROR_CAT(vulkan, "Failed to create shader module");
 		return false;
 	}
 	
@@ -914,10 +914,10 @@ void VulkanRenderer::destroyMesh(MeshHandle& _inMeshHandle)
 	YAE_CAPTURE_FUNCTION();
 
 	vulkan::destroyBuffer(m_allocator, _inMeshHandle.indexBuffer, _inMeshHandle.indexMemory);
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Index Buffer");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Index Buffer");
 
 	vulkan::destroyBuffer(m_allocator, _inMeshHandle.vertexBuffer, _inMeshHandle.vertexMemory);
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Vertex Buffer");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Vertex Buffer");
 
 	_inMeshHandle.indexBuffer = VK_NULL_HANDLE;
 	_inMeshHandle.indexMemory = VK_NULL_HANDLE;
@@ -1304,7 +1304,7 @@ void VulkanRenderer::_createPipeline()
 	fragmentShader->releaseUnuse();
 	vertexShader->releaseUnuse();
 
-	YAE_VERBOSE_CAT("vulkan", "Created Graphics Pipeline");
+	YAE_VERBOSE_CAT(vulkan, "Created Graphics Pipeline");
 }
 
 void VulkanRenderer::_destroyPipeline()
@@ -1313,7 +1313,7 @@ void VulkanRenderer::_destroyPipeline()
 	m_graphicsPipeline = VK_NULL_HANDLE;
 	vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
 	m_pipelineLayout = VK_NULL_HANDLE;
-	YAE_VERBOSE_CAT("vulkan", "Destroyed Graphic Pipeline");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed Graphic Pipeline");
 }
 
 void VulkanRenderer::_transitionImageLayout(VkImage _image, VkFormat _format, VkImageLayout _oldLayout, VkImageLayout _newLayout)
@@ -66,7 +66,7 @@ void VulkanSwapChain::shutdown()
 	m_images.clear();
 	_destroySwapChain();
 
-	YAE_VERBOSE_CAT("vulkan", "Destroyed SwapChain");
+	YAE_VERBOSE_CAT(vulkan, "Destroyed SwapChain");
 }
 
 VkResult VulkanSwapChain::acquireNextImage(u32* _imageIndex)
@@ -246,7 +246,7 @@ void VulkanSwapChain::_createSwapChain(VkSwapchainKHR _previousSwapChain)
 	createInfo.oldSwapchain = _previousSwapChain;
 
 	VK_VERIFY(vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapChain));
-	YAE_VERBOSE_CAT("vulkan", "SwapChain: Created SwapChain");
+	YAE_VERBOSE_CAT(vulkan, "SwapChain: Created SwapChain");
 }
 
 void VulkanSwapChain::_createSwapChainImages()
@@ -269,7 +269,7 @@ void VulkanSwapChain::_createSwapChainImages()
 		m_images[i].imageView = vulkan::createImageView(m_device, images[i], m_imageFormat, VK_IMAGE_ASPECT_COLOR_BIT);
 		m_images[i].imageInFlight = VK_NULL_HANDLE;
 	}
-	YAE_VERBOSE_CAT("vulkan", "SwapChain: Created Images");
+	YAE_VERBOSE_CAT(vulkan, "SwapChain: Created Images");
 }
 
 void VulkanSwapChain::_createDepthImages()
@@ -297,7 +297,7 @@ void VulkanSwapChain::_createDepthImages()
 		m_images[i].depthImageView = vulkan::createImageView(m_device, m_images[i].depthImage, m_depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
 		//_transitionImageLayout(m_images[i].depthImage, m_depthFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 	}
-	YAE_VERBOSE_CAT("vulkan", "SwapChain: Depth Resources Created");
+	YAE_VERBOSE_CAT(vulkan, "SwapChain: Depth Resources Created");
 }
 
 void VulkanSwapChain::_createRenderPass()
@@ -362,7 +362,7 @@ void VulkanSwapChain::_createRenderPass()
 	renderPassInfo.pDependencies = &dependency;
 
 	VK_VERIFY(vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass));
-	YAE_VERBOSE_CAT("vulkan", "SwapChain: Created RenderPass");
+	YAE_VERBOSE_CAT(vulkan, "SwapChain: Created RenderPass");
 }
 
 void VulkanSwapChain::_createFrameBuffers()
@@ -387,7 +387,7 @@ void VulkanSwapChain::_createFrameBuffers()
 
 		VK_VERIFY(vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &m_images[i].frameBuffer));
 	}
-	YAE_VERBOSE_CAT("vulkan", "SwapChain: Created Frame Buffers");
+	YAE_VERBOSE_CAT(vulkan, "SwapChain: Created Frame Buffers");
 }
 
 void VulkanSwapChain::_createSyncObjects()
@@ -407,7 +407,7 @@ void VulkanSwapChain::_createSyncObjects()
 		VK_VERIFY(vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_syncObjects[i].renderFinishedSemaphore));
 		VK_VERIFY(vkCreateFence(m_device, &fenceInfo, nullptr, &m_syncObjects[i].inFlightFence));
 	}
-	YAE_VERBOSE_CAT("vulkan", "SwapChain: Created Sync Objects");
+	YAE_VERBOSE_CAT(vulkan, "SwapChain: Created Sync Objects");
 }
 
 
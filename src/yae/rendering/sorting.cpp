@@ -0,0 +1,82 @@
+#include "sorting.h"
+
+#include <core/math.h>
+
+namespace yae {
+namespace sorting {
+
+u64 makeDrawKey(RenderPass _pass, u32 _shader, u32 _texture, float _depth, u32 _mesh)
+{
+	const u64 pass = u64(_pass) & 0xF;
+	const u64 shader = u64(_shader) & 0x3FFF;
+	const u64 texture = u64(_texture) & 0x3FFF;
+	const u64 mesh = u64(_mesh) & 0xFFFF;
+	const u64 depth = u64(math::clamp(_depth, 0.f, 1.f) * 65535.f);
+
+	switch (_pass)
+	{
+		case RenderPass::BLENDED:
+			return (pass << 60) | ((0xFFFF - depth) << 44) | (shader << 30) | (texture << 16) | mesh;
+
+		default:
+			return (pass << 60) | (shader << 46) | (texture << 32) | (depth << 16) | mesh;
+	}
+}
+
+void radixSort(u64* _keys, u32* _values, u32 _count, u64* _tmpKeys, u32* _tmpValues)
+{
+	if (_count < 2)
+		return;
+
+	// Build every histogram in a single read of the keys
+	u32 histograms[8][256] = {};
+	for (u32 i = 0; i < _count; ++i)
+	{
+		u64 key = _keys[i];
+		for (u32 byte = 0; byte < 8; ++byte)
+		{
+			++histograms[byte][(key >> (byte * 8)) & 0xFF];
+		}
+	}
+
+	u64* srcKeys = _keys;
+	u32* srcValues = _values;
+	u64* dstKeys = _tmpKeys;
+	u32* dstValues = _tmpValues;
+	for (u32 byte = 0; byte < 8; ++byte)
+	{
+		u32* histogram = histograms[byte];
+
+		// Every key has the same value for this byte, the pass would not move anything
+		if (histogram[(srcKeys[0] >> (byte * 8)) & 0xFF] == _count)
+			continue;
+
+		u32 offset = 0;
+		for (u32 bucket = 0; bucket < 256; ++bucket)
+		{
+			u32 bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (u32 i = 0; i < _count; ++i)
+		{
+			u32 bucket = (srcKeys[i] >> (byte * 8)) & 0xFF;
+			u32 destination = histogram[bucket]++;
+			dstKeys[destination] = srcKeys[i];
+			dstValues[destination] = srcValues[i];
+		}
+
+		u64* swapKeys = srcKeys; srcKeys = dstKeys; dstKeys = swapKeys;
+		u32* swapValues = srcValues; srcValues = dstValues; dstValues = swapValues;
+	}
+
+	if (srcKeys != _keys)
+	{
+		memcpy(_keys, srcKeys, _count * sizeof(*_keys));
+		memcpy(_values, srcValues, _count * sizeof(*_values));
+	}
+}
+
+} // namespace sorting
+} // namespace yae
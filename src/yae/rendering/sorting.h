@@ -0,0 +1,23 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/rendering/render_types.h>
+
+namespace yae {
+namespace sorting {
+
+// 64 bits draw sort key, from most to least significant bits:
+//   SOLID:   pass(4) | shader(14) | texture(14) | depth(16) | mesh(16)
+//   BLENDED: pass(4) | inverted depth(16) | shader(14) | texture(14) | mesh(16)
+// Handles are truncated to their field size: commands sharing a key field do not necessarily share the state,
+// so the backend still has to compare the actual handles when filtering state changes.
+// _depth is the normalized view depth, clamped to [0, 1].
+YAE_API u64 makeDrawKey(RenderPass _pass, u32 _shader, u32 _texture, float _depth, u32 _mesh);
+
+// Stable LSD radix sort of _keys, 8 bits per pass. _values are reordered along with the keys.
+// Passes on bytes that are identical across all keys are skipped.
+// _tmpKeys and _tmpValues must be able to hold _count elements.
+YAE_API void radixSort(u64* _keys, u32* _values, u32 _count, u64* _tmpKeys, u32* _tmpValues);
+
+} // namespace sorting
+} // namespace yae
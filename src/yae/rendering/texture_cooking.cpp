@@ -0,0 +1,517 @@
+#include "texture_cooking.h"
+
+#include <core/math.h>
+
+namespace yae {
+namespace texture_cooking {
+
+struct CookedTextureHeader
+{
+	u32 magic;
+	u32 version;
+	u32 sourceHash;
+	u32 format; // TextureFormat
+	u32 width;
+	u32 height;
+	u32 mipCount;
+	u32 mipSizes[YAE_TEXTURE_MAX_MIP_COUNT];
+};
+const u32 COOKED_TEXTURE_MAGIC = 0x58544159; // "YATX"
+
+static u32 getBlockSize(TextureFormat _format)
+{
+	switch (_format)
+	{
+		case TextureFormat::BC1: return 8;
+		case TextureFormat::BC3: return 16;
+		default: return 0;
+	}
+}
+
+u32 getImageSize(TextureFormat _format, u32 _width, u32 _height)
+{
+	if (_format == TextureFormat::RGBA8)
+		return _width * _height * 4;
+
+	u32 blockCountX = math::max((_width + 3) / 4, 1u);
+	u32 blockCountY = math::max((_height + 3) / 4, 1u);
+	return blockCountX * blockCountY * getBlockSize(_format);
+}
+
+u32 getMipCount(u32 _width, u32 _height)
+{
+	u32 size = math::max(_width, _height);
+	u32 count = 1;
+	while (size > 1)
+	{
+		size /= 2;
+		++count;
+	}
+	return count;
+}
+
+void downsample(const u8* _src, u32 _srcWidth, u32 _srcHeight, u8* _dst)
+{
+	u32 dstWidth = math::max(_srcWidth / 2, 1u);
+	u32 dstHeight = math::max(_srcHeight / 2, 1u);
+	for (u32 y = 0; y < dstHeight; ++y)
+	{
+		const u8* row0 = _src + (y * 2) * _srcWidth * 4;
+		const u8* row1 = _src + math::min(y * 2 + 1, _srcHeight - 1) * _srcWidth * 4;
+		for (u32 x = 0; x < dstWidth; ++x)
+		{
+			u32 x0 = (x * 2) * 4;
+			u32 x1 = math::min(x * 2 + 1, _srcWidth - 1) * 4;
+			u8* dst = _dst + (y * dstWidth + x) * 4;
+			for (u32 c = 0; c < 4; ++c)
+			{
+				dst[c] = u8((u32(row0[x0 + c]) + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+			}
+		}
+	}
+}
+
+bool hasAlpha(const u8* _pixels, u32 _width, u32 _height)
+{
+	u32 pixelCount = _width * _height;
+	for (u32 i = 0; i < pixelCount; ++i)
+	{
+		if (_pixels[i * 4 + 3] != 255)
+			return true;
+	}
+	return false;
+}
+
+// Gathers the 4x4 block at (_blockX, _blockY), coordinates outside of the image are clamped to the edges
+static void fetchBlock(const u8* _pixels, u32 _width, u32 _height, u32 _blockX, u32 _blockY, u8 _outBlock[16][4])
+{
+	for (u32 y = 0; y < 4; ++y)
+	{
+		u32 sourceY = math::min(_blockY * 4 + y, _height - 1);
+		for (u32 x = 0; x < 4; ++x)
+		{
+			u32 sourceX = math::min(_blockX * 4 + x, _width - 1);
+			memcpy(_outBlock[y * 4 + x], _pixels + (sourceY * _width + sourceX) * 4, 4);
+		}
+	}
+}
+
+static u16 packColor565(const float _rgb[3])
+{
+	u32 r = u32(math::clamp(_rgb[0] * (31.f / 255.f) + .5f, 0.f, 31.f));
+	u32 g = u32(math::clamp(_rgb[1] * (63.f / 255.f) + .5f, 0.f, 63.f));
+	u32 b = u32(math::clamp(_rgb[2] * (31.f / 255.f) + .5f, 0.f, 31.f));
+	return u16((r << 11) | (g << 5) | b);
+}
+
+static void unpackColor565(u16 _color, u8 _outRgb[3])
+{
+	u32 r = (_color >> 11) & 31;
+	u32 g = (_color >> 5) & 63;
+	u32 b = _color & 31;
+	_outRgb[0] = u8((r << 3) | (r >> 2));
+	_outRgb[1] = u8((g << 2) | (g >> 4));
+	_outRgb[2] = u8((b << 3) | (b >> 2));
+}
+
+static void writeU16(u8* _dst, u16 _value)
+{
+	_dst[0] = u8(_value);
+	_dst[1] = u8(_value >> 8);
+}
+
+static u16 readU16(const u8* _src)
+{
+	return u16(_src[0] | (_src[1] << 8));
+}
+
+// Range fit along the principal axis of the block colors, the endpoints are then inset by 1/16 of the range
+// to make up for the extremes being less represented than the rest of the colors.
+// Always produces a four colors block (color0 > color1), or a single color block with all indices at 0.
+static void compressColorBlock(const u8 _block[16][4], u8* _out)
+{
+	float mean[3] = {};
+	for (u32 i = 0; i < 16; ++i)
+	{
+		for (u32 c = 0; c < 3; ++c)
+		{
+			mean[c] += _block[i][c];
+		}
+	}
+	for (u32 c = 0; c < 3; ++c)
+	{
+		mean[c] /= 16.f;
+	}
+
+	float covariance[6] = {}; // rr, rg, rb, gg, gb, bb
+	for (u32 i = 0; i < 16; ++i)
+	{
+		float r = _block[i][0] - mean[0];
+		float g = _block[i][1] - mean[1];
+		float b = _block[i][2] - mean[2];
+		covariance[0] += r * r;
+		covariance[1] += r * g;
+		covariance[2] += r * b;
+		covariance[3] += g * g;
+		covariance[4] += g * b;
+		covariance[5] += b * b;
+	}
+
+	// Power iteration, starting from the covariance row of the widest channel so that the start is never orthogonal
+	// to the principal axis (e.g. anti-correlated channels)
+	float axis[3] = { covariance[0], covariance[1], covariance[2] };
+	if (covariance[3] > covariance[0] && covariance[3] >= covariance[5])
+	{
+		axis[0] = covariance[1];
+		axis[1] = covariance[3];
+		axis[2] = covariance[4];
+	}
+	else if (covariance[5] > covariance[0] && covariance[5] > covariance[3])
+	{
+		axis[0] = covariance[2];
+		axis[1] = covariance[4];
+		axis[2] = covariance[5];
+	}
+	for (u32 iteration = 0; iteration < 8; ++iteration)
+	{
+		float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+		float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+		float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+		float length = math::max(math::max(math::abs(x), math::abs(y)), math::abs(z));
+		if (length < 1e-6f)
+			break;
+		axis[0] = x / length;
+		axis[1] = y / length;
+		axis[2] = z / length;
+	}
+
+	float minT = 0.f, maxT = 0.f;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		float t = (_block[i][0] - mean[0]) * axis[0] + (_block[i][1] - mean[1]) * axis[1] + (_block[i][2] - mean[2]) * axis[2];
+		minT = math::min(minT, t);
+		maxT = math::max(maxT, t);
+	}
+	float axisLengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	if (axisLengthSquared > 1e-6f)
+	{
+		float inset = (maxT - minT) / 16.f;
+		minT = (minT + inset) / axisLengthSquared;
+		maxT = (maxT - inset) / axisLengthSquared;
+	}
+
+	float maxColor[3], minColor[3];
+	for (u32 c = 0; c < 3; ++c)
+	{
+		maxColor[c] = mean[c] + axis[c] * maxT;
+		minColor[c] = mean[c] + axis[c] * minT;
+	}
+	u16 color0 = packColor565(maxColor);
+	u16 color1 = packColor565(minColor);
+	if (color0 < color1)
+	{
+		u16 tmp = color0;
+		color0 = color1;
+		color1 = tmp;
+	}
+
+	u32 indices = 0;
+	if (color0 != color1)
+	{
+		u8 palette[4][3];
+		unpackColor565(color0, palette[0]);
+		unpackColor565(color1, palette[1]);
+		for (u32 c = 0; c < 3; ++c)
+		{
+			palette[2][c] = u8((2 * palette[0][c] + palette[1][c]) / 3);
+			palette[3][c] = u8((palette[0][c] + 2 * palette[1][c]) / 3);
+		}
+
+		for (u32 i = 0; i < 16; ++i)
+		{
+			u32 bestIndex = 0;
+			i32 bestDistance = INT32_MAX;
+			for (u32 p = 0; p < 4; ++p)
+			{
+				i32 dr = i32(_block[i][0]) - palette[p][0];
+				i32 dg = i32(_block[i][1]) - palette[p][1];
+				i32 db = i32(_block[i][2]) - palette[p][2];
+				i32 distance = dr * dr + dg * dg + db * db;
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+			indices |= bestIndex << (i * 2);
+		}
+	}
+
+	writeU16(_out, color0);
+	writeU16(_out + 2, color1);
+	_out[4] = u8(indices);
+	_out[5] = u8(indices >> 8);
+	_out[6] = u8(indices >> 16);
+	_out[7] = u8(indices >> 24);
+}
+
+static void decompressColorBlock(const u8* _data, bool _forceFourColors, u8 _outBlock[16][4])
+{
+	u16 color0 = readU16(_data);
+	u16 color1 = readU16(_data + 2);
+	u8 palette[4][4];
+	unpackColor565(color0, palette[0]);
+	unpackColor565(color1, palette[1]);
+	palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+	if (color0 > color1 || _forceFourColors)
+	{
+		for (u32 c = 0; c < 3; ++c)
+		{
+			palette[2][c] = u8((2 * palette[0][c] + palette[1][c]) / 3);
+			palette[3][c] = u8((palette[0][c] + 2 * palette[1][c]) / 3);
+		}
+	}
+	else
+	{
+		for (u32 c = 0; c < 3; ++c)
+		{
+			palette[2][c] = u8((palette[0][c] + palette[1][c]) / 2);
+			palette[3][c] = 0;
+		}
+		palette[3][3] = 0;
+	}
+
+	u32 indices = u32(_data[4]) | (u32(_data[5]) << 8) | (u32(_data[6]) << 16) | (u32(_data[7]) << 24);
+	for (u32 i = 0; i < 16; ++i)
+	{
+		memcpy(_outBlock[i], palette[(indices >> (i * 2)) & 3], 4);
+	}
+}
+
+static void computeAlphaPalette(u8 _alpha0, u8 _alpha1, u8 _outPalette[8])
+{
+	_outPalette[0] = _alpha0;
+	_outPalette[1] = _alpha1;
+	if (_alpha0 > _alpha1)
+	{
+		for (u32 i = 2; i < 8; ++i)
+		{
+			_outPalette[i] = u8(((8 - i) * _alpha0 + (i - 1) * _alpha1) / 7);
+		}
+	}
+	else
+	{
+		for (u32 i = 2; i < 6; ++i)
+		{
+			_outPalette[i] = u8(((6 - i) * _alpha0 + (i - 1) * _alpha1) / 5);
+		}
+		_outPalette[6] = 0;
+		_outPalette[7] = 255;
+	}
+}
+
+// Min/max endpoints, eight alpha values mode
+static void compressAlphaBlock(const u8 _block[16][4], u8* _out)
+{
+	u8 alpha0 = 0, alpha1 = 255;
+	for (u32 i = 0; i < 16; ++i)
+	{
+		alpha0 = math::max(alpha0, _block[i][3]);
+		alpha1 = math::min(alpha1, _block[i][3]);
+	}
+
+	u64 indices = 0;
+	if (alpha0 != alpha1)
+	{
+		u8 palette[8];
+		computeAlphaPalette(alpha0, alpha1, palette);
+		for (u32 i = 0; i < 16; ++i)
+		{
+			u32 bestIndex = 0;
+			i32 bestDistance = INT32_MAX;
+			for (u32 p = 0; p < 8; ++p)
+			{
+				i32 distance = math::abs(i32(_block[i][3]) - i32(palette[p]));
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+			indices |= u64(bestIndex) << (i * 3);
+		}
+	}
+
+	_out[0] = alpha0;
+	_out[1] = alpha1;
+	for (u32 i = 0; i < 6; ++i)
+	{
+		_out[2 + i] = u8(indices >> (i * 8));
+	}
+}
+
+static void decompressAlphaBlock(const u8* _data, u8 _outBlock[16][4])
+{
+	u8 palette[8];
+	computeAlphaPalette(_data[0], _data[1], palette);
+
+	u64 indices = 0;
+	for (u32 i = 0; i < 6; ++i)
+	{
+		indices |= u64(_data[2 + i]) << (i * 8);
+	}
+	for (u32 i = 0; i < 16; ++i)
+	{
+		_outBlock[i][3] = palette[(indices >> (i * 3)) & 7];
+	}
+}
+
+void compressImage(TextureFormat _format, const u8* _pixels, u32 _width, u32 _height, u8* _outData)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_format == TextureFormat::BC1 || _format == TextureFormat::BC3);
+
+	u32 blockSize = getBlockSize(_format);
+	u32 blockCountX = (_width + 3) / 4;
+	u32 blockCountY = (_height + 3) / 4;
+	u8 block[16][4];
+	for (u32 blockY = 0; blockY < blockCountY; ++blockY)
+	{
+		for (u32 blockX = 0; blockX < blockCountX; ++blockX)
+		{
+			u8* out = _outData + (blockY * blockCountX + blockX) * blockSize;
+			fetchBlock(_pixels, _width, _height, blockX, blockY, block);
+			if (_format == TextureFormat::BC3)
+			{
+				compressAlphaBlock(block, out);
+				out += 8;
+			}
+			compressColorBlock(block, out);
+		}
+	}
+}
+
+void decompressImage(TextureFormat _format, const u8* _data, u32 _width, u32 _height, u8* _outPixels)
+{
+	YAE_ASSERT(_format == TextureFormat::BC1 || _format == TextureFormat::BC3);
+
+	u32 blockSize = getBlockSize(_format);
+	u32 blockCountX = (_width + 3) / 4;
+	u32 blockCountY = (_height + 3) / 4;
+	u8 block[16][4];
+	for (u32 blockY = 0; blockY < blockCountY; ++blockY)
+	{
+		for (u32 blockX = 0; blockX < blockCountX; ++blockX)
+		{
+			const u8* data = _data + (blockY * blockCountX + blockX) * blockSize;
+			if (_format == TextureFormat::BC3)
+			{
+				decompressColorBlock(data + 8, true, block);
+				decompressAlphaBlock(data, block);
+			}
+			else
+			{
+				decompressColorBlock(data, false, block);
+			}
+
+			for (u32 y = 0; y < 4 && blockY * 4 + y < _height; ++y)
+			{
+				for (u32 x = 0; x < 4 && blockX * 4 + x < _width; ++x)
+				{
+					memcpy(_outPixels + ((blockY * 4 + y) * _width + blockX * 4 + x) * 4, block[y * 4 + x], 4);
+				}
+			}
+		}
+	}
+}
+
+void cookTexture(const u8* _pixels, u32 _width, u32 _height, TextureFormat _format, bool _generateMips, u32 _sourceHash, DataArray<u8>& _outData)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(_pixels != nullptr && _width > 0 && _height > 0);
+
+	CookedTextureHeader header = {};
+	header.magic = COOKED_TEXTURE_MAGIC;
+	header.version = YAE_TEXTURE_COOK_VERSION;
+	header.sourceHash = _sourceHash;
+	header.format = u32(_format);
+	header.width = _width;
+	header.height = _height;
+	header.mipCount = _generateMips ? math::min(getMipCount(_width, _height), u32(YAE_TEXTURE_MAX_MIP_COUNT)) : 1;
+
+	u32 totalSize = sizeof(header);
+	for (u32 level = 0; level < header.mipCount; ++level)
+	{
+		header.mipSizes[level] = getImageSize(_format, math::max(_width >> level, 1u), math::max(_height >> level, 1u));
+		totalSize += header.mipSizes[level];
+	}
+	_outData.resize(totalSize);
+	memcpy(_outData.data(), &header, sizeof(header));
+
+	// Each level is filtered from the previous one
+	DataArray<u8> levelPixels[2] = { DataArray<u8>(&scratchAllocator()), DataArray<u8>(&scratchAllocator()) };
+	const u8* pixels = _pixels;
+	u8* out = _outData.data() + sizeof(header);
+	for (u32 level = 0; level < header.mipCount; ++level)
+	{
+		u32 width = math::max(_width >> level, 1u);
+		u32 height = math::max(_height >> level, 1u);
+		if (level > 0)
+		{
+			DataArray<u8>& nextPixels = levelPixels[level % 2];
+			nextPixels.resize(width * height * 4);
+			downsample(pixels, math::max(_width >> (level - 1), 1u), math::max(_height >> (level - 1), 1u), nextPixels.data());
+			pixels = nextPixels.data();
+		}
+
+		if (_format == TextureFormat::RGBA8)
+		{
+			memcpy(out, pixels, header.mipSizes[level]);
+		}
+		else
+		{
+			compressImage(_format, pixels, width, height, out);
+		}
+		out += header.mipSizes[level];
+	}
+}
+
+bool readCookedTexture(const void* _data, u32 _dataSize, CookedTexture& _outTexture)
+{
+	if (_dataSize < sizeof(CookedTextureHeader))
+		return false;
+
+	const CookedTextureHeader* header = (const CookedTextureHeader*)_data;
+	if (header->magic != COOKED_TEXTURE_MAGIC
+		|| header->version != YAE_TEXTURE_COOK_VERSION
+		|| header->format >= u32(TextureFormat::COUNT)
+		|| header->mipCount == 0 || header->mipCount > YAE_TEXTURE_MAX_MIP_COUNT)
+	{
+		return false;
+	}
+
+	_outTexture.format = TextureFormat(header->format);
+	_outTexture.width = header->width;
+	_outTexture.height = header->height;
+	_outTexture.sourceHash = header->sourceHash;
+	_outTexture.mipCount = header->mipCount;
+
+	const u8* data = (const u8*)(header + 1);
+	const u8* end = (const u8*)_data + _dataSize;
+	for (u32 level = 0; level < header->mipCount; ++level)
+	{
+		u32 expectedSize = getImageSize(_outTexture.format, math::max(header->width >> level, 1u), math::max(header->height >> level, 1u));
+		if (header->mipSizes[level] != expectedSize || u32(end - data) < expectedSize)
+			return false;
+
+		_outTexture.mips[level].data = data;
+		_outTexture.mips[level].size = expectedSize;
+		data += expectedSize;
+	}
+	return true;
+}
+
+} // namespace texture_cooking
+} // namespace yae
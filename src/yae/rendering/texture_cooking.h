@@ -0,0 +1,54 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/rendering/render_types.h>
+#include <core/containers/Array.h>
+
+// Bump when the cooked output changes, cooked files of other versions are rebuilt
+#define YAE_TEXTURE_COOK_VERSION 1
+
+// Enough levels for a 32768x32768 texture
+#define YAE_TEXTURE_MAX_MIP_COUNT 16
+
+namespace yae {
+namespace texture_cooking {
+
+// Cooked texture, the mips point into the buffer it was read from
+struct YAE_API CookedTexture
+{
+	TextureFormat format = TextureFormat::RGBA8;
+	u32 width = 0;
+	u32 height = 0;
+	u32 sourceHash = 0;
+	u32 mipCount = 0;
+	TextureMip mips[YAE_TEXTURE_MAX_MIP_COUNT];
+};
+
+// Size in bytes of a _width x _height image in _format
+YAE_API u32 getImageSize(TextureFormat _format, u32 _width, u32 _height);
+
+// Number of levels of a full mip chain, down to 1x1
+YAE_API u32 getMipCount(u32 _width, u32 _height);
+
+// Box filters a RGBA8 image down to the next mip level: max(_srcWidth / 2, 1) x max(_srcHeight / 2, 1)
+YAE_API void downsample(const u8* _src, u32 _srcWidth, u32 _srcHeight, u8* _dst);
+
+// True if any pixel of a RGBA8 image is not fully opaque
+YAE_API bool hasAlpha(const u8* _pixels, u32 _width, u32 _height);
+
+// Encodes a RGBA8 image in a block compressed format, _outData must hold getImageSize(_format, _width, _height) bytes.
+// Blocks crossing the image borders are padded with the edge pixels.
+YAE_API void compressImage(TextureFormat _format, const u8* _pixels, u32 _width, u32 _height, u8* _outData);
+
+// Decodes a block compressed image back to RGBA8, for tools and tests
+YAE_API void decompressImage(TextureFormat _format, const u8* _data, u32 _width, u32 _height, u8* _outPixels);
+
+// Builds the mip chain of a RGBA8 image (a single level if !_generateMips), encodes it in _format
+// and writes the whole cooked container in _outData. Runs on the CPU only.
+YAE_API void cookTexture(const u8* _pixels, u32 _width, u32 _height, TextureFormat _format, bool _generateMips, u32 _sourceHash, DataArray<u8>& _outData);
+
+// Reads a cooked container, fails if it is invalid or was produced by another cook version
+YAE_API bool readCookedTexture(const void* _data, u32 _dataSize, CookedTexture& _outTexture);
+
+} // namespace texture_cooking
+} // namespace yae
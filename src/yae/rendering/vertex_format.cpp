@@ -0,0 +1,320 @@
+#include "vertex_format.h"
+
+#include <core/math.h>
+
+#include <cmath>
+
+namespace yae {
+namespace vertex_format {
+
+// Largest rounding error of quantized positions, relative to the mesh size
+const float POSITION_TOLERANCE = 1.f / 1000.f;
+const float HALF_MAX = 65504.f;
+
+u32 getAttributeSize(VertexAttributeFormat _format)
+{
+	switch (_format)
+	{
+		case VertexAttributeFormat::FLOAT2: return 8;
+		case VertexAttributeFormat::FLOAT3: return 12;
+		case VertexAttributeFormat::HALF4: return 8;
+		case VertexAttributeFormat::UNORM16x2: return 4;
+		case VertexAttributeFormat::SNORM10x3: return 4;
+		case VertexAttributeFormat::UNORM8x4: return 4;
+		default: YAE_ASSERT(false); return 0;
+	}
+}
+
+u32 getStride(const VertexFormat& _format)
+{
+	u32 stride = 0;
+	for (VertexAttributeFormat attribute : _format.attributes)
+	{
+		stride += getAttributeSize(attribute);
+	}
+	return stride;
+}
+
+u32 getOffset(const VertexFormat& _format, VertexAttribute _attribute)
+{
+	u32 offset = 0;
+	for (u32 i = 0; i < u32(_attribute); ++i)
+	{
+		offset += getAttributeSize(_format.attributes[i]);
+	}
+	return offset;
+}
+
+VertexFormat computeQuantizedFormat(const Vertex* _vertices, u32 _vertexCount)
+{
+	YAE_ASSERT(_vertices != nullptr || _vertexCount == 0);
+
+	VertexFormat format;
+	if (_vertexCount == 0)
+		return format;
+
+	Vector3 minPosition = _vertices[0].pos;
+	Vector3 maxPosition = _vertices[0].pos;
+	bool areTexCoordsNormalized = true;
+	bool areColorsNormalized = true;
+	for (u32 i = 0; i < _vertexCount; ++i)
+	{
+		const Vertex& vertex = _vertices[i];
+		minPosition = Vector3(math::min(minPosition.x, vertex.pos.x), math::min(minPosition.y, vertex.pos.y), math::min(minPosition.z, vertex.pos.z));
+		maxPosition = Vector3(math::max(maxPosition.x, vertex.pos.x), math::max(maxPosition.y, vertex.pos.y), math::max(maxPosition.z, vertex.pos.z));
+		areTexCoordsNormalized = areTexCoordsNormalized
+			&& vertex.texCoord.x >= 0.f && vertex.texCoord.x <= 1.f
+			&& vertex.texCoord.y >= 0.f && vertex.texCoord.y <= 1.f;
+		areColorsNormalized = areColorsNormalized
+			&& vertex.color.x >= 0.f && vertex.color.x <= 1.f
+			&& vertex.color.y >= 0.f && vertex.color.y <= 1.f
+			&& vertex.color.z >= 0.f && vertex.color.z <= 1.f;
+	}
+
+	// Half floats have 11 significant bits, the rounding error grows with the distance to the origin
+	float maxAbsolute = math::max(math::max(math::max(-minPosition.x, maxPosition.x), math::max(-minPosition.y, maxPosition.y)), math::max(-minPosition.z, maxPosition.z));
+	float size = math::max(math::max(maxPosition.x - minPosition.x, maxPosition.y - minPosition.y), maxPosition.z - minPosition.z);
+	if (maxAbsolute < HALF_MAX && maxAbsolute / 2048.f <= size * POSITION_TOLERANCE)
+	{
+		format.attributes[u32(VertexAttribute::POSITION)] = VertexAttributeFormat::HALF4;
+	}
+	if (areTexCoordsNormalized)
+	{
+		format.attributes[u32(VertexAttribute::TEXCOORD)] = VertexAttributeFormat::UNORM16x2;
+	}
+	format.attributes[u32(VertexAttribute::NORMAL)] = VertexAttributeFormat::SNORM10x3;
+	if (areColorsNormalized)
+	{
+		format.attributes[u32(VertexAttribute::COLOR)] = VertexAttributeFormat::UNORM8x4;
+	}
+	return format;
+}
+
+static void encodeAttribute(VertexAttributeFormat _format, const float* _values, u8* _out)
+{
+	switch (_format)
+	{
+		case VertexAttributeFormat::FLOAT2:
+		{
+			memcpy(_out, _values, sizeof(float) * 2);
+		}
+		break;
+
+		case VertexAttributeFormat::FLOAT3:
+		{
+			memcpy(_out, _values, sizeof(float) * 3);
+		}
+		break;
+
+		case VertexAttributeFormat::HALF4:
+		{
+			u16 halves[4] = { floatToHalf(_values[0]), floatToHalf(_values[1]), floatToHalf(_values[2]), 0 };
+			memcpy(_out, halves, sizeof(halves));
+		}
+		break;
+
+		case VertexAttributeFormat::UNORM16x2:
+		{
+			u16 values[2];
+			for (u32 i = 0; i < 2; ++i)
+			{
+				values[i] = u16(math::clamp(_values[i], 0.f, 1.f) * 65535.f + .5f);
+			}
+			memcpy(_out, values, sizeof(values));
+		}
+		break;
+
+		case VertexAttributeFormat::SNORM10x3:
+		{
+			// x in the low bits, w left at 0
+			u32 packed = 0;
+			for (u32 i = 0; i < 3; ++i)
+			{
+				i32 value = i32(roundf(math::clamp(_values[i], -1.f, 1.f) * 511.f));
+				packed |= (u32(value) & 0x3FF) << (i * 10);
+			}
+			memcpy(_out, &packed, sizeof(packed));
+		}
+		break;
+
+		case VertexAttributeFormat::UNORM8x4:
+		{
+			for (u32 i = 0; i < 3; ++i)
+			{
+				_out[i] = u8(math::clamp(_values[i], 0.f, 1.f) * 255.f + .5f);
+			}
+			_out[3] = 255;
+		}
+		break;
+
+		default:
+			YAE_ASSERT(false);
+	}
+}
+
+static void decodeAttribute(VertexAttributeFormat _format, const u8* _data, float* _outValues, u32 _valueCount)
+{
+	float values[4] = {};
+	switch (_format)
+	{
+		case VertexAttributeFormat::FLOAT2:
+		{
+			memcpy(values, _data, sizeof(float) * 2);
+		}
+		break;
+
+		case VertexAttributeFormat::FLOAT3:
+		{
+			memcpy(values, _data, sizeof(float) * 3);
+		}
+		break;
+
+		case VertexAttributeFormat::HALF4:
+		{
+			u16 halves[4];
+			memcpy(halves, _data, sizeof(halves));
+			for (u32 i = 0; i < 3; ++i)
+			{
+				values[i] = halfToFloat(halves[i]);
+			}
+		}
+		break;
+
+		case VertexAttributeFormat::UNORM16x2:
+		{
+			u16 encoded[2];
+			memcpy(encoded, _data, sizeof(encoded));
+			values[0] = float(encoded[0]) / 65535.f;
+			values[1] = float(encoded[1]) / 65535.f;
+		}
+		break;
+
+		case VertexAttributeFormat::SNORM10x3:
+		{
+			u32 packed;
+			memcpy(&packed, _data, sizeof(packed));
+			for (u32 i = 0; i < 3; ++i)
+			{
+				i32 value = i32(packed << (22 - i * 10)) >> 22; // sign extended
+				values[i] = math::max(float(value) / 511.f, -1.f);
+			}
+		}
+		break;
+
+		case VertexAttributeFormat::UNORM8x4:
+		{
+			for (u32 i = 0; i < 3; ++i)
+			{
+				values[i] = float(_data[i]) / 255.f;
+			}
+		}
+		break;
+
+		default:
+			YAE_ASSERT(false);
+	}
+	memcpy(_outValues, values, sizeof(float) * _valueCount);
+}
+
+void encodeVertices(const VertexFormat& _format, const Vertex* _vertices, u32 _vertexCount, u8* _outData)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	const u32 stride = getStride(_format);
+	const u32 texCoordOffset = getOffset(_format, VertexAttribute::TEXCOORD);
+	const u32 normalOffset = getOffset(_format, VertexAttribute::NORMAL);
+	const u32 colorOffset = getOffset(_format, VertexAttribute::COLOR);
+	for (u32 i = 0; i < _vertexCount; ++i)
+	{
+		const Vertex& vertex = _vertices[i];
+		u8* out = _outData + i * stride;
+		encodeAttribute(_format.get(VertexAttribute::POSITION), (const float*)&vertex.pos, out);
+		encodeAttribute(_format.get(VertexAttribute::TEXCOORD), (const float*)&vertex.texCoord, out + texCoordOffset);
+		encodeAttribute(_format.get(VertexAttribute::NORMAL), (const float*)&vertex.normal, out + normalOffset);
+		encodeAttribute(_format.get(VertexAttribute::COLOR), (const float*)&vertex.color, out + colorOffset);
+	}
+}
+
+void decodeVertices(const VertexFormat& _format, const u8* _data, u32 _vertexCount, Vertex* _outVertices)
+{
+	const u32 stride = getStride(_format);
+	const u32 texCoordOffset = getOffset(_format, VertexAttribute::TEXCOORD);
+	const u32 normalOffset = getOffset(_format, VertexAttribute::NORMAL);
+	const u32 colorOffset = getOffset(_format, VertexAttribute::COLOR);
+	for (u32 i = 0; i < _vertexCount; ++i)
+	{
+		Vertex& vertex = _outVertices[i];
+		const u8* data = _data + i * stride;
+		decodeAttribute(_format.get(VertexAttribute::POSITION), data, (float*)&vertex.pos, 3);
+		decodeAttribute(_format.get(VertexAttribute::TEXCOORD), data + texCoordOffset, (float*)&vertex.texCoord, 2);
+		decodeAttribute(_format.get(VertexAttribute::NORMAL), data + normalOffset, (float*)&vertex.normal, 3);
+		decodeAttribute(_format.get(VertexAttribute::COLOR), data + colorOffset, (float*)&vertex.color, 3);
+	}
+}
+
+u16 floatToHalf(float _value)
+{
+	u32 bits;
+	memcpy(&bits, &_value, sizeof(bits));
+	u32 sign = (bits >> 16) & 0x8000;
+	u32 exponent = (bits >> 23) & 0xFF;
+	u32 mantissa = bits & 0x7FFFFF;
+
+	// Infinity and NaN
+	if (exponent == 0xFF)
+		return u16(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+
+	i32 halfExponent = i32(exponent) - 127 + 15;
+	if (halfExponent >= 31)
+		return u16(sign | 0x7C00);
+
+	// Rounded to nearest even, a carry out of the mantissa correctly bumps the exponent
+	if (halfExponent <= 0)
+	{
+		// Subnormal
+		if (halfExponent < -10)
+			return u16(sign);
+
+		mantissa |= 0x800000;
+		u32 shift = u32(14 - halfExponent);
+		u32 half = mantissa >> shift;
+		u32 remainder = mantissa & ((1u << shift) - 1);
+		u32 halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+		{
+			++half;
+		}
+		return u16(sign | half);
+	}
+
+	u32 half = (u32(halfExponent) << 10) | (mantissa >> 13);
+	u32 remainder = mantissa & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+	{
+		++half;
+	}
+	return u16(sign | half);
+}
+
+float halfToFloat(u16 _value)
+{
+	u32 sign = (u32(_value) & 0x8000) << 16;
+	u32 exponent = (u32(_value) >> 10) & 0x1F;
+	u32 mantissa = u32(_value) & 0x3FF;
+
+	if (exponent == 0)
+	{
+		float value = float(mantissa) / 16777216.f; // subnormal, mantissa * 2^-24
+		return sign != 0 ? -value : value;
+	}
+
+	u32 bits = exponent == 31
+		? sign | 0x7F800000 | (mantissa << 13)
+		: sign | ((exponent + 112) << 23) | (mantissa << 13);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+} // namespace vertex_format
+} // namespace yae
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <yae/types.h>
+#include <yae/rendering/render_types.h>
+
+namespace yae {
+namespace vertex_format {
+
+// Size in bytes of an attribute, every size is a multiple of 4 so that attributes stay aligned
+YAE_API u32 getAttributeSize(VertexAttributeFormat _format);
+
+// Interleaved layout, attributes follow each other in VertexAttribute order
+YAE_API u32 getStride(const VertexFormat& _format);
+YAE_API u32 getOffset(const VertexFormat& _format, VertexAttribute _attribute);
+
+// Smallest formats that keep the vertices accurate enough for rendering:
+// - positions in half floats if their rounding error stays under a thousandth of the mesh size
+// - texture coordinates in unorm16 if they are all in [0, 1], tiling ones stay in floats
+// - normals in 10:10:10:2
+// - colors in unorm8 if they are all in [0, 1]
+YAE_API VertexFormat computeQuantizedFormat(const Vertex* _vertices, u32 _vertexCount);
+
+// _outData must hold _vertexCount * getStride(_format) bytes
+YAE_API void encodeVertices(const VertexFormat& _format, const Vertex* _vertices, u32 _vertexCount, u8* _outData);
+
+// Converts encoded vertices back to floats, for tools and tests
+YAE_API void decodeVertices(const VertexFormat& _format, const u8* _data, u32 _vertexCount, Vertex* _outVertices);
+
+YAE_API u16 floatToHalf(float _value);
+YAE_API float halfToFloat(u16 _value);
+
+} // namespace vertex_format
+} // namespace yae
@@ -15,21 +15,33 @@ Resource* findOrCreateFromFile(const char* _path)
 	ResourceManager& manager = resourceManager();
 	String path = String(filesystem::getAbsolutePath(_path), &scratchAllocator());
 
-
 	Resource* resource = manager.findResource(path.c_str());
 	if (resource == nullptr)
 	{
 		FileReader reader(path.c_str(), &scratchAllocator());
-		if (!reader.load())
+		if (!reader.map())
 		{
-			YAE_ERRORF_CAT("resource", "Failed to open \"%s\" for read", path.c_str());
+			YAE_ERRORF_CAT(resource, "Failed to open \"%s\" for read", path.c_str());
 			return nullptr;
 		}
 
+		resource = findOrCreateFromFileData(path.c_str(), reader.getContent(), reader.getContentSize());
+	}
+	return resource;
+}
+
+Resource* findOrCreateFromFileData(const char* _path, const void* _data, size_t _size)
+{
+	ResourceManager& manager = resourceManager();
+	String path = String(filesystem::getAbsolutePath(_path), &scratchAllocator());
+
+	Resource* resource = manager.findResource(path.c_str());
+	if (resource == nullptr)
+	{
 		JsonSerializer serializer(&scratchAllocator());
-		if (!serializer.parseSourceData(reader.getContent(), reader.getContentSize()))
+		if (!serializer.parseSourceData(_data, _size))
 		{
-			YAE_ERRORF_CAT("resource", "Failed to parse \"%s\" JSON file", path.c_str());
+			YAE_ERRORF_CAT(resource, "Failed to parse \"%s\" JSON file", path.c_str());
 			return nullptr;
 		}
 
@@ -48,7 +60,7 @@ Resource* findOrCreateFromFile(const char* _path)
 		}
 		else
 		{
-			YAE_ERRORF_CAT("resource", "Unknown reflected type \"%s\"", resourceTypeStr.c_str());
+			YAE_ERRORF_CAT(resource, "Unknown reflected type \"%s\"", resourceTypeStr.c_str());
 		}
 		YAE_VERIFY(serializer.endSerializeObject());
 		serializer.endRead();
@@ -77,12 +89,12 @@ void saveToFile(Resource* _resource, const char* _path)
 	FileHandle file(_path);
 	if (!file.open(FileHandle::OPENMODE_WRITE))
 	{
-		YAE_ERRORF_CAT("resource", "Failed to open \"%s\" for write", _path);
+		YAE_ERRORF_CAT(resource, "Failed to open \"%s\" for write", _path);
 		return;
 	}
 	if (!file.write(serializer.getWriteData(), serializer.getWriteDataSize()))
 	{
-		YAE_ERRORF_CAT("resource", "Failed to write into \"%s\"", _path);
+		YAE_ERRORF_CAT(resource, "Failed to write into \"%s\"", _path);
 		return;
 	}
 	file.close();
@@ -94,7 +106,7 @@ void deleteResourceFile(Resource* _resource)
 
 	if (_resource->isTransient())
 	{
-		YAE_WARNINGF_CAT("resource", "Can't delete transient resource \"%s\"", _resource->getName());
+		YAE_WARNINGF_CAT(resource, "Can't delete transient resource \"%s\"", _resource->getName());
 		return;
 	}
 
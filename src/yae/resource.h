@@ -11,6 +11,8 @@ template <typename T> T* findOrCreateFile(const char* _path);
 template <typename T> T* findOrCreateFromFile(const char* _path);
 
 YAE_API Resource* findOrCreateFromFile(const char* _path);
+// Same as findOrCreateFromFile, with the file content already read
+YAE_API Resource* findOrCreateFromFileData(const char* _path, const void* _data, size_t _size);
 YAE_API void saveToFile(Resource* _resource, const char* _path);
 YAE_API void deleteResourceFile(Resource* _resource);
 
@@ -4,8 +4,14 @@
 #include <yae/rendering/Renderer.h>
 #include <yae/resource.h>
 #include <yae/resources/File.h>
+#include <yae/rendering/GlyphRunCache.h>
 #include <core/string.h>
 
+#include <cmath>
+
+// Glyphs are packed until the atlas would be higher than this, which every supported GPU handles
+#define YAE_FONT_ATLAS_MAX_SIZE 4096
+
 // this is helpful: https://github.com/0xc0dec/demos
 
 MIRROR_CLASS(yae::FontFile)
@@ -15,6 +21,8 @@ MIRROR_CLASS(yae::FontFile)
 
 namespace yae {
 
+static u32 s_nextFontId = 1;
+
 FontFile::FontFile()
 {
 }
@@ -46,29 +54,125 @@ u32 FontFile::getSize() const
 	return m_fontSize;
 }
 
+u32 FontFile::getFontId() const
+{
+	return m_fontId;
+}
+
+void FontFile::shapeText(const char* _text, u32 _textLength, DataArray<GlyphQuad>& _outQuads)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	YAE_ASSERT(isLoaded());
+	YAE_ASSERT(_text != nullptr || _textLength == 0);
+
+	float x = 0.f;
+	float y = 0.f;
+	u32 previousCodepoint = 0;
+	const char* cursor = _text;
+	const char* end = _text + _textLength;
+	while (cursor < end)
+	{
+		u32 codepoint = string::decodeUtf8(cursor, end);
+		if (codepoint == '\n')
+		{
+			x = 0.f;
+			y += m_lineHeight;
+			previousCodepoint = 0;
+			continue;
+		}
+
+		stbtt_packedchar glyph;
+		if (!_findOrPackGlyph(codepoint, glyph))
+			continue;
+
+		if (previousCodepoint != 0)
+		{
+			x += m_scale * float(stbtt_GetCodepointKernAdvance(&m_font, previousCodepoint, codepoint));
+		}
+		previousCodepoint = codepoint;
+
+		// Same placement as stbtt_GetPackedQuad, aligned on pixels
+		if (glyph.x1 > glyph.x0 && glyph.y1 > glyph.y0)
+		{
+			GlyphQuad quad;
+			quad.x0 = floorf(x + glyph.xoff + .5f);
+			quad.y0 = floorf(y + glyph.yoff + .5f);
+			quad.x1 = quad.x0 + glyph.xoff2 - glyph.xoff;
+			quad.y1 = quad.y0 + glyph.yoff2 - glyph.yoff;
+			quad.u0 = glyph.x0;
+			quad.v0 = glyph.y0;
+			quad.u1 = glyph.x1;
+			quad.v1 = glyph.y1;
+			_outQuads.push_back(quad);
+		}
+		x += glyph.xadvance;
+	}
+}
+
+void FontFile::updateAtlasTexture()
+{
+	if (!m_isAtlasDirty)
+		return;
+
+	YAE_CAPTURE_FUNCTION();
+
+	renderer().updateTexture(m_fontTexture, m_atlasPixels.data(), m_atlasWidth, m_atlasHeight, 1);
+	m_isAtlasDirty = false;
+}
+
 void FontFile::_doLoad()
 {
 	YAE_CAPTURE_FUNCTION();
 
 	FileReader reader(m_path.c_str(), &scratchAllocator());
-	if (!reader.load())
+	if (!reader.map())
 	{
 		_log(RESOURCELOGTYPE_ERROR, string::format("Could not load file \"%s\".", m_path.c_str()).c_str());
 		return;
 	}
-	stbtt_InitFont(&m_font, (const u8*)reader.getContent(), 0);
 
+	// The font info reads the file content for as long as glyphs are packed
+	m_fontData.resize(u32(reader.getContentSize()));
+	memcpy(m_fontData.data(), reader.getContent(), m_fontData.size());
+	if (stbtt_InitFont(&m_font, m_fontData.data(), stbtt_GetFontOffsetForIndex(m_fontData.data(), 0)) == 0)
+	{
+		_log(RESOURCELOGTYPE_ERROR, string::format("Invalid font file \"%s\".", m_path.c_str()).c_str());
+		m_fontData.clear();
+		return;
+	}
+
+	int ascent, descent, lineGap;
+	stbtt_GetFontVMetrics(&m_font, &ascent, &descent, &lineGap);
+	m_scale = stbtt_ScaleForPixelHeight(&m_font, float(m_fontSize));
+	m_lineHeight = m_scale * float(ascent - descent + lineGap);
+	m_fontId = s_nextFontId++;
+
+	// Starts with room for a few lines of glyphs, larger fonts get a wider atlas
 	m_atlasWidth = 512;
-	m_atlasHeight = 512;
-	u8* fontBitmap = (u8*)scratchAllocator().allocate(m_atlasWidth*m_atlasHeight);
-	stbtt_pack_context pc;
-	YAE_VERIFY(stbtt_PackBegin(&pc, fontBitmap, m_atlasWidth, m_atlasHeight, 0, 1, nullptr) == 1);
-	YAE_VERIFY(stbtt_PackFontRange(&pc, (const u8*)reader.getContent(), 0, float(m_fontSize), 0, 256, m_packedChar) == 1);
-	stbtt_PackEnd(&pc);
+	while (m_atlasWidth < m_fontSize * 8 && m_atlasWidth < YAE_FONT_ATLAS_MAX_SIZE)
+	{
+		m_atlasWidth *= 2;
+	}
+	m_atlasHeight = m_atlasWidth / 2;
+	m_atlasPixels.resize(m_atlasWidth * m_atlasHeight);
+	memset(m_atlasPixels.data(), 0, m_atlasPixels.size());
+	_beginPacking(0);
 
-	YAE_VERIFY(renderer().createTexture(fontBitmap, m_atlasWidth, m_atlasHeight, 1, m_fontTexture) == true);
+	// Printable ASCII is packed right away, in one go
+	const u32 firstCodepoint = 32;
+	const u32 codepointCount = 95;
+	stbtt_packedchar asciiGlyphs[codepointCount];
+	if (stbtt_PackFontRange(&m_packContext, m_fontData.data(), 0, float(m_fontSize), firstCodepoint, codepointCount, asciiGlyphs) == 1)
+	{
+		for (u32 i = 0; i < codepointCount; ++i)
+		{
+			m_glyphs.set(firstCodepoint + i, asciiGlyphs[i]);
+		}
+	}
 
-	scratchAllocator().deallocate(fontBitmap);
+	YAE_VERIFY(renderer().createTexture(m_atlasPixels.data(), m_atlasWidth, m_atlasHeight, 1, m_fontTexture) == true);
+	m_isAtlasDirty = false;
 }
 
 void FontFile::_doUnload()
@@ -77,7 +181,82 @@ void FontFile::_doUnload()
 
 	renderer().destroyTexture(m_fontTexture);
 	m_fontTexture = 0;
+
+	if (m_isPacking)
+	{
+		stbtt_PackEnd(&m_packContext);
+		m_isPacking = false;
+	}
+	m_glyphs.clear();
+	m_atlasPixels.clear();
+	m_atlasPixels.shrink();
+	m_fontData.clear();
+	m_fontData.shrink();
+	m_atlasWidth = 0;
+	m_atlasHeight = 0;
+	m_isAtlasDirty = false;
+	m_fontId = 0;
 }
 
-} // namespace yae
+bool FontFile::_findOrPackGlyph(u32 _codepoint, stbtt_packedchar& _outGlyph)
+{
+	const stbtt_packedchar* glyph = m_glyphs.get(_codepoint);
+	if (glyph != nullptr)
+	{
+		_outGlyph = *glyph;
+		return true;
+	}
+
+	stbtt_packedchar packedGlyph = {};
+	while (stbtt_PackFontRange(&m_packContext, m_fontData.data(), 0, float(m_fontSize), int(_codepoint), 1, &packedGlyph) == 0)
+	{
+		if (!_growAtlas())
+		{
+			YAE_WARNINGF_CAT(resource, "Font atlas of \"%s\" is full, could not pack codepoint U+%04X", m_path.c_str(), _codepoint);
+			return false;
+		}
+	}
+
+	// Rows are relative to the packing context
+	packedGlyph.y0 += m_packTop;
+	packedGlyph.y1 += m_packTop;
+	m_glyphs.set(_codepoint, packedGlyph);
+	m_isAtlasDirty = true;
+
+	_outGlyph = packedGlyph;
+	return true;
+}
+
+bool FontFile::_growAtlas()
+{
+	if (m_atlasHeight * 2 > YAE_FONT_ATLAS_MAX_SIZE)
+		return false;
+
+	YAE_CAPTURE_FUNCTION();
+
+	u32 previousHeight = m_atlasHeight;
+	m_atlasHeight *= 2;
+	YAE_VERBOSEF_CAT(resource, "Growing font atlas of \"%s\" to %ux%u", m_path.c_str(), m_atlasWidth, m_atlasHeight);
+
+	// Rows are appended, existing glyphs keep their pixel coordinates
+	m_atlasPixels.resize(m_atlasWidth * m_atlasHeight);
+	memset(m_atlasPixels.data() + previousHeight * m_atlasWidth, 0, (m_atlasHeight - previousHeight) * m_atlasWidth);
+	_beginPacking(previousHeight);
+	m_isAtlasDirty = true;
+	return true;
+}
 
+void FontFile::_beginPacking(u32 _top)
+{
+	if (m_isPacking)
+	{
+		stbtt_PackEnd(&m_packContext);
+	}
+
+	m_packTop = _top;
+	u8* pixels = m_atlasPixels.data() + m_packTop * m_atlasWidth;
+	YAE_VERIFY(stbtt_PackBegin(&m_packContext, pixels, m_atlasWidth, m_atlasHeight - m_packTop, m_atlasWidth, 1, nullptr) == 1);
+	m_isPacking = true;
+}
+
+} // namespace yae
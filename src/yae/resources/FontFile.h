@@ -3,6 +3,7 @@
 #include <yae/types.h>
 #include <yae/resources/Resource.h>
 #include <yae/rendering/render_types.h>
+#include <core/containers/HashMap.h>
 
 #include <mirror/mirror.h>
 
@@ -11,7 +12,11 @@
 namespace yae {
 
 class File;
+struct GlyphQuad;
 
+// Glyphs are packed in the atlas the first time they are drawn, so that any codepoint of the font can be displayed.
+// The atlas grows by doubling its height, the new rows get their own packing context: glyphs never move and their
+// atlas pixel coordinates stay valid for the whole life of the loaded font.
 class YAE_API FontFile : public Resource
 {
 	MIRROR_GETCLASS_VIRTUAL();
@@ -27,17 +32,40 @@ public:
 	void setSize(u32 _size);
 	u32 getSize() const;
 
+	// Unique for each load, shaped text is cached by font id
+	u32 getFontId() const;
+
+	// Lays out _text (UTF-8) from the origin, one quad per visible glyph. Packs the missing glyphs in the atlas.
+	void shapeText(const char* _text, u32 _textLength, DataArray<GlyphQuad>& _outQuads);
+
+	// Uploads the glyphs packed since the last update
+	void updateAtlasTexture();
+
 // private:
 	virtual void _doLoad() override;
 	virtual void _doUnload() override;
 
+	bool _findOrPackGlyph(u32 _codepoint, stbtt_packedchar& _outGlyph); // fails if the atlas is full
+	bool _growAtlas();
+	void _beginPacking(u32 _top);
+
 	String m_path;
 	u32 m_fontSize = 0;
-	u32 m_atlasWidth;
-	u32 m_atlasHeight;
+	u32 m_fontId = 0;
+	float m_lineHeight = 0.f;
+	float m_scale = 0.f; // font units to pixels
 
+	DataArray<u8> m_fontData; // stbtt_fontinfo points into it
 	stbtt_fontinfo m_font;
-	stbtt_packedchar m_packedChar[256];
+
+	u32 m_atlasWidth = 0;
+	u32 m_atlasHeight = 0;
+	DataArray<u8> m_atlasPixels;
+	stbtt_pack_context m_packContext; // packs the rows added by the last growth
+	u32 m_packTop = 0; // first atlas row of the packing context
+	bool m_isPacking = false;
+	bool m_isAtlasDirty = false;
+	HashMap<u32, stbtt_packedchar> m_glyphs; // by codepoint, in atlas pixels
 	TextureHandle m_fontTexture;
 };
 
@@ -1,5 +1,8 @@
 #include "Mesh.h"
 
+#include <yae/rendering/Renderer.h>
+#include <yae/rendering/vertex_format.h>
+
 MIRROR_CLASS(yae::Mesh)
 (
 	MIRROR_PARENT(yae::Resource)
@@ -7,6 +10,8 @@ MIRROR_CLASS(yae::Mesh)
 
 namespace yae {
 
+u32 Mesh::s_boundsVersion = 0;
+
 Mesh::Mesh()
 {
 }
@@ -40,13 +45,70 @@ const BaseArray<u32>& Mesh::getIndices() const
 	return m_indices;
 }
 
+void Mesh::setVertexFormat(const VertexFormat& _vertexFormat)
+{
+	YAE_ASSERT(!isLoaded());
+	m_vertexFormat = _vertexFormat;
+}
+
+const VertexFormat& Mesh::getVertexFormat() const
+{
+	return m_vertexFormat;
+}
+
+const AABB& Mesh::getBounds() const
+{
+	return m_bounds;
+}
+
+u32 Mesh::GetBoundsVersion()
+{
+	return s_boundsVersion;
+}
+
+const MeshHandle& Mesh::getMeshHandle() const
+{
+	return m_meshHandle;
+}
+
 void Mesh::_doLoad()
 {
+	YAE_CAPTURE_FUNCTION();
+
+	m_bounds = AABB::EMPTY();
+	for (const Vertex& vertex : m_vertices)
+	{
+		m_bounds = math::merge(m_bounds, vertex.pos);
+	}
+	++s_boundsVersion;
+
+	if (m_vertices.size() == 0 || m_indices.size() == 0)
+		return;
+
+	// The float vertices are kept on the CPU for bounds and picking, only the GPU copy is quantized
+	DataArray<u8> encodedVertices(&scratchAllocator());
+	encodedVertices.resize(m_vertices.size() * vertex_format::getStride(m_vertexFormat));
+	vertex_format::encodeVertices(m_vertexFormat, m_vertices.data(), m_vertices.size(), encodedVertices.data());
+
+	if (!renderer().createMesh(m_vertexFormat, encodedVertices.data(), m_vertices.size(), m_indices.data(), m_indices.size(), m_meshHandle))
+	{
+		_log(RESOURCELOGTYPE_ERROR, "Failed to create mesh buffers.");
+		m_meshHandle = 0;
+	}
 }
 
 
 void Mesh::_doUnload()
 {
+	YAE_CAPTURE_FUNCTION();
+
+	if (m_meshHandle != 0)
+	{
+		renderer().destroyMesh(m_meshHandle);
+		m_meshHandle = 0;
+	}
+	m_bounds = AABB::EMPTY();
+	++s_boundsVersion;
 }
 
 } // namespace yae
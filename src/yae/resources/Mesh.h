@@ -4,6 +4,7 @@
 #include <yae/resources/Resource.h>
 #include <core/containers/Array.h>
 #include <yae/rendering/render_types.h>
+#include <yae/math/bounds.h>
 
 namespace yae {
 
@@ -22,12 +23,26 @@ public:
 	void setIndices(const u32* _indices, u32 _indexCount);
 	const BaseArray<u32>& getIndices() const;
 
+	// Layout of the GPU vertex buffer, the vertices are encoded at load time. Defaults to the float layout of Vertex.
+	void setVertexFormat(const VertexFormat& _vertexFormat);
+	const VertexFormat& getVertexFormat() const;
+
+	const AABB& getBounds() const; // local space, computed at load time
+	// Incremented each time the bounds of any mesh change, lets users skip checking their meshes when nothing was (re)loaded
+	static u32 GetBoundsVersion();
+	const MeshHandle& getMeshHandle() const; // GPU buffers, created at load time
+
 // private:
 	virtual void _doLoad() override;
 	virtual void _doUnload() override;
 
 	DataArray<Vertex> m_vertices;
 	DataArray<u32> m_indices;
+	VertexFormat m_vertexFormat;
+	AABB m_bounds = AABB::EMPTY();
+	MeshHandle m_meshHandle = 0;
+
+	static u32 s_boundsVersion;
 };
 
 } // namespace yae
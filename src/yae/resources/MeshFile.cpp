@@ -2,9 +2,13 @@
 
 #include <core/filesystem.h>
 #include <core/hash.h>
-#include <core/containers/HashMap.h>
+#include <core/Program.h>
+#include <core/string.h>
 
+#include <yae/ContentHashDatabase.h>
+#include <yae/Engine.h>
 #include <yae/ResourceManager.h>
+#include <yae/rendering/vertex_format.h>
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tinyobjloader/tiny_obj_loader.h>
@@ -15,6 +19,7 @@ MIRROR_CLASS(yae::MeshFile)
 
 	MIRROR_MEMBER(m_path);
 	MIRROR_MEMBER(m_offset);
+	MIRROR_MEMBER(m_optimizeOverdraw);
 );
 
 
@@ -53,6 +58,17 @@ const Transform& MeshFile::getOffset() const
 	return m_offset;
 }
 
+void MeshFile::setOptimizeOverdraw(bool _optimizeOverdraw)
+{
+	YAE_ASSERT(!isLoaded());
+	m_optimizeOverdraw = _optimizeOverdraw;
+}
+
+bool MeshFile::getOptimizeOverdraw() const
+{
+	return m_optimizeOverdraw;
+}
+
 void MeshFile::_doLoad()
 {
 	YAE_CAPTURE_FUNCTION();
@@ -62,66 +78,36 @@ void MeshFile::_doLoad()
 
 	m_manager->registerReloadOnFileChanged(m_path.c_str(), this);
 
-	tinyobj::ObjReader reader;
+	// The source hash detects changes since the last cook, the source is only read if it changed on disk
+	u64 contentHash = 0;
+	if (!engine().contentHashDatabase().getContentHash(m_path.c_str(), &contentHash))
 	{
-		YAE_CAPTURE_SCOPE("open_file");
-		if (!reader.ParseFromFile(m_path.c_str()))
-		{
-			if (reader.Warning().size() > 0)
-			{
-				_log(RESOURCELOGTYPE_WARNING, reader.Warning().c_str());
-			}
-			if (reader.Error().size() > 0)
-			{
-				_log(RESOURCELOGTYPE_ERROR, reader.Error().c_str());
-			}
-		}
+		_log(RESOURCELOGTYPE_ERROR, "Could not open file.");
+		return;
 	}
-	
+	u32 sourceHash = u32(contentHash);
+
+	String cookedPath = _getCookedPath();
+	if (!_loadCookedFile(cookedPath.c_str(), sourceHash))
 	{
-		YAE_CAPTURE_SCOPE("remove_duplicates");
-		
-		yae::HashMap<u32, u32> uniqueVertices(&yae::scratchAllocator());
-		for (const auto& shape : reader.GetShapes())
+		// Nothing is written to the cache, so that the next load tries the source again
+		if (!_cook(sourceHash))
+			return;
+
+		String cookedDirectory = filesystem::getDirectory(cookedPath.c_str());
+		filesystem::createDirectory(cookedDirectory.c_str());
+		FileHandle file(cookedPath.c_str());
+		if (!file.open(FileHandle::OPENMODE_WRITE) || !file.write(m_cookedData.data(), m_cookedData.size()))
 		{
-			for (const auto& index : shape.mesh.indices)
-			{
-				Vertex v{};
-				v.pos = {
-					reader.GetAttrib().vertices[3 * index.vertex_index + 0],
-					reader.GetAttrib().vertices[3 * index.vertex_index + 1],
-					reader.GetAttrib().vertices[3 * index.vertex_index + 2]
-				};
-
-				v.texCoord = {
-					reader.GetAttrib().texcoords[2 * index.texcoord_index + 0],
-					1.f - reader.GetAttrib().texcoords[2 * index.texcoord_index + 1]
-				};
-
-				v.normal = {
-					reader.GetAttrib().normals[3 * index.normal_index + 0],
-					reader.GetAttrib().normals[3 * index.normal_index + 1],
-					reader.GetAttrib().normals[3 * index.normal_index + 2],
-				};
-
-				v.color = {1.f, 1.f, 1.f};
-
-				u32 vertexHash = hash::hash32(&v, sizeof(Vertex));
-				const u32* uniqueVertexIndexPtr = uniqueVertices.get(vertexHash);
-				if (uniqueVertexIndexPtr == nullptr)
-				{
-					uniqueVertexIndexPtr = &uniqueVertices.set(vertexHash, m_vertices.size());
-
-					// Apply offset
-					v.pos = m_offset * v.pos;
-
-					m_vertices.push_back(v);
-				}
-				m_indices.push_back(*uniqueVertexIndexPtr);
-			}
+			YAE_WARNINGF_CAT(resource, "Failed to write cooked mesh \"%s\"", cookedPath.c_str());
 		}
+		file.close();
 	}
 
+	m_vertices.push_back(m_cookedMesh.vertices, m_cookedMesh.vertexCount);
+	m_indices.push_back(m_cookedMesh.indices, m_cookedMesh.indexCount);
+	m_vertexFormat = vertex_format::computeQuantizedFormat(m_vertices.data(), m_vertices.size());
+
 	Mesh::_doLoad();
 }
 
@@ -134,8 +120,123 @@ void MeshFile::_doUnload()
 
 	m_vertices.resize(0);
 	m_indices.resize(0);
+	m_cookedMesh = mesh_cooking::CookedMesh();
+	m_cookedData.clear();
+	m_cookedData.shrink();
 
 	m_manager->unregisterReloadOnFileChanged(m_path.c_str(), this);
 }
 
+
+String MeshFile::_getCookedPath() const
+{
+	String key = string::format("%s|%08x|%d", m_path.c_str(), hash::hash32(&m_offset, sizeof(m_offset)), m_optimizeOverdraw ? 1 : 0);
+	return string::format("%s/mesh_cache/%08x.ymsh", program().getIntermediateDirectory(), hash::hashString(key.c_str()));
+}
+
+
+bool MeshFile::_loadCookedFile(const char* _cookedPath, u32 _sourceHash)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	FileHandle file(_cookedPath);
+	if (!file.open(FileHandle::OPENMODE_READ))
+		return false;
+
+	m_cookedData.resize(u32(file.getSize()));
+	bool isRead = file.read(m_cookedData.data(), m_cookedData.size()) == m_cookedData.size();
+	file.close();
+
+	if (!isRead
+		|| !mesh_cooking::readCookedMesh(m_cookedData.data(), m_cookedData.size(), m_cookedMesh)
+		|| m_cookedMesh.sourceHash != _sourceHash)
+	{
+		YAE_VERBOSEF_CAT(resource, "Cooked mesh \"%s\" is out of date", _cookedPath);
+		return false;
+	}
+
+	YAE_VERBOSEF_CAT(resource, "Loaded cooked mesh \"%s\"", _cookedPath);
+	return true;
+}
+
+
+bool MeshFile::_cook(u32 _sourceHash)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	tinyobj::ObjReader reader;
+	{
+		YAE_CAPTURE_SCOPE("parse_file");
+		if (!reader.ParseFromFile(m_path.c_str()))
+		{
+			if (reader.Warning().size() > 0)
+			{
+				_log(RESOURCELOGTYPE_WARNING, reader.Warning().c_str());
+			}
+			_log(RESOURCELOGTYPE_ERROR, reader.Error().size() > 0 ? reader.Error().c_str() : "Failed to parse file.");
+			return false;
+		}
+	}
+
+	// One vertex per index, as they come out of the file
+	DataArray<Vertex> vertices(&scratchAllocator());
+	const tinyobj::attrib_t& attrib = reader.GetAttrib();
+	for (const auto& shape : reader.GetShapes())
+	{
+		for (const auto& index : shape.mesh.indices)
+		{
+			Vertex v{};
+			v.pos = m_offset * Vector3(
+				attrib.vertices[3 * index.vertex_index + 0],
+				attrib.vertices[3 * index.vertex_index + 1],
+				attrib.vertices[3 * index.vertex_index + 2]
+			);
+
+			v.texCoord = Vector2::ZERO();
+			if (index.texcoord_index >= 0)
+			{
+				v.texCoord = Vector2(
+					attrib.texcoords[2 * index.texcoord_index + 0],
+					1.f - attrib.texcoords[2 * index.texcoord_index + 1]
+				);
+			}
+
+			v.normal = Vector3::ZERO();
+			if (index.normal_index >= 0)
+			{
+				v.normal = Vector3(
+					attrib.normals[3 * index.normal_index + 0],
+					attrib.normals[3 * index.normal_index + 1],
+					attrib.normals[3 * index.normal_index + 2]
+				);
+			}
+
+			v.color = Vector3::ONE();
+			vertices.push_back(v);
+		}
+	}
+
+	DataArray<u32> indices(&scratchAllocator());
+	indices.resize(vertices.size());
+	u32 vertexCount = mesh_cooking::weldVertices(vertices.data(), vertices.size(), indices.data());
+	mesh_cooking::VertexCacheStatistics sourceStatistics = mesh_cooking::analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+
+	mesh_cooking::optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+	if (m_optimizeOverdraw)
+	{
+		mesh_cooking::optimizeOverdraw(indices.data(), indices.size(), vertices.data(), vertexCount);
+	}
+	vertexCount = mesh_cooking::optimizeVertexFetch(vertices.data(), vertexCount, indices.data(), indices.size());
+
+	mesh_cooking::cookMesh(vertices.data(), vertexCount, indices.data(), indices.size(), sourceStatistics, _sourceHash, m_cookedData);
+	YAE_VERIFY(mesh_cooking::readCookedMesh(m_cookedData.data(), m_cookedData.size(), m_cookedMesh));
+
+	YAE_VERBOSEF_CAT(resource, "Cooked mesh \"%s\": %u vertices, %u triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+		m_path.c_str(), vertexCount, indices.size() / 3,
+		sourceStatistics.acmr, m_cookedMesh.statistics.acmr,
+		sourceStatistics.atvr, m_cookedMesh.statistics.atvr
+	);
+	return true;
+}
+
 } // namespace yae
@@ -2,6 +2,7 @@
 
 #include <yae/types.h>
 #include <yae/resources/Mesh.h>
+#include <yae/rendering/mesh_cooking.h>
 
 namespace yae {
 
@@ -20,12 +21,25 @@ public:
 	void setOffset(const Transform& _offset);
 	const Transform& getOffset() const;
 
+	// Sorts the triangles so that the outer ones are drawn first, at a small vertex cache cost
+	void setOptimizeOverdraw(bool _optimizeOverdraw);
+	bool getOptimizeOverdraw() const;
+
 // private:
 	virtual void _doLoad() override;
 	virtual void _doUnload() override;
 
+	String _getCookedPath() const;
+	bool _loadCookedFile(const char* _cookedPath, u32 _sourceHash);
+	bool _cook(u32 _sourceHash); // false if the source could not be parsed, nothing is cooked then
+
 	String m_path;
 	Transform m_offset = Transform::IDENTITY();
+	bool m_optimizeOverdraw = false;
+
+	// Welded and reordered geometry, in the intermediate directory. It is rebuilt when the source file changes.
+	DataArray<u8> m_cookedData;
+	mesh_cooking::CookedMesh m_cookedMesh;
 };
 
 } // namespace yae
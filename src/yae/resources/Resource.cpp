@@ -56,7 +56,7 @@ void Resource::_reload()
 
 void Resource::_internalLoad()
 {
-	YAE_VERBOSEF_CAT("resource", "Loading \"%s\"...", getName());
+	YAE_VERBOSEF_CAT(resource, "Loading \"%s\"...", getName());
 
 	// Reset Logs
 	m_errorCount = 0;
@@ -73,37 +73,37 @@ void Resource::_internalLoad()
 		switch(log.type)
 		{
 			case RESOURCELOGTYPE_LOG:
-				YAE_VERBOSEF_CAT("resource", "[%s] %s", getName(), log.message.c_str());
+				YAE_VERBOSEF_CAT(resource, "[%s] %s", getName(), log.message.c_str());
 				break;
 			case RESOURCELOGTYPE_WARNING:
-				YAE_WARNINGF_CAT("resource", "[%s] %s", getName(), log.message.c_str());
+				YAE_WARNINGF_CAT(resource, "[%s] %s", getName(), log.message.c_str());
 				break;
 			case RESOURCELOGTYPE_ERROR:
-				YAE_ERRORF_CAT("resource", "[%s] %s", getName(), log.message.c_str());
+				YAE_ERRORF_CAT(resource, "[%s] %s", getName(), log.message.c_str());
 				break;
 		}
 	}
 
 	if (m_errorCount > 0)
 	{
-		YAE_ERRORF_CAT("resource", "Error Loading \"%s\" (%d warnings, %d errors)", getName(), m_warningCount, m_errorCount);
+		YAE_ERRORF_CAT(resource, "Error Loading \"%s\" (%d warnings, %d errors)", getName(), m_warningCount, m_errorCount);
 	}
 	else if (m_warningCount > 0)
 	{
-		YAE_LOGF_CAT("resource", "Loaded \"%s\" with warnings (%d warnings, %d errors)", getName(), m_warningCount, m_errorCount);
+		YAE_LOGF_CAT(resource, "Loaded \"%s\" with warnings (%d warnings, %d errors)", getName(), m_warningCount, m_errorCount);
 	}
 	else
 	{
-		YAE_LOGF_CAT("resource", "Loaded \"%s\" (%d warnings, %d errors)", getName(), m_warningCount, m_errorCount);
+		YAE_LOGF_CAT(resource, "Loaded \"%s\" (%d warnings, %d errors)", getName(), m_warningCount, m_errorCount);
 	}
 }
 
 
 void Resource::_internalUnload()
 {
-	YAE_VERBOSEF_CAT("resource", "Releasing \"%s\"...", getName());
+	YAE_VERBOSEF_CAT(resource, "Releasing \"%s\"...", getName());
 	_doUnload();
-	YAE_LOGF_CAT("resource", "Released \"%s\"", getName());
+	YAE_LOGF_CAT(resource, "Released \"%s\"", getName());
 }
 
 
@@ -3,6 +3,7 @@
 #include <yae/types.h>
 
 #include <core/containers/Array.h>
+#include <core/StringPool.h>
 #include <yae/resources/ResourceID.h>
 
 #include <mirror/mirror.h>
@@ -31,7 +32,7 @@ public:
 	Resource();
 	virtual ~Resource();
 	
-	const char* getName() const { return m_name; }
+	const char* getName() const { return m_name.c_str(); }
 	ResourceID getID() const { return m_id; }
 
 	bool load();
@@ -56,7 +57,7 @@ public:
 
 	ResourceManager* m_manager = nullptr;
 	Array<ResourceLog> m_logs;
-	char m_name[256];
+	InternedString m_name;
 	ResourceID m_id;
 	u32 m_loadCount = 0;
 	u32 m_errorCount = 0;
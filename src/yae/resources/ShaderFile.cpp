@@ -1,6 +1,8 @@
 #include "ShaderFile.h"
 
 #include <core/filesystem.h>
+#include <yae/ContentHashDatabase.h>
+#include <yae/Engine.h>
 #include <yae/ResourceManager.h>
 #include <core/string.h>
 
@@ -40,12 +42,16 @@ void ShaderFile::_doLoad()
 	m_manager->registerReloadOnFileChanged(m_path.c_str(), this);
 
 	FileReader reader(m_path.c_str(), &scratchAllocator());
-	if (!reader.load())
+	if (!reader.map())
 	{
 		_log(RESOURCELOGTYPE_ERROR, string::format("Could not load file \"%s\".", m_path.c_str()).c_str());
 	}
 
-	setShaderData(reader.getContent(), reader.getContentSize());
+	setShaderData(reader.getContent(), u32(reader.getContentSize()));
+
+	// Recorded so that saving the file without changes does not reload it
+	u64 contentHash = 0;
+	engine().contentHashDatabase().getContentHash(m_path.c_str(), &contentHash);
 
 	Shader::_doLoad();
 }
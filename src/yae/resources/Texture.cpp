@@ -36,6 +36,17 @@ const void* Texture::getPixelData() const
 	return m_pixelData;
 }
 
+void Texture::setMipData(TextureFormat _format, u32 _width, u32 _height, const TextureMip* _mips, u32 _mipCount)
+{
+	YAE_ASSERT(m_textureHandle == 0);
+	m_format = _format;
+	m_mips = _mips;
+	m_mipCount = _mipCount;
+	m_width = _width;
+	m_height = _height;
+	m_channelCount = 4;
+}
+
 void Texture::setFilter(TextureFilter _filter)
 {
 	YAE_ASSERT(m_textureHandle == 0);
@@ -73,8 +84,16 @@ void Texture::_doLoad()
 {
 	YAE_CAPTURE_FUNCTION();
 
-	YAE_ASSERT(m_pixelData != nullptr);
-	bool result = renderer().createTexture(m_pixelData, m_width, m_height, m_channelCount, m_textureHandle);
+	bool result = false;
+	if (m_mipCount > 0)
+	{
+		result = renderer().createTexture(m_format, m_width, m_height, m_mips, m_mipCount, m_textureHandle);
+	}
+	else
+	{
+		YAE_ASSERT(m_pixelData != nullptr);
+		result = renderer().createTexture(m_pixelData, m_width, m_height, m_channelCount, m_textureHandle);
+	}
 	if (!result)
 	{
 		_log(RESOURCELOGTYPE_ERROR, "Failed to create texture.");
@@ -83,7 +102,7 @@ void Texture::_doLoad()
 
 	renderer().applyTextureParameters(m_textureHandle, m_parameters);
 
-	YAE_VERBOSEF_CAT("resource", "Succesfully loaded texture \"%s\".", getName());
+	YAE_VERBOSEF_CAT(resource, "Succesfully loaded texture \"%s\".", getName());
 	return;
 }
 
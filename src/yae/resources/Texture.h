@@ -19,6 +19,9 @@ public:
 	void setPixelData(const void* _data, u32 _width, u32 _height, u32 _channelCount);
 	const void* getPixelData() const;
 
+	// Pre-built mip chain, uploaded instead of the pixel data when set. The mips are not copied.
+	void setMipData(TextureFormat _format, u32 _width, u32 _height, const TextureMip* _mips, u32 _mipCount);
+
 	void setFilter(TextureFilter _filter);
 	TextureFilter getFilter() const;
 
@@ -36,6 +39,9 @@ public:
 	u32 m_width = 0;
 	u32 m_height = 0;
 	u32 m_channelCount = 0;
+	TextureFormat m_format = TextureFormat::RGBA8;
+	const TextureMip* m_mips = nullptr;
+	u32 m_mipCount = 0;
 	TextureHandle m_textureHandle;
 	
 	TextureParameters m_parameters;
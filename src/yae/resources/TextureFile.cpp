@@ -1,7 +1,12 @@
 #include "TextureFile.h"
 
 #include <core/filesystem.h>
+#include <core/hash.h>
+#include <core/Program.h>
+#include <core/string.h>
 #include <yae/rendering/Renderer.h>
+#include <yae/ContentHashDatabase.h>
+#include <yae/Engine.h>
 #include <yae/ResourceManager.h>
 
 #include <stb/stb_image.h>
@@ -40,21 +45,52 @@ void TextureFile::_doLoad()
 {
 	YAE_CAPTURE_FUNCTION();
 
-	// Create Texture Image
-	i32 width, height, channelCount;
-	stbi_uc* pixels = nullptr;
+	YAE_VERBOSEF_CAT(resource, "Loading texture \"%s\"...", m_path.c_str());
+
+	// The source hash detects changes since the last cook, the source is only read if it changed on disk
+	u64 contentHash = 0;
+	if (!engine().contentHashDatabase().getContentHash(m_path.c_str(), &contentHash))
+	{
+		_log(RESOURCELOGTYPE_ERROR, "Could not open file.");
+		return;
+	}
+	u32 sourceHash = u32(contentHash);
+
+	// Nearest filtered textures are usually data (e.g. palettes), they are kept exact and without mips
+	bool generateMips = m_parameters.filter == TextureFilter::LINEAR;
+	bool compress = generateMips && renderer().isTextureFormatSupported(TextureFormat::BC1) && renderer().isTextureFormatSupported(TextureFormat::BC3);
+
+	String cookedPath = _getCookedPath(compress, generateMips);
+	if (!_loadCookedFile(cookedPath.c_str(), sourceHash))
 	{
-		YAE_CAPTURE_SCOPE("open_file");
+		FileReader reader(m_path.c_str(), &scratchAllocator());
+		{
+			YAE_CAPTURE_SCOPE("open_file");
+
+			if (!reader.map())
+			{
+				_log(RESOURCELOGTYPE_ERROR, "Could not open file.");
+				return;
+			}
+		}
 
-		YAE_VERBOSEF_CAT("resource", "Loading texture \"%s\"...", m_path.c_str());
-		pixels = stbi_load(m_path.c_str(), &width, &height, &channelCount, STBI_rgb_alpha);
-		if (pixels == nullptr)
+		if (!_cook(reader.getContent(), u32(reader.getContentSize()), sourceHash, compress, generateMips))
 		{
-			_log(RESOURCELOGTYPE_ERROR, "Could not open file.");
+			_log(RESOURCELOGTYPE_ERROR, "Could not decode image.");
 			return;
-		}	
+		}
+
+		String cookedDirectory = filesystem::getDirectory(cookedPath.c_str());
+		filesystem::createDirectory(cookedDirectory.c_str());
+		FileHandle file(cookedPath.c_str());
+		if (!file.open(FileHandle::OPENMODE_WRITE) || !file.write(m_cookedData.data(), m_cookedData.size()))
+		{
+			YAE_WARNINGF_CAT(resource, "Failed to write cooked texture \"%s\"", cookedPath.c_str());
+		}
+		file.close();
 	}
-	setPixelData(pixels, width, height, channelCount);
+
+	setMipData(m_cookedTexture.format, m_cookedTexture.width, m_cookedTexture.height, m_cookedTexture.mips, m_cookedTexture.mipCount);
 	Texture::_doLoad();
 
 	m_manager->registerReloadOnFileChanged(m_path.c_str(), this);
@@ -69,8 +105,65 @@ void TextureFile::_doUnload()
 
 	Texture::_doUnload();
 
-	stbi_image_free((void*)m_pixelData);
-	setPixelData(nullptr, 0, 0, 0);
+	setMipData(TextureFormat::RGBA8, 0, 0, nullptr, 0);
+	m_cookedTexture = texture_cooking::CookedTexture();
+	m_cookedData.clear();
+	m_cookedData.shrink();
+}
+
+
+String TextureFile::_getCookedPath(bool _compress, bool _generateMips) const
+{
+	String key = string::format("%s|%d|%d", m_path.c_str(), _compress ? 1 : 0, _generateMips ? 1 : 0);
+	return string::format("%s/texture_cache/%08x.ytex", program().getIntermediateDirectory(), hash::hashString(key.c_str()));
+}
+
+
+bool TextureFile::_loadCookedFile(const char* _cookedPath, u32 _sourceHash)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	FileHandle file(_cookedPath);
+	if (!file.open(FileHandle::OPENMODE_READ))
+		return false;
+
+	m_cookedData.resize(u32(file.getSize()));
+	bool isRead = file.read(m_cookedData.data(), m_cookedData.size()) == m_cookedData.size();
+	file.close();
+
+	if (!isRead
+		|| !texture_cooking::readCookedTexture(m_cookedData.data(), m_cookedData.size(), m_cookedTexture)
+		|| m_cookedTexture.sourceHash != _sourceHash
+		|| !renderer().isTextureFormatSupported(m_cookedTexture.format))
+	{
+		YAE_VERBOSEF_CAT(resource, "Cooked texture \"%s\" is out of date", _cookedPath);
+		return false;
+	}
+
+	YAE_VERBOSEF_CAT(resource, "Loaded cooked texture \"%s\"", _cookedPath);
+	return true;
+}
+
+
+bool TextureFile::_cook(const void* _sourceData, u32 _sourceSize, u32 _sourceHash, bool _compress, bool _generateMips)
+{
+	YAE_CAPTURE_FUNCTION();
+
+	i32 width, height, channelCount;
+	stbi_uc* pixels = stbi_load_from_memory((const stbi_uc*)_sourceData, i32(_sourceSize), &width, &height, &channelCount, STBI_rgb_alpha);
+	if (pixels == nullptr)
+		return false;
+
+	TextureFormat format = TextureFormat::RGBA8;
+	if (_compress)
+	{
+		format = texture_cooking::hasAlpha(pixels, width, height) ? TextureFormat::BC3 : TextureFormat::BC1;
+	}
+	texture_cooking::cookTexture(pixels, width, height, format, _generateMips, _sourceHash, m_cookedData);
+	stbi_image_free(pixels);
+
+	YAE_VERBOSEF_CAT(resource, "Cooked texture \"%s\"", m_path.c_str());
+	return texture_cooking::readCookedTexture(m_cookedData.data(), m_cookedData.size(), m_cookedTexture);
 }
 
 } // namespace yae
@@ -4,6 +4,7 @@
 
 #include <yae/resources/Texture.h>
 #include <yae/rendering/render_types.h>
+#include <yae/rendering/texture_cooking.h>
 
 namespace yae {
 
@@ -23,7 +24,15 @@ public:
 	virtual void _doLoad() override;
 	virtual void _doUnload() override;
 
+	String _getCookedPath(bool _compress, bool _generateMips) const;
+	bool _loadCookedFile(const char* _cookedPath, u32 _sourceHash);
+	bool _cook(const void* _sourceData, u32 _sourceSize, u32 _sourceHash, bool _compress, bool _generateMips);
+
 	String m_path;
+
+	// Cooked mip chain, in the intermediate directory. It is rebuilt when the source file changes.
+	DataArray<u8> m_cookedData;
+	texture_cooking::CookedTexture m_cookedTexture;
 };
 
 } // namespace yae
@@ -5,6 +5,13 @@
 #include <yae/test/serialization_test.h>
 #include <yae/test/math_test.h>
 #include <yae/test/random_test.h>
+#include <yae/test/ecs_test.h>
+#include <yae/test/spatial_test.h>
+#include <yae/test/rendering_test.h>
+#include <yae/test/logging_test.h>
+#include <yae/test/filesystem_test.h>
+#include <yae/test/hash_test.h>
+#include <yae/test/string_test.h>
 
 namespace yae {
 
@@ -20,12 +27,57 @@ void TestSystem::_registerAllTests()
         addTest("quaternion", &test::testQuaternion);
     popCategory();
 
+    pushCategory("hash");
+        addTest("properties", &test::testHash);
+        addTest("collisions", &test::testHashCollisions);
+        addBenchmark("throughput", &test::benchmarkHash);
+    popCategory();
+
+    pushCategory("string");
+        addTest("StringPool", &test::testStringPool);
+        addTest("StringBuilder", &test::testStringBuilder);
+        addBenchmark("StringBuilder", &test::benchmarkStringBuilder);
+    popCategory();
+
     addTest("random", &test::testRandom);
+    addTest("logging", &test::testLogging);
+    addTest("FileReader", &test::testFileReader);
+    addTest("IOService", &test::testIOService);
+    addTest("FileWatchSystem", &test::testFileWatchSystem);
+    addTest("ContentHashDatabase", &test::testContentHashDatabase);
+    addBenchmark("IOService", &test::benchmarkIOService);
+
+    pushCategory("ecs");
+        addTest("ComponentStorage", &test::testComponentStorage);
+        addTest("ComponentQuery", &test::testComponentQuery);
+        addBenchmark("ComponentStorage", &test::benchmarkComponentStorage);
+    popCategory();
+
+    pushCategory("spatial");
+        addTest("bounds", &test::testBounds);
+        addTest("DynamicBVH", &test::testDynamicBVH);
+        addTest("culling", &test::testCulling);
+        addBenchmark("DynamicBVH", &test::benchmarkDynamicBVH);
+    popCategory();
+
+    pushCategory("rendering");
+        addTest("draw sort keys", &test::testDrawSortKeys);
+        addTest("radix sort", &test::testRadixSort);
+        addTest("stream array", &test::testStreamArray);
+        addTest("range allocator", &test::testRangeAllocator);
+        addTest("texture cooking", &test::testTextureCooking);
+        addTest("utf8 decoding", &test::testUtf8Decoding);
+        addTest("glyph run cache", &test::testGlyphRunCache);
+        addTest("vertex format", &test::testVertexFormat);
+        addTest("mesh cooking", &test::testMeshCooking);
+        addBenchmark("radix sort", &test::benchmarkRadixSort);
+    popCategory();
 }
 
 TestSystem::TestSystem()
 	: m_categoryStack(&toolAllocator())
 	, m_tests(&toolAllocator())
+	, m_benchmarks(&toolAllocator())
 	, m_categories(&toolAllocator())
 {
 }
@@ -87,56 +139,45 @@ void TestSystem::popCategory()
 
 void TestSystem::addTest(const char* _name, void(*_testFunctionPtr)())
 {
-	YAE_ASSERT(m_categoryStack.size() > 0);
-	YAE_ASSERT(strlen(_name) < 128);
-
-	String fullName(&scratchAllocator());
-	for (u32 i = 1; i < m_categoryStack.size(); ++i)
-	{
-		fullName += m_categories.get(m_categoryStack[i])->name;
-		fullName += "::";
-	}
-	fullName += _name;
-
-	Test test;
-	strcpy(test.name, _name);
-	test.fullName = fullName;
-	test.testFunctionPtr = _testFunctionPtr;
-
-	m_tests.push_back(test);
+	m_tests.push_back(_makeTest(_name, _testFunctionPtr));
 
 	TestCategory* currentCategory = m_categories.get(m_categoryStack.back());
 	YAE_ASSERT(currentCategory != nullptr);
 	currentCategory->tests.push_back(m_tests.size());
 }
 
+void TestSystem::addBenchmark(const char* _name, void(*_benchmarkFunctionPtr)())
+{
+	m_benchmarks.push_back(_makeTest(_name, _benchmarkFunctionPtr));
+}
+
 void TestSystem::runAllTests()
 {
 	YAE_CAPTURE_FUNCTION();
-	YAE_VERBOSE_CAT("test", "Running all tests...");
+	YAE_VERBOSE_CAT(test, "Running all tests...");
 
 	for (const Test& test : m_tests)
 	{
 		_runTest(test);
 	}
 
-	YAE_VERBOSE_CAT("test", "All tests Done.");
+	YAE_VERBOSE_CAT(test, "All tests Done.");
 }
 
 void TestSystem::runAllTestsInCategory(char* _name)
 {
-	YAE_VERBOSEF_CAT("test", "Running all tests in category \"%s\"...", _name);
+	YAE_VERBOSEF_CAT(test, "Running all tests in category \"%s\"...", _name);
 
 	StringHash nameHash = StringHash(_name);
 	const TestCategory* categoryPtr = m_categories.get(nameHash);
 	if (!categoryPtr)
 	{
-		YAE_ERRORF_CAT("test", "Unknown category \"%s\"", _name);
+		YAE_ERRORF_CAT(test, "Unknown category \"%s\"", _name);
 		return;
 	}
 	_runAllTestsInCategory(*categoryPtr);
 
-	YAE_VERBOSEF_CAT("test", "All \"%s\" tests Done.", _name);
+	YAE_VERBOSEF_CAT(test, "All \"%s\" tests Done.", _name);
 }
 
 void TestSystem::runTest(u32 _testId)
@@ -145,19 +186,74 @@ void TestSystem::runTest(u32 _testId)
 	_runTest(m_tests[_testId]);
 }
 
+void TestSystem::runAllBenchmarks()
+{
+	runBenchmarks("");
+}
+
+void TestSystem::runBenchmarks(const char* _filter)
+{
+	YAE_LOGF_CAT(benchmark, "Running benchmarks matching \"%s\"...", _filter);
+
+	u32 count = 0;
+	for (const Test& benchmark : m_benchmarks)
+	{
+		if (strstr(benchmark.fullName.c_str(), _filter) == nullptr)
+			continue;
+
+		_runBenchmark(benchmark);
+		++count;
+	}
+
+	YAE_LOGF_CAT(benchmark, "%d benchmark(s) done.", count);
+}
+
 void TestSystem::_runTest(const Test& _test)
 {
 	try
 	{
 		_test.testFunctionPtr();
 		logger().setDefaultOutputColor(OutputColor_Green);
-		YAE_LOGF_CAT("test", "%s: SUCCESS", _test.fullName.c_str());
+		YAE_LOGF_CAT(test, "%s: SUCCESS", _test.fullName.c_str());
 		logger().setDefaultOutputColor(OutputColor_Default);
 	}
 	catch(const char* _e)
 	{
-		YAE_ERRORF_CAT("test", "%s: FAILED (%s)", _test.fullName.c_str(), _e != nullptr ? _e : "");
+		YAE_ERRORF_CAT(test, "%s: FAILED (%s)", _test.fullName.c_str(), _e != nullptr ? _e : "");
+	}
+}
+
+void TestSystem::_runBenchmark(const Test& _benchmark)
+{
+	YAE_LOGF_CAT(benchmark, "-- %s", _benchmark.fullName.c_str());
+	try
+	{
+		_benchmark.testFunctionPtr();
+	}
+	catch(const char* _e)
+	{
+		YAE_ERRORF_CAT(benchmark, "%s: FAILED (%s)", _benchmark.fullName.c_str(), _e != nullptr ? _e : "");
+	}
+}
+
+Test TestSystem::_makeTest(const char* _name, void(*_functionPtr)())
+{
+	YAE_ASSERT(m_categoryStack.size() > 0);
+	YAE_ASSERT(strlen(_name) < 128);
+
+	String fullName(&scratchAllocator());
+	for (u32 i = 1; i < m_categoryStack.size(); ++i)
+	{
+		fullName += m_categories.get(m_categoryStack[i])->name;
+		fullName += "::";
 	}
+	fullName += _name;
+
+	Test test;
+	strcpy(test.name, _name);
+	test.fullName = fullName;
+	test.testFunctionPtr = _functionPtr;
+	return test;
 }
 
 void TestSystem::_runAllTestsInCategory(const TestCategory& _category)
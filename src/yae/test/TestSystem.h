@@ -33,21 +33,29 @@ public:
 	void popCategory();
 
 	void addTest(const char* _name, void(*_testFunctionPtr)());
+	// Benchmarks are registered like tests but never run automatically, see the "test.benchmark" console command
+	void addBenchmark(const char* _name, void(*_benchmarkFunctionPtr)());
 
 	void runAllTests();
 	void runAllTestsInCategory(char* _name);
 	void runTest(u32 _testId);
 
+	void runAllBenchmarks();
+	void runBenchmarks(const char* _filter); // runs every benchmark whose full name contains _filter
+
 	const TestCategory& getRootCategory() const;
 
 //private:
 	void _registerAllTests();
 	void _runTest(const Test& _test);
 	void _runAllTestsInCategory(const TestCategory& _category);
+	void _runBenchmark(const Test& _benchmark);
+	Test _makeTest(const char* _name, void(*_functionPtr)());
 
 	DataArray<StringHash> m_categoryStack;
 
 	Array<Test> m_tests;
+	Array<Test> m_benchmarks;
 	HashMap<StringHash, TestCategory> m_categories;
 };
 
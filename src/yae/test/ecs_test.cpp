@@ -0,0 +1,204 @@
+#include "ecs_test.h"
+
+#include <core/JobSystem.h>
+#include <core/serialization/BinarySerializer.h>
+#include <core/time.h>
+#include <yae/ComponentStorage.h>
+#include <yae/math_types.h>
+
+#include <yae/test/test_macros.h>
+
+#include <mirror/mirror.h>
+
+namespace yae {
+namespace test {
+
+struct PositionComponent
+{
+	Vector3 position = Vector3::ZERO();
+};
+
+struct VelocityComponent
+{
+	Vector3 velocity = Vector3::ONE();
+};
+
+struct NameComponent
+{
+	String name;
+};
+
+void testComponentStorage()
+{
+	ComponentStorage storage(&toolAllocator());
+
+	const PoolID entityA = 0;
+	const PoolID entityB = 1;
+	const PoolID entityC = 2;
+	storage.addEntity(entityA);
+	storage.addEntity(entityB);
+	storage.addEntity(entityC);
+	TEST(storage.getEntityCount() == 3);
+
+	storage.addComponent(entityA, PositionComponent{ Vector3(1.f, 2.f, 3.f) });
+	storage.addComponent(entityB, PositionComponent{ Vector3(4.f, 5.f, 6.f) });
+	storage.addComponent<VelocityComponent>(entityB);
+	storage.addComponent(entityC, NameComponent()).name = "entityC";
+
+	TEST(storage.hasComponent<PositionComponent>(entityA));
+	TEST(!storage.hasComponent<VelocityComponent>(entityA));
+	TEST(storage.getComponent<PositionComponent>(entityB)->position == Vector3(4.f, 5.f, 6.f));
+	TEST(storage.getComponent<VelocityComponent>(entityB)->velocity == Vector3::ONE());
+	TEST(storage.getComponent<NameComponent>(entityC)->name == "entityC");
+	TEST(storage.getComponentCount(entityB) == 2);
+
+	// Moving entity A to another archetype must keep its data, and must not disturb B
+	storage.addComponent<VelocityComponent>(entityA);
+	TEST(storage.getComponent<PositionComponent>(entityA)->position == Vector3(1.f, 2.f, 3.f));
+	TEST(storage.getComponent<PositionComponent>(entityB)->position == Vector3(4.f, 5.f, 6.f));
+
+	TEST(storage.removeComponent<PositionComponent>(entityB));
+	TEST(!storage.removeComponent<PositionComponent>(entityB));
+	TEST(storage.getComponent<PositionComponent>(entityB) == nullptr);
+	TEST(storage.getComponent<VelocityComponent>(entityB) != nullptr);
+
+	// Stale ids must not resolve
+	storage.removeEntity(entityC);
+	TEST(!storage.hasEntity(entityC));
+	storage.addEntity(makeId(2, 1));
+	TEST(storage.getComponent<NameComponent>(makeId(2, 1)) == nullptr);
+	TEST(storage.getComponent<NameComponent>(entityC) == nullptr);
+
+	// Serialization round trip
+	{
+		BinarySerializer serializer(&toolAllocator());
+		serializer.beginWrite();
+		TEST(storage.serializeComponents(serializer, entityA));
+		serializer.endWrite();
+
+		u32 dataSize = serializer.getWriteDataSize();
+		void* data = toolAllocator().allocate(dataSize);
+		memcpy(data, serializer.getWriteData(), dataSize);
+
+		storage.addEntity(3);
+		serializer.setReadData(data, dataSize);
+		serializer.beginRead();
+		TEST(storage.serializeComponents(serializer, 3));
+		serializer.endRead();
+		toolAllocator().deallocate(data);
+
+		TEST(storage.getComponent<PositionComponent>(3)->position == Vector3(1.f, 2.f, 3.f));
+		TEST(storage.hasComponent<VelocityComponent>(3));
+	}
+
+	storage.clear();
+	TEST(storage.getEntityCount() == 0);
+}
+
+void testComponentQuery()
+{
+	ComponentStorage storage(&toolAllocator());
+
+	const u32 ENTITY_COUNT = 5000;
+	for (u32 i = 0; i < ENTITY_COUNT; ++i)
+	{
+		storage.addEntity(i);
+		storage.addComponent(i, PositionComponent{ Vector3(float(i), 0.f, 0.f) });
+		if (i % 2 == 0)
+		{
+			storage.addComponent<VelocityComponent>(i);
+		}
+		if (i % 3 == 0)
+		{
+			storage.addComponent<NameComponent>(i);
+		}
+	}
+
+	auto query = storage.query<PositionComponent, VelocityComponent>();
+	TEST(query.count() == ENTITY_COUNT / 2);
+
+	query.forEach([](PoolID _entity, PositionComponent& _position, VelocityComponent& _velocity)
+	{
+		_position.position += _velocity.velocity;
+	});
+	query.parallelForEach([](PoolID _entity, PositionComponent& _position, VelocityComponent& _velocity)
+	{
+		_position.position += _velocity.velocity;
+	});
+
+	for (u32 i = 0; i < ENTITY_COUNT; ++i)
+	{
+		float expectedX = float(i) + (i % 2 == 0 ? 2.f : 0.f);
+		TEST(storage.getComponent<PositionComponent>(i)->position.x == expectedX);
+	}
+
+	// The query picks up archetypes created after it
+	storage.addEntity(ENTITY_COUNT);
+	storage.addComponent<VelocityComponent>(ENTITY_COUNT);
+	storage.addComponent<PositionComponent>(ENTITY_COUNT);
+	TEST(query.count() == ENTITY_COUNT / 2 + 1);
+}
+
+void benchmarkComponentStorage()
+{
+	const u32 ENTITY_COUNT = 1000000;
+	ComponentStorage storage(&defaultAllocator());
+	Clock clock;
+
+	clock.reset();
+	for (u32 i = 0; i < ENTITY_COUNT; ++i)
+	{
+		storage.addEntity(i);
+		storage.addComponent(i, PositionComponent{ Vector3(float(i), 0.f, 0.f) });
+		storage.addComponent<VelocityComponent>(i);
+		if (i % 4 == 0)
+		{
+			storage.addComponent<NameComponent>(i);
+		}
+	}
+	YAE_LOGF_CAT(benchmark, "create %d entities: %.2fms", ENTITY_COUNT, clock.reset().asMilliSeconds());
+
+	auto query = storage.query<PositionComponent, VelocityComponent>();
+	auto integrate = [](PoolID _entity, PositionComponent& _position, const VelocityComponent& _velocity)
+	{
+		_position.position += _velocity.velocity * 0.016f;
+	};
+
+	clock.reset();
+	query.forEach(integrate);
+	YAE_LOGF_CAT(benchmark, "forEach: %.2fms", clock.reset().asMilliSeconds());
+
+	query.parallelForEach(integrate);
+	YAE_LOGF_CAT(benchmark, "parallelForEach (%d threads): %.2fms", jobSystem().getThreadCount(), clock.reset().asMilliSeconds());
+
+	float sum = 0.f;
+	for (u32 i = 0; i < ENTITY_COUNT; i += 7)
+	{
+		sum += storage.getComponent<PositionComponent>(i)->position.x;
+	}
+	YAE_LOGF_CAT(benchmark, "random access (%d lookups): %.2fms (%f)", ENTITY_COUNT / 7, clock.reset().asMilliSeconds(), sum);
+
+	for (u32 i = 0; i < ENTITY_COUNT; ++i)
+	{
+		storage.removeEntity(i);
+	}
+	YAE_LOGF_CAT(benchmark, "destroy %d entities: %.2fms", ENTITY_COUNT, clock.reset().asMilliSeconds());
+}
+
+} // namespace test
+} // namespace yae
+
+MIRROR_CLASS(yae::test::PositionComponent)
+(
+	MIRROR_MEMBER(position);
+);
+
+MIRROR_CLASS(yae::test::VelocityComponent)
+(
+	MIRROR_MEMBER(velocity);
+);
+
+MIRROR_CLASS(yae::test::NameComponent)
+(
+	MIRROR_MEMBER(name);
+);
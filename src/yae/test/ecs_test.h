@@ -0,0 +1,14 @@
+#pragma once
+
+#include <yae/types.h>
+
+namespace yae {
+namespace test {
+
+void testComponentStorage();
+void testComponentQuery();
+
+void benchmarkComponentStorage();
+
+} // namespace test
+} // namespace yae
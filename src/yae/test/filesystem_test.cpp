@@ -0,0 +1,387 @@
+#include "filesystem_test.h"
+
+#include <core/containers/Array.h>
+#include <core/filesystem.h>
+#include <core/IOService.h>
+#include <core/string.h>
+#include <core/time.h>
+#include <yae/ContentHashDatabase.h>
+#include <yae/FileWatchSystem.h>
+
+#include <yae/test/test_macros.h>
+
+#include <filesystem>
+
+namespace yae {
+namespace test {
+
+static bool writeTestFile(const char* _path, const void* _data, size_t _size)
+{
+	FileHandle file(_path);
+	return file.open(FileHandle::OPENMODE_WRITE) && file.write(_data, _size);
+}
+
+void testFileReader()
+{
+	const char* path = "./intermediate/file_reader_test.bin";
+
+	// Not a multiple of the page size
+	DataArray<u8> data(&scratchAllocator());
+	data.resize(3 * 4096 + 123);
+	for (u32 i = 0; i < data.size(); ++i)
+	{
+		data[i] = u8(i * 7 + (i >> 8));
+	}
+	TEST(writeTestFile(path, data.data(), data.size()));
+
+	{
+		FileReader reader(path, &scratchAllocator());
+		TEST(reader.map());
+		TEST(reader.isMapped());
+		TEST(reader.getContentSize() == data.size());
+		TEST(memcmp(reader.getContent(), data.data(), data.size()) == 0);
+	}
+
+	{
+		FileReader reader(path, &scratchAllocator());
+		TEST(reader.map(true));
+		TEST(reader.isMapped());
+		TEST(reader.getContentSize() == data.size());
+		TEST(memcmp(reader.getContent(), data.data(), data.size()) == 0);
+	}
+
+	{
+		FileReader reader(path, &scratchAllocator());
+		TEST(reader.load());
+		TEST(!reader.isMapped());
+		TEST(reader.getContentSize() == data.size());
+		TEST(memcmp(reader.getContent(), data.data(), data.size()) == 0);
+	}
+
+	// Empty files can't be mapped, they are loaded instead
+	TEST(writeTestFile(path, nullptr, 0));
+	{
+		FileReader reader(path, &scratchAllocator());
+		TEST(reader.map());
+		TEST(!reader.isMapped());
+		TEST(reader.getContentSize() == 0);
+	}
+
+	{
+		FileReader reader("./intermediate/file_reader_test_missing.bin", &scratchAllocator());
+		TEST(!reader.map());
+	}
+
+	filesystem::deletePath(path);
+}
+
+static u32 s_ioCallbackCount = 0;
+
+void testIOService()
+{
+	const char* paths[] = { "./intermediate/io_service_test_0.bin", "./intermediate/io_service_test_1.bin", "./intermediate/io_service_test_2.bin" };
+	const char* missingPath = "./intermediate/io_service_test_missing.bin";
+
+	DataArray<u8> data(&scratchAllocator());
+	data.resize(10000);
+	for (u32 i = 0; i < data.size(); ++i)
+	{
+		data[i] = u8(i * 13 + (i >> 8));
+	}
+	TEST(writeTestFile(paths[0], data.data(), data.size()));
+	TEST(writeTestFile(paths[1], data.data(), 100));
+	TEST(writeTestFile(paths[2], nullptr, 0));
+
+	// Without threads, with threads
+	for (u32 threadCount : { 0u, 2u })
+	{
+		IOService service(&defaultAllocator());
+		service.init(threadCount);
+
+		u8 buffer[100];
+		u8 smallBuffer[10];
+		{
+			// The arena only fits the first file, the second one goes to the heap
+			IOBatch batch(&defaultAllocator(), 10000);
+			batch.addRead(paths[0]);
+			batch.addRead(paths[0]);
+			batch.addRead(paths[1], buffer, sizeof(buffer));
+			batch.addRead(paths[1], smallBuffer, sizeof(smallBuffer));
+			batch.addRead(paths[2]);
+			batch.addRead(missingPath);
+			s_ioCallbackCount = 0;
+			batch.setCallback([](const IOReadRequest& _request) { ++s_ioCallbackCount; });
+			service.submit(batch);
+			service.wait(batch);
+
+			TEST(batch.isComplete());
+			TEST(s_ioCallbackCount == 6);
+			for (u32 i = 0; i < 2; ++i)
+			{
+				const IOReadRequest& request = batch.getRequest(i);
+				TEST(request.status == IOStatus::DONE);
+				TEST(request.size == data.size());
+				TEST(memcmp(request.data, data.data(), data.size()) == 0);
+			}
+			TEST(batch.getRequest(0).isDataOwned != batch.getRequest(1).isDataOwned);
+			TEST(batch.getRequest(2).status == IOStatus::DONE);
+			TEST(batch.getRequest(2).data == buffer);
+			TEST(batch.getRequest(2).size == 100);
+			TEST(memcmp(buffer, data.data(), 100) == 0);
+			TEST(batch.getRequest(3).status == IOStatus::BUFFER_TOO_SMALL);
+			TEST(batch.getRequest(4).status == IOStatus::DONE);
+			TEST(batch.getRequest(4).size == 0);
+			TEST(batch.getRequest(5).status == IOStatus::OPEN_FAILED);
+		}
+
+		// Completion polled from update, callbacks are called there
+		{
+			IOBatch batch(&defaultAllocator());
+			batch.addRead(paths[1]);
+			s_ioCallbackCount = 0;
+			batch.setCallback([](const IOReadRequest& _request) { ++s_ioCallbackCount; });
+			service.submit(batch);
+			while (!batch.isComplete())
+			{
+				std::this_thread::yield();
+			}
+			TEST(s_ioCallbackCount == 0);
+			service.update();
+			TEST(s_ioCallbackCount == 1);
+			TEST(batch.getRequest(0).status == IOStatus::DONE);
+		}
+
+		// Empty batches are complete right away
+		{
+			IOBatch batch(&defaultAllocator());
+			service.submit(batch);
+			TEST(batch.isComplete());
+			service.update();
+		}
+
+		service.shutdown();
+	}
+
+	for (const char* path : paths)
+	{
+		filesystem::deletePath(path);
+	}
+}
+
+struct FileWatchTestData
+{
+	u32 callCount = 0;
+	FileChangeType lastChangeType = FileChangeType::ADDED;
+};
+
+// Updates until a change is notified, then for more than the debounce delay so that a late event of the burst would be notified too
+static void waitForFileChanges(FileWatchSystem& _fileWatchSystem, const FileWatchTestData& _data)
+{
+	Clock clock;
+	clock.reset();
+	while (_data.callCount == 0 && clock.elapsed().asSeconds() < 2.f)
+	{
+		_fileWatchSystem.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	clock.reset();
+	while (clock.elapsed().asMilliSeconds() < 300.f)
+	{
+		_fileWatchSystem.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void testFileWatchSystem()
+{
+#if YAE_PLATFORM_WEB == 0
+	String path = filesystem::getAbsolutePath("./intermediate/file_watch_test.txt");
+	TEST(writeTestFile(path.c_str(), "0", 1));
+
+	FileWatchSystem* fileWatchSystem = defaultAllocator().create<FileWatchSystem>();
+	fileWatchSystem->init();
+
+	FileWatchTestData data;
+	fileWatchSystem->startFileWatcher(path.c_str(), [](const char* _filePath, FileChangeType _changeType, void* _userData)
+	{
+		FileWatchTestData* data = (FileWatchTestData*)_userData;
+		++data->callCount;
+		data->lastChangeType = _changeType;
+	}, &data);
+
+	// A burst of writes is notified once, after the changes settled
+	for (u32 i = 0; i < 5; ++i)
+	{
+		TEST(writeTestFile(path.c_str(), "12345", 5));
+	}
+	waitForFileChanges(*fileWatchSystem, data);
+	TEST(data.callCount == 1);
+	TEST(data.lastChangeType == FileChangeType::MODIFIED);
+
+	// Saved by deleting, recreating then writing the file: still a modification, resources only reload on those
+	data.callCount = 0;
+	TEST(filesystem::deletePath(path.c_str()));
+	TEST(writeTestFile(path.c_str(), "", 0));
+	TEST(writeTestFile(path.c_str(), "123", 3));
+	waitForFileChanges(*fileWatchSystem, data);
+	TEST(data.callCount == 1);
+	TEST(data.lastChangeType == FileChangeType::MODIFIED);
+
+	// Saved by renaming a temporary file over it
+	data.callCount = 0;
+	String temporaryPath = path + ".tmp";
+	TEST(writeTestFile(temporaryPath.c_str(), "1234", 4));
+	std::error_code errorCode;
+	std::filesystem::rename(temporaryPath.c_str(), path.c_str(), errorCode);
+	TEST(errorCode.value() == 0);
+	waitForFileChanges(*fileWatchSystem, data);
+	TEST(data.callCount == 1);
+	TEST(data.lastChangeType == FileChangeType::MODIFIED);
+
+	// Removed
+	data.callCount = 0;
+	TEST(filesystem::deletePath(path.c_str()));
+	waitForFileChanges(*fileWatchSystem, data);
+	TEST(data.callCount == 1);
+	TEST(data.lastChangeType == FileChangeType::REMOVED);
+
+	// Nothing after the watcher is stopped
+	data.callCount = 0;
+	fileWatchSystem->stopFileWatcher(path.c_str());
+	TEST(writeTestFile(path.c_str(), "0", 1));
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	fileWatchSystem->update();
+	TEST(data.callCount == 0);
+
+	fileWatchSystem->shutdown();
+	defaultAllocator().destroy(fileWatchSystem);
+	filesystem::deletePath(path.c_str());
+#endif
+}
+
+void testContentHashDatabase()
+{
+	const char* path = "./intermediate/content_hash_test.txt";
+	const char* otherPath = "./intermediate/content_hash_test_other.txt";
+	const char* databasePath = "./intermediate/content_hash_test.bin";
+
+	TEST(writeTestFile(path, "content", 7));
+	TEST(writeTestFile(otherPath, "content", 7));
+
+	u64 hash = 0;
+	u64 otherHash = 0;
+	{
+		ContentHashDatabase database(&defaultAllocator());
+		TEST(database.getContentHash(path, &hash));
+		TEST(database.getContentHash(otherPath, &otherHash));
+		TEST(hash == otherHash);
+		TEST(database.getFileCount() == 2);
+		TEST(!database.getContentHash("./intermediate/content_hash_test_missing.txt", &hash));
+
+		// Rewritten with the same bytes
+		TEST(writeTestFile(path, "content", 7));
+		TEST(!database.updateContentHash(path));
+
+		TEST(writeTestFile(path, "changed", 7));
+		TEST(database.updateContentHash(path));
+		TEST(database.getContentHash(path, &hash));
+		TEST(hash != otherHash);
+
+		TEST(database.save(databasePath));
+	}
+
+	// Reloaded records are compared with the files
+	{
+		ContentHashDatabase database(&defaultAllocator());
+		TEST(database.load(databasePath));
+		TEST(database.getFileCount() == 2);
+		TEST(!database.updateContentHash(path));
+
+		u64 reloadedHash = 0;
+		TEST(database.getContentHash(otherPath, &reloadedHash));
+		TEST(reloadedHash == otherHash);
+
+		database.forgetFile(otherPath);
+		TEST(database.getFileCount() == 1);
+	}
+
+	filesystem::deletePath(path);
+	filesystem::deletePath(otherPath);
+	filesystem::deletePath(databasePath);
+}
+
+void benchmarkIOService()
+{
+	const u32 FILE_COUNT = 256;
+	const u32 FILE_SIZE = 64 * 1024;
+
+	DataArray<u8> data(&defaultAllocator());
+	data.resize(FILE_SIZE);
+	for (u32 i = 0; i < data.size(); ++i)
+	{
+		data[i] = u8(i * 31);
+	}
+
+	Array<String> paths(&defaultAllocator());
+	for (u32 i = 0; i < FILE_COUNT; ++i)
+	{
+		paths.push_back(string::format("./intermediate/io_service_benchmark_%d.bin", i));
+		writeTestFile(paths.back().c_str(), data.data(), data.size());
+	}
+
+	IOService service(&defaultAllocator());
+	service.init(IOService::GetDefaultThreadCount());
+	YAE_LOGF_CAT(benchmark, "- %d files of %dKB, %d I/O threads -", FILE_COUNT, FILE_SIZE / 1024, service.getThreadCount());
+
+	// @NOTE(remi): the files were just written so the first pass is only as cold as the OS file cache allows, drop
+	// the cache before running the benchmark (e.g. RAMMap on Windows, /proc/sys/vm/drop_caches on Linux) for actually cold reads.
+	const char* passNames[] = { "cold", "warm" };
+	for (const char* passName : passNames)
+	{
+		Clock clock;
+		u64 readSize = 0;
+
+		clock.reset();
+		{
+			IOBatch batch(&defaultAllocator(), u64(FILE_COUNT) * FILE_SIZE);
+			for (const String& path : paths)
+			{
+				batch.addRead(path.c_str());
+			}
+			service.submit(batch);
+			service.wait(batch);
+			for (u32 i = 0; i < batch.getRequestCount(); ++i)
+			{
+				readSize += batch.getRequest(i).size;
+			}
+		}
+		double batchedTime = clock.reset().asMilliSeconds();
+
+		// Same files in reverse order, so that the batched reads do not always get the colder cache
+		for (u32 i = FILE_COUNT; i > 0; --i)
+		{
+			FileReader reader(paths[i - 1].c_str(), &defaultAllocator());
+			if (reader.load())
+			{
+				readSize += reader.getContentSize();
+			}
+		}
+		double sequentialTime = clock.reset().asMilliSeconds();
+
+		TEST(readSize == 2 * u64(FILE_COUNT) * FILE_SIZE);
+		YAE_LOGF_CAT(benchmark, "%s: batched %.2fms (%.0fMB/s), sequential FileReader %.2fms (%.0fMB/s)", passName,
+			batchedTime, double(FILE_COUNT) * FILE_SIZE / (1024.0 * 1024.0) / (batchedTime / 1000.0),
+			sequentialTime, double(FILE_COUNT) * FILE_SIZE / (1024.0 * 1024.0) / (sequentialTime / 1000.0));
+	}
+
+	service.shutdown();
+
+	for (const String& path : paths)
+	{
+		filesystem::deletePath(path.c_str());
+	}
+}
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <yae/types.h>
+
+namespace yae {
+namespace test {
+
+void testFileReader();
+void testIOService();
+void testFileWatchSystem();
+void testContentHashDatabase();
+
+void benchmarkIOService();
+
+} // namespace test
+} // namespace yae
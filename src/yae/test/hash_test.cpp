@@ -0,0 +1,208 @@
+#include "hash_test.h"
+
+#include <core/filesystem.h>
+#include <core/hash.h>
+#include <core/string.h>
+#include <core/time.h>
+
+#include <yae/test/test_macros.h>
+
+#include <algorithm>
+
+namespace yae {
+namespace test {
+
+// Previous hash32 implementation, kept as the benchmark baseline
+static u32 fnv1a(const void* _data, size_t _size)
+{
+	u32 hash = 2166136261u;
+	const u8* buf = static_cast<const u8*>(_data);
+	for (size_t i = 0; i < _size; ++i)
+	{
+		hash = hash * 16777619u;
+		hash = hash ^ buf[i];
+	}
+	return hash;
+}
+
+template <typename Hash>
+static u32 countCollisions(DataArray<Hash>& _hashes)
+{
+	std::sort(_hashes.begin(), _hashes.end());
+	u32 collisionCount = 0;
+	for (u32 i = 1; i < _hashes.size(); ++i)
+	{
+		if (_hashes[i] == _hashes[i - 1])
+		{
+			++collisionCount;
+		}
+	}
+	return collisionCount;
+}
+
+static_assert(""_sh.getHash() == 0, "Empty strings hash to 0");
+static_assert(string_hash::areUnique({ "yae"_sh, "YAE"_sh, "game"_sh }), "");
+static_assert(!string_hash::areUnique({ "yae"_sh, "game"_sh, "yae"_sh }), "");
+
+void testHash()
+{
+	TEST(hash::hash32(nullptr, 0) == 0);
+	TEST(hash::hashString("") == 0);
+	TEST(hash::hashString("yae") == hash::hash32("yae", 3));
+	TEST(hash::hashString64("yae") == hash::hash64("yae", 3));
+	TEST(hash::hash64("yae", 3) != hash::hash64("yae", 3, 1));
+	TEST(StringHash("yae") == StringHash(String("yae")));
+	TEST(StringHash64("yae") == StringHash64(String("yae")));
+	TEST(StringHash64("yae") != StringHash64("YAE"));
+
+	// Every prefix of a buffer hashes differently, across the small, medium and 48 bytes block paths
+	u8 buffer[257];
+	for (u32 i = 0; i < sizeof(buffer); ++i)
+	{
+		buffer[i] = u8(i * 7);
+	}
+	DataArray<u64> hashes64(&scratchAllocator());
+	DataArray<u32> hashes32(&scratchAllocator());
+	for (u32 size = 1; size <= 256; ++size)
+	{
+		hashes64.push_back(hash::hash64(buffer, size));
+		hashes32.push_back(hash::hash32(buffer, size));
+	}
+	TEST(countCollisions(hashes64) == 0);
+	TEST(countCollisions(hashes32) == 0);
+
+	// Same result whatever the alignment
+	{
+		u8 aligned[64 + 8];
+		u8 unaligned[64 + 8];
+		for (u32 i = 0; i < 64; ++i)
+		{
+			aligned[i] = u8(i * 13 + 1);
+			unaligned[i + 3] = aligned[i];
+		}
+		for (u32 size = 0; size <= 64; ++size)
+		{
+			TEST(hash::hash64(aligned, size) == hash::hash64(unaligned + 3, size));
+		}
+	}
+
+	// Single bit flips change the hash
+	{
+		u8 data[44]; // Vertex sized
+		memset(data, 0, sizeof(data));
+		u64 reference = hash::hash64(data, sizeof(data));
+		for (u32 bit = 0; bit < sizeof(data) * 8; ++bit)
+		{
+			data[bit / 8] ^= u8(1 << (bit % 8));
+			TEST(hash::hash64(data, sizeof(data)) != reference);
+			data[bit / 8] ^= u8(1 << (bit % 8));
+		}
+	}
+
+	// Compile time hashes match the runtime ones
+	{
+		constexpr StringHash literalHash = "spatialSystem"_sh;
+		constexpr u32 categoryHash = hash::hashStringConstexpr("resource");
+		TEST(literalHash == StringHash("spatialSystem"));
+		TEST(categoryHash == hash::hashString("resource"));
+		TEST(log_category::resource.hash == hash::hashString("resource"));
+		TEST("yae"_sh == StringHash("yae"));
+
+		const char* text = (const char*)buffer;
+		for (u32 size = 0; size <= 256; ++size)
+		{
+			TEST(hash::hash64Constexpr(text, size) == hash::hash64(buffer, size));
+			TEST(hash::hash64Constexpr(text, size, 42) == hash::hash64(buffer, size, 42));
+			TEST(hash::hash32Constexpr(text, size) == hash::hash32(buffer, size));
+		}
+	}
+}
+
+void testHashCollisions()
+{
+	// Names from the data tree, as used for resource names
+	Array<String> names(&scratchAllocator());
+	filesystem::walkDirectory("./data", [](const filesystem::Entry& _entry, void* _userData)
+	{
+		Array<String>& names = *(Array<String>*)_userData;
+		String candidates[] = { String(_entry.path.c_str(), &scratchAllocator()), String(filesystem::getFileName(_entry.path.c_str()), &scratchAllocator()) };
+		for (const String& candidate : candidates)
+		{
+			if (names.find(candidate) == nullptr)
+			{
+				names.push_back(candidate);
+			}
+		}
+		return true;
+	}, true, filesystem::EntryType_All, &names);
+	TEST(names.size() > 0);
+
+	DataArray<u32> hashes32(&scratchAllocator());
+	DataArray<u64> hashes64(&scratchAllocator());
+	for (const String& name : names)
+	{
+		hashes32.push_back(hash::hashString(name.c_str()));
+		hashes64.push_back(hash::hashString64(name.c_str()));
+	}
+	TEST(countCollisions(hashes32) == 0);
+	TEST(countCollisions(hashes64) == 0);
+
+	// Large generated set of resource like paths. 32 bits hashes are expected to collide around once for that
+	// many names (birthday bound), 64 bits hashes should not.
+	const u32 GENERATED_COUNT = 200000;
+	hashes32.clear();
+	hashes64.clear();
+	char name[128];
+	for (u32 i = 0; i < GENERATED_COUNT; ++i)
+	{
+		int size = snprintf(name, sizeof(name), "./data/models/level_%u/prop_%u.res", i / 1000, i);
+		hashes32.push_back(hash::hash32(name, size));
+		hashes64.push_back(hash::hash64(name, size));
+	}
+	u32 collisionCount32 = countCollisions(hashes32);
+	TEST(collisionCount32 < 20);
+	TEST(countCollisions(hashes64) == 0);
+	YAE_VERBOSEF_CAT(test, "%d distinct data names, %d collisions out of %d generated names with 32 bits hashes", hashes64.size(), collisionCount32, GENERATED_COUNT);
+}
+
+void benchmarkHash()
+{
+	const u32 KEY_SIZES[] = { 4, 8, 16, 32, 44, 64, 256, 1024, 4096 };
+	const u32 BYTES_PER_SIZE = 64 * 1024 * 1024;
+	const u32 BUFFER_SIZE = 64 * 1024;
+
+	DataArray<u8> buffer(&defaultAllocator());
+	buffer.resize(BUFFER_SIZE);
+	for (u32 i = 0; i < BUFFER_SIZE; ++i)
+	{
+		buffer[i] = u8(i * 31 + (i >> 8));
+	}
+
+	auto measure = [&](u32 _keySize, auto _hashFunction)
+	{
+		u32 keyCount = BYTES_PER_SIZE / _keySize;
+		u64 sink = 0;
+		Clock clock;
+		clock.reset();
+		for (u32 i = 0; i < keyCount; ++i)
+		{
+			// Keys move through the buffer so that they are not all the same
+			u32 offset = (i * _keySize) % (BUFFER_SIZE - _keySize);
+			sink += _hashFunction(buffer.data() + offset, _keySize);
+		}
+		double seconds = clock.reset().asSeconds64();
+		TEST(sink != 0);
+		return double(keyCount) * _keySize / (1024.0 * 1024.0 * 1024.0) / seconds;
+	};
+
+	for (u32 keySize : KEY_SIZES)
+	{
+		double fnvSpeed = measure(keySize, [](const void* _data, size_t _size) { return u64(fnv1a(_data, _size)); });
+		double hash32Speed = measure(keySize, [](const void* _data, size_t _size) { return u64(hash::hash32(_data, _size)); });
+		double hash64Speed = measure(keySize, [](const void* _data, size_t _size) { return hash::hash64(_data, _size); });
+		YAE_LOGF_CAT(benchmark, "%4dB keys: fnv1a %.2fGB/s, hash32 %.2fGB/s, hash64 %.2fGB/s", keySize, fnvSpeed, hash32Speed, hash64Speed);
+	}
+}
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <yae/types.h>
+
+namespace yae {
+namespace test {
+
+void testHash();
+void testHashCollisions();
+
+void benchmarkHash();
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,185 @@
+#include "logging_test.h"
+
+#include <core/logger.h>
+
+#include <yae/test/test_macros.h>
+
+#include <mutex>
+#include <thread>
+
+YAE_DECLARE_LOG_CATEGORY(, logging_test, WARNING)
+YAE_DEFINE_LOG_CATEGORY(logging_test)
+
+namespace yae {
+namespace test {
+
+struct LoggedMessages
+{
+	LoggedMessages()
+		: categories(&scratchAllocator())
+		, messages(&scratchAllocator())
+	{
+	}
+
+	void onLogged(const char* _categoryName, LogVerbosity _verbosity, const char* _fileInfo, const char* _message)
+	{
+		categories.push_back(String(_categoryName, &scratchAllocator()));
+		messages.push_back(String(_message, &scratchAllocator()));
+	}
+
+	Array<String> categories;
+	Array<String> messages;
+};
+
+void testLogging()
+{
+	// More verbose than the compiled verbosity, the calls are compiled out whatever the runtime verbosity
+	{
+		static_assert(log_category::logging_test_compiledVerbosity == LogVerbosity::WARNING, "");
+		LogVerbosity previousVerbosity = log_category::logging_test.verbosity;
+		log_category::logging_test.verbosity = LogVerbosity::VERBOSE;
+		u32 evaluationCount = 0;
+		YAE_LOGF_CAT(logging_test, "%u", ++evaluationCount);
+		YAE_VERBOSEF_CAT(logging_test, "%u", ++evaluationCount);
+		TEST(evaluationCount == 0);
+		log_category::logging_test.verbosity = previousVerbosity;
+	}
+
+	Logger logger;
+	logger.setStandardOutputEnabled(false);
+	LogVerbosity previousVerbosity = log_category::test.verbosity;
+	logger.setCategoryVerbosity("test", LogVerbosity::LOG);
+	TEST(log_category::test.verbosity == LogVerbosity::LOG);
+
+	LoggedMessages logged;
+	logger.logged.bind(&logged, &LoggedMessages::onLogged);
+
+	// Arguments are copied, the strings can be gone before the message is formatted
+	{
+		char buffer[16];
+		strcpy(buffer, "abc");
+		logging::log(logger, log_category::test, LogVerbosity::LOG, __FILE_AND_LINE__, "%d %s %.1f", 42, buffer, 1.5);
+		strcpy(buffer, "def");
+		logging::log(logger, log_category::test, LogVerbosity::VERBOSE, __FILE_AND_LINE__, "%s", buffer);
+		logging::log(logger, log_category::Default, LogVerbosity::WARNING, __FILE_AND_LINE__, "no arguments");
+		logger.flush();
+
+		TEST(logged.messages.size() == 2);
+		TEST(logged.categories[0] == "test");
+		TEST(logged.messages[0] == "42 abc 1.5");
+		TEST(logged.categories[1] == "Default");
+		TEST(logged.messages[1] == "no arguments");
+	}
+
+	// Bigger than a queue, formatted right away and truncated
+	{
+		logged.messages.clear();
+		String bigMessage(&scratchAllocator());
+		for (u32 i = 0; i < YAE_LOG_QUEUE_SIZE / 2; ++i)
+		{
+			bigMessage += "x";
+		}
+		logging::log(logger, log_category::test, LogVerbosity::LOG, __FILE_AND_LINE__, "%s", bigMessage.c_str());
+		logger.flush();
+
+		TEST(logged.messages.size() == 1);
+		TEST(logged.messages[0].size() > 0 && logged.messages[0].size() < bigMessage.size());
+		TEST(logged.messages[0][0] == 'x');
+	}
+
+	// The queue wraps many times
+	{
+		logged.messages.clear();
+		const u32 MESSAGE_COUNT = 10000;
+		for (u32 i = 0; i < MESSAGE_COUNT; ++i)
+		{
+			logging::log(logger, log_category::test, LogVerbosity::LOG, __FILE_AND_LINE__, "%u", i);
+			if (i % 1000 == 999)
+			{
+				logger.flush();
+			}
+		}
+		logger.flush();
+
+		TEST(logged.messages.size() == MESSAGE_COUNT);
+		for (u32 i = 0; i < MESSAGE_COUNT; ++i)
+		{
+			TEST(u32(atoi(logged.messages[i].c_str())) == i);
+		}
+	}
+
+#if YAE_LOG_ASYNC
+	// Every thread keeps its order
+	{
+		logged.messages.clear();
+		const u32 THREAD_COUNT = 4;
+		const u32 MESSAGE_COUNT = 250;
+		std::thread threads[THREAD_COUNT];
+		for (u32 i = 0; i < THREAD_COUNT; ++i)
+		{
+			threads[i] = std::thread([&logger, i]()
+			{
+				for (u32 j = 0; j < MESSAGE_COUNT; ++j)
+				{
+					logging::log(logger, log_category::test, LogVerbosity::LOG, __FILE_AND_LINE__, "%u %u", i, j);
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		logger.flush();
+
+		TEST(logged.messages.size() == THREAD_COUNT * MESSAGE_COUNT);
+		u32 nextIndices[THREAD_COUNT] = {};
+		for (const String& message : logged.messages)
+		{
+			u32 thread = ~0u;
+			u32 index = ~0u;
+			TEST(sscanf(message.c_str(), "%u %u", &thread, &index) == 2);
+			TEST(thread < THREAD_COUNT);
+			TEST(index == nextIndices[thread]);
+			++nextIndices[thread];
+		}
+	}
+
+	// Messages of different threads are written in the order of the log calls
+	{
+		logged.messages.clear();
+		const u32 THREAD_COUNT = 4;
+		const u32 MESSAGE_COUNT = 250;
+		std::mutex callMutex;
+		u32 callIndex = 0;
+		std::thread threads[THREAD_COUNT];
+		for (u32 i = 0; i < THREAD_COUNT; ++i)
+		{
+			threads[i] = std::thread([&logger, &callMutex, &callIndex]()
+			{
+				for (u32 j = 0; j < MESSAGE_COUNT; ++j)
+				{
+					std::lock_guard<std::mutex> lock(callMutex);
+					logging::log(logger, log_category::test, LogVerbosity::LOG, __FILE_AND_LINE__, "%u", callIndex++);
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		logger.flush();
+
+		TEST(logged.messages.size() == THREAD_COUNT * MESSAGE_COUNT);
+		for (u32 i = 0; i < logged.messages.size(); ++i)
+		{
+			TEST(u32(atoi(logged.messages[i].c_str())) == i);
+		}
+	}
+#endif
+
+	logger.logged.unbind(&logged, &LoggedMessages::onLogged);
+	logger.setCategoryVerbosity("test", previousVerbosity);
+}
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <yae/types.h>
+
+namespace yae {
+namespace test {
+
+void testLogging();
+
+} // namespace test
+} // namespace yae
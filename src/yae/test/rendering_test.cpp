@@ -0,0 +1,599 @@
+#include "rendering_test.h"
+
+#include <core/math.h>
+#include <core/string.h>
+#include <core/time.h>
+#include <yae/random.h>
+#include <yae/rendering/GlyphRunCache.h>
+#include <yae/rendering/mesh_cooking.h>
+#include <yae/rendering/RangeAllocator.h>
+#include <yae/rendering/sorting.h>
+#include <yae/rendering/StreamArray.h>
+#include <yae/rendering/texture_cooking.h>
+#include <yae/rendering/vertex_format.h>
+#include <yae/RandomGenerator.h>
+
+#include <yae/test/test_macros.h>
+
+#include <algorithm>
+
+namespace yae {
+namespace test {
+
+struct KeyValue
+{
+	u64 key;
+	u32 value;
+
+	bool operator<(const KeyValue& _other) const { return key < _other.key; }
+};
+
+static u64 randomKey(RandomGenerator& _generator)
+{
+	return (u64(_generator.mt()) << 32) | u64(_generator.mt());
+}
+
+void testDrawSortKeys()
+{
+	// Passes come first
+	TEST(sorting::makeDrawKey(RenderPass::SOLID, 0x3FFF, 0x3FFF, 1.f, 0xFFFF) < sorting::makeDrawKey(RenderPass::BLENDED, 0, 0, 0.f, 0));
+
+	// Solid: state first, then front to back
+	TEST(sorting::makeDrawKey(RenderPass::SOLID, 1, 9, 1.f, 9) < sorting::makeDrawKey(RenderPass::SOLID, 2, 0, 0.f, 0));
+	TEST(sorting::makeDrawKey(RenderPass::SOLID, 1, 1, 1.f, 9) < sorting::makeDrawKey(RenderPass::SOLID, 1, 2, 0.f, 0));
+	TEST(sorting::makeDrawKey(RenderPass::SOLID, 1, 1, .2f, 9) < sorting::makeDrawKey(RenderPass::SOLID, 1, 1, .8f, 0));
+	TEST(sorting::makeDrawKey(RenderPass::SOLID, 1, 1, .5f, 1) < sorting::makeDrawKey(RenderPass::SOLID, 1, 1, .5f, 2));
+
+	// Blended: back to front first
+	TEST(sorting::makeDrawKey(RenderPass::BLENDED, 9, 9, .8f, 9) < sorting::makeDrawKey(RenderPass::BLENDED, 1, 1, .2f, 1));
+	TEST(sorting::makeDrawKey(RenderPass::BLENDED, 1, 9, .5f, 9) < sorting::makeDrawKey(RenderPass::BLENDED, 2, 1, .5f, 1));
+
+	// Out of range depths are clamped
+	TEST(sorting::makeDrawKey(RenderPass::SOLID, 1, 1, -5.f, 1) == sorting::makeDrawKey(RenderPass::SOLID, 1, 1, 0.f, 1));
+	TEST(sorting::makeDrawKey(RenderPass::SOLID, 1, 1, 5.f, 1) == sorting::makeDrawKey(RenderPass::SOLID, 1, 1, 1.f, 1));
+}
+
+void testRadixSort()
+{
+	const u32 COUNT = 5000;
+	RandomGenerator generator(11);
+
+	DataArray<u64> keys(&toolAllocator());
+	DataArray<u32> values(&toolAllocator());
+	DataArray<u64> tmpKeys(&toolAllocator());
+	DataArray<u32> tmpValues(&toolAllocator());
+	DataArray<KeyValue> expected(&toolAllocator());
+
+	// Full random keys, keys with few distinct values (stability, skipped passes), and all equal keys
+	for (u32 distribution = 0; distribution < 3; ++distribution)
+	{
+		keys.resize(COUNT);
+		values.resize(COUNT);
+		tmpKeys.resize(COUNT);
+		tmpValues.resize(COUNT);
+		expected.resize(COUNT);
+		for (u32 i = 0; i < COUNT; ++i)
+		{
+			switch (distribution)
+			{
+				case 0: keys[i] = randomKey(generator); break;
+				case 1: keys[i] = sorting::makeDrawKey(RenderPass(generator.mt() % 2), generator.mt() % 4, generator.mt() % 8, 0.f, 0); break;
+				default: keys[i] = 42; break;
+			}
+			values[i] = i;
+			expected[i] = { keys[i], i };
+		}
+
+		sorting::radixSort(keys.data(), values.data(), COUNT, tmpKeys.data(), tmpValues.data());
+		std::stable_sort(expected.begin(), expected.end());
+
+		for (u32 i = 0; i < COUNT; ++i)
+		{
+			TEST(keys[i] == expected[i].key);
+			TEST(values[i] == expected[i].value);
+		}
+	}
+}
+
+void testStreamArray()
+{
+	u32 storage[8];
+	StreamArray<u32> stream(&toolAllocator());
+
+	// Heap storage
+	for (u32 i = 0; i < 100; ++i)
+	{
+		stream.push_back(i);
+	}
+	TEST(stream.size() == 100);
+	TEST(stream[99] == 99);
+	TEST(!stream.isMapped() && !stream.overflowed());
+	stream.clear();
+
+	// Written in place while it fits
+	stream.setStorage(storage, countof(storage));
+	u32 values[] = { 1, 2, 3, 4, 5, 6 };
+	stream.push_back(values, countof(values));
+	stream.push_back(7);
+	TEST(stream.isMapped() && !stream.overflowed());
+	TEST(stream.data() == storage);
+	TEST(storage[0] == 1 && storage[6] == 7);
+
+	// Moves to the heap with its content when it does not
+	stream.resize(12);
+	stream[11] = 12;
+	TEST(!stream.isMapped() && stream.overflowed());
+	TEST(stream.data() != storage);
+	TEST(stream[0] == 1 && stream[6] == 7 && stream[11] == 12);
+	TEST(stream.getRequiredCapacity() == 12);
+
+	// Back in place the next frame
+	stream.clear();
+	stream.setStorage(storage, countof(storage));
+	stream.push_back(42);
+	TEST(stream.isMapped() && storage[0] == 42);
+	TEST(stream.getRequiredCapacity() == 1);
+
+	stream.clear();
+	stream.setStorage(nullptr, 0);
+	stream.push_back(values, countof(values));
+	TEST(!stream.isMapped() && !stream.overflowed());
+	TEST(stream[5] == 6);
+}
+
+void testRangeAllocator()
+{
+	RangeAllocator allocator(&toolAllocator());
+
+	u32 a = allocator.allocate(10);
+	u32 b = allocator.allocate(20);
+	u32 c = allocator.allocate(30);
+	u32 d = allocator.allocate(5);
+	TEST(a == 0 && b == 10 && c == 30 && d == 60);
+	TEST(allocator.getTop() == 65);
+
+	// First fit in freed ranges
+	allocator.free(b, 20);
+	TEST(allocator.getFreeCount() == 20);
+	TEST(allocator.allocate(8) == 10);
+	TEST(allocator.allocate(12) == 18);
+	TEST(allocator.getFreeCount() == 0);
+	TEST(allocator.allocate(1) == 65);
+	allocator.free(65, 1);
+
+	// Neighbors merge
+	allocator.free(10, 8);
+	allocator.free(30, 30);
+	allocator.free(18, 12);
+	TEST(allocator.m_freeRanges.size() == 1);
+	TEST(allocator.m_freeRanges[0].first == 10 && allocator.m_freeRanges[0].count == 50);
+	TEST(allocator.allocate(50) == 10);
+	allocator.free(10, 50);
+
+	// Freeing the last range lowers the top, along with the free space right before it
+	allocator.free(d, 5);
+	TEST(allocator.getTop() == 10);
+	TEST(allocator.getFreeCount() == 0);
+	allocator.free(a, 10);
+	TEST(allocator.getTop() == 0);
+}
+
+void testUtf8Decoding()
+{
+	// a, e acute, euro sign, G clef
+	const char* text = "a\xC3\xA9\xE2\x82\xAC\xF0\x9D\x84\x9E";
+	const char* cursor = text;
+	const char* end = text + strlen(text);
+	TEST(string::decodeUtf8(cursor, end) == 'a');
+	TEST(string::decodeUtf8(cursor, end) == 0xE9);
+	TEST(string::decodeUtf8(cursor, end) == 0x20AC);
+	TEST(string::decodeUtf8(cursor, end) == 0x1D11E);
+	TEST(cursor == end);
+
+	// Invalid sequences only skip one byte
+	const char* invalid[] =
+	{
+		"\x80", // lone continuation byte
+		"\xC3", // truncated
+		"\xC3\x41", // missing continuation byte
+		"\xC0\xAF", // overlong
+		"\xED\xA0\x80", // surrogate
+		"\xF4\x90\x80\x80", // past U+10FFFF
+	};
+	for (const char* sequence : invalid)
+	{
+		cursor = sequence;
+		end = sequence + strlen(sequence);
+		TEST(string::decodeUtf8(cursor, end) == 0xFFFD);
+		TEST(cursor == sequence + 1);
+	}
+}
+
+void testGlyphRunCache()
+{
+	GlyphRunCache cache(&toolAllocator());
+
+	GlyphQuad quads[3];
+	for (u32 i = 0; i < countof(quads); ++i)
+	{
+		quads[i].x0 = float(i);
+		quads[i].u0 = u16(i);
+	}
+
+	TEST(cache.find(1, "abc", 3, 0) == nullptr);
+	const GlyphRun& abc = cache.add(1, "abc", 3, quads, 3, 0);
+	TEST(abc.quadCount == 3);
+	TEST(cache.getQuads(abc.firstQuad, abc.quadCount)[2].u0 == 2);
+	cache.add(1, "b", 1, quads + 1, 1, 0);
+	cache.add(1, "c", 1, quads + 2, 1, 0);
+
+	// Keyed by font and full text
+	TEST(cache.find(2, "abc", 3, 1) == nullptr);
+	TEST(cache.find(1, "ab", 2, 1) == nullptr);
+	TEST(cache.find(1, "abc", 3, 1) != nullptr);
+	TEST(cache.find(1, "c", 1, 5) != nullptr);
+
+	// Only the runs used since frame 2 are kept, and the storage is compacted
+	cache.evict(2);
+	TEST(cache.getRunCount() == 1);
+	TEST(cache.getQuadCount() == 1);
+	TEST(cache.find(1, "abc", 3, 6) == nullptr);
+	TEST(cache.find(1, "b", 1, 6) == nullptr);
+	const GlyphRun* c = cache.find(1, "c", 1, 6);
+	TEST(c != nullptr);
+	TEST(c->firstQuad == 0 && c->firstChar == 0);
+	TEST(cache.getQuads(c->firstQuad, c->quadCount)[0].x0 == 2.f);
+
+	// Nothing to evict
+	cache.evict(6);
+	TEST(cache.getRunCount() == 1);
+
+	cache.clear();
+	TEST(cache.getRunCount() == 0);
+	TEST(cache.find(1, "c", 1, 7) == nullptr);
+}
+
+static u32 maxChannelError(const u8* _a, const u8* _b, u32 _pixelCount, u32 _firstChannel, u32 _channelCount)
+{
+	u32 maxError = 0;
+	for (u32 i = 0; i < _pixelCount; ++i)
+	{
+		for (u32 c = _firstChannel; c < _firstChannel + _channelCount; ++c)
+		{
+			maxError = math::max(maxError, u32(math::abs(i32(_a[i * 4 + c]) - i32(_b[i * 4 + c]))));
+		}
+	}
+	return maxError;
+}
+
+void testVertexFormat()
+{
+	// Default format matches Vertex
+	VertexFormat floatFormat;
+	TEST(vertex_format::getStride(floatFormat) == sizeof(Vertex));
+	TEST(vertex_format::getOffset(floatFormat, VertexAttribute::NORMAL) == sizeof(float) * 5);
+	TEST(vertex_format::getOffset(floatFormat, VertexAttribute::COLOR) == sizeof(float) * 8);
+
+	// Half floats
+	TEST(vertex_format::floatToHalf(0.f) == 0x0000);
+	TEST(vertex_format::floatToHalf(1.f) == 0x3C00);
+	TEST(vertex_format::floatToHalf(-2.f) == 0xC000);
+	TEST(vertex_format::floatToHalf(65504.f) == 0x7BFF);
+	TEST(vertex_format::floatToHalf(100000.f) == 0x7C00);
+	TEST(vertex_format::halfToFloat(0x3555) == 0.333251953125f);
+	TEST(vertex_format::halfToFloat(0x0001) == 1.f / 16777216.f);
+	for (float value : { 0.5f, -3.25f, 1000.f, 0.1f, 1.f / 16384.f })
+	{
+		TEST(math::abs(vertex_format::halfToFloat(vertex_format::floatToHalf(value)) - value) <= math::abs(value) / 1024.f);
+	}
+
+	DataArray<Vertex> vertices(&defaultAllocator());
+	vertices.push_back(Vertex(Vector3(-1.f, 0.f, 2.5f), Vector2(0.f, 1.f), Vector3(0.f, 1.f, 0.f), Vector3(1.f, 1.f, 1.f)));
+	vertices.push_back(Vertex(Vector3(1.f, 0.5f, -2.5f), Vector2(0.25f, 0.75f), Vector3(0.6f, 0.f, -0.8f), Vector3(0.f, 0.5f, 1.f)));
+	vertices.push_back(Vertex(Vector3(0.3f, -1.f, 0.f), Vector2(1.f, 0.f), Vector3(-0.70710678f, -0.70710678f, 0.f), Vector3(0.2f, 0.f, 0.8f)));
+
+	// Small mesh with normalized attributes is fully quantized
+	VertexFormat format = vertex_format::computeQuantizedFormat(vertices.data(), vertices.size());
+	TEST(format.get(VertexAttribute::POSITION) == VertexAttributeFormat::HALF4);
+	TEST(format.get(VertexAttribute::TEXCOORD) == VertexAttributeFormat::UNORM16x2);
+	TEST(format.get(VertexAttribute::NORMAL) == VertexAttributeFormat::SNORM10x3);
+	TEST(format.get(VertexAttribute::COLOR) == VertexAttributeFormat::UNORM8x4);
+	TEST(vertex_format::getStride(format) == 20);
+
+	DataArray<u8> encoded(&defaultAllocator());
+	encoded.resize(vertices.size() * vertex_format::getStride(format));
+	vertex_format::encodeVertices(format, vertices.data(), vertices.size(), encoded.data());
+	DataArray<Vertex> decoded(&defaultAllocator());
+	decoded.resize(vertices.size());
+	vertex_format::decodeVertices(format, encoded.data(), vertices.size(), decoded.data());
+	for (u32 i = 0; i < vertices.size(); ++i)
+	{
+		for (u32 j = 0; j < 3; ++j)
+		{
+			TEST(math::abs(decoded[i].pos[j] - vertices[i].pos[j]) <= 5.f / 1000.f);
+			TEST(math::abs(decoded[i].normal[j] - vertices[i].normal[j]) <= 1.f / 511.f);
+			TEST(math::abs(decoded[i].color[j] - vertices[i].color[j]) <= 1.f / 255.f);
+		}
+		TEST(math::abs(decoded[i].texCoord.x - vertices[i].texCoord.x) <= 1.f / 65535.f);
+		TEST(math::abs(decoded[i].texCoord.y - vertices[i].texCoord.y) <= 1.f / 65535.f);
+	}
+	TEST(decoded[0].normal == Vector3(0.f, 1.f, 0.f));
+
+	// Tiling texture coordinates, far from the origin positions and overbright colors stay in floats
+	vertices[0].texCoord = Vector2(2.f, 0.f);
+	vertices[1].color = Vector3(1.5f, 0.f, 0.f);
+	for (Vertex& vertex : vertices)
+	{
+		vertex.pos += Vector3(1000.f, 0.f, 0.f);
+	}
+	format = vertex_format::computeQuantizedFormat(vertices.data(), vertices.size());
+	TEST(format.get(VertexAttribute::POSITION) == VertexAttributeFormat::FLOAT3);
+	TEST(format.get(VertexAttribute::TEXCOORD) == VertexAttributeFormat::FLOAT2);
+	TEST(format.get(VertexAttribute::COLOR) == VertexAttributeFormat::FLOAT3);
+
+	// Float attributes are copied exactly
+	encoded.resize(vertices.size() * vertex_format::getStride(floatFormat));
+	vertex_format::encodeVertices(floatFormat, vertices.data(), vertices.size(), encoded.data());
+	TEST(memcmp(encoded.data(), vertices.data(), encoded.size()) == 0);
+
+	TEST(vertex_format::computeQuantizedFormat(nullptr, 0) == floatFormat);
+}
+
+static u64 sortedTrianglesHash(const u32* _indices, u32 _indexCount)
+{
+	// Order independent: sum of the triangle hashes
+	u64 sum = 0;
+	for (u32 i = 0; i < _indexCount; i += 3)
+	{
+		sum += u64(_indices[i]) * 73856093u ^ u64(_indices[i + 1]) * 19349663u ^ u64(_indices[i + 2]) * 83492791u;
+	}
+	return sum;
+}
+
+void testMeshCooking()
+{
+	// Grid of GRID_SIZE x GRID_SIZE quads, unindexed and with the triangles shuffled
+	const u32 GRID_SIZE = 32;
+	DataArray<Vertex> vertices(&defaultAllocator());
+	for (u32 y = 0; y < GRID_SIZE; ++y)
+	{
+		for (u32 x = 0; x < GRID_SIZE; ++x)
+		{
+			Vector2 corners[4] = { Vector2(float(x), float(y)), Vector2(float(x + 1), float(y)), Vector2(float(x + 1), float(y + 1)), Vector2(float(x), float(y + 1)) };
+			u32 quad[6] = { 0, 1, 2, 0, 2, 3 };
+			for (u32 corner : quad)
+			{
+				vertices.push_back(Vertex(Vector3(corners[corner], 0.f), corners[corner] / float(GRID_SIZE), Vector3(0.f, 0.f, 1.f), Vector3::ONE()));
+			}
+		}
+	}
+	RandomGenerator generator(42);
+	u32 triangleCount = vertices.size() / 3;
+	for (u32 i = triangleCount - 1; i > 0; --i)
+	{
+		u32 j = generator.mt() % (i + 1);
+		for (u32 k = 0; k < 3; ++k)
+		{
+			Vertex tmp = vertices[i * 3 + k];
+			vertices[i * 3 + k] = vertices[j * 3 + k];
+			vertices[j * 3 + k] = tmp;
+		}
+	}
+
+	// Welding
+	DataArray<Vertex> sourceVertices(&defaultAllocator());
+	sourceVertices.push_back(vertices.data(), vertices.size());
+	DataArray<u32> indices(&defaultAllocator());
+	indices.resize(vertices.size());
+	u32 vertexCount = mesh_cooking::weldVertices(vertices.data(), vertices.size(), indices.data());
+	TEST(vertexCount == (GRID_SIZE + 1) * (GRID_SIZE + 1));
+	for (u32 i = 0; i < indices.size(); ++i)
+	{
+		TEST(memcmp(&vertices[indices[i]], &sourceVertices[i], sizeof(Vertex)) == 0);
+	}
+	{
+		// Vertices one bit apart stay apart
+		Vertex close[3] = { sourceVertices[0], sourceVertices[0], sourceVertices[0] };
+		u32 bits;
+		memcpy(&bits, &close[1].pos.x, sizeof(bits));
+		bits ^= 1;
+		memcpy(&close[1].pos.x, &bits, sizeof(bits));
+		u32 remap[3];
+		TEST(mesh_cooking::weldVertices(close, 3, remap) == 2);
+		TEST(remap[0] == 0 && remap[1] == 1 && remap[2] == 0);
+	}
+
+	// Vertex cache
+	mesh_cooking::VertexCacheStatistics sourceStatistics = mesh_cooking::analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+	TEST(sourceStatistics.acmr > 1.5f);
+	u64 trianglesHash = sortedTrianglesHash(indices.data(), indices.size());
+	mesh_cooking::optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+	TEST(sortedTrianglesHash(indices.data(), indices.size()) == trianglesHash);
+	mesh_cooking::VertexCacheStatistics statistics = mesh_cooking::analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+	TEST(statistics.acmr < 0.8f);
+	TEST(statistics.atvr < sourceStatistics.atvr);
+
+	// Overdraw keeps the triangles
+	DataArray<u32> overdrawIndices(&defaultAllocator());
+	overdrawIndices.push_back(indices.data(), indices.size());
+	mesh_cooking::optimizeOverdraw(overdrawIndices.data(), overdrawIndices.size(), vertices.data(), vertexCount);
+	TEST(sortedTrianglesHash(overdrawIndices.data(), overdrawIndices.size()) == trianglesHash);
+
+	// Vertex fetch: vertices in first use order, unreferenced ones dropped
+	DataArray<Vertex> cachedVertices(&defaultAllocator());
+	cachedVertices.push_back(vertices.data(), vertexCount);
+	DataArray<u32> cachedIndices(&defaultAllocator());
+	cachedIndices.push_back(indices.data(), indices.size());
+	vertices[vertexCount] = vertices[0];
+	TEST(mesh_cooking::optimizeVertexFetch(vertices.data(), vertexCount + 1, indices.data(), indices.size()) == vertexCount);
+	u32 nextVertex = 0;
+	for (u32 i = 0; i < indices.size(); ++i)
+	{
+		TEST(indices[i] <= nextVertex);
+		if (indices[i] == nextVertex)
+		{
+			++nextVertex;
+		}
+		TEST(memcmp(&vertices[indices[i]], &cachedVertices[cachedIndices[i]], sizeof(Vertex)) == 0);
+	}
+	TEST(mesh_cooking::analyzeVertexCache(indices.data(), indices.size(), vertexCount).acmr == statistics.acmr);
+
+	// Cooked container
+	DataArray<u8> cooked(&defaultAllocator());
+	mesh_cooking::cookMesh(vertices.data(), vertexCount, indices.data(), indices.size(), sourceStatistics, 0x1234, cooked);
+	mesh_cooking::CookedMesh mesh;
+	TEST(mesh_cooking::readCookedMesh(cooked.data(), cooked.size(), mesh));
+	TEST(mesh.sourceHash == 0x1234);
+	TEST(mesh.vertexCount == vertexCount && memcmp(mesh.vertices, vertices.data(), vertexCount * sizeof(Vertex)) == 0);
+	TEST(mesh.indexCount == indices.size() && memcmp(mesh.indices, indices.data(), indices.size() * sizeof(u32)) == 0);
+	TEST(mesh.sourceStatistics.acmr == sourceStatistics.acmr);
+	TEST(mesh.statistics.acmr == statistics.acmr);
+	TEST(!mesh_cooking::readCookedMesh(cooked.data(), cooked.size() - 1, mesh));
+	memcpy(cooked.data() + cooked.size() - sizeof(u32), &vertexCount, sizeof(u32)); // out of range index
+	TEST(!mesh_cooking::readCookedMesh(cooked.data(), cooked.size(), mesh));
+}
+
+void testTextureCooking()
+{
+	TEST(texture_cooking::getMipCount(1, 1) == 1);
+	TEST(texture_cooking::getMipCount(256, 128) == 9);
+	TEST(texture_cooking::getMipCount(5, 3) == 3);
+	TEST(texture_cooking::getImageSize(TextureFormat::RGBA8, 5, 3) == 60);
+	TEST(texture_cooking::getImageSize(TextureFormat::BC1, 5, 3) == 16);
+	TEST(texture_cooking::getImageSize(TextureFormat::BC3, 1, 1) == 16);
+
+	// Box filter, odd sizes clamp to the last row and column
+	{
+		u8 source[3 * 2 * 4] = {
+			0, 0, 0, 255,    100, 0, 0, 255,  40, 0, 0, 255,
+			200, 0, 0, 255,  100, 0, 0, 255,  40, 0, 0, 255,
+		};
+		u8 mip[4];
+		texture_cooking::downsample(source, 3, 2, mip);
+		TEST(mip[0] == 100 && mip[3] == 255);
+		TEST(!texture_cooking::hasAlpha(source, 3, 2));
+	}
+
+	// Block compression round trips
+	const u32 SIZE = 16;
+	u8 pixels[SIZE * SIZE * 4];
+	u8 decoded[SIZE * SIZE * 4];
+	u8 blocks[SIZE * SIZE];
+	for (u32 y = 0; y < SIZE; ++y)
+	{
+		for (u32 x = 0; x < SIZE; ++x)
+		{
+			u8* pixel = pixels + (y * SIZE + x) * 4;
+			// Anti-correlated red and green, the usual worst case for a poorly chosen axis
+			pixel[0] = u8(x * 16);
+			pixel[1] = u8(255 - x * 16);
+			pixel[2] = u8(y * 4);
+			pixel[3] = u8(y * 16);
+		}
+	}
+	TEST(texture_cooking::hasAlpha(pixels, SIZE, SIZE));
+
+	texture_cooking::compressImage(TextureFormat::BC1, pixels, SIZE, SIZE, blocks);
+	texture_cooking::decompressImage(TextureFormat::BC1, blocks, SIZE, SIZE, decoded);
+	TEST(maxChannelError(pixels, decoded, SIZE * SIZE, 0, 3) <= 12);
+
+	texture_cooking::compressImage(TextureFormat::BC3, pixels, SIZE, SIZE, blocks);
+	texture_cooking::decompressImage(TextureFormat::BC3, blocks, SIZE, SIZE, decoded);
+	TEST(maxChannelError(pixels, decoded, SIZE * SIZE, 0, 3) <= 12);
+	TEST(maxChannelError(pixels, decoded, SIZE * SIZE, 3, 1) <= 4);
+
+	// Colors exactly representable in 565 are kept
+	{
+		u8 solid[4 * 4 * 4];
+		for (u32 i = 0; i < 16; ++i)
+		{
+			solid[i * 4 + 0] = 255;
+			solid[i * 4 + 1] = 0;
+			solid[i * 4 + 2] = 255;
+			solid[i * 4 + 3] = 255;
+		}
+		texture_cooking::compressImage(TextureFormat::BC1, solid, 4, 4, blocks);
+		texture_cooking::decompressImage(TextureFormat::BC1, blocks, 4, 4, decoded);
+		TEST(maxChannelError(solid, decoded, 16, 0, 4) == 0);
+	}
+
+	// Cooked container
+	{
+		DataArray<u8> cooked(&toolAllocator());
+		texture_cooking::cookTexture(pixels, SIZE, 8, TextureFormat::RGBA8, true, 0x1234, cooked);
+
+		texture_cooking::CookedTexture texture;
+		TEST(texture_cooking::readCookedTexture(cooked.data(), cooked.size(), texture));
+		TEST(texture.format == TextureFormat::RGBA8);
+		TEST(texture.width == SIZE && texture.height == 8);
+		TEST(texture.sourceHash == 0x1234);
+		TEST(texture.mipCount == 5);
+		TEST(texture.mips[0].size == SIZE * 8 * 4 && memcmp(texture.mips[0].data, pixels, texture.mips[0].size) == 0);
+		TEST(texture.mips[4].size == 4);
+
+		texture_cooking::cookTexture(pixels, SIZE, SIZE, TextureFormat::BC1, false, 0, cooked);
+		TEST(texture_cooking::readCookedTexture(cooked.data(), cooked.size(), texture));
+		TEST(texture.format == TextureFormat::BC1 && texture.mipCount == 1);
+
+		TEST(!texture_cooking::readCookedTexture(cooked.data(), cooked.size() - 1, texture));
+		cooked[0] = 0;
+		TEST(!texture_cooking::readCookedTexture(cooked.data(), cooked.size(), texture));
+	}
+}
+
+void benchmarkRadixSort()
+{
+	const u32 COUNTS[] = { 1000, 10000, 100000 };
+	const u32 ITERATION_COUNT = 20;
+
+	for (u32 count : COUNTS)
+	{
+		RandomGenerator generator(count);
+		DataArray<u64> sourceKeys(&defaultAllocator());
+		DataArray<u64> keys(&defaultAllocator());
+		DataArray<u32> values(&defaultAllocator());
+		DataArray<u64> tmpKeys(&defaultAllocator());
+		DataArray<u32> tmpValues(&defaultAllocator());
+		DataArray<KeyValue> pairs(&defaultAllocator());
+		sourceKeys.resize(count);
+		keys.resize(count);
+		values.resize(count);
+		tmpKeys.resize(count);
+		tmpValues.resize(count);
+		pairs.resize(count);
+
+		// Typical scene: few shaders, some textures, many meshes and depths
+		for (u32 i = 0; i < count; ++i)
+		{
+			sourceKeys[i] = sorting::makeDrawKey(RenderPass::SOLID, generator.mt() % 8, generator.mt() % 64, random::range(generator, 0.f, 1.f), generator.mt() % 1024);
+		}
+
+		Clock clock;
+		clock.reset();
+		for (u32 iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+		{
+			memcpy(keys.data(), sourceKeys.data(), count * sizeof(u64));
+			for (u32 i = 0; i < count; ++i)
+			{
+				values[i] = i;
+			}
+			sorting::radixSort(keys.data(), values.data(), count, tmpKeys.data(), tmpValues.data());
+		}
+		float radixTime = clock.reset().asMilliSeconds() / float(ITERATION_COUNT);
+
+		for (u32 iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+		{
+			for (u32 i = 0; i < count; ++i)
+			{
+				pairs[i] = { sourceKeys[i], i };
+			}
+			std::sort(pairs.begin(), pairs.end());
+		}
+		float comparisonTime = clock.reset().asMilliSeconds() / float(ITERATION_COUNT);
+
+		YAE_LOGF_CAT(benchmark, "sort %d draw keys: radix %.3fms, std::sort %.3fms", count, radixTime, comparisonTime);
+	}
+}
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <yae/types.h>
+
+namespace yae {
+namespace test {
+
+void testDrawSortKeys();
+void testRadixSort();
+void testStreamArray();
+void testRangeAllocator();
+void testTextureCooking();
+void testUtf8Decoding();
+void testGlyphRunCache();
+void testVertexFormat();
+void testMeshCooking();
+
+void benchmarkRadixSort();
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,422 @@
+#include "spatial_test.h"
+
+#include <core/time.h>
+#include <yae/DynamicBVH.h>
+#include <yae/random.h>
+#include <yae/rendering/culling.h>
+#include <yae/RandomGenerator.h>
+
+#include <yae/test/test_macros.h>
+
+#include <algorithm>
+
+namespace yae {
+namespace test {
+
+static AABB randomBounds(RandomGenerator& _generator, float _worldExtent, float _maxHalfSize)
+{
+	Vector3 center(
+		random::range(_generator, -_worldExtent, _worldExtent),
+		random::range(_generator, -_worldExtent, _worldExtent),
+		random::range(_generator, -_worldExtent, _worldExtent)
+	);
+	Vector3 halfSize(
+		random::range(_generator, .1f, _maxHalfSize),
+		random::range(_generator, .1f, _maxHalfSize),
+		random::range(_generator, .1f, _maxHalfSize)
+	);
+	return AABB(center - halfSize, center + halfSize);
+}
+
+static Frustum boxFrustum(const AABB& _box)
+{
+	Frustum frustum;
+	frustum.planes[Frustum::PLANE_LEFT] = Vector4(1.f, 0.f, 0.f, -_box.min.x);
+	frustum.planes[Frustum::PLANE_RIGHT] = Vector4(-1.f, 0.f, 0.f, _box.max.x);
+	frustum.planes[Frustum::PLANE_BOTTOM] = Vector4(0.f, 1.f, 0.f, -_box.min.y);
+	frustum.planes[Frustum::PLANE_TOP] = Vector4(0.f, -1.f, 0.f, _box.max.y);
+	frustum.planes[Frustum::PLANE_NEAR] = Vector4(0.f, 0.f, 1.f, -_box.min.z);
+	frustum.planes[Frustum::PLANE_FAR] = Vector4(0.f, 0.f, -1.f, _box.max.z);
+	return frustum;
+}
+
+static bool sameProxies(DataArray<u32>& _a, DataArray<u32>& _b)
+{
+	std::sort(_a.begin(), _a.end());
+	std::sort(_b.begin(), _b.end());
+	return _a == _b;
+}
+
+void testBounds()
+{
+	AABB box(Vector3(-1.f), Vector3(1.f));
+	TEST(math::isValid(box));
+	TEST(!math::isValid(AABB::EMPTY()));
+	AABB merged = math::merge(AABB::EMPTY(), box);
+	TEST(merged.min == box.min && merged.max == box.max);
+	TEST(math::contains(box, Vector3::ZERO()));
+	TEST(!math::contains(box, Vector3(2.f, 0.f, 0.f)));
+	TEST(math::overlaps(box, AABB(Vector3(.5f), Vector3(3.f))));
+	TEST(!math::overlaps(box, AABB(Vector3(1.5f), Vector3(3.f))));
+	TEST(math::overlaps(box, Sphere(Vector3(2.f, 0.f, 0.f), 1.5f)));
+	TEST(!math::overlaps(box, Sphere(Vector3(2.f, 2.f, 0.f), 1.f)));
+
+	// 90 degrees rotation around Y, then translation
+	Matrix4 matrix(
+		Vector4(0.f, 0.f, -1.f, 0.f),
+		Vector4(0.f, 1.f, 0.f, 0.f),
+		Vector4(1.f, 0.f, 0.f, 0.f),
+		Vector4(10.f, 0.f, 0.f, 1.f)
+	);
+	AABB transformed = math::transform(AABB(Vector3(0.f), Vector3(2.f, 1.f, 1.f)), matrix);
+	TEST(transformed.min == Vector3(10.f, 0.f, -2.f) && transformed.max == Vector3(11.f, 1.f, 0.f));
+
+	float distance = 0.f;
+	TEST(math::raycast(Ray(Vector3(-5.f, 0.f, 0.f), Vector3(1.f, 0.f, 0.f)), box, 100.f, distance));
+	TEST(distance == 4.f);
+	TEST(!math::raycast(Ray(Vector3(-5.f, 0.f, 0.f), Vector3(-1.f, 0.f, 0.f)), box, 100.f, distance));
+	TEST(!math::raycast(Ray(Vector3(-5.f, 0.f, 0.f), Vector3(1.f, 0.f, 0.f)), box, 3.f, distance));
+	TEST(math::raycast(Ray(Vector3::ZERO(), Vector3(0.f, 1.f, 0.f)), box, 100.f, distance));
+	TEST(distance == 0.f);
+
+	// OpenGL perspective, 90 degrees fov, looking down -Z, near 1, far 100
+	const float n = 1.f;
+	const float f = 100.f;
+	Matrix4 projection(
+		Vector4(1.f, 0.f, 0.f, 0.f),
+		Vector4(0.f, 1.f, 0.f, 0.f),
+		Vector4(0.f, 0.f, -(f + n) / (f - n), -1.f),
+		Vector4(0.f, 0.f, -2.f * f * n / (f - n), 0.f)
+	);
+	Frustum frustum = Frustum::FromViewProjection(projection);
+	TEST(math::test(frustum, AABB(Vector3(-1.f, -1.f, -11.f), Vector3(1.f, 1.f, -9.f))) == math::FrustumTest::INSIDE);
+	TEST(math::test(frustum, AABB(Vector3(9.f, -1.f, -11.f), Vector3(11.f, 1.f, -9.f))) == math::FrustumTest::INTERSECTS);
+	TEST(math::test(frustum, AABB(Vector3(-1.f, -1.f, 9.f), Vector3(1.f, 1.f, 11.f))) == math::FrustumTest::OUTSIDE);
+	TEST(math::test(frustum, AABB(Vector3(-1.f, -1.f, -201.f), Vector3(1.f, 1.f, -199.f))) == math::FrustumTest::OUTSIDE);
+	TEST(math::overlaps(frustum, Sphere(Vector3(0.f, 0.f, -50.f), 1.f)));
+	TEST(!math::overlaps(frustum, Sphere(Vector3(0.f, 60.f, -50.f), 1.f)));
+}
+
+void testDynamicBVH()
+{
+	const u32 PROXY_COUNT = 2000;
+	const u32 QUERY_COUNT = 50;
+	const float WORLD_EXTENT = 100.f;
+
+	RandomGenerator generator(42);
+	DynamicBVH bvh(&toolAllocator());
+	DataArray<AABB> bounds(&toolAllocator());
+	DataArray<u32> proxies(&toolAllocator());
+	DataArray<bool> alive(&toolAllocator());
+	for (u32 i = 0; i < PROXY_COUNT; ++i)
+	{
+		bounds.push_back(randomBounds(generator, WORLD_EXTENT, 2.f));
+		proxies.push_back(bvh.createProxy(bounds[i], i));
+		alive.push_back(true);
+	}
+	TEST(bvh.getProxyCount() == PROXY_COUNT);
+	TEST(bvh.validate());
+
+	// Every query is checked against a brute force pass over the same bounds
+	auto checkQueries = [&]()
+	{
+		DataArray<u32> result(&toolAllocator());
+		DataArray<u32> expected(&toolAllocator());
+		for (u32 query = 0; query < QUERY_COUNT; ++query)
+		{
+			AABB box = math::inflate(randomBounds(generator, WORLD_EXTENT, 2.f), random::range(generator, 0.f, 20.f));
+			result.clear();
+			expected.clear();
+			bvh.queryAABB(box, result);
+			for (u32 i = 0; i < PROXY_COUNT; ++i)
+			{
+				if (alive[i] && math::overlaps(bounds[i], box))
+					expected.push_back(proxies[i]);
+			}
+			TEST(sameProxies(result, expected));
+
+			Sphere sphere(math::center(box), random::range(generator, 1.f, 30.f));
+			result.clear();
+			expected.clear();
+			bvh.querySphere(sphere, result);
+			for (u32 i = 0; i < PROXY_COUNT; ++i)
+			{
+				if (alive[i] && math::overlaps(bounds[i], sphere))
+					expected.push_back(proxies[i]);
+			}
+			TEST(sameProxies(result, expected));
+
+			result.clear();
+			expected.clear();
+			bvh.queryFrustum(boxFrustum(box), result);
+			for (u32 i = 0; i < PROXY_COUNT; ++i)
+			{
+				if (alive[i] && math::overlaps(bounds[i], box))
+					expected.push_back(proxies[i]);
+			}
+			TEST(sameProxies(result, expected));
+
+			Ray ray(
+				Vector3(random::range(generator, -WORLD_EXTENT, WORLD_EXTENT), random::range(generator, -WORLD_EXTENT, WORLD_EXTENT), -2.f * WORLD_EXTENT),
+				math::normalize(Vector3(random::range(generator, -.5f, .5f), random::range(generator, -.5f, .5f), 1.f))
+			);
+			BVHRaycastHit hit;
+			bool hasHit = bvh.raycast(ray, 4.f * WORLD_EXTENT, hit);
+			float closestDistance = 4.f * WORLD_EXTENT;
+			bool expectedHit = false;
+			for (u32 i = 0; i < PROXY_COUNT; ++i)
+			{
+				float distance;
+				if (alive[i] && math::raycast(ray, bounds[i], closestDistance, distance))
+				{
+					closestDistance = distance;
+					expectedHit = true;
+				}
+			}
+			TEST(hasHit == expectedHit);
+			TEST(!hasHit || math::isZero(hit.distance - closestDistance));
+
+			const u32 K = 8;
+			Vector3 point = math::center(box);
+			result.clear();
+			bvh.queryKNearest(point, K, result);
+			DataArray<float> distances(&toolAllocator());
+			for (u32 i = 0; i < PROXY_COUNT; ++i)
+			{
+				if (alive[i])
+					distances.push_back(math::distanceSquared(bounds[i], point));
+			}
+			std::sort(distances.begin(), distances.end());
+			TEST(result.size() == K);
+			for (u32 i = 0; i < result.size(); ++i)
+			{
+				u32 index = u32(bvh.getUserData(result[i]));
+				TEST(math::isZero(math::distanceSquared(bounds[index], point) - distances[i]));
+			}
+		}
+	};
+	checkQueries();
+
+	// Destroy and recreate a third of the proxies
+	for (u32 i = 0; i < PROXY_COUNT; i += 3)
+	{
+		bvh.destroyProxy(proxies[i]);
+		alive[i] = false;
+	}
+	TEST(bvh.validate());
+	checkQueries();
+	for (u32 i = 0; i < PROXY_COUNT; i += 3)
+	{
+		proxies[i] = bvh.createProxy(bounds[i], i);
+		alive[i] = true;
+	}
+	TEST(bvh.validate());
+
+	// Incremental moves
+	for (u32 frame = 0; frame < 10; ++frame)
+	{
+		for (u32 i = 0; i < PROXY_COUNT; i += 7)
+		{
+			Vector3 offset(random::range(generator, -3.f, 3.f), random::range(generator, -3.f, 3.f), random::range(generator, -3.f, 3.f));
+			bounds[i] = AABB(bounds[i].min + offset, bounds[i].max + offset);
+			bvh.moveProxy(proxies[i], bounds[i]);
+		}
+	}
+	TEST(bvh.validate());
+	checkQueries();
+
+	// Bulk update followed by a refit, then a full rebuild
+	for (u32 i = 0; i < PROXY_COUNT; i += 2)
+	{
+		Vector3 offset(random::range(generator, -3.f, 3.f), random::range(generator, -3.f, 3.f), random::range(generator, -3.f, 3.f));
+		bounds[i] = AABB(bounds[i].min + offset, bounds[i].max + offset);
+		bvh.setProxyBounds(proxies[i], bounds[i]);
+	}
+	bvh.refit();
+	TEST(bvh.validate());
+	checkQueries();
+
+	bvh.rebuild();
+	TEST(bvh.validate());
+	checkQueries();
+
+	for (u32 i = 0; i < PROXY_COUNT; ++i)
+	{
+		TEST(bvh.getUserData(proxies[i]) == i);
+		bvh.destroyProxy(proxies[i]);
+	}
+	TEST(bvh.getProxyCount() == 0);
+	TEST(bvh.validate());
+}
+
+void testCulling()
+{
+	// Odd count so that both the batched and the remainder paths are exercised
+	const u32 BOUNDS_COUNT = 1023;
+
+	RandomGenerator generator(7);
+	DataArray<float> storage(&toolAllocator());
+	storage.resize(BOUNDS_COUNT * 6);
+	culling::BoundsStream bounds;
+	bounds.centerX = storage.data();
+	bounds.centerY = bounds.centerX + BOUNDS_COUNT;
+	bounds.centerZ = bounds.centerY + BOUNDS_COUNT;
+	bounds.extentX = bounds.centerZ + BOUNDS_COUNT;
+	bounds.extentY = bounds.extentX + BOUNDS_COUNT;
+	bounds.extentZ = bounds.extentY + BOUNDS_COUNT;
+
+	DataArray<AABB> worldBounds(&toolAllocator());
+	for (u32 i = 0; i < BOUNDS_COUNT; ++i)
+	{
+		AABB localBounds = randomBounds(generator, 1.f, 2.f);
+		Matrix4 transform(
+			Vector4(0.f, 0.f, -2.f, 0.f),
+			Vector4(0.f, 1.f, 0.f, 0.f),
+			Vector4(1.f, 0.f, 0.f, 0.f),
+			Vector4(random::range(generator, -50.f, 50.f), random::range(generator, -50.f, 50.f), random::range(generator, -150.f, 50.f), 1.f)
+		);
+		culling::storeBounds(localBounds, transform, bounds, i);
+		worldBounds.push_back(math::transform(localBounds, transform));
+	}
+
+	const float n = 1.f;
+	const float f = 100.f;
+	Matrix4 projection(
+		Vector4(1.f, 0.f, 0.f, 0.f),
+		Vector4(0.f, 1.f, 0.f, 0.f),
+		Vector4(0.f, 0.f, -(f + n) / (f - n), -1.f),
+		Vector4(0.f, 0.f, -2.f * f * n / (f - n), 0.f)
+	);
+	Frustum frustums[] = { Frustum::FromViewProjection(projection), boxFrustum(AABB(Vector3(-20.f), Vector3(20.f))) };
+
+	DataArray<u32> masks(&toolAllocator());
+	masks.resize(BOUNDS_COUNT, 0);
+	for (u32 i = 0; i < countof(frustums); ++i)
+	{
+		culling::cullBounds(frustums[i], bounds, BOUNDS_COUNT, 1u << i, masks.data());
+	}
+
+	u32 visibleCount = 0;
+	for (u32 i = 0; i < BOUNDS_COUNT; ++i)
+	{
+		u32 expectedMask = 0;
+		for (u32 j = 0; j < countof(frustums); ++j)
+		{
+			if (math::overlaps(frustums[j], worldBounds[i]))
+				expectedMask |= 1u << j;
+		}
+		TEST(masks[i] == expectedMask);
+		visibleCount += masks[i] != 0 ? 1 : 0;
+	}
+	TEST(visibleCount > 0 && visibleCount < BOUNDS_COUNT);
+}
+
+void benchmarkDynamicBVH()
+{
+	const u32 PROXY_COUNTS[] = { 10000, 100000, 1000000 };
+	const u32 FRAME_COUNT = 10;
+	const u32 QUERY_COUNT = 1000;
+
+	for (u32 proxyCount : PROXY_COUNTS)
+	{
+		// Keep the density constant so that queries return a similar amount of proxies whatever the count
+		const float worldExtent = 50.f * std::cbrt(float(proxyCount) / 10000.f);
+		RandomGenerator generator(proxyCount);
+		DynamicBVH bvh(&defaultAllocator());
+		DataArray<AABB> bounds(&defaultAllocator());
+		DataArray<u32> proxies(&defaultAllocator());
+		bounds.reserve(proxyCount);
+		proxies.reserve(proxyCount);
+		Clock clock;
+
+		YAE_LOGF_CAT(benchmark, "- %d proxies -", proxyCount);
+
+		clock.reset();
+		for (u32 i = 0; i < proxyCount; ++i)
+		{
+			bounds.push_back(randomBounds(generator, worldExtent, 1.f));
+			proxies.push_back(bvh.createProxy(bounds[i], i));
+		}
+		YAE_LOGF_CAT(benchmark, "incremental insertion: %.2fms (height %d, area ratio %.1f)", clock.reset().asMilliSeconds(), bvh.getHeight(), bvh.getAreaRatio());
+
+		clock.reset();
+		bvh.rebuild();
+		YAE_LOGF_CAT(benchmark, "rebuild: %.2fms (height %d, area ratio %.1f)", clock.reset().asMilliSeconds(), bvh.getHeight(), bvh.getAreaRatio());
+
+		// 10% of the proxies move every frame
+		const u32 movingCount = proxyCount / 10;
+		auto moveSubset = [&](bool _inPlace)
+		{
+			for (u32 i = 0; i < movingCount; ++i)
+			{
+				u32 index = (i * 7919) % proxyCount;
+				Vector3 offset(random::range(generator, -.5f, .5f), random::range(generator, -.5f, .5f), random::range(generator, -.5f, .5f));
+				bounds[index] = AABB(bounds[index].min + offset, bounds[index].max + offset);
+				if (_inPlace)
+					bvh.setProxyBounds(proxies[index], bounds[index]);
+				else
+					bvh.moveProxy(proxies[index], bounds[index]);
+			}
+		};
+
+		clock.reset();
+		for (u32 frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			moveSubset(false);
+		}
+		YAE_LOGF_CAT(benchmark, "move %d proxies (reinsertion): %.2fms/frame", movingCount, clock.reset().asMilliSeconds() / float(FRAME_COUNT));
+
+		for (u32 frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			moveSubset(true);
+			bvh.refit();
+		}
+		YAE_LOGF_CAT(benchmark, "move %d proxies (refit): %.2fms/frame", movingCount, clock.reset().asMilliSeconds() / float(FRAME_COUNT));
+
+		DataArray<u32> result(&defaultAllocator());
+		u32 resultCount = 0;
+		clock.reset();
+		for (u32 i = 0; i < QUERY_COUNT; ++i)
+		{
+			result.clear();
+			resultCount += bvh.queryAABB(math::inflate(bounds[i], 5.f), result);
+		}
+		YAE_LOGF_CAT(benchmark, "%d aabb queries: %.2fms (%d results)", QUERY_COUNT, clock.reset().asMilliSeconds(), resultCount);
+
+		resultCount = 0;
+		for (u32 i = 0; i < QUERY_COUNT; ++i)
+		{
+			result.clear();
+			resultCount += bvh.querySphere(Sphere(math::center(bounds[i]), 5.f), result);
+		}
+		YAE_LOGF_CAT(benchmark, "%d sphere queries: %.2fms (%d results)", QUERY_COUNT, clock.reset().asMilliSeconds(), resultCount);
+
+		resultCount = 0;
+		for (u32 i = 0; i < QUERY_COUNT; ++i)
+		{
+			BVHRaycastHit hit;
+			Ray ray(math::center(bounds[i]) - Vector3(0.f, 0.f, 2.f * worldExtent), Vector3(0.f, 0.f, 1.f));
+			resultCount += bvh.raycast(ray, 4.f * worldExtent, hit) ? 1 : 0;
+		}
+		YAE_LOGF_CAT(benchmark, "%d raycasts: %.2fms (%d hits)", QUERY_COUNT, clock.reset().asMilliSeconds(), resultCount);
+
+		resultCount = 0;
+		for (u32 i = 0; i < QUERY_COUNT; ++i)
+		{
+			result.clear();
+			resultCount += bvh.queryKNearest(math::center(bounds[i]), 16, result);
+		}
+		YAE_LOGF_CAT(benchmark, "%d k-nearest queries (k=16): %.2fms", QUERY_COUNT, clock.reset().asMilliSeconds());
+
+		resultCount = 0;
+		for (u32 i = 0; i < QUERY_COUNT / 10; ++i)
+		{
+			result.clear();
+			resultCount += bvh.queryFrustum(boxFrustum(math::inflate(bounds[i], .25f * worldExtent)), result);
+		}
+		YAE_LOGF_CAT(benchmark, "%d frustum queries: %.2fms (%d results)", QUERY_COUNT / 10, clock.reset().asMilliSeconds(), resultCount);
+	}
+}
+
+} // namespace test
+} // namespace yae
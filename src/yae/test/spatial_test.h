@@ -0,0 +1,15 @@
+#pragma once
+
+#include <yae/types.h>
+
+namespace yae {
+namespace test {
+
+void testBounds();
+void testDynamicBVH();
+void testCulling();
+
+void benchmarkDynamicBVH();
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,246 @@
+#include "string_test.h"
+
+#include <core/StringBuilder.h>
+#include <core/StringPool.h>
+#include <core/string.h>
+#include <core/time.h>
+
+#include <yae/test/test_macros.h>
+
+#include <climits>
+#include <thread>
+
+namespace yae {
+namespace test {
+
+void testStringPool()
+{
+	// Empty strings are not stored
+	TEST(InternedString().isEmpty());
+	TEST(InternedString("").isEmpty());
+	TEST(strcmp(InternedString().c_str(), "") == 0);
+	TEST(InternedString().size() == 0);
+
+	InternedString a = "data/textures/test.png";
+	InternedString b = String("data/textures/test.png", &scratchAllocator());
+	InternedString c = "data/textures/test.PNG";
+	TEST(!a.isEmpty());
+	TEST(a == b);
+	TEST(a != c);
+	TEST(a.getID() == b.getID());
+	TEST(strcmp(a.c_str(), "data/textures/test.png") == 0);
+	TEST(a.size() == strlen("data/textures/test.png"));
+	TEST(InternedString::Find("data/textures/test.png") == a);
+	TEST(InternedString::Find("data/textures/never_interned.png").isEmpty());
+
+	// Ids and pointers stay valid while the pool grows
+	const u32 STRING_COUNT = 20000;
+	u32 previousCount = stringPool().getStringCount();
+	DataArray<InternedString> strings(&scratchAllocator());
+	DataArray<const char*> pointers(&scratchAllocator());
+	for (u32 i = 0; i < STRING_COUNT; ++i)
+	{
+		InternedString string = string::format("string_pool_test/%d", i).c_str();
+		strings.push_back(string);
+		pointers.push_back(string.c_str());
+	}
+	TEST(stringPool().getStringCount() == previousCount + STRING_COUNT);
+	for (u32 i = 0; i < STRING_COUNT; i += 97)
+	{
+		String expected = string::format("string_pool_test/%d", i);
+		TEST(strings[i].c_str() == pointers[i]);
+		TEST(strcmp(strings[i].c_str(), expected.c_str()) == 0);
+		TEST(InternedString(expected) == strings[i]);
+	}
+
+	// Strings longer than a page
+	{
+		String longString(&scratchAllocator());
+		longString.resize(StringPool::PAGE_SIZE + 100, 'x');
+		InternedString longName = longString;
+		InternedString shortName = "string_pool_test/after_long";
+		TEST(longName.size() == longString.size());
+		TEST(strcmp(longName.c_str(), longString.c_str()) == 0);
+		TEST(InternedString(longString) == longName);
+		TEST(strcmp(shortName.c_str(), "string_pool_test/after_long") == 0);
+	}
+
+#if YAE_PLATFORM_WEB == 0
+	// Threads interning the same names get the same ids
+	{
+		const u32 THREAD_COUNT = 4;
+		const u32 NAME_COUNT = 2000;
+		DataArray<u32> ids(&scratchAllocator());
+		ids.resize(THREAD_COUNT * NAME_COUNT, 0);
+		std::thread threads[THREAD_COUNT];
+		for (u32 t = 0; t < THREAD_COUNT; ++t)
+		{
+			threads[t] = std::thread([t, &ids]()
+			{
+				for (u32 i = 0; i < NAME_COUNT; ++i)
+				{
+					char name[64];
+					snprintf(name, sizeof(name), "string_pool_thread_test/%u", (i + t * 17) % NAME_COUNT);
+					ids[t * NAME_COUNT + (i + t * 17) % NAME_COUNT] = stringPool().intern(name, u32(strlen(name)));
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (u32 i = 0; i < NAME_COUNT; ++i)
+		{
+			for (u32 t = 1; t < THREAD_COUNT; ++t)
+			{
+				TEST(ids[t * NAME_COUNT + i] == ids[i]);
+			}
+			TEST(ids[i] == InternedString(string::format("string_pool_thread_test/%d", i)).getID());
+		}
+	}
+#endif
+}
+
+void testStringBuilder()
+{
+	StringBuilder builder(&scratchAllocator());
+	TEST(builder.size() == 0);
+	TEST(strcmp(builder.c_str(), "") == 0);
+
+	builder.append("abc").append('d').append(String("ef", &scratchAllocator())).appendRepeated('-', 3);
+	TEST(strcmp(builder.c_str(), "abcdef---") == 0);
+	TEST(builder.size() == 9);
+
+	// Integers
+	auto toString = [&builder](auto _write) -> const char*
+	{
+		builder.clear();
+		_write(builder);
+		return builder.c_str();
+	};
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendInteger(0); }), "0") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendInteger(-7); }), "-7") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendInteger(1234567890); }), "1234567890") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendInteger(LLONG_MIN); }), "-9223372036854775808") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendUnsigned(ULLONG_MAX); }), "18446744073709551615") == 0);
+	for (i64 value = -100000; value <= 100000; value += 7)
+	{
+		char expected[32];
+		snprintf(expected, sizeof(expected), "%lld", (long long)value);
+		TEST(strcmp(toString([value](StringBuilder& _b) { _b.appendInteger(value); }), expected) == 0);
+	}
+
+	// Floats
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(0.0); }), "0") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(1.5); }), "1.5") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(0.1f); }), "0.1") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(-2.25, 3); }), "-2.250") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(3.14159, 2); }), "3.14") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(9.999, 2); }), "10.00") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(42.0, 0); }), "42") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(2.5e20, 2); }), "2.50e+20") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(1.0 / 0.0); }), "inf") == 0);
+	TEST(strcmp(toString([](StringBuilder& _b) { _b.appendFloat(0.0 / 0.0); }), "nan") == 0);
+	for (i32 i = -2000; i <= 2000; ++i)
+	{
+		double value = double(i) * 0.37 + 0.001;
+		char expected[32];
+		snprintf(expected, sizeof(expected), "%.2f", value);
+		TEST(strcmp(toString([value](StringBuilder& _b) { _b.appendFloat(value, 2); }), expected) == 0);
+	}
+
+	// Formatting
+	builder.clear();
+	builder.format("{}: {} {} {} {.1}ms {{{}}}", "name", -3, 42u, true, 1.26f, 'x');
+	TEST(strcmp(builder.c_str(), "name: -3 42 true 1.3ms {x}") == 0);
+	builder.clear();
+	builder.format("no arguments");
+	TEST(strcmp(builder.c_str(), "no arguments") == 0);
+	builder.clear();
+	builder.format("{}{}", u8(200), i8(-100));
+	TEST(strcmp(builder.c_str(), "200-100") == 0);
+
+	// Starts in the given buffer, then grows in the allocator
+	char buffer[8];
+	StringBuilder stackBuilder(buffer, sizeof(buffer), &scratchAllocator());
+	stackBuilder.append("1234567");
+	TEST(stackBuilder.c_str() == buffer);
+	stackBuilder.append("89");
+	TEST(stackBuilder.c_str() != buffer);
+	for (u32 i = 0; i < 1000; ++i)
+	{
+		stackBuilder.appendUnsigned(i % 10);
+	}
+	TEST(stackBuilder.size() == 1009);
+	TEST(strncmp(stackBuilder.c_str(), "1234567890123", 13) == 0);
+	TEST(stackBuilder.toString(&scratchAllocator()).size() == 1009);
+}
+
+void benchmarkStringBuilder()
+{
+	// Profiler dump like output: a formatted line per event
+	const u32 LINE_COUNT = 100000;
+
+	auto measure = [](auto _function)
+	{
+		Clock clock;
+		clock.reset();
+		size_t size = _function();
+		double milliseconds = clock.reset().asMilliSeconds64();
+		TEST(size > 0);
+		return milliseconds;
+	};
+
+	double formatTime = measure([&]()
+	{
+		String output(&scratchAllocator());
+		for (u32 i = 0; i < LINE_COUNT; ++i)
+		{
+			output += string::format("%s%s: %.2f%s\n", "    ", "Renderer::render", double(i) * 0.37, "ms");
+		}
+		return output.size();
+	});
+
+	double builderTime = measure([&]()
+	{
+		StringBuilder builder(&scratchAllocator());
+		for (u32 i = 0; i < LINE_COUNT; ++i)
+		{
+			builder.appendRepeated(' ', 4);
+			builder.format("{}: {.2}{}\n", "Renderer::render", double(i) * 0.37, "ms");
+		}
+		return builder.size();
+	});
+
+	double snprintfIntegerTime = measure([&]()
+	{
+		char buffer[32];
+		size_t size = 0;
+		for (u32 i = 0; i < LINE_COUNT * 10; ++i)
+		{
+			size += snprintf(buffer, sizeof(buffer), "%u", i * 2654435761u);
+		}
+		return size;
+	});
+
+	double builderIntegerTime = measure([&]()
+	{
+		char buffer[32];
+		StringBuilder builder(buffer, sizeof(buffer));
+		size_t size = 0;
+		for (u32 i = 0; i < LINE_COUNT * 10; ++i)
+		{
+			builder.clear();
+			builder.appendUnsigned(i * 2654435761u);
+			size += builder.size();
+		}
+		return size;
+	});
+
+	YAE_LOGF_CAT(benchmark, "%d lines: String += string::format %.2fms, StringBuilder::format %.2fms", LINE_COUNT, formatTime, builderTime);
+	YAE_LOGF_CAT(benchmark, "%d integers: snprintf %.2fms, StringBuilder %.2fms", LINE_COUNT * 10, snprintfIntegerTime, builderIntegerTime);
+}
+
+} // namespace test
+} // namespace yae
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <yae/types.h>
+
+namespace yae {
+namespace test {
+
+void testStringPool();
+void testStringBuilder();
+
+void benchmarkStringBuilder();
+
+} // namespace test
+} // namespace yae
@@ -29,3 +29,5 @@ YAE_API Renderer& renderer();
 YAE_API Console& console();
 
 } // namespace yae
+
+#include <yae/log_categories.h>